@@ -237,44 +237,76 @@ class SourceAudioHalAsrc::Resampler {
 
   static const unsigned WSIZE = 64;
 
-  int32_t win_[2][WSIZE];
+  // The PCM stream is interleaved, all the channels share the same
+  // position, and each one keeps two copies of its window, shifted by
+  // `WSIZE / 2`, so that `2 * KERNEL_A` contiguous samples are available.
+
+  const int channels_;
+  std::vector<int32_t> win_;
   unsigned out_pos_, in_pos_;
   const int32_t pcm_min_, pcm_max_;
 
-  // Apply the transfer coefficients `h`, corrected by linear interpolation,
-  // given fraction position `mu` weigthed by `d` values.
+  inline int32_t* Window(int ch, unsigned wbuf) { return win_.data() + (2 * ch + wbuf) * WSIZE; }
+
+  // Compute in `k` the transfer coefficients `h`, corrected by linear
+  // interpolation, given fraction position `mu` weigthed by `d` values.
+  // The coefficients are computed once for all the channels.
+
+  inline void Interpolate(const int32_t* h, int16_t mu, const int16_t* d, int32_t* k);
+
+  // Apply the interpolated coefficients `k` to the input `in`.
+
+  inline int32_t Filter(const int32_t* in, const int32_t* k);
+
+  // Filter the channels at the current position of the input stream,
+  // to the `out` frame.
+
+  template <typename T>
+  inline void FilterFrame(T* out) {
+    alignas(16) int32_t k[2 * KERNEL_A];
+
+    unsigned idx = (in_pos_ >> 26);
+    unsigned phy = (in_pos_ >> 17) & 0x1ff;
+    int16_t mu = (in_pos_ >> 2) & 0x7fff;
+
+    unsigned wbuf = idx < WSIZE / 2 || idx >= WSIZE + WSIZE / 2;
+    unsigned woff = ((idx + wbuf * WSIZE / 2) % WSIZE) - WSIZE / 2;
+
+    Interpolate(h_[phy], mu, d_[phy], k);
+    for (int ch = 0; ch < channels_; ch++) {
+      out[ch] = Filter(Window(ch, wbuf) + woff, k);
+    }
+  }
+
+  // Push the `in` frame in the windows of the channels.
 
-  inline int32_t Filter(const int32_t* in, const int32_t* h, int16_t mu, const int16_t* d);
+  template <typename T>
+  inline void PushFrame(const T* in) {
+    for (int ch = 0; ch < channels_; ch++) {
+      Window(ch, 0)[(out_pos_ + WSIZE / 2) % WSIZE] = Window(ch, 1)[out_pos_] = in[ch];
+    }
+    out_pos_ = (out_pos_ + 1) % WSIZE;
+  }
 
   // Upsampling loop, the ratio is less than 1.0 in Q26 format,
   // more output samples are produced compared to input.
 
   template <typename T>
-  __attribute__((no_sanitize("integer"))) void Upsample(unsigned ratio, const T* in, int in_stride,
-                                                        size_t in_len, size_t* in_count, T* out,
-                                                        int out_stride, size_t out_len,
+  __attribute__((no_sanitize("integer"))) void Upsample(unsigned ratio, const T* in, size_t in_len,
+                                                        size_t* in_count, T* out, size_t out_len,
                                                         size_t* out_count) {
-    int nin = in_len, nout = out_len;
+    size_t nin = in_len, nout = out_len;
 
     while (nin > 0 && nout > 0) {
-      unsigned idx = (in_pos_ >> 26);
-      unsigned phy = (in_pos_ >> 17) & 0x1ff;
-      int16_t mu = (in_pos_ >> 2) & 0x7fff;
-
-      unsigned wbuf = idx < WSIZE / 2 || idx >= WSIZE + WSIZE / 2;
-      auto w = win_[wbuf] + ((idx + wbuf * WSIZE / 2) % WSIZE) - WSIZE / 2;
-
-      *out = Filter(w, h_[phy], mu, d_[phy]);
-      out += out_stride;
+      FilterFrame(out);
+      out += channels_;
       nout--;
       in_pos_ += ratio;
 
       if (in_pos_ - (out_pos_ << 26) >= (1u << 26)) {
-        win_[0][(out_pos_ + WSIZE / 2) % WSIZE] = win_[1][(out_pos_)] = *in;
-
-        in += in_stride;
+        PushFrame(in);
+        in += channels_;
         nin--;
-        out_pos_ = (out_pos_ + 1) % WSIZE;
       }
     }
 
@@ -287,31 +319,21 @@ class SourceAudioHalAsrc::Resampler {
 
   template <typename T>
   __attribute__((no_sanitize("integer"))) void Downsample(unsigned ratio, const T* in,
-                                                          int in_stride, size_t in_len,
-                                                          size_t* in_count, T* out, int out_stride,
+                                                          size_t in_len, size_t* in_count, T* out,
                                                           size_t out_len, size_t* out_count) {
     size_t nin = in_len, nout = out_len;
 
     while (nin > 0 && nout > 0) {
       if (in_pos_ - (out_pos_ << 26) < (1u << 26)) {
-        unsigned idx = (in_pos_ >> 26);
-        unsigned phy = (in_pos_ >> 17) & 0x1ff;
-        int16_t mu = (in_pos_ >> 2) & 0x7fff;
-
-        unsigned wbuf = idx < WSIZE / 2 || idx >= WSIZE + WSIZE / 2;
-        auto w = win_[wbuf] + ((idx + wbuf * WSIZE / 2) % WSIZE) - WSIZE / 2;
-
-        *out = Filter(w, h_[phy], mu, d_[phy]);
-        out += out_stride;
+        FilterFrame(out);
+        out += channels_;
         nout--;
         in_pos_ += ratio;
       }
 
-      win_[0][(out_pos_ + WSIZE / 2) % WSIZE] = win_[1][(out_pos_)] = *in;
-
-      in += in_stride;
+      PushFrame(in);
+      in += channels_;
       nin--;
-      out_pos_ = (out_pos_ + 1) % WSIZE;
     }
 
     *in_count = in_len - nin;
@@ -319,26 +341,30 @@ class SourceAudioHalAsrc::Resampler {
   }
 
 public:
-  Resampler(int bit_depth)
+  Resampler(int channels, int bit_depth)
       : h_(asrc::resampler_tables.h),
         d_(asrc::resampler_tables.d),
-        win_{{0}, {0}},
+        channels_(channels),
+        win_(2 * channels * WSIZE, 0),
         out_pos_(0),
         in_pos_(0),
         pcm_min_(-(int32_t(1) << (bit_depth - 1))),
         pcm_max_((int32_t(1) << (bit_depth - 1)) - 1) {}
 
-  // Resample from `in` buffer to `out` buffer, until the end of any of
-  // the two buffers. `in_count` returns the number of consumed samples,
-  // and `out_count` the number produced. `in_sub` returns the phase in
-  // the input stream, in Q26 format.
+  int channels() const { return channels_; }
+
+  // Resample from the interleaved `in` buffer to `out` buffer, until the
+  // end of any of the two buffers. The lengths are expressed in frames,
+  // one sample for each channel. `in_count` returns the number of consumed
+  // frames, and `out_count` the number produced. `in_sub` returns the phase
+  // in the input stream, in Q26 format.
 
   template <typename T>
-  void Resample(unsigned ratio_q26, const T* in, int in_stride, size_t in_len, size_t* in_count,
-                T* out, int out_stride, size_t out_len, size_t* out_count, unsigned* in_sub_q26) {
+  void Resample(unsigned ratio_q26, const T* in, size_t in_len, size_t* in_count, T* out,
+                size_t out_len, size_t* out_count, unsigned* in_sub_q26) {
     auto fn = ratio_q26 < (1u << 26) ? &Resampler::Upsample<T> : &Resampler::Downsample<T>;
 
-    (this->*fn)(ratio_q26, in, in_stride, in_len, in_count, out, out_stride, out_len, out_count);
+    (this->*fn)(ratio_q26, in, in_len, in_count, out, out_len, out_count);
 
     *in_sub_q26 = in_pos_ & ((1u << 26) - 1);
   }
@@ -356,61 +382,102 @@ static inline int32x4_t vmull_low_s16(int16x8_t a, int16x8_t b) {
   return vmull_s16(vget_low_s16(a), vget_low_s16(b));
 }
 
-static inline int64x2_t vmull_low_s32(int32x4_t a, int32x4_t b) {
-  return vmull_s32(vget_low_s32(a), vget_low_s32(b));
-}
-
 static inline int64x2_t vmlal_low_s32(int64x2_t r, int32x4_t a, int32x4_t b) {
   return vmlal_s32(r, vget_low_s32(a), vget_low_s32(b));
 }
 
-inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x, const int32_t* h,
-                                                     int16_t _mu, const int16_t* d) {
-  int64x2_t sx;
-
+inline void SourceAudioHalAsrc::Resampler::Interpolate(const int32_t* h, int16_t _mu,
+                                                       const int16_t* d, int32_t* k) {
   int16x8_t mu = vdupq_n_s16(_mu);
 
-  int16x8_t d0 = vld1q_s16(d + 0);
-  int32x4_t h0 = vld1q_s32(h + 0), h4 = vld1q_s32(h + 4);
-  int32x4_t x0 = vld1q_s32(x + 0), x4 = vld1q_s32(x + 4);
-
-  h0 = vaddq_s32(h0, vrshrq_n_s32(vmull_low_s16(d0, mu), 7));
-  h4 = vaddq_s32(h4, vrshrq_n_s32(vmull_high_s16(d0, mu), 7));
-
-  sx = vmull_low_s32(x0, h0);
-  sx = vmlal_high_s32(sx, x0, h0);
-  sx = vmlal_low_s32(sx, x4, h4);
-  sx = vmlal_high_s32(sx, x4, h4);
-
-  for (int i = 8; i < 32; i += 8) {
+  for (int i = 0; i < 2 * KERNEL_A; i += 8) {
     int16x8_t d8 = vld1q_s16(d + i);
     int32x4_t h8 = vld1q_s32(h + i), h12 = vld1q_s32(h + i + 4);
-    int32x4_t x8 = vld1q_s32(x + i), x12 = vld1q_s32(x + i + 4);
 
-    h8 = vaddq_s32(h8, vrshrq_n_s32(vmull_low_s16(d8, mu), 7));
-    h12 = vaddq_s32(h12, vrshrq_n_s32(vmull_high_s16(d8, mu), 7));
+    vst1q_s32(k + i, vaddq_s32(h8, vrshrq_n_s32(vmull_low_s16(d8, mu), 7)));
+    vst1q_s32(k + i + 4, vaddq_s32(h12, vrshrq_n_s32(vmull_high_s16(d8, mu), 7)));
+  }
+}
+
+inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x, const int32_t* k) {
+  int64x2_t sx = vdupq_n_s64(0);
 
-    sx = vmlal_low_s32(sx, x8, h8);
-    sx = vmlal_high_s32(sx, x8, h8);
-    sx = vmlal_low_s32(sx, x12, h12);
-    sx = vmlal_high_s32(sx, x12, h12);
+  for (int i = 0; i < 2 * KERNEL_A; i += 8) {
+    int32x4_t k0 = vld1q_s32(k + i), k4 = vld1q_s32(k + i + 4);
+    int32x4_t x0 = vld1q_s32(x + i), x4 = vld1q_s32(x + i + 4);
+
+    sx = vmlal_low_s32(sx, x0, k0);
+    sx = vmlal_high_s32(sx, x0, k0);
+    sx = vmlal_low_s32(sx, x4, k4);
+    sx = vmlal_high_s32(sx, x4, k4);
   }
 
   int64_t s = (vaddvq_s64(sx) + (1 << 30)) >> 31;
   return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
 }
 
+//
+// x86 SSE4.1 Resampler Filtering
+//
+
+#elif __SSE4_1__ && __x86_64__
+
+#include <smmintrin.h>
+
+inline void SourceAudioHalAsrc::Resampler::Interpolate(const int32_t* h, int16_t mu,
+                                                       const int16_t* d, int32_t* k) {
+  // The pairs (d, 1) multiplied by (mu, 1 << 6) give the rounded products.
+
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i mu_round = _mm_set1_epi32((1 << 22) | uint16_t(mu));
+
+  for (int i = 0; i < 2 * KERNEL_A; i += 8) {
+    __m128i d8 = _mm_loadu_si128((const __m128i*)(d + i));
+    __m128i h0 = _mm_loadu_si128((const __m128i*)(h + i));
+    __m128i h4 = _mm_loadu_si128((const __m128i*)(h + i + 4));
+
+    __m128i dmu0 = _mm_madd_epi16(_mm_unpacklo_epi16(d8, one), mu_round);
+    __m128i dmu4 = _mm_madd_epi16(_mm_unpackhi_epi16(d8, one), mu_round);
+
+    _mm_storeu_si128((__m128i*)(k + i), _mm_add_epi32(h0, _mm_srai_epi32(dmu0, 7)));
+    _mm_storeu_si128((__m128i*)(k + i + 4), _mm_add_epi32(h4, _mm_srai_epi32(dmu4, 7)));
+  }
+}
+
+inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x, const int32_t* k) {
+  __m128i sx = _mm_setzero_si128();
+
+  for (int i = 0; i < 2 * KERNEL_A; i += 4) {
+    __m128i x0 = _mm_loadu_si128((const __m128i*)(x + i));
+    __m128i k0 = _mm_loadu_si128((const __m128i*)(k + i));
+
+    sx = _mm_add_epi64(sx, _mm_mul_epi32(x0, k0));
+    sx = _mm_add_epi64(sx, _mm_mul_epi32(_mm_srli_epi64(x0, 32), _mm_srli_epi64(k0, 32)));
+  }
+
+  sx = _mm_add_epi64(sx, _mm_unpackhi_epi64(sx, sx));
+
+  int64_t s = (_mm_cvtsi128_si64(sx) + (1 << 30)) >> 31;
+  return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
+}
+
 //
 // Generic Resampler Filtering
 //
 
 #else
 
-inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* in, const int32_t* h,
-                                                     int16_t mu, const int16_t* d) {
+inline void SourceAudioHalAsrc::Resampler::Interpolate(const int32_t* h, int16_t mu,
+                                                       const int16_t* d, int32_t* k) {
+  for (int i = 0; i < 2 * KERNEL_A; i++) {
+    k[i] = h[i] + ((mu * d[i] + (1 << 6)) >> 7);
+  }
+}
+
+inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* in, const int32_t* k) {
   int64_t s = 0;
   for (int i = 0; i < 2 * KERNEL_A - 1; i++) {
-    s += int64_t(in[i]) * (h[i] + ((mu * d[i] + (1 << 6)) >> 7));
+    s += int64_t(in[i]) * k[i];
   }
 
   s = (s + (1 << 30)) >> 31;
@@ -437,7 +504,8 @@ SourceAudioHalAsrc::SourceAudioHalAsrc(bluetooth::common::MessageLoopThread* thr
 
   if (!check_bounds(channels, 1, 8) || !check_bounds(sample_rate, 1 * 1000, 100 * 1000) ||
       !check_bounds(bit_depth, 8, 32) || !check_bounds(interval_us, 1 * 1000, 100 * 1000) ||
-      !check_bounds(num_burst_buffers, 0, 10) || !check_bounds(burst_delay_ms, 0, 1000)) {
+      !check_bounds(num_burst_buffers, 0, kMaxBurstBuffers) ||
+      !check_bounds(burst_delay_ms, 0, 1000)) {
     log::error(
             "Bad parameters: channels: {} sample_rate: {} bit_depth: {} "
             "interval_us: {} num_burst_buffers: {} burst_delay_ms: {}",
@@ -455,7 +523,7 @@ SourceAudioHalAsrc::SourceAudioHalAsrc(bluetooth::common::MessageLoopThread* thr
   // when the PCM bit_depth is higher than 16 bits.
 
   clock_recovery_ = std::make_unique<ClockRecovery>(thread);
-  resamplers_ = std::make_unique<std::vector<Resampler>>(channels, bit_depth_);
+  resampler_ = std::make_unique<Resampler>(channels, bit_depth_);
 
   // Deduct from the PCM stream characteristics, the size of the pool buffers
   // It needs 3 buffers (one almost full, an entire one, and a last which can be
@@ -488,12 +556,13 @@ SourceAudioHalAsrc::SourceAudioHalAsrc(bluetooth::common::MessageLoopThread* thr
 SourceAudioHalAsrc::~SourceAudioHalAsrc() {}
 
 template <typename T>
-__attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
-        double ratio, const std::vector<uint8_t>& in, std::vector<const std::vector<uint8_t>*>* out,
+__attribute__((no_sanitize("integer"))) size_t SourceAudioHalAsrc::Resample(
+        double ratio, std::span<const uint8_t> in, std::span<const std::vector<uint8_t>*> out,
         uint32_t* output_us) {
-  auto& resamplers = *resamplers_;
+  auto& resampler = *resampler_;
   auto& buffers = buffers_;
-  auto channels = resamplers.size();
+  auto channels = resampler.channels();
+  size_t out_buffers = 0;
 
   // Convert the resampling ration in fixed Q16,
   // then loop until the input buffer is consumed.
@@ -509,7 +578,7 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
 
     // Load from the context the current output buffer, the offset
     // and deduct the remaning size. Let's resample the interleaved
-    // PCM stream, a separate reampler is used for each channel.
+    // PCM stream, all the channels at once.
 
     auto buffer = &buffers.pool[buffers.index];
     auto out_data = (T*)buffer->data() + buffers.offset;
@@ -518,10 +587,8 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
 
     size_t in_count, out_count;
 
-    for (auto& r : resamplers) {
-      r.Resample<T>(ratio_q26, in_data++, channels, in_length, &in_count, out_data++, channels,
-                    out_length, &out_count, &sub_q26);
-    }
+    resampler.Resample<T>(ratio_q26, in_data, in_length, &in_count, out_data, out_length,
+                          &out_count, &sub_q26);
 
     in_length -= in_count;
     buffers.offset += out_count * channels;
@@ -541,7 +608,11 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
     if (out_count >= out_length) {
       buffers.index = (buffers.index + 1) % buffers.pool.size();
       buffers.offset = 0;
-      out->push_back(buffer);
+      if (out_buffers < out.size()) {
+        out[out_buffers++] = buffer;
+      } else {
+        log::warn("Output buffer dropped");
+      }
     }
   }
 
@@ -554,22 +625,29 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
 
   *output_us = resampler_pos_.seconds * (1000 * 1000) +
                uint32_t((output_samples_q26 * 1000 * 1000) / (int64_t(sample_rate_) << 26));
+
+  return out_buffers;
 }
 
-__attribute__((no_sanitize("integer"))) std::vector<const std::vector<uint8_t>*>
-SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
-  std::vector<const std::vector<uint8_t>*> out;
+__attribute__((no_sanitize("integer"))) size_t SourceAudioHalAsrc::Run(
+        std::span<const uint8_t> in, std::span<const std::vector<uint8_t>*> out) {
+  size_t num_out = 0;
 
   if (in.size() != buffers_size_) {
     log::error("Inconsistent input buffer size: {} ({} expected)", in.size(), buffers_size_);
-    return out;
+    return 0;
+  }
+
+  if (out.size() < kMaxOutputBuffers) {
+    log::error("Output list too small: {} ({} expected)", out.size(), kMaxOutputBuffers);
+    return 0;
   }
 
   // The burst delay has expired, let's generate the burst.
 
   if (burst_buffers_.size() && stream_us_ >= burst_delay_us_) {
     for (size_t i = 0; i < burst_buffers_.size(); i++) {
-      out.push_back(burst_buffers_[(out_counter_ + i) % burst_buffers_.size()]);
+      out[num_out++] = burst_buffers_[(out_counter_ + i) % burst_buffers_.size()];
     }
 
     burst_buffers_.clear();
@@ -588,10 +666,12 @@ SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
 
   uint32_t output_us;
 
+  auto resampled = out.subspan(num_out);
+
   if (bit_depth_ <= 16) {
-    Resample<int16_t>(ratio, in, &out, &output_us);
+    num_out += Resample<int16_t>(ratio, in, resampled, &output_us);
   } else {
-    Resample<int32_t>(ratio, in, &out, &output_us);
+    num_out += Resample<int32_t>(ratio, in, resampled, &output_us);
   }
 
   drift_us_ += drift_z0_ * (int(output_us - local_us) - drift_us_);
@@ -600,7 +680,7 @@ SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
   // the associated delay has expired.
 
   if (burst_buffers_.size()) {
-    for (size_t i = 0; i < out.size(); i++) {
+    for (size_t i = 0; i < num_out; i++) {
       std::exchange<const std::vector<uint8_t>*>(
               out[i], burst_buffers_[(out_counter_ + i) % burst_buffers_.size()]);
     }
@@ -608,7 +688,7 @@ SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
 
   // Return the output statistics to the clock recovery module
 
-  out_counter_ += out.size();
+  out_counter_ += num_out;
   clock_recovery_->UpdateOutputStats(ratio * sample_rate_, int(output_us - local_us));
 
   if (0) {
@@ -616,7 +696,7 @@ SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
               output_us % (1000 * 1000), ratio * sample_rate_, int(output_us - local_us));
   }
 
-  return out;
+  return num_out;
 }
 
 }  // namespace bluetooth::audio::asrc
@@ -19,6 +19,7 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "common/message_loop_thread.h"
@@ -27,6 +28,13 @@ namespace bluetooth::audio::asrc {
 
 class SourceAudioHalAsrc {
 public:
+  // Bounds of the number of buffers of the transmission burst, and of the
+  // number of buffers returned by a call to `Run()`: the burst, and at most
+  // two resampled buffers.
+
+  static constexpr int kMaxBurstBuffers = 10;
+  static constexpr size_t kMaxOutputBuffers = kMaxBurstBuffers + 2;
+
   // The Asynchronous Sample Rate Conversion (ASRC) is set up from the PCM
   // stream characteristics and the length, expressed in us, of the buffers.
   //
@@ -44,15 +52,17 @@ public:
 
   ~SourceAudioHalAsrc();
 
-  // Takes an input buffer, and returns a list of resamples buffers locked to
-  // the cadence of the transmission. The input and output buffers have a fixed
-  // size, deducted from the PCM characteristics, given to the constructor.
+  // Takes an input buffer, and fills `out` with the resampled buffers locked
+  // to the cadence of the transmission, returning their number. The input and
+  // output buffers have a fixed size, deducted from the PCM characteristics,
+  // given to the constructor. `out` is provided by the caller, and must hold
+  // `kMaxOutputBuffers` elements, so that no allocation is done per call.
   //
   // The data of `in` mest be aligned to `int16_t` or `int32_t` for respectively
   // bit depth less or equal to 16, or greater.
   //
 
-  std::vector<const std::vector<uint8_t>*> Run(const std::vector<uint8_t>& in);
+  size_t Run(std::span<const uint8_t> in, std::span<const std::vector<uint8_t>*> out);
 
 private:
   const int sample_rate_;
@@ -78,15 +88,15 @@ private:
   std::unique_ptr<ClockRecovery> clock_recovery_;
 
   class Resampler;
-  std::unique_ptr<std::vector<Resampler>> resamplers_;
+  std::unique_ptr<Resampler> resampler_;
   struct {
     unsigned seconds;
     int samples;
   } resampler_pos_;
 
   template <typename T>
-  void Resample(double, const std::vector<uint8_t>&, std::vector<const std::vector<uint8_t>*>*,
-                uint32_t*);
+  size_t Resample(double, std::span<const uint8_t>, std::span<const std::vector<uint8_t>*>,
+                  uint32_t*);
 
   friend class SourceAudioHalAsrcTest;
 };
@@ -16,12 +16,14 @@
 #
 
 import ctypes
+import logging
 import numpy as np
 from scipy import signal
 from mobly import test_runner, base_test
 from mobly.asserts import assert_greater
 import sys
 import os
+import time
 
 
 class CResampler:
@@ -32,7 +34,16 @@ class CResampler:
         self.channels = channels
         self.bitdepth = bitdepth
 
-    def resample(self, xs, ratio):
+    def quantize(self, xs):
+
+        bitdepth = self.bitdepth
+
+        xs_min = -(2**(bitdepth - 1))
+        xs_max = (2**(bitdepth - 1) - 1)
+        return np.rint(np.clip(np.ldexp(xs, bitdepth-1), xs_min, xs_max)).\
+               astype([np.int16, np.int32][bitdepth > 16], 'C')
+
+    def run(self, xs_int, ys_int, ratio):
 
         c_int = ctypes.c_int
         c_size_t = ctypes.c_size_t
@@ -43,13 +54,6 @@ class CResampler:
         channels = self.channels
         bitdepth = self.bitdepth
 
-        xs_min = -(2**(bitdepth - 1))
-        xs_max = (2**(bitdepth - 1) - 1)
-        xs_int = np.rint(np.clip(np.ldexp(xs, bitdepth-1), xs_min, xs_max)).\
-                 astype([np.int16, np.int32][bitdepth > 16], 'C')
-
-        ys_int = np.empty(int(np.ceil(len(xs) / ratio)), dtype=xs_int.dtype)
-
         if bitdepth <= 16:
             lib.resample_i16(c_int(channels), c_int(bitdepth), c_double(ratio), xs_int.ctypes.data_as(c_int16_p),
                              c_size_t(len(xs_int)), ys_int.ctypes.data_as(c_int16_p), c_size_t(len(ys_int)))
@@ -57,7 +61,14 @@ class CResampler:
             lib.resample_i32(c_int(channels), c_int(bitdepth), c_double(ratio), xs_int.ctypes.data_as(c_int32_p),
                              c_size_t(len(xs_int)), ys_int.ctypes.data_as(c_int32_p), c_size_t(len(ys_int)))
 
-        return np.ldexp(ys_int, 1 - bitdepth)
+    def resample(self, xs, ratio):
+
+        xs_int = self.quantize(xs)
+        ys_int = np.empty(int(np.ceil(len(xs) / ratio)), dtype=xs_int.dtype)
+
+        self.run(xs_int, ys_int, ratio)
+
+        return np.ldexp(ys_int, 1 - self.bitdepth)
 
 
 FS = 48e3
@@ -92,11 +103,30 @@ def mean_snr(resampler, ratio):
     return np.mean(values[:k])
 
 
+def realtime_factor(resampler, ratio, duration=10):
+    channels = resampler.channels
+    xt = np.arange(int(duration * FS)) / FS
+
+    xs = np.repeat(0.5 * np.sin(2 * np.pi * xt * 997), channels)
+    xs_int = resampler.quantize(xs)
+    ys_int = np.empty(int(np.ceil(len(xt) / ratio)) * channels, dtype=xs_int.dtype)
+
+    t0 = time.perf_counter()
+    resampler.run(xs_int, ys_int, ratio)
+    elapsed = time.perf_counter() - t0
+
+    logging.info('%d channels %d bits ratio %.4f: %.0f x real time', channels, resampler.bitdepth,
+                 ratio, duration / elapsed)
+    return duration / elapsed
+
+
 root = os.path.dirname(os.path.dirname(os.path.dirname(__file__)))
 lib = ctypes.cdll.LoadLibrary(os.path.join(root, "libasrc_resampler_test.so"))
 
 cresampler_16 = CResampler(lib, 1, 16)
 cresampler_24 = CResampler(lib, 1, 24)
+cresampler_16_stereo = CResampler(lib, 2, 16)
+cresampler_24_stereo = CResampler(lib, 2, 24)
 
 
 class SnrTest(base_test.BaseTestClass):
@@ -114,6 +144,21 @@ class SnrTest(base_test.BaseTestClass):
         assert_greater(mean_snr(cresampler_24, 48.0 / 44.1), 114)
 
 
+class ThroughputTest(base_test.BaseTestClass):
+
+    def test_16bit_stereo_48000_to_44100(self):
+        assert_greater(realtime_factor(cresampler_16_stereo, 44.1 / 48.0), 1)
+
+    def test_16bit_stereo_44100_to_48000(self):
+        assert_greater(realtime_factor(cresampler_16_stereo, 48.0 / 44.1), 1)
+
+    def test_24bit_stereo_48000_to_44100(self):
+        assert_greater(realtime_factor(cresampler_24_stereo, 44.1 / 48.0), 1)
+
+    def test_24bit_stereo_44100_to_48000(self):
+        assert_greater(realtime_factor(cresampler_24_stereo, 48.0 / 44.1), 1)
+
+
 if __name__ == '__main__':
     index = sys.argv.index('--')
     sys.argv = sys.argv[:1] + sys.argv[index + 1:]
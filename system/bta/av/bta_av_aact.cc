@@ -460,6 +460,9 @@ void bta_av_sink_data_cback(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     return;
   }
   p_pkt->event = BTA_AV_SINK_MEDIA_DATA_EVT;
+  /* AVDTP has consumed at least the fixed media header in front of the payload */
+  memcpy((uint8_t*)(p_pkt + 1) + p_pkt->offset - BTA_AV_SINK_MEDIA_TIMESTAMP_LEN, &time_stamp,
+         BTA_AV_SINK_MEDIA_TIMESTAMP_LEN);
   p_scb->seps[p_scb->sep_idx].p_app_sink_data_cback(
           p_scb->PeerAddress(), BTA_AV_SINK_MEDIA_DATA_EVT, (tBTA_AV_MEDIA*)p_pkt);
   /* Free the buffer: a copy of the packet has been delivered */
@@ -1898,7 +1901,6 @@ void bta_av_do_start(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 void bta_av_str_stopped(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   uint8_t start = p_scb->started;
   bool sus_evt = true;
-  BT_HDR* p_buf;
 
   log::info("peer {} bta_handle:0x{:x} audio_open_cnt:{}, p_data {} start:{}", p_scb->PeerAddress(),
             p_scb->hndl, bta_av_cb.audio_open_cnt, fmt::ptr(p_data), start);
@@ -1924,11 +1926,7 @@ void bta_av_str_stopped(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* if q_info.a2dp_list is not empty, drop it now */
   if (BTA_AV_CHNL_AUDIO == p_scb->chnl) {
-    while (!list_is_empty(p_scb->a2dp_list)) {
-      p_buf = (BT_HDR*)list_front(p_scb->a2dp_list);
-      list_remove(p_scb->a2dp_list, p_buf);
-      osi_free(p_buf);
-    }
+    bta_av_flush_audio_list(p_scb);
 
     /* drop the audio buffers queued in L2CAP */
     if (p_data && p_data->api_stop.flush) {
@@ -2079,6 +2077,7 @@ void bta_av_reconfig(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
  *
  ******************************************************************************/
 void bta_av_data_path(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
+  tBTA_AV_MEDIA_PKT* p_pkt = NULL;
   BT_HDR* p_buf = NULL;
   uint32_t timestamp;
   bool new_buf = false;
@@ -2101,30 +2100,35 @@ void bta_av_data_path(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
   p_scb->l2c_bufs = (uint8_t)L2CA_FlushChannel(p_scb->l2c_cid, L2CAP_FLUSH_CHANS_GET);
 
   if (!list_is_empty(p_scb->a2dp_list)) {
-    p_buf = (BT_HDR*)list_front(p_scb->a2dp_list);
-    list_remove(p_scb->a2dp_list, p_buf);
-    /* use q_info.a2dp data, read the timestamp */
-    timestamp = *(uint32_t*)(p_buf + 1);
+    p_pkt = (tBTA_AV_MEDIA_PKT*)list_front(p_scb->a2dp_list);
+    list_remove(p_scb->a2dp_list, p_pkt);
+  } else if (bta_av_media_codec_mismatch(p_scb)) {
+    /* Another channel reads the encoder output, with a codec configuration
+     * this peer can't decode. Reading it here would take its packets. */
+    return;
   } else {
     new_buf = true;
-    /* A2DP_list empty, call co_data, dup data to other channels */
+    /* A2DP_list empty, call co_data, share data with other channels */
     p_buf = p_scb->p_cos->data(p_scb->cfg.codec_info, &timestamp);
 
     if (p_buf) {
-      /* use the offset area for the time stamp */
-      *(uint32_t*)(p_buf + 1) = timestamp;
+      bta_av_cb.encoded_pkts++;
+      p_pkt = bta_av_media_pkt_new(p_buf, timestamp);
 
-      /* dup the data to other channels */
-      bta_av_dup_audio_buf(p_scb, p_buf);
+      /* share the data with other channels */
+      bta_av_dup_audio_buf(p_scb, p_pkt);
     }
   }
 
-  if (p_buf) {
+  if (p_pkt) {
     if (p_scb->l2c_bufs < (BTA_AV_QUEUE_DATA_CHK_NUM)) {
       /* There's a buffer, just queue it to L2CAP.
        * There's no need to increment it here, it is always read from
        * L2CAP (see above).
        */
+      timestamp = p_pkt->timestamp;
+      p_buf = bta_av_media_pkt_take(p_scb, p_pkt);
+      p_scb->media_stats.sent++;
 
       /* opt is a bit mask, it could have several options set */
       opt = AVDT_DATA_OPT_NONE;
@@ -2183,16 +2187,17 @@ void bta_av_data_path(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
       if (new_buf) {
         /* just got this buffer from co_data,
          * put it in queue */
-        list_append(p_scb->a2dp_list, p_buf);
+        list_append(p_scb->a2dp_list, p_pkt);
       } else {
         /* just dequeue it from the a2dp_list */
         if (list_length(p_scb->a2dp_list) < 3) {
           /* put it back to the queue */
-          list_prepend(p_scb->a2dp_list, p_buf);
+          list_prepend(p_scb->a2dp_list, p_pkt);
         } else {
           /* too many buffers in a2dp_list, drop it. */
           bta_av_co_audio_drop(p_scb->hndl, p_scb->PeerAddress());
-          osi_free(p_buf);
+          bta_av_media_pkt_release(p_pkt);
+          p_scb->media_stats.dropped++;
         }
       }
     }
@@ -484,6 +484,26 @@ typedef union {
 #define BTA_AV_COLL_INC_TMR 0x01    /* Timer is running for incoming L2C connection */
 #define BTA_AV_COLL_API_CALLED 0x02 /* API open was called while incoming timer is running */
 
+/* An encoded media packet shared by the audio channels streaming the same codec
+ * configuration. The encoder output is read once, and each channel holds a
+ * reference in its a2dp_list. The buffer is copied only when a channel sends it
+ * while other channels still hold it, so the last channel sends it as is. */
+typedef struct {
+  BT_HDR* p_buf;      /* the encoded media packet, not modified while shared */
+  uint32_t timestamp; /* media timestamp of the packet */
+  uint8_t ref_count;  /* number of channels holding the packet */
+} tBTA_AV_MEDIA_PKT;
+
+/* Media packet counters of an audio channel */
+typedef struct {
+  uint32_t sent;           /* packets sent to AVDTP */
+  uint32_t copied;         /* packets copied because other channels still held them */
+  uint32_t fanned_in;      /* packets received from the encoder output of another channel */
+  uint32_t dropped;        /* packets dropped because the channel was not moving data */
+  uint32_t flushed;        /* packets flushed when the stream stopped */
+  uint32_t codec_mismatch; /* packets not shared because the codec configuration differs */
+} tBTA_AV_MEDIA_STATS;
+
 /* type for AV stream control block */
 // TODO: This should be renamed and changed to a proper class
 struct tBTA_AV_SCB final {
@@ -492,7 +512,7 @@ public:
   bool sdp_discovery_started;     /* variable to determine whether SDP is started */
   tBTA_AV_SEP seps[BTAV_A2DP_CODEC_INDEX_MAX];
   AvdtpSepConfig peer_cap; /* buffer used for get capabilities */
-  list_t* a2dp_list;       /* used for audio channels only */
+  list_t* a2dp_list;       /* tBTA_AV_MEDIA_PKT queue, used for audio channels only */
   tBTA_AV_Q_INFO q_info;
   tAVDT_SEP_INFO sep_info[BTA_AV_NUM_SEPS]; /* stream discovery results */
   AvdtpSepConfig cfg;                       /* local SEP configuration */
@@ -542,6 +562,12 @@ public:
   bool no_rtp_header;             /* true if add no RTP header */
   uint16_t uuid_int;              /*intended UUID of Initiator to connect to */
 
+  tBTA_AV_MEDIA_STATS media_stats; /* media packet counters of the audio channel */
+  bool media_codec_mismatch;       /* true if the encoder output read by another channel
+                                      can't be shared with this one */
+  uint8_t media_reader_hdi;        /* index of the channel reading the encoder output, if
+                                      media_codec_mismatch is true */
+
   /**
    * Called to setup the state when connected to a peer.
    *
@@ -648,6 +674,9 @@ typedef struct {
   tBTA_AV_FEAT sink_features; /* sink features */
   uint8_t reg_role;           /* bit0-src, bit1-sink */
   tBTA_AV_RC_FEAT rc_feature; /* save peer rc feature */
+  uint32_t encoded_pkts;     /* media packets read from the encoder */
+  uint32_t shared_pkts;      /* media packets shared by more than one audio channel */
+  uint32_t shared_refs;      /* references handed out for the shared media packets */
 } tBTA_AV_CB;
 
 // total attempts are half seconds
@@ -719,7 +748,12 @@ void bta_av_free_scb(tBTA_AV_SCB* p_scb);
 
 /* main functions */
 void bta_av_api_deregister(tBTA_AV_DATA* p_data);
-void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, BT_HDR* p_buf);
+tBTA_AV_MEDIA_PKT* bta_av_media_pkt_new(BT_HDR* p_buf, uint32_t timestamp);
+BT_HDR* bta_av_media_pkt_take(tBTA_AV_SCB* p_scb, tBTA_AV_MEDIA_PKT* p_pkt);
+void bta_av_media_pkt_release(tBTA_AV_MEDIA_PKT* p_pkt);
+void bta_av_flush_audio_list(tBTA_AV_SCB* p_scb);
+void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, tBTA_AV_MEDIA_PKT* p_pkt);
+bool bta_av_media_codec_mismatch(tBTA_AV_SCB* p_scb);
 void bta_av_sm_execute(tBTA_AV_CB* p_cb, uint16_t event, tBTA_AV_DATA* p_data);
 void bta_av_ssm_execute(tBTA_AV_SCB* p_scb, uint16_t event, tBTA_AV_DATA* p_data);
 bool bta_av_hdl_event(const BT_HDR_RIGID* p_msg);
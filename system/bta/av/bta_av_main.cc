@@ -323,6 +323,7 @@ void bta_av_free_scb(tBTA_AV_SCB* p_scb) {
                    "assert failed: p_scb == bta_av_cb.p_scb[scb_index]");
   bta_av_cb.p_scb[scb_index] = nullptr;
   alarm_free(p_scb->avrc_ct_timer);
+  bta_av_flush_audio_list(p_scb);
   list_free(p_scb->a2dp_list);
   p_scb->a2dp_list = NULL;
   // TODO: After tBTA_AV_SCB is changed to a proper class, the entry
@@ -1115,23 +1116,103 @@ bool bta_av_link_role_ok(tBTA_AV_SCB* p_scb, uint8_t bits) {
   return true;
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_av_media_pkt_new
+ *
+ * Description      Wrap an encoded media packet so that it can be shared by the
+ *                  audio channels. The caller holds the only reference.
+ *
+ * Returns          the shared media packet
+ *
+ ******************************************************************************/
+tBTA_AV_MEDIA_PKT* bta_av_media_pkt_new(BT_HDR* p_buf, uint32_t timestamp) {
+  tBTA_AV_MEDIA_PKT* p_pkt = (tBTA_AV_MEDIA_PKT*)osi_malloc(sizeof(tBTA_AV_MEDIA_PKT));
+  p_pkt->p_buf = p_buf;
+  p_pkt->timestamp = timestamp;
+  p_pkt->ref_count = 1;
+  return p_pkt;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_media_pkt_take
+ *
+ * Description      Release the reference of p_scb to the media packet, and get
+ *                  a buffer that it can hand over to AVDTP. The buffer of the
+ *                  packet is handed over by the last channel holding it, the
+ *                  other channels get a copy.
+ *
+ * Returns          the buffer, owned by the caller
+ *
+ ******************************************************************************/
+BT_HDR* bta_av_media_pkt_take(tBTA_AV_SCB* p_scb, tBTA_AV_MEDIA_PKT* p_pkt) {
+  BT_HDR* p_buf = p_pkt->p_buf;
+  if (--p_pkt->ref_count == 0) {
+    osi_free(p_pkt);
+    return p_buf;
+  }
+
+  uint16_t copy_size = BT_HDR_SIZE + p_buf->offset + p_buf->len;
+  BT_HDR* p_copy = (BT_HDR*)osi_malloc(copy_size);
+  memcpy(p_copy, p_buf, copy_size);
+  p_scb->media_stats.copied++;
+  return p_copy;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_media_pkt_release
+ *
+ * Description      Release a reference to the media packet without sending it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_media_pkt_release(tBTA_AV_MEDIA_PKT* p_pkt) {
+  if (--p_pkt->ref_count == 0) {
+    osi_free(p_pkt->p_buf);
+    osi_free(p_pkt);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_flush_audio_list
+ *
+ * Description      Drop the media packets queued in the a2dp_list of p_scb.
+ *                  The packets stay queued for the other audio channels.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_flush_audio_list(tBTA_AV_SCB* p_scb) {
+  while (!list_is_empty(p_scb->a2dp_list)) {
+    tBTA_AV_MEDIA_PKT* p_pkt = (tBTA_AV_MEDIA_PKT*)list_front(p_scb->a2dp_list);
+    list_remove(p_scb->a2dp_list, p_pkt);
+    bta_av_media_pkt_release(p_pkt);
+    p_scb->media_stats.flushed++;
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_dup_audio_buf
  *
- * Description      dup the audio data to the q_info.a2dp of other audio
- *                  channels
+ * Description      share the media packet read by p_scb with the other started
+ *                  audio channels that use the same codec configuration, by
+ *                  queueing a reference to it in their a2dp_list
  *
  * Returns          void
  *
  ******************************************************************************/
-void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, BT_HDR* p_buf) {
+void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, tBTA_AV_MEDIA_PKT* p_pkt) {
   /* Test whether there is more than one audio channel connected */
-  if ((p_buf == NULL) || (bta_av_cb.audio_open_cnt < 2)) {
+  if ((p_pkt == NULL) || (bta_av_cb.audio_open_cnt < 2)) {
     return;
   }
 
-  uint16_t copy_size = BT_HDR_SIZE + p_buf->len + p_buf->offset;
+  uint8_t refs = p_pkt->ref_count;
   for (int i = 0; i < BTA_AV_NUM_STRS; i++) {
     tBTA_AV_SCB* p_scbi = bta_av_cb.p_scb[i];
 
@@ -1144,20 +1225,64 @@ void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, BT_HDR* p_buf) {
     if (!(bta_av_cb.conn_audio & BTA_AV_HNDL_TO_MSK(i))) {
       continue; /* Audio is not connected */
     }
+    if (!A2DP_CodecEquals(p_scb->cfg.codec_info, p_scbi->cfg.codec_info)) {
+      /* The encoder output can't be decoded by this peer */
+      p_scbi->media_stats.codec_mismatch++;
+      p_scbi->media_codec_mismatch = true;
+      p_scbi->media_reader_hdi = p_scb->hdi;
+      continue;
+    }
 
-    /* Enqueue the data */
-    BT_HDR* p_new = (BT_HDR*)osi_malloc(copy_size);
-    memcpy(p_new, p_buf, copy_size);
-    list_append(p_scbi->a2dp_list, p_new);
+    /* Enqueue a reference to the packet */
+    p_pkt->ref_count++;
+    list_append(p_scbi->a2dp_list, p_pkt);
+    p_scbi->media_stats.fanned_in++;
+    p_scbi->media_codec_mismatch = false;
 
     if (list_length(p_scbi->a2dp_list) > p_bta_av_cfg->audio_mqs) {
       // Drop the oldest packet
       bta_av_co_audio_drop(p_scbi->hndl, p_scbi->PeerAddress());
-      BT_HDR* p_buf_drop = static_cast<BT_HDR*>(list_front(p_scbi->a2dp_list));
-      list_remove(p_scbi->a2dp_list, p_buf_drop);
-      osi_free(p_buf_drop);
+      tBTA_AV_MEDIA_PKT* p_pkt_drop =
+              static_cast<tBTA_AV_MEDIA_PKT*>(list_front(p_scbi->a2dp_list));
+      list_remove(p_scbi->a2dp_list, p_pkt_drop);
+      bta_av_media_pkt_release(p_pkt_drop);
+      p_scbi->media_stats.dropped++;
     }
   }
+
+  if (p_pkt->ref_count > refs) {
+    bta_av_cb.shared_pkts++;
+    bta_av_cb.shared_refs += p_pkt->ref_count - refs;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_media_codec_mismatch
+ *
+ * Description      Check whether another started audio channel reads the
+ *                  encoder output, with a codec configuration that differs
+ *                  from the one of p_scb. Reading the encoder output from
+ *                  p_scb would then take packets from that channel.
+ *
+ * Returns          true if p_scb must not read the encoder output
+ *
+ ******************************************************************************/
+bool bta_av_media_codec_mismatch(tBTA_AV_SCB* p_scb) {
+  if (!p_scb->media_codec_mismatch) {
+    return false;
+  }
+
+  uint8_t hdi = p_scb->media_reader_hdi;
+  tBTA_AV_SCB* p_reader = bta_av_cb.p_scb[hdi];
+  if ((p_reader != NULL) && p_reader->co_started &&
+      (bta_av_cb.conn_audio & BTA_AV_HNDL_TO_MSK(hdi))) {
+    return true;
+  }
+
+  /* The reading channel stopped, p_scb can read the encoder output */
+  p_scb->media_codec_mismatch = false;
+  return false;
 }
 
 static void bta_av_non_state_machine_event(uint16_t event, tBTA_AV_DATA* p_data) {
@@ -1486,6 +1611,9 @@ void bta_debug_av_dump(int fd) {
   dprintf(fd, "  Connected LCBs mask: 0x%x\n", bta_av_cb.conn_lcb);
   dprintf(fd, "  Offload start pending handle: %d\n", bta_av_cb.offload_start_pending_hndl);
   dprintf(fd, "  Offload started handle: %d\n", bta_av_cb.offload_started_hndl);
+  dprintf(fd, "  Media packets read from the encoder: %u\n", bta_av_cb.encoded_pkts);
+  dprintf(fd, "  Media packets shared by audio channels: %u\n", bta_av_cb.shared_pkts);
+  dprintf(fd, "  Media packet references shared: %u\n", bta_av_cb.shared_refs);
 
   for (size_t i = 0; i < sizeof(bta_av_cb.lcb) / sizeof(bta_av_cb.lcb[0]); i++) {
     const tBTA_AV_LCB& lcb = bta_av_cb.lcb[i];
@@ -1557,5 +1685,13 @@ void bta_debug_av_dump(int fd) {
     dprintf(fd, "    Wait mask: 0x%x\n", p_scb->wait);
     dprintf(fd, "    Don't use RTP header: %s\n", p_scb->no_rtp_header ? "true" : "false");
     dprintf(fd, "    Intended UUID of Initiator to connect to: 0x%x\n", p_scb->uuid_int);
+    const tBTA_AV_MEDIA_STATS& stats = p_scb->media_stats;
+    dprintf(fd, "    Queued media packets: %zu\n", list_length(p_scb->a2dp_list));
+    dprintf(fd, "    Media packets shared by another channel: %u\n", stats.fanned_in);
+    dprintf(fd, "    Media packets sent: %u\n", stats.sent);
+    dprintf(fd, "      Copied while shared: %u\n", stats.copied);
+    dprintf(fd, "    Media packets dropped: %u\n", stats.dropped);
+    dprintf(fd, "    Media packets flushed: %u\n", stats.flushed);
+    dprintf(fd, "    Media packets not shared (codec mismatch): %u\n", stats.codec_mismatch);
   }
 }
@@ -63,10 +63,12 @@
 #include "stack/include/gatt_api.h"
 #include "stack/include/l2c_api.h"
 #include "stack/include/main_thread.h"
+#include "stack/include/sdp_api.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
 using bluetooth::Uuid;
+using bluetooth::legacy::stack::sdp::get_legacy_stack_sdp_api;
 using namespace bluetooth;
 
 bool ble_vnd_is_included();
@@ -465,6 +467,9 @@ void bta_dm_process_remove_device_no_callback(const RawAddress& bd_addr) {
 
   /* remove all cached GATT information */
   bta_dm_disc_gatt_refresh(bd_addr);
+
+  /* remove all cached SDP records */
+  get_legacy_stack_sdp_api()->service.SDP_InvalidateCache(bd_addr);
 }
 
 void bta_dm_process_remove_device(const RawAddress& bd_addr) {
@@ -1045,6 +1045,10 @@ static void bta_dm_find_services(const RawAddress& bd_addr) {
 
       bta_dm_search_cb.p_sdp_db->raw_size = MAX_DISC_RAW_DATA_BUF;
 
+      /* Service discovery asks the device itself, the records cached from previous
+       * searches may be stale */
+      get_legacy_stack_sdp_api()->service.SDP_InvalidateCache(bd_addr);
+
       if (!get_legacy_stack_sdp_api()->service.SDP_ServiceSearchAttributeRequest(
                   bd_addr, bta_dm_search_cb.p_sdp_db, &bta_dm_sdp_callback)) {
         log::warn("Unable to start SDP service search attribute request peer:{}", bd_addr);
@@ -339,6 +339,10 @@ void bta_dm_sdp_find_services(tBTA_DM_SDP_STATE* sdp_state) {
 
   p_sdp_db->raw_size = MAX_DISC_RAW_DATA_BUF;
 
+  /* Service discovery asks the device itself, the records cached from previous
+   * searches may be stale */
+  get_legacy_stack_sdp_api()->service.SDP_InvalidateCache(sdp_state->bd_addr);
+
   if (!get_legacy_stack_sdp_api()->service.SDP_ServiceSearchAttributeRequest(
               sdp_state->bd_addr, p_sdp_db, &bta_dm_sdp_callback)) {
     /*
@@ -32,10 +32,12 @@
 #include "stack/include/btm_sec_api.h"
 #include "stack/include/btm_status.h"
 #include "stack/include/gatt_api.h"
+#include "stack/include/sdp_api.h"
 #include "stack/include/security_client_callbacks.h"
 #include "types/bt_transport.h"
 #include "types/raw_address.h"
 
+using bluetooth::legacy::stack::sdp::get_legacy_stack_sdp_api;
 using namespace bluetooth;
 
 static tBTM_STATUS bta_dm_sp_cback(tBTM_SP_EVT event, tBTM_SP_EVT_DATA* p_data);
@@ -317,6 +319,9 @@ static tBTM_STATUS bta_dm_new_link_key_cback(const RawAddress& bd_addr, DEV_CLAS
 
   sec_event.auth_cmpl.fail_reason = HCI_SUCCESS;
 
+  // The peer may expose other records once bonded, search them again
+  get_legacy_stack_sdp_api()->service.SDP_InvalidateCache(bd_addr);
+
   // Report the BR link key based on the BR/EDR address and type
   get_btm_client_interface().peer.BTM_ReadDevInfo(bd_addr, &sec_event.auth_cmpl.dev_type,
                                                   &sec_event.auth_cmpl.addr_type);
@@ -115,17 +115,6 @@ void bta_gattc_init_cache(tBTA_GATTC_SERV* p_srvc_cb) {
   p_srvc_cb->pending_discovery.Clear();
 }
 
-const Service* bta_gattc_find_matching_service(const std::list<Service>& services,
-                                               uint16_t handle) {
-  for (const Service& service : services) {
-    if (handle >= service.handle && handle <= service.end_handle) {
-      return &service;
-    }
-  }
-
-  return nullptr;
-}
-
 /// Whether the peer device uses robust caching
 RobustCachingSupport GetRobustCachingSupport(const tBTA_GATTC_CLCB* p_clcb,
                                              const gatt::Database& db) {
@@ -610,36 +599,27 @@ const std::list<Service>* bta_gattc_get_services(uint16_t conn_id) {
 }
 
 const Service* bta_gattc_get_service_for_handle_srcb(tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services_srcb(p_srcb);
-  if (services == NULL) {
+  if (!p_srcb) {
     return NULL;
   }
-  return bta_gattc_find_matching_service(*services, handle);
+  return p_srcb->gatt_database.FindServiceByHandle(handle);
 }
 
 const Service* bta_gattc_get_service_for_handle(uint16_t conn_id, uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services(conn_id);
-  if (services == NULL) {
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
+
+  if (p_clcb == NULL) {
     return NULL;
   }
 
-  return bta_gattc_find_matching_service(*services, handle);
+  return bta_gattc_get_service_for_handle_srcb(p_clcb->p_srcb, handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service = bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
+  if (!p_srcb) {
     return NULL;
   }
-
-  for (const Characteristic& charac : service->characteristics) {
-    if (handle == charac.value_handle) {
-      return &charac;
-    }
-  }
-
-  return NULL;
+  return p_srcb->gatt_database.FindCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id, uint16_t handle) {
@@ -654,21 +634,10 @@ const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id, uint16_t ha
 }
 
 const Descriptor* bta_gattc_get_descriptor_srcb(tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service = bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
+  if (!p_srcb) {
     return NULL;
   }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) {
-        return &desc;
-      }
-    }
-  }
-
-  return NULL;
+  return p_srcb->gatt_database.FindDescriptor(handle);
 }
 
 const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
@@ -684,21 +653,10 @@ const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
 
 const Characteristic* bta_gattc_get_owning_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                                uint16_t handle) {
-  const Service* service = bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
+  if (!p_srcb) {
     return NULL;
   }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) {
-        return &charac;
-      }
-    }
-  }
-
-  return NULL;
+  return p_srcb->gatt_database.FindOwningCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id, uint16_t handle) {
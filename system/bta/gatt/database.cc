@@ -21,6 +21,7 @@
 #include <bluetooth/log.h>
 
 #include <algorithm>
+#include <iterator>
 #include <list>
 #include <sstream>
 
@@ -45,6 +46,10 @@ const Uuid CHARACTERISTIC_EXTENDED_PROPERTIES = Uuid::From16Bit(GATT_UUID_CHAR_E
 bool HandleInRange(const Service& svc, uint16_t handle) {
   return handle >= svc.handle && handle <= svc.end_handle;
 }
+
+uint32_t AttributeKey(uint16_t handle, IndexedAttribute::Type type) {
+  return (static_cast<uint32_t>(handle) << 8) | static_cast<uint8_t>(type);
+}
 }  // namespace
 
 static size_t UuidSize(const Uuid& uuid) {
@@ -62,6 +67,105 @@ Service* FindService(std::list<Service>& services, uint16_t handle) {
   return nullptr;
 }
 
+Database& Database::operator=(const Database& other) {
+  if (this != &other) {
+    services = other.services;
+    BuildIndex();
+  }
+  return *this;
+}
+
+void Database::BuildIndex() {
+  service_index.clear();
+  attribute_keys.clear();
+  attribute_index.clear();
+
+  size_t attribute_count = 0;
+  for (const Service& service : services) {
+    for (const Characteristic& charac : service.characteristics) {
+      attribute_count += 1 + charac.descriptors.size();
+    }
+  }
+  service_index.reserve(services.size());
+  attribute_index.reserve(attribute_count);
+
+  for (const Service& service : services) {
+    service_index.push_back(&service);
+    for (const Characteristic& charac : service.characteristics) {
+      attribute_index.push_back(IndexedAttribute{
+              .handle = charac.value_handle,
+              .type = IndexedAttribute::Type::CHARACTERISTIC_VALUE,
+              .service = &service,
+              .characteristic = &charac,
+              .descriptor = nullptr,
+      });
+      for (const Descriptor& desc : charac.descriptors) {
+        attribute_index.push_back(IndexedAttribute{
+                .handle = desc.handle,
+                .type = IndexedAttribute::Type::DESCRIPTOR,
+                .service = &service,
+                .characteristic = &charac,
+                .descriptor = &desc,
+        });
+      }
+    }
+  }
+
+  // Services are kept in handle order, attributes almost always are, so these
+  // sorts are cheap. Stable sort keeps the first match on duplicate handles
+  // the same as a linear walk of the service tree would return.
+  std::stable_sort(service_index.begin(), service_index.end(),
+                   [](const Service* a, const Service* b) { return a->handle < b->handle; });
+  std::stable_sort(attribute_index.begin(), attribute_index.end(),
+                   [](const IndexedAttribute& a, const IndexedAttribute& b) {
+                     return AttributeKey(a.handle, a.type) < AttributeKey(b.handle, b.type);
+                   });
+
+  attribute_keys.reserve(attribute_index.size());
+  for (const IndexedAttribute& attr : attribute_index) {
+    attribute_keys.push_back(AttributeKey(attr.handle, attr.type));
+  }
+}
+
+const Service* Database::FindServiceByHandle(uint16_t handle) const {
+  // First service starting after |handle|, the candidate is the one before it
+  auto it = std::upper_bound(
+          service_index.begin(), service_index.end(), handle,
+          [](uint16_t handle, const Service* service) { return handle < service->handle; });
+  if (it == service_index.begin()) {
+    return nullptr;
+  }
+
+  const Service* service = *std::prev(it);
+  return HandleInRange(*service, handle) ? service : nullptr;
+}
+
+const IndexedAttribute* Database::FindIndexedAttribute(uint16_t handle,
+                                                       IndexedAttribute::Type type) const {
+  uint32_t key = AttributeKey(handle, type);
+  auto it = std::lower_bound(attribute_keys.begin(), attribute_keys.end(), key);
+  if (it == attribute_keys.end() || *it != key) {
+    return nullptr;
+  }
+  return &attribute_index[it - attribute_keys.begin()];
+}
+
+const Characteristic* Database::FindCharacteristic(uint16_t value_handle) const {
+  const IndexedAttribute* attr =
+          FindIndexedAttribute(value_handle, IndexedAttribute::Type::CHARACTERISTIC_VALUE);
+  return attr ? attr->characteristic : nullptr;
+}
+
+const Descriptor* Database::FindDescriptor(uint16_t handle) const {
+  const IndexedAttribute* attr = FindIndexedAttribute(handle, IndexedAttribute::Type::DESCRIPTOR);
+  return attr ? attr->descriptor : nullptr;
+}
+
+const Characteristic* Database::FindOwningCharacteristic(uint16_t handle) const {
+  const IndexedAttribute* attr = FindIndexedAttribute(handle, IndexedAttribute::Type::DESCRIPTOR);
+  return attr ? attr->characteristic : nullptr;
+}
+
 std::string Database::ToString() const {
   std::stringstream tmp;
 
@@ -211,6 +315,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr, bool
       }
     }
   }
+  result.BuildIndex();
   *success = true;
   return result;
 }
@@ -101,18 +101,56 @@ struct Descriptor {
 
 class DatabaseBuilder;
 
+/* Entry of the flat, handle sorted attribute index kept next to the service
+ * tree. Pointers reference elements of the owning Database. */
+struct IndexedAttribute {
+  enum class Type : uint8_t {
+    CHARACTERISTIC_VALUE,
+    DESCRIPTOR,
+  };
+
+  uint16_t handle;
+  Type type;
+  const Service* service;
+  const Characteristic* characteristic; /* owning characteristic */
+  const Descriptor* descriptor;         /* nullptr for characteristic values */
+};
+
 class Database {
 public:
+  Database() = default;
+  Database(const Database& other) : services(other.services) { BuildIndex(); }
+  Database(Database&& other) = default;
+  Database& operator=(const Database& other);
+  Database& operator=(Database&& other) = default;
+
   /* Return true if there are no services in this database. */
   bool IsEmpty() const { return services.empty(); }
 
   /* Clear the GATT database. This method forces relocation to ensure no extra
    * space is used unnecesarly */
-  void Clear() { std::list<Service>().swap(services); }
+  void Clear() {
+    std::list<Service>().swap(services);
+    std::vector<const Service*>().swap(service_index);
+    std::vector<uint32_t>().swap(attribute_keys);
+    std::vector<IndexedAttribute>().swap(attribute_index);
+  }
 
   /* Return list of services available in this database */
   const std::list<Service>& Services() const { return services; }
 
+  /* Return service containing |handle|, or nullptr if there is none. */
+  const Service* FindServiceByHandle(uint16_t handle) const;
+
+  /* Return characteristic whose value handle is |handle|, or nullptr. */
+  const Characteristic* FindCharacteristic(uint16_t value_handle) const;
+
+  /* Return descriptor with |handle|, or nullptr. */
+  const Descriptor* FindDescriptor(uint16_t handle) const;
+
+  /* Return characteristic owning descriptor with |handle|, or nullptr. */
+  const Characteristic* FindOwningCharacteristic(uint16_t handle) const;
+
   std::string ToString() const;
 
   std::vector<gatt::StoredAttribute> Serialize() const;
@@ -125,7 +163,21 @@ public:
   friend class DatabaseBuilder;
 
 private:
+  /* Rebuild |service_index| and |attribute_index| from |services|. Must be
+   * called whenever |services| is modified, lookups above rely on it. */
+  void BuildIndex();
+
+  const IndexedAttribute* FindIndexedAttribute(uint16_t handle, IndexedAttribute::Type type) const;
+
   std::list<Service> services;
+
+  /* Services sorted by start handle */
+  std::vector<const Service*> service_index;
+
+  /* Characteristic values and descriptors sorted by (handle, type), and their
+   * packed keys kept apart so that the binary search touches few cache lines */
+  std::vector<uint32_t> attribute_keys;
+  std::vector<IndexedAttribute> attribute_index;
 };
 
 /* Find a service that should contain handle. Helper method for internal use
@@ -24,9 +24,11 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <mutex>
+#include <span>
 #include <vector>
 
 #include "audio/asrc/asrc_resampler.h"
@@ -230,6 +232,8 @@ static void write_rpt_ctl_cfg_cb(uint16_t conn_id, tGATT_STATUS status, uint16_t
 
 g722_encode_state_t* encoder_state_left = nullptr;
 g722_encode_state_t* encoder_state_right = nullptr;
+// Encodes both sides in one pass, when both hearing aids are streaming.
+g722_encode_stereo_state_t* encoder_state_stereo = nullptr;
 
 inline void encoder_state_init() {
   if (encoder_state_left != nullptr) {
@@ -238,6 +242,7 @@ inline void encoder_state_init() {
   }
   encoder_state_left = g722_encode_init(nullptr, 64000, G722_PACKED);
   encoder_state_right = g722_encode_init(nullptr, 64000, G722_PACKED);
+  encoder_state_stereo = g722_encode_stereo_init(nullptr, 64000, G722_PACKED);
 }
 
 inline void encoder_state_release() {
@@ -246,6 +251,8 @@ inline void encoder_state_release() {
     encoder_state_left = nullptr;
     g722_encode_release(encoder_state_right);
     encoder_state_right = nullptr;
+    g722_encode_stereo_release(encoder_state_stereo);
+    encoder_state_stereo = nullptr;
   }
 }
 
@@ -1347,8 +1354,12 @@ public:
       return OnAudioDataReady(data);
     }
 
-    for (auto const resampled_data : asrc->Run(data)) {
-      OnAudioDataReady(*resampled_data);
+    std::array<const std::vector<uint8_t>*,
+               bluetooth::audio::asrc::SourceAudioHalAsrc::kMaxOutputBuffers>
+            resampled_data;
+    size_t num_resampled = asrc->Run(data, resampled_data);
+    for (auto const buffer : std::span(resampled_data).first(num_resampled)) {
+      OnAudioDataReady(*buffer);
     }
   }
 
@@ -1426,23 +1437,37 @@ public:
       l2cap_flush_threshold = 8;
     }
 
-    // TODO: monural, binarual check
-
     // divide encoded data into packets, add header, send.
 
     // TODO: make those buffers static and global to prevent constant
     // reallocations
-    // TODO: this should basically fit the encoded data, tune the size later
+    // G.722 packs two samples in each byte. Only the sides that are streaming
+    // are encoded, both in one pass when binaural.
     std::vector<uint8_t> encoded_data_left;
-    auto time_point = std::chrono::steady_clock::now();
-    if (left) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_left.resize(4000);
+    std::vector<uint8_t> encoded_data_right;
+    if (left && right) {
+      encoded_data_left.resize(chan_left.size() / 2);
+      encoded_data_right.resize(chan_right.size() / 2);
+      int encoded_size = g722_encode_stereo(
+              encoder_state_stereo, encoded_data_left.data(), encoded_data_right.data(),
+              (const int16_t*)chan_left.data(), (const int16_t*)chan_right.data(),
+              chan_left.size());
+      encoded_data_left.resize(encoded_size);
+      encoded_data_right.resize(encoded_size);
+    } else if (left) {
+      encoded_data_left.resize(chan_left.size() / 2);
       int encoded_size = g722_encode(encoder_state_left, encoded_data_left.data(),
                                      (const int16_t*)chan_left.data(), chan_left.size());
       encoded_data_left.resize(encoded_size);
+    } else if (right) {
+      encoded_data_right.resize(chan_right.size() / 2);
+      int encoded_size = g722_encode(encoder_state_right, encoded_data_right.data(),
+                                     (const int16_t*)chan_right.data(), chan_right.size());
+      encoded_data_right.resize(encoded_size);
+    }
 
+    auto time_point = std::chrono::steady_clock::now();
+    if (left) {
       uint16_t cid = GAP_ConnGetL2CAPCid(left->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
       if (packets_in_chans > l2cap_flush_threshold) {
@@ -1467,15 +1492,7 @@ public:
       check_and_do_rssi_read(left);
     }
 
-    std::vector<uint8_t> encoded_data_right;
     if (right) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_right.resize(4000);
-      int encoded_size = g722_encode(encoder_state_right, encoded_data_right.data(),
-                                     (const int16_t*)chan_right.data(), chan_right.size());
-      encoded_data_right.resize(encoded_size);
-
       uint16_t cid = GAP_ConnGetL2CAPCid(right->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
       if (packets_in_chans > l2cap_flush_threshold) {
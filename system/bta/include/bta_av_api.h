@@ -364,6 +364,11 @@ typedef struct {
   RawAddress bd_addr;
 } tBTA_AVK_CONFIG;
 
+/* For BTA_AV_SINK_MEDIA_DATA_EVT, the RTP timestamp of the media packet is stored in host byte
+ * order in the BTA_AV_SINK_MEDIA_TIMESTAMP_LEN bytes preceding the payload, over the parsed media
+ * header. The RTP sequence number is in layer_specific. */
+#define BTA_AV_SINK_MEDIA_TIMESTAMP_LEN sizeof(uint32_t)
+
 /* union of data associated with AV Media callback */
 typedef union {
   BT_HDR* p_data;
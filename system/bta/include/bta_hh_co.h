@@ -50,6 +50,7 @@ typedef enum : uint8_t {
 
 typedef struct {
   tBTA_HH_UHID_INBOUND_EVT_TYPE type;
+  uint64_t rx_time_us;  // when an input report was received, for BTA_HH_UHID_INBOUND_INPUT_EVT
   union {
     uhid_event uhid;
   };
@@ -613,6 +613,21 @@ tBTA_JV_STATUS BTA_JvL2capStopServer(uint16_t local_psm, uint32_t l2cap_socket_i
  ******************************************************************************/
 tBTA_JV_STATUS BTA_JvL2capRead(uint32_t handle, uint32_t req_id, uint8_t* p_data, uint16_t len);
 
+/*******************************************************************************
+ *
+ * Function         BTA_JvL2capReadBuf
+ *
+ * Description      This function dequeues the next SDU received on an L2CAP
+ *                  connection without copying it. The caller takes ownership
+ *                  of *pp_buf and must osi_free it. No BTA_JV_L2CAP_READ_EVT
+ *                  is sent.
+ *
+ * Returns          BTA_JV_SUCCESS, if an SDU is in *pp_buf.
+ *                  BTA_JV_FAILURE, otherwise.
+ *
+ ******************************************************************************/
+tBTA_JV_STATUS BTA_JvL2capReadBuf(uint32_t handle, BT_HDR** pp_buf);
+
 /*******************************************************************************
  *
  * Function         BTA_JvL2capReady
@@ -327,6 +327,32 @@ tBTA_JV_STATUS BTA_JvL2capRead(uint32_t handle, uint32_t req_id, uint8_t* p_data
   return tBTA_JV_STATUS::SUCCESS;
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_JvL2capReadBuf
+ *
+ * Description      This function dequeues the next SDU received on an L2CAP
+ *                  connection without copying it. The caller takes ownership
+ *                  of *pp_buf.
+ *
+ * Returns          tBTA_JV_STATUS::SUCCESS, if an SDU is in *pp_buf.
+ *                  tBTA_JV_STATUS::FAILURE, otherwise.
+ *
+ ******************************************************************************/
+tBTA_JV_STATUS BTA_JvL2capReadBuf(uint32_t handle, BT_HDR** pp_buf) {
+  log::verbose("handle:{}", handle);
+
+  *pp_buf = nullptr;
+  if (handle >= BTA_JV_MAX_L2C_CONN || !bta_jv_cb.l2c_cb[handle].p_cback) {
+    return tBTA_JV_STATUS::FAILURE;
+  }
+
+  if (BT_PASS != GAP_ConnReadBuf((uint16_t)handle, pp_buf)) {
+    return tBTA_JV_STATUS::FAILURE;
+  }
+  return tBTA_JV_STATUS::SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         BTA_JvL2capReady
@@ -21,7 +21,9 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <array>
 #include <optional>
+#include <span>
 
 #include "audio/asrc/asrc_resampler.h"
 #include "audio_hal_client.h"
@@ -214,10 +216,13 @@ void SourceImpl::SendAudioData() {
   }
 
   if (com::android::bluetooth::flags::leaudio_hal_client_asrc()) {
-    auto asrc_buffers = asrc_->Run(data);
+    std::array<const std::vector<uint8_t>*,
+               bluetooth::audio::asrc::SourceAudioHalAsrc::kMaxOutputBuffers>
+            asrc_buffers;
+    size_t num_asrc_buffers = asrc_->Run(data, asrc_buffers);
 
     std::lock_guard<std::mutex> guard(audioSourceCallbacksMutex_);
-    for (auto buffer : asrc_buffers) {
+    for (auto buffer : std::span(asrc_buffers).first(num_asrc_buffers)) {
       if (audioSourceCallbacks_ != nullptr) {
         audioSourceCallbacks_->OnAudioDataReady(*buffer);
       }
@@ -20,8 +20,11 @@
 
 #include "bta/av/bta_av_int.h"
 #include "bta/hf_client/bta_hf_client_int.h"
+#include "osi/include/allocator.h"
 #include "test/common/mock_functions.h"
 #include "test/mock/mock_osi_alarm.h"
+#include "test/mock/mock_osi_allocator.h"
+#include "test/mock/mock_osi_list.h"
 #include "test/mock/mock_stack_acl.h"
 
 using namespace std::chrono_literals;
@@ -67,3 +70,132 @@ TEST_F(BtaAvTest, bta_av_rc_opened) {
   };
   bta_av_rc_opened(&cb, &data);
 }
+
+class BtaAvMediaPktTest : public BtaAvTest {
+protected:
+  void SetUp() override {
+    BtaAvTest::SetUp();
+    test::mock::osi_allocator::osi_malloc.body = [](size_t size) { return malloc(size); };
+    test::mock::osi_allocator::osi_free.body = [](void* ptr) { free(ptr); };
+  }
+
+  void TearDown() override {
+    bta_av_cb = {};
+    test::mock::osi_allocator::osi_malloc = {};
+    test::mock::osi_allocator::osi_free = {};
+    test::mock::osi_list::list_is_empty = {};
+    BtaAvTest::TearDown();
+  }
+
+  BT_HDR* NewMediaBuf(uint8_t value) {
+    BT_HDR* p_buf = static_cast<BT_HDR*>(osi_malloc(BT_HDR_SIZE + kOffset + kLen));
+    p_buf->offset = kOffset;
+    p_buf->len = kLen;
+    p_buf->layer_specific = 0;
+    memset(p_buf->data + kOffset, value, kLen);
+    return p_buf;
+  }
+
+  static constexpr uint16_t kOffset = 16;
+  static constexpr uint16_t kLen = 32;
+  tBTA_AV_SCB scb_[2]{};
+};
+
+TEST_F(BtaAvMediaPktTest, take_copies_while_shared) {
+  BT_HDR* p_buf = NewMediaBuf(0x5a);
+  tBTA_AV_MEDIA_PKT* p_pkt = bta_av_media_pkt_new(p_buf, 0x1234);
+  ASSERT_EQ(0x1234u, p_pkt->timestamp);
+  p_pkt->ref_count++;  // Queued for the second channel
+
+  BT_HDR* p_first = bta_av_media_pkt_take(&scb_[0], p_pkt);
+  ASSERT_NE(p_buf, p_first);
+  ASSERT_EQ(kOffset, p_first->offset);
+  ASSERT_EQ(kLen, p_first->len);
+  ASSERT_EQ(0, memcmp(p_buf->data + kOffset, p_first->data + kOffset, kLen));
+  ASSERT_EQ(1u, scb_[0].media_stats.copied);
+
+  // The last channel gets the buffer of the packet
+  BT_HDR* p_last = bta_av_media_pkt_take(&scb_[1], p_pkt);
+  ASSERT_EQ(p_buf, p_last);
+  ASSERT_EQ(0u, scb_[1].media_stats.copied);
+
+  osi_free(p_first);
+  osi_free(p_last);
+}
+
+TEST_F(BtaAvMediaPktTest, release_frees_on_last_reference) {
+  int freed = 0;
+  test::mock::osi_allocator::osi_free.body = [&freed](void* ptr) {
+    freed++;
+    free(ptr);
+  };
+  tBTA_AV_MEDIA_PKT* p_pkt = bta_av_media_pkt_new(NewMediaBuf(0x5a), 0);
+  p_pkt->ref_count++;
+
+  bta_av_media_pkt_release(p_pkt);
+  ASSERT_EQ(0, freed);
+  bta_av_media_pkt_release(p_pkt);
+  ASSERT_EQ(2, freed);
+}
+
+TEST_F(BtaAvMediaPktTest, dup_audio_buf_skips_other_codec_configuration) {
+  for (uint8_t i = 0; i < 2; i++) {
+    scb_[i].hdi = i;
+    scb_[i].co_started = true;
+    bta_av_cb.p_scb[i] = &scb_[i];
+    bta_av_cb.conn_audio |= BTA_AV_HNDL_TO_MSK(i);
+  }
+  bta_av_cb.audio_open_cnt = 2;
+
+  tBTA_AV_MEDIA_PKT* p_pkt = bta_av_media_pkt_new(NewMediaBuf(0x5a), 0);
+  bta_av_dup_audio_buf(&scb_[0], p_pkt);
+
+  ASSERT_EQ(1, get_func_call_count("A2DP_CodecEquals"));
+  ASSERT_EQ(1u, scb_[1].media_stats.codec_mismatch);
+  ASSERT_EQ(0u, scb_[1].media_stats.fanned_in);
+  ASSERT_EQ(1, p_pkt->ref_count);
+  ASSERT_EQ(0u, bta_av_cb.shared_pkts);
+
+  osi_free(bta_av_media_pkt_take(&scb_[0], p_pkt));
+}
+
+namespace {
+int data_path_reads = 0;
+
+BT_HDR* CountingDataPath(const uint8_t* /* p_codec_info */, uint32_t* /* p_timestamp */) {
+  data_path_reads++;
+  return nullptr;
+}
+}  // namespace
+
+TEST_F(BtaAvMediaPktTest, data_path_skips_encoder_of_other_codec_configuration) {
+  tBTA_AV_CO_FUNCTS cos{};
+  cos.data = CountingDataPath;
+  data_path_reads = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    scb_[i].hdi = i;
+    scb_[i].started = true;
+    scb_[i].co_started = true;
+    scb_[i].p_cos = &cos;
+    bta_av_cb.p_scb[i] = &scb_[i];
+    bta_av_cb.conn_audio |= BTA_AV_HNDL_TO_MSK(i);
+  }
+  bta_av_cb.audio_open_cnt = 2;
+  test::mock::osi_list::list_is_empty.body = [](const list_t* /* list */) { return true; };
+
+  // The first channel reads the encoder output, the second one can't share it
+  tBTA_AV_MEDIA_PKT* p_pkt = bta_av_media_pkt_new(NewMediaBuf(0x5a), 0);
+  bta_av_dup_audio_buf(&scb_[0], p_pkt);
+  ASSERT_TRUE(scb_[1].media_codec_mismatch);
+
+  bta_av_data_path(&scb_[1], nullptr);
+  ASSERT_EQ(0, data_path_reads);
+
+  // Once the first channel stops, the second one reads the encoder output
+  scb_[0].co_started = false;
+  bta_av_data_path(&scb_[1], nullptr);
+  ASSERT_EQ(1, data_path_reads);
+  ASSERT_FALSE(scb_[1].media_codec_mismatch);
+
+  osi_free(bta_av_media_pkt_take(&scb_[0], p_pkt));
+}
@@ -62,6 +62,7 @@ public:
                                base::RepeatingCallback<tSDP_DISC_CMPL_CB> /* complete_callback */) {
                               return true;
                             },
+                    .SDP_InvalidateCache = nullptr,
             },
             .db =
                     {
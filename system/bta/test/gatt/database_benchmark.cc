@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gatt/database.h"
+#include "gatt/database_builder.h"
+#include "types/bluetooth/uuid.h"
+
+using ::benchmark::State;
+using bluetooth::Uuid;
+
+namespace gatt {
+
+namespace {
+
+/* 100 characteristics, each with a CCC and a user description descriptor:
+ * 300 characteristic values and descriptors, split over |num_services|. */
+constexpr uint16_t kNumCharacteristics = 100;
+constexpr uint16_t kHandlesPerCharacteristic = 4;
+
+Database BuildDatabase(uint16_t num_services, std::vector<uint16_t>* value_handles) {
+  uint16_t chars_per_service = kNumCharacteristics / num_services;
+  uint16_t handles_per_service = 1 + chars_per_service * kHandlesPerCharacteristic;
+
+  DatabaseBuilder builder;
+  for (uint16_t s = 0; s < num_services; s++) {
+    uint16_t start = 1 + s * handles_per_service;
+    builder.AddService(start, start + handles_per_service - 1, Uuid::From16Bit(0x1800 + s), true);
+  }
+
+  for (uint16_t s = 0; s < num_services; s++) {
+    uint16_t start = 1 + s * handles_per_service;
+    for (uint16_t c = 0; c < chars_per_service; c++) {
+      uint16_t decl = start + 1 + c * kHandlesPerCharacteristic;
+      builder.AddCharacteristic(decl, decl + 1, Uuid::From16Bit(0x2a00 + c), 0x12);
+      builder.AddDescriptor(decl + 2, Uuid::From16Bit(0x2902));
+      builder.AddDescriptor(decl + 3, Uuid::From16Bit(0x2901));
+      value_handles->push_back(decl + 1);
+    }
+  }
+
+  // Notifications don't arrive in handle order
+  std::shuffle(value_handles->begin(), value_handles->end(), std::mt19937(0));
+  return builder.Build();
+}
+
+/* Lookup the way bta_gattc_get_characteristic_srcb() used to do it: find the
+ * service, then walk its characteristics. */
+const Characteristic* LinearFindCharacteristic(const Database& db, uint16_t handle) {
+  for (const Service& service : db.Services()) {
+    if (handle < service.handle || handle > service.end_handle) {
+      continue;
+    }
+    for (const Characteristic& charac : service.characteristics) {
+      if (handle == charac.value_handle) {
+        return &charac;
+      }
+    }
+    return nullptr;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+class BM_GattDatabaseLookup : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    value_handles_.clear();
+    database_ = BuildDatabase(st.range(0), &value_handles_);
+  }
+
+  Database database_;
+  std::vector<uint16_t> value_handles_;
+};
+
+/* Dispatch one notification to every characteristic of the database */
+BENCHMARK_DEFINE_F(BM_GattDatabaseLookup, dispatch_notifications_linear)(State& state) {
+  for (auto _ : state) {
+    for (uint16_t handle : value_handles_) {
+      ::benchmark::DoNotOptimize(LinearFindCharacteristic(database_, handle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * value_handles_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_GattDatabaseLookup, dispatch_notifications_linear)->Arg(2)->Arg(20);
+
+BENCHMARK_DEFINE_F(BM_GattDatabaseLookup, dispatch_notifications_indexed)(State& state) {
+  for (auto _ : state) {
+    for (uint16_t handle : value_handles_) {
+      ::benchmark::DoNotOptimize(database_.FindCharacteristic(handle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * value_handles_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_GattDatabaseLookup, dispatch_notifications_indexed)->Arg(2)->Arg(20);
+
+/* Write response on a CCC descriptor resolves its owning characteristic */
+BENCHMARK_DEFINE_F(BM_GattDatabaseLookup, owning_characteristic_indexed)(State& state) {
+  for (auto _ : state) {
+    for (uint16_t handle : value_handles_) {
+      ::benchmark::DoNotOptimize(database_.FindOwningCharacteristic(handle + 1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * value_handles_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_GattDatabaseLookup, owning_characteristic_indexed)->Arg(2)->Arg(20);
+
+}  // namespace gatt
@@ -540,4 +540,53 @@ TEST(GattDatabaseTest, serialized_hash_test) {
   EXPECT_EQ(db_from_disk.Hash(), db_from_serialized.Hash());
 }
 
+/* This test makes sure that handle lookups served from the flat attribute
+ * index match the service tree, and survive copies and deserialization. */
+TEST(GattDatabaseTest, handle_index_lookup_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x12);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x10);
+  builder.AddDescriptor(0x0013, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0014, CHARACTERISTIC_EXTENDED_PROPERTIES);
+  builder.SetValueOfDescriptors({0x0001});
+
+  Database built = builder.Build();
+  bool is_successful = false;
+  Database deserialized = Database::Deserialize(built.Serialize(), &is_successful);
+  ASSERT_TRUE(is_successful);
+
+  for (const Database& db : {built, deserialized}) {
+    const Service& service_1 = db.Services().front();
+    const Service& service_2 = db.Services().back();
+
+    EXPECT_EQ(db.FindServiceByHandle(0x0001), &service_1);
+    EXPECT_EQ(db.FindServiceByHandle(0x000f), &service_1);
+    EXPECT_EQ(db.FindServiceByHandle(0x0014), &service_2);
+    EXPECT_EQ(db.FindServiceByHandle(0x0020), nullptr);
+
+    EXPECT_EQ(db.FindCharacteristic(0x0004), &service_1.characteristics[0]);
+    EXPECT_EQ(db.FindCharacteristic(0x0012), &service_2.characteristics[0]);
+    EXPECT_EQ(db.FindCharacteristic(0x0003), nullptr);
+    EXPECT_EQ(db.FindCharacteristic(0x0005), nullptr);
+
+    EXPECT_EQ(db.FindDescriptor(0x0005), &service_1.characteristics[0].descriptors[0]);
+    EXPECT_EQ(db.FindDescriptor(0x0014), &service_2.characteristics[0].descriptors[1]);
+    EXPECT_EQ(db.FindDescriptor(0x0014)->characteristic_extended_properties, 0x0001);
+    EXPECT_EQ(db.FindDescriptor(0x0004), nullptr);
+
+    EXPECT_EQ(db.FindOwningCharacteristic(0x0005), &service_1.characteristics[0]);
+    EXPECT_EQ(db.FindOwningCharacteristic(0x0013), &service_2.characteristics[0]);
+    EXPECT_EQ(db.FindOwningCharacteristic(0x0012), nullptr);
+  }
+
+  Database copy;
+  copy = built;
+  built.Clear();
+  EXPECT_EQ(built.FindCharacteristic(0x0004), nullptr);
+  EXPECT_EQ(copy.FindCharacteristic(0x0004), &copy.Services().front().characteristics[0]);
+}
+
 }  // namespace gatt
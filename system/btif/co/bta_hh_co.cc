@@ -18,6 +18,8 @@
 
 #include "bta_hh_co.h"
 
+#include <base/functional/bind.h>
+#include <base/strings/stringprintf.h>
 #include <com_android_bluetooth_flags.h>
 #include <fcntl.h>
 #include <linux/uhid.h>
@@ -26,14 +28,26 @@
 #include <stdint.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "bta_hh_api.h"
 #include "btif_hh.h"
+#include "common/time_util.h"
 #include "hci/controller_interface.h"
+#include "main/shim/dumpsys.h"
 #include "main/shim/entry.h"
+#include "os/thread.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/osi.h"
@@ -55,6 +69,15 @@ static tBTA_HH_RPT_CACHE_ENTRY sReportCache[BTA_HH_NV_LOAD_MAX];
 #define BTA_HH_UHID_POLL_PERIOD2_MS -1
 /* Max number of polling interrupt allowed */
 #define BTA_HH_UHID_INTERRUPT_COUNT_MAX 100
+/* With the aflags hid_report_queuing, serve all the devices from one real-time
+ * uhid thread instead of one thread per device */
+#define BTA_HH_SHARED_UHID_THREAD_PROPERTY "persist.bluetooth.hid.shared_uhid_thread"
+/* Max number of internal events read at once by the shared uhid thread */
+#define BTA_HH_UHID_INBOUND_BATCH_MAX 16
+/* Max time given to the shared uhid thread to close the devices before it is
+ * stopped */
+#define BTA_HH_UHID_SHARED_THREAD_IDLE_TIMEOUT_MS 500
+#define DUMPSYS_TAG "shim::legacy::hid"
 
 using namespace bluetooth;
 
@@ -66,6 +89,64 @@ static const bthh_report_type_t map_rtype_uhid_hh[] = {BTHH_FEATURE_REPORT, BTHH
 static void* btif_hh_poll_event_thread(void* arg);
 static bool to_uhid_thread(int fd, const tBTA_HH_TO_UHID_EVT* ev);
 
+// Upper bounds of the buckets of the input report latency histograms
+static constexpr std::array<uint64_t, 6> kUhidInputLatencyBucketsUs = {500,  1000,  2000,
+                                                                       5000, 10000, 20000};
+
+// Latency of the input reports of a device, from bta_hh_co_write() to the
+// write to uhid.
+struct UhidInputLatency {
+  tAclLinkSpec link_spec;
+  uint64_t reports = 0;
+  uint64_t total_us = 0;
+  uint64_t max_us = 0;
+  std::array<uint64_t, kUhidInputLatencyBucketsUs.size() + 1> histogram = {};
+};
+
+static std::mutex uhid_input_latency_mutex;
+static std::unordered_map<const btif_hh_uhid_t*, UhidInputLatency> uhid_input_latency;
+
+// A device served by the shared uhid thread.
+struct UhidReactables {
+  btif_hh_uhid_t* p_uhid;
+  bluetooth::os::Reactor* reactor;
+  bluetooth::os::Reactor::Reactable* uhid;
+  bluetooth::os::Reactor::Reactable* inbound;
+};
+
+static std::mutex uhid_shared_thread_mutex;
+// Started with the first device, and stopped when the last one is closed.
+static bluetooth::os::Thread* uhid_shared_thread = nullptr;
+// Devices opened and not closed yet by bta_hh_co_close().
+static size_t uhid_shared_thread_users = 0;
+// Devices served by the shared uhid thread.
+static std::unordered_set<UhidReactables*> uhid_shared_thread_devices;
+
+static bool uhid_shared_thread_enabled() {
+  static const bool enabled = osi_property_get_bool(BTA_HH_SHARED_UHID_THREAD_PROPERTY, false);
+  return enabled;
+}
+
+static void uhid_record_input_latency(const btif_hh_uhid_t* p_uhid, uint64_t rx_time_us) {
+  uint64_t latency_us = bluetooth::common::time_get_os_boottime_us() - rx_time_us;
+  size_t bucket = 0;
+  while (bucket < kUhidInputLatencyBucketsUs.size() &&
+         latency_us > kUhidInputLatencyBucketsUs[bucket]) {
+    bucket++;
+  }
+
+  std::lock_guard<std::mutex> lock(uhid_input_latency_mutex);
+  auto it = uhid_input_latency.find(p_uhid);
+  if (it == uhid_input_latency.end()) {
+    return;
+  }
+  UhidInputLatency& latency = it->second;
+  latency.reports++;
+  latency.total_us += latency_us;
+  latency.max_us = std::max(latency.max_us, latency_us);
+  latency.histogram[bucket]++;
+}
+
 void uhid_set_non_blocking(int fd) {
   int opts = fcntl(fd, F_GETFL);
   if (opts < 0) {
@@ -324,29 +405,16 @@ static int uhid_read_outbound_event(btif_hh_uhid_t* p_uhid) {
   return 0;
 }
 
-// Parse the internal events received from BTIF and translate to UHID
+// Translate an internal event received from BTIF to UHID
 // returns -errno when error, 0 when successful, 1 when receiving close event.
-static int uhid_read_inbound_event(btif_hh_uhid_t* p_uhid) {
-  log::assert_that(p_uhid != nullptr, "assert failed: p_uhid != nullptr");
-
-  tBTA_HH_TO_UHID_EVT ev = {};
-  ssize_t ret;
-  OSI_NO_INTR(ret = read(p_uhid->internal_recv_fd, &ev, sizeof(ev)));
-
-  if (ret == 0) {
-    log::error("Read HUP on internal uhid-cdev {}", strerror(errno));
-    return -EFAULT;
-  } else if (ret < 0) {
-    log::error("Cannot read internal uhid-cdev: {}", strerror(errno));
-    return -errno;
-  }
-
+static int uhid_handle_inbound_event(btif_hh_uhid_t* p_uhid, tBTA_HH_TO_UHID_EVT& ev) {
   int res = 0;
   uint32_t* context;
   switch (ev.type) {
     case BTA_HH_UHID_INBOUND_INPUT_EVT:
       if (p_uhid->ready_for_data) {
         res = uhid_write(p_uhid->fd, &ev.uhid);
+        uhid_record_input_latency(p_uhid, ev.rx_time_us);
       } else {
         uhid_queue_input(p_uhid, &ev.uhid);
       }
@@ -390,6 +458,72 @@ static int uhid_read_inbound_event(btif_hh_uhid_t* p_uhid) {
   return res;
 }
 
+// Parse the internal events received from BTIF and translate to UHID
+// returns -errno when error, 0 when successful, 1 when receiving close event.
+static int uhid_read_inbound_event(btif_hh_uhid_t* p_uhid) {
+  log::assert_that(p_uhid != nullptr, "assert failed: p_uhid != nullptr");
+
+  tBTA_HH_TO_UHID_EVT ev = {};
+  ssize_t ret;
+  OSI_NO_INTR(ret = read(p_uhid->internal_recv_fd, &ev, sizeof(ev)));
+
+  if (ret == 0) {
+    log::error("Read HUP on internal uhid-cdev {}", strerror(errno));
+    return -EFAULT;
+  } else if (ret < 0) {
+    log::error("Cannot read internal uhid-cdev: {}", strerror(errno));
+    return -errno;
+  }
+
+  return uhid_handle_inbound_event(p_uhid, ev);
+}
+
+// Parse all the pending internal events received from BTIF, reading up to
+// BTA_HH_UHID_INBOUND_BATCH_MAX of them per system call. Only used on the
+// shared uhid thread.
+// returns -errno when error, 0 when successful, 1 when receiving close event.
+static int uhid_read_inbound_events(btif_hh_uhid_t* p_uhid) {
+  static std::array<tBTA_HH_TO_UHID_EVT, BTA_HH_UHID_INBOUND_BATCH_MAX> events;
+  static std::array<struct iovec, BTA_HH_UHID_INBOUND_BATCH_MAX> iovecs;
+  static std::array<struct mmsghdr, BTA_HH_UHID_INBOUND_BATCH_MAX> msgs;
+
+  while (true) {
+    for (size_t i = 0; i < msgs.size(); i++) {
+      iovecs[i] = {.iov_base = &events[i], .iov_len = sizeof(events[i])};
+      msgs[i] = {};
+      msgs[i].msg_hdr.msg_iov = &iovecs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count;
+    OSI_NO_INTR(count = recvmmsg(p_uhid->internal_recv_fd, msgs.data(), msgs.size(), MSG_DONTWAIT,
+                                 nullptr));
+    if (count < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+      }
+      log::error("Cannot read internal uhid-cdev: {}", strerror(errno));
+      return -errno;
+    }
+
+    for (int i = 0; i < count; i++) {
+      // Each read past the hangup returns an empty message
+      if (msgs[i].msg_len == 0) {
+        log::error("inbound fd hangup, disconnect UHID");
+        return -EFAULT;
+      }
+      int res = uhid_handle_inbound_event(p_uhid, events[i]);
+      if (res != 0) {
+        return res;
+      }
+    }
+
+    if (count < static_cast<int>(msgs.size())) {
+      return 0;
+    }
+  }
+}
+
 /*******************************************************************************
  *
  * Function create_thread
@@ -444,10 +578,142 @@ static void uhid_fd_close(btif_hh_uhid_t* p_uhid) {
     p_uhid->input_queue = nullptr;
 
     alarm_free(p_uhid->ready_timer);
+    {
+      std::lock_guard<std::mutex> lock(uhid_input_latency_mutex);
+      uhid_input_latency.erase(p_uhid);
+    }
     osi_free(p_uhid);
   }
 }
 
+/* Internal function to open the UHID driver of a device with the aflags
+ * hid_report_queuing. Runs before the device is served by its uhid thread. */
+static bool uhid_fd_setup(btif_hh_uhid_t* p_uhid) {
+  p_uhid->fd = open(dev_path, O_RDWR | O_CLOEXEC);
+  if (p_uhid->fd < 0) {
+    log::error("Failed to open uhid, err:{}", strerror(errno));
+    close(p_uhid->internal_recv_fd);
+    p_uhid->internal_recv_fd = -1;
+    return false;
+  }
+  p_uhid->ready_for_data = false;
+  p_uhid->ready_timer = alarm_new("uhid_ready_timer");
+
+  p_uhid->get_rpt_id_queue = fixed_queue_new(SIZE_MAX);
+  log::assert_that(p_uhid->get_rpt_id_queue, "assert failed: p_uhid->get_rpt_id_queue");
+#if ENABLE_UHID_SET_REPORT
+  p_uhid->set_rpt_id_queue = fixed_queue_new(SIZE_MAX);
+  log::assert_that(p_uhid->set_rpt_id_queue, "assert failed: p_uhid->set_rpt_id_queue");
+#endif  // ENABLE_UHID_SET_REPORT
+  p_uhid->input_queue = fixed_queue_new(SIZE_MAX);
+  log::assert_that(p_uhid->input_queue, "assert failed: p_uhid->input_queue");
+
+  std::lock_guard<std::mutex> lock(uhid_input_latency_mutex);
+  uhid_input_latency[p_uhid].link_spec = p_uhid->link_spec;
+  return true;
+}
+
+// Stops serving a device from the shared uhid thread, and closes it.
+// Runs on the shared uhid thread, or after it is stopped.
+static void uhid_shared_thread_detach(UhidReactables* p_reactables) {
+  {
+    std::lock_guard<std::mutex> lock(uhid_shared_thread_mutex);
+    uhid_shared_thread_devices.erase(p_reactables);
+  }
+  p_reactables->reactor->Unregister(p_reactables->uhid);
+  p_reactables->reactor->Unregister(p_reactables->inbound);
+  log::info("Polling stopped for device {}", p_reactables->p_uhid->link_spec);
+  uhid_fd_close(p_reactables->p_uhid);
+  delete p_reactables;
+}
+
+static void uhid_shared_thread_on_uhid_ready(UhidReactables* p_reactables) {
+  int result = uhid_read_outbound_event(p_reactables->p_uhid);
+  if (result != 0) {
+    log::error("Unhandled UHID outbound event, error: {}", result);
+    uhid_shared_thread_detach(p_reactables);
+  }
+}
+
+static void uhid_shared_thread_on_inbound_ready(UhidReactables* p_reactables) {
+  int result = uhid_read_inbound_events(p_reactables->p_uhid);
+  if (result != 0) {
+    if (result < 0) {
+      log::error("Unhandled UHID inbound event, error: {}", result);
+    }
+    uhid_shared_thread_detach(p_reactables);
+  }
+}
+
+// Serves a device from the shared uhid thread, which owns the uhid struct from
+// then on. Neither fd has an event before the UHID device is created, through
+// an internal event sent after this returns.
+static bool uhid_shared_thread_attach(btif_hh_uhid_t* p_uhid) {
+  if (!uhid_fd_setup(p_uhid)) {
+    return false;
+  }
+  uhid_set_non_blocking(p_uhid->fd);
+
+  std::lock_guard<std::mutex> lock(uhid_shared_thread_mutex);
+  if (uhid_shared_thread == nullptr) {
+    uhid_shared_thread =
+            new bluetooth::os::Thread("bt_hh_uhid", bluetooth::os::Thread::Priority::REAL_TIME);
+  }
+  uhid_shared_thread_users++;
+  bluetooth::os::Reactor* reactor = uhid_shared_thread->GetReactor();
+  UhidReactables* p_reactables = new UhidReactables{.p_uhid = p_uhid, .reactor = reactor};
+  uhid_shared_thread_devices.insert(p_reactables);
+  p_reactables->uhid =
+          reactor->Register(p_uhid->fd,
+                            base::BindRepeating(uhid_shared_thread_on_uhid_ready, p_reactables),
+                            bluetooth::common::Closure());
+  p_reactables->inbound = reactor->Register(
+          p_uhid->internal_recv_fd,
+          base::BindRepeating(uhid_shared_thread_on_inbound_ready, p_reactables),
+          bluetooth::common::Closure());
+  log::debug("Host hid device served by the shared uhid thread fd:{}", p_uhid->fd);
+  return true;
+}
+
+// Called once the internal socket of a device served by the shared uhid
+// thread is closed. With the last device, waits for the thread to close the
+// devices, then stops and frees it.
+static void uhid_shared_thread_release() {
+  bluetooth::os::Thread* thread;
+  {
+    std::lock_guard<std::mutex> lock(uhid_shared_thread_mutex);
+    log::assert_that(uhid_shared_thread_users > 0, "assert failed: uhid_shared_thread_users > 0");
+    if (--uhid_shared_thread_users > 0) {
+      return;
+    }
+    thread = uhid_shared_thread;
+    uhid_shared_thread = nullptr;
+  }
+
+  bluetooth::os::Reactor* reactor = thread->GetReactor();
+  if (!reactor->WaitForIdle(
+              std::chrono::milliseconds(BTA_HH_UHID_SHARED_THREAD_IDLE_TIMEOUT_MS))) {
+    log::warn("Shared uhid thread not idle, stopping it");
+  }
+  thread->Stop();
+
+  // Close the devices the thread did not get to
+  std::vector<UhidReactables*> remaining;
+  {
+    std::lock_guard<std::mutex> lock(uhid_shared_thread_mutex);
+    for (UhidReactables* p_reactables : uhid_shared_thread_devices) {
+      if (p_reactables->reactor == reactor) {
+        remaining.push_back(p_reactables);
+      }
+    }
+  }
+  for (UhidReactables* p_reactables : remaining) {
+    uhid_shared_thread_detach(p_reactables);
+  }
+  delete thread;
+  log::info("Shared uhid thread stopped");
+}
+
 /* Internal function to open the UHID driver*/
 static bool uhid_fd_open(btif_hh_device_t* p_dev) {
   if (!com::android::bluetooth::flags::hid_report_queuing()) {
@@ -479,6 +745,17 @@ static bool uhid_fd_open(btif_hh_device_t* p_dev) {
     uhid->internal_send_fd = sockets[1];
     p_dev->internal_send_fd = sockets[1];
 
+    if (uhid_shared_thread_enabled()) {
+      p_dev->hh_poll_thread_id = -1;
+      if (!uhid_shared_thread_attach(uhid)) {
+        osi_free(uhid);
+        close(p_dev->internal_send_fd);
+        p_dev->internal_send_fd = -1;
+        return false;
+      }
+      return true;
+    }
+
     // UHID thread owns the uhid struct and is responsible to free it.
     p_dev->hh_poll_thread_id = create_thread(btif_hh_poll_event_thread, uhid);
   }
@@ -623,25 +900,8 @@ static bool uhid_configure_thread(btif_hh_uhid_t* p_uhid) {
 static void* btif_hh_poll_event_thread(void* arg) {
   btif_hh_uhid_t* p_uhid = (btif_hh_uhid_t*)arg;
 
-  if (com::android::bluetooth::flags::hid_report_queuing()) {
-    p_uhid->fd = open(dev_path, O_RDWR | O_CLOEXEC);
-    if (p_uhid->fd < 0) {
-      log::error("Failed to open uhid, err:{}", strerror(errno));
-      close(p_uhid->internal_recv_fd);
-      p_uhid->internal_recv_fd = -1;
-      return 0;
-    }
-    p_uhid->ready_for_data = false;
-    p_uhid->ready_timer = alarm_new("uhid_ready_timer");
-
-    p_uhid->get_rpt_id_queue = fixed_queue_new(SIZE_MAX);
-    log::assert_that(p_uhid->get_rpt_id_queue, "assert failed: p_uhid->get_rpt_id_queue");
-#if ENABLE_UHID_SET_REPORT
-    p_uhid->set_rpt_id_queue = fixed_queue_new(SIZE_MAX);
-    log::assert_that(p_uhid->set_rpt_id_queue, "assert failed: p_uhid->set_rpt_id_queue");
-#endif  // ENABLE_UHID_SET_REPORT
-    p_uhid->input_queue = fixed_queue_new(SIZE_MAX);
-    log::assert_that(p_uhid->input_queue, "assert failed: p_uhid->input_queue");
+  if (com::android::bluetooth::flags::hid_report_queuing() && !uhid_fd_setup(p_uhid)) {
+    return 0;
   }
 
   if (uhid_configure_thread(p_uhid)) {
@@ -696,6 +956,7 @@ int bta_hh_co_write(int fd, uint8_t* rpt, uint16_t len) {
   }
 
   to_uhid.type = BTA_HH_UHID_INBOUND_INPUT_EVT;
+  to_uhid.rx_time_us = bluetooth::common::time_get_os_boottime_us();
   return to_uhid_thread(fd, &to_uhid) ? 0 : -1;
 }
 
@@ -821,11 +1082,17 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) {
     tBTA_HH_TO_UHID_EVT to_uhid = {};
     to_uhid.type = BTA_HH_UHID_INBOUND_CLOSE_EVT;
     to_uhid_thread(p_dev->internal_send_fd, &to_uhid);
-    pthread_join(p_dev->hh_poll_thread_id, NULL);
-    p_dev->hh_poll_thread_id = -1;
+    // The shared uhid thread closes the device when handling the event
+    if (!uhid_shared_thread_enabled()) {
+      pthread_join(p_dev->hh_poll_thread_id, NULL);
+      p_dev->hh_poll_thread_id = -1;
+    }
 
     close(p_dev->internal_send_fd);
     p_dev->internal_send_fd = -1;
+    if (uhid_shared_thread_enabled()) {
+      uhid_shared_thread_release();
+    }
   }
 }
 
@@ -876,6 +1143,40 @@ void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_co_dump
+ *
+ * Description      This function is called in btif_hh.c to dump the uhid
+ *                  threading and the input report latency of the devices.
+ *
+ * Parameters       fd  - file descriptor to dump to
+ *
+ * Returns          void
+ ******************************************************************************/
+void bta_hh_co_dump(int fd) {
+  LOG_DUMPSYS(fd, "uhid thread:%s",
+              uhid_shared_thread_enabled() ? "shared by all devices" : "one per device");
+
+  std::lock_guard<std::mutex> lock(uhid_input_latency_mutex);
+  for (const auto& [p_uhid, latency] : uhid_input_latency) {
+    std::string histogram;
+    for (size_t i = 0; i < kUhidInputLatencyBucketsUs.size(); i++) {
+      histogram += base::StringPrintf(" <=%llu:%llu",
+                                      (unsigned long long)kUhidInputLatencyBucketsUs[i],
+                                      (unsigned long long)latency.histogram[i]);
+    }
+    histogram += base::StringPrintf(" >%llu:%llu",
+                                    (unsigned long long)kUhidInputLatencyBucketsUs.back(),
+                                    (unsigned long long)latency.histogram.back());
+    LOG_DUMPSYS(fd, "  addr:%s input reports:%llu latency_us avg:%llu max:%llu%s",
+                latency.link_spec.ToRedactedStringForLogging().c_str(),
+                (unsigned long long)latency.reports,
+                (unsigned long long)(latency.reports > 0 ? latency.total_us / latency.reports : 0),
+                (unsigned long long)latency.max_us, histogram.c_str());
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_co_send_hid_info
@@ -956,10 +1257,15 @@ void bta_hh_co_send_hid_info(btif_hh_device_t* p_dev, const char* dev_name, uint
     log::warn("Error: failed to send DSCP");
     if (p_dev->internal_send_fd >= 0) {
       // Detach the uhid thread. It will exit by itself upon receiving hangup.
-      pthread_detach(p_dev->hh_poll_thread_id);
-      p_dev->hh_poll_thread_id = -1;
+      if (!uhid_shared_thread_enabled()) {
+        pthread_detach(p_dev->hh_poll_thread_id);
+        p_dev->hh_poll_thread_id = -1;
+      }
       close(p_dev->internal_send_fd);
       p_dev->internal_send_fd = -1;
+      if (uhid_shared_thread_enabled()) {
+        uhid_shared_thread_release();
+      }
     }
   }
 
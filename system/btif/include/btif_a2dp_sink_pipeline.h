@@ -0,0 +1,176 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace bluetooth {
+namespace btif {
+
+/* Decoded audio of the A2DP sink, written by the worker thread and read by
+ * the output thread. */
+class A2dpSinkPcmRing {
+public:
+  /* Drops the audio and the count of dropped bytes */
+  void Reset(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.assign(capacity, 0);
+    read_ = 0;
+    size_ = 0;
+    dropped_bytes_ = 0;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_ = 0;
+    size_ = 0;
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+  /* Bytes dropped by Write() as the ring was full */
+  size_t DroppedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_bytes_;
+  }
+
+  /* Returns the number of bytes dropped because the ring is full. */
+  size_t Write(const uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = std::min(len, buffer_.size() - size_);
+    for (size_t done = 0; done < count;) {
+      size_t write = (read_ + size_) % buffer_.size();
+      size_t chunk = std::min(count - done, buffer_.size() - write);
+      memcpy(&buffer_[write], data + done, chunk);
+      size_ += chunk;
+      done += chunk;
+    }
+    dropped_bytes_ += len - count;
+    return len - count;
+  }
+
+  /* Returns the number of bytes read, less than |len| if the ring runs
+   * empty. */
+  size_t Read(uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = std::min(len, size_);
+    for (size_t done = 0; done < count;) {
+      size_t chunk = std::min(count - done, buffer_.size() - read_);
+      memcpy(data + done, &buffer_[read_], chunk);
+      read_ = (read_ + chunk) % buffer_.size();
+      size_ -= chunk;
+      done += chunk;
+    }
+    return count;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<uint8_t> buffer_;
+  size_t read_ = 0;
+  size_t size_ = 0;
+  size_t dropped_bytes_ = 0;
+};
+
+/* RTP timing of the media packets received by the A2DP sink. Not thread
+ * safe. */
+class A2dpSinkRxTiming {
+public:
+  /* Late packets in a row after which the source is taken to have restarted
+   * its RTP timestamps: the last of them is taken as the new baseline */
+  static constexpr size_t kMaxLatePacketRun = 8;
+
+  /* Clears the timing and the counts */
+  void Reset() { *this = A2dpSinkRxTiming(); }
+
+  /* Takes the next packet as the new baseline. The jitter estimate is kept. */
+  void Restart() {
+    has_last_packet_ = false;
+    late_packet_run_ = 0;
+  }
+
+  /* Updates the timing with a packet received at |now_us|. Returns false if
+   * the packet is late: its RTP timestamp is not after the one of the previous
+   * packet. */
+  bool Update(uint16_t seq_num, uint32_t timestamp, uint64_t now_us, int sample_rate) {
+    if (has_last_packet_) {
+      int32_t timestamp_delta = static_cast<int32_t>(timestamp - last_timestamp_);
+      if (timestamp_delta <= 0) {
+        if (++late_packet_run_ < kMaxLatePacketRun) {
+          late_packets_++;
+          return false;
+        }
+        resyncs_++;
+        Restart();
+      } else {
+        late_packet_run_ = 0;
+        uint16_t seq_num_delta = seq_num - last_seq_num_;
+        if (seq_num_delta > 1) {
+          lost_packets_ += seq_num_delta - 1;
+        }
+        if (sample_rate > 0) {
+          // Interarrival jitter estimate of RFC 3550 section 6.4.1
+          int64_t media_us = static_cast<int64_t>(timestamp_delta) * 1000000 / sample_rate;
+          int64_t transit_delta_us = static_cast<int64_t>(now_us - last_arrival_us_) - media_us;
+          int64_t jitter_us = jitter_us_;
+          jitter_us += (std::llabs(transit_delta_us) - jitter_us) / 16;
+          jitter_us_ = jitter_us;
+        }
+      }
+    }
+
+    has_last_packet_ = true;
+    last_seq_num_ = seq_num;
+    last_timestamp_ = timestamp;
+    last_arrival_us_ = now_us;
+    return true;
+  }
+
+  /* RTP timestamp of the last packet taken by Update() */
+  uint32_t LastTimestamp() const { return last_timestamp_; }
+  /* RFC 3550 interarrival jitter */
+  uint64_t JitterUs() const { return jitter_us_; }
+  /* Packets Update() returned false for */
+  size_t LatePackets() const { return late_packets_; }
+  /* Gaps in the RTP sequence numbers */
+  size_t LostPackets() const { return lost_packets_; }
+  /* Restarts of the timing after kMaxLatePacketRun late packets */
+  size_t Resyncs() const { return resyncs_; }
+
+private:
+  bool has_last_packet_ = false;
+  uint16_t last_seq_num_ = 0;
+  uint32_t last_timestamp_ = 0;
+  uint64_t last_arrival_us_ = 0;
+  uint64_t jitter_us_ = 0;
+  size_t late_packet_run_ = 0;
+  size_t late_packets_ = 0;
+  size_t lost_packets_ = 0;
+  size_t resyncs_ = 0;
+};
+
+}  // namespace btif
+}  // namespace bluetooth
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+class MessageLoopThread;
+}  // namespace common
+
+namespace btif {
+
+/* Delivery window and bounds of a JniBatchChannel */
+struct JniBatchConfig {
+  /* Time the first event of a batch waits for others */
+  std::chrono::microseconds window;
+  /* Number of queued events delivering the batch without waiting */
+  size_t max_batch;
+  /* Number of queued events past which the new ones are dropped */
+  size_t max_queued;
+};
+
+struct JniBatchStats {
+  uint64_t events;        /* Events posted */
+  uint64_t coalesced;     /* Events which replaced a queued one */
+  uint64_t dropped;       /* Events dropped as the queue was full */
+  uint64_t batches;       /* Batches delivered, one JNI thread task each */
+  uint64_t max_batch_len; /* Events in the largest batch */
+  uint64_t first_event_us;
+  uint64_t last_batch_us;
+};
+
+/* Part of the JniBatchChannel independent of the event type: the scheduling
+ * of the deliveries on the JNI thread, and the statistics. */
+class JniBatchChannelBase {
+public:
+  /* |thread| runs the deliveries, the JNI thread when null. It must be shut
+   * down before the channel is destroyed. */
+  JniBatchChannelBase(std::string name, JniBatchConfig config,
+                      bluetooth::common::MessageLoopThread* thread);
+  virtual ~JniBatchChannelBase();
+
+  JniBatchChannelBase(const JniBatchChannelBase&) = delete;
+  JniBatchChannelBase& operator=(const JniBatchChannelBase&) = delete;
+
+  JniBatchStats GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  void Dump(int fd) const;
+
+protected:
+  /* Delivers the queued events, on the JNI thread */
+  virtual void Flush() = 0;
+
+  /* Schedules the delivery of |queued| events. Called with |mutex_| held. */
+  void OnQueued(size_t queued) {
+    if (queued == 1 && !flush_pending_) {
+      flush_pending_ = true;
+      PostFlush(config_.window);
+    } else if (queued == config_.max_batch) {
+      PostFlush(std::chrono::microseconds(0));
+    }
+  }
+
+  /* Accounts for a delivered batch. Called with |mutex_| held. */
+  void OnFlushed(size_t len);
+
+  /* Accounts for a new event. Returns false when it can't be queued after
+   * |queued| events. Called with |mutex_| held. */
+  bool Admit(size_t queued);
+
+  const std::string name_;
+  const JniBatchConfig config_;
+  mutable std::mutex mutex_;
+  JniBatchStats stats_;
+
+private:
+  void PostFlush(std::chrono::microseconds delay);
+
+  bluetooth::common::MessageLoopThread* thread_;
+  bool flush_pending_;
+  bool overflowed_;
+};
+
+/* Channel delivering the events posted from any thread to the JNI thread in
+ * batches, a single task per batch instead of one per event.
+ *
+ * A batch is delivered |window| after its first event was posted, or as soon
+ * as |max_batch| events are queued. An event posted with the key of a queued
+ * one replaces it in the batch when |supersedes| says so, or always if it is
+ * null. At most |max_queued| events are queued, the ones posted past that are
+ * dropped and counted. */
+template <typename Key, typename Event, typename Hash = std::hash<Key>>
+class JniBatchChannel : public JniBatchChannelBase {
+public:
+  using DeliverCallback = std::function<void(std::vector<Event>)>;
+  using SupersedesCallback = std::function<bool(const Event& queued, const Event& event)>;
+
+  JniBatchChannel(std::string name, JniBatchConfig config, DeliverCallback deliver,
+                  SupersedesCallback supersedes = nullptr,
+                  bluetooth::common::MessageLoopThread* thread = nullptr)
+      : JniBatchChannelBase(std::move(name), config, thread),
+        deliver_(std::move(deliver)),
+        supersedes_(std::move(supersedes)) {}
+
+  void Post(const Key& key, Event event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it != index_.end() && (!supersedes_ || supersedes_(events_[it->second], event))) {
+      stats_.events++;
+      stats_.coalesced++;
+      events_[it->second] = std::move(event);
+      return;
+    }
+
+    if (!Admit(events_.size())) {
+      return;
+    }
+    index_[key] = events_.size();
+    events_.push_back(std::move(event));
+    OnQueued(events_.size());
+  }
+
+private:
+  void Flush() override {
+    std::vector<Event> events;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      events.swap(events_);
+      index_.clear();
+      OnFlushed(events.size());
+    }
+
+    if (!events.empty()) {
+      deliver_(std::move(events));
+    }
+  }
+
+  DeliverCallback deliver_;
+  SupersedesCallback supersedes_;
+  std::vector<Event> events_;
+  /* Position in |events_| of the last event queued with a key */
+  std::unordered_map<Key, size_t, Hash> index_;
+};
+
+}  // namespace btif
+}  // namespace bluetooth
+
+/* Dumps the statistics of the JNI batch channels */
+void btif_jni_batch_dump(int fd);
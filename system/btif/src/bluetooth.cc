@@ -71,6 +71,7 @@
 #include "btif/include/btif_hd.h"
 #include "btif/include/btif_hf.h"
 #include "btif/include/btif_hh.h"
+#include "btif/include/btif_jni_batch.h"
 #include "btif/include/btif_keystore.h"
 #include "btif/include/btif_metrics_logging.h"
 #include "btif/include/btif_pan.h"
@@ -85,6 +86,7 @@
 #include "common/init_flags.h"
 #include "common/metrics.h"
 #include "common/os_utils.h"
+#include "common/trace_ring.h"
 #include "device/include/device_iot_config.h"
 #include "device/include/esco_parameters.h"
 #include "device/include/interop.h"
@@ -876,6 +878,8 @@ static void dump(int fd, const char** arguments) {
   bta_debug_av_dump(fd);
   stack_debug_avdtp_api_dump(fd);
   btif_sock_dump(fd);
+  btif_jni_batch_dump(fd);
+  bluetooth::common::TraceRing::Dump(fd);
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   gatt_tcb_dump(fd);
   bta_gatt_client_dump(fd);
@@ -25,22 +25,30 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <mutex>
 #include <string>
+#include <vector>
 
+#include "btif/include/btif_a2dp_sink_pipeline.h"
 #include "btif/include/btif_av.h"
 #include "btif/include/btif_av_co.h"
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "hardware/bt_av.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "types/raw_address.h"
 
+using bluetooth::btif::A2dpSinkPcmRing;
+using bluetooth::btif::A2dpSinkRxTiming;
 using bluetooth::common::MessageLoopThread;
 using LockGuard = std::lock_guard<std::mutex>;
 using namespace bluetooth;
@@ -55,6 +63,20 @@ using namespace bluetooth;
 /* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
 #define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
 
+/* Decode ahead of the output on the worker thread, and write the decoded audio to the audio
+ * track from a separate output thread */
+#define A2DP_SINK_PIPELINED_DECODE_PROPERTY "persist.bluetooth.a2dp_sink.pipelined_decode"
+
+/* Bounds of the adaptive playout delay when decoding ahead of the output */
+#define A2DP_SINK_MIN_PLAYOUT_DELAY_MS 40
+#define A2DP_SINK_MAX_PLAYOUT_DELAY_MS 200
+
+/* Capacity of the ring of decoded audio */
+#define A2DP_SINK_PCM_RING_MS (A2DP_SINK_MAX_PLAYOUT_DELAY_MS * 2)
+
+/* Longest output tick made up for with decoded audio */
+#define A2DP_SINK_MAX_OUTPUT_TICK_MS (BTIF_SINK_MEDIA_TIME_TICK_MS * 4)
+
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
   BTIF_A2DP_SINK_STATE_STARTING_UP,
@@ -83,6 +105,19 @@ typedef struct {
   btif_a2dp_sink_focus_state_t focus_state;
 } tBTIF_MEDIA_SINK_FOCUS_UPDATE;
 
+class BtifA2dpSinkStats {
+public:
+  void Reset() { *this = BtifA2dpSinkStats(); }
+
+  size_t media_packets = 0;     // Received media packets
+  size_t overflow_packets = 0;  // Dropped from a full receive queue
+  size_t decoded_packets = 0;
+  size_t decode_errors = 0;
+  uint64_t total_decode_us = 0;
+  uint64_t max_decode_us = 0;
+  size_t output_underruns = 0;  // Output ticks short of decoded audio
+};
+
 /* BTIF A2DP Sink control block */
 class BtifA2dpSinkControlBlock {
 public:
@@ -95,7 +130,14 @@ public:
         channel_count(0),
         rx_focus_state(BTIF_A2DP_SINK_FOCUS_NOT_GRANTED),
         audio_track(nullptr),
-        decoder_interface(nullptr) {}
+        decoder_interface(nullptr),
+        pipelined_decode(false),
+        output_thread("bt_a2dp_sink_output_thread"),
+        decode_pending(false),
+        output_primed(false),
+        output_start_us(0),
+        output_frames(0),
+        decode_peak_us(0) {}
 
   void Reset() {
     if (audio_track != nullptr) {
@@ -112,6 +154,20 @@ public:
     sample_rate = 0;
     channel_count = 0;
     decoder_interface = nullptr;
+    pipelined_decode = false;
+    decode_pending = false;
+    ResetPipeline();
+    rx_timing.Reset();
+    decode_peak_us = 0;
+    stats.Reset();
+  }
+
+  // Drops the decoded audio, and restarts the RTP timing and the playout
+  // delay from the next received packet.
+  void ResetPipeline() {
+    pcm_ring.Clear();
+    output_primed = false;
+    rx_timing.Restart();
   }
 
   MessageLoopThread worker_thread;
@@ -124,6 +180,20 @@ public:
   btif_a2dp_sink_focus_state_t rx_focus_state; /* audio focus state */
   void* audio_track;
   const tA2DP_DECODER_INTERFACE* decoder_interface;
+
+  bool pipelined_decode;  // see A2DP_SINK_PIPELINED_DECODE_PROPERTY
+  MessageLoopThread output_thread;
+  std::atomic<bool> decode_pending;
+  A2dpSinkPcmRing pcm_ring;
+  std::vector<uint8_t> output_buffer;
+  bool output_primed;        // the playout delay has been built up
+  uint64_t output_start_us;  // output time of the first frame since primed
+  uint64_t output_frames;    // frames output since primed
+
+  A2dpSinkRxTiming rx_timing;  // RTP timing of the queued media packets
+  uint64_t decode_peak_us;     // decaying peak of the decoding time
+
+  BtifA2dpSinkStats stats;
 };
 
 // Mutex for below data structures.
@@ -145,6 +215,9 @@ static void btif_a2dp_sink_audio_handle_stop_decoding();
 static void btif_decode_alarm_cb(void* context);
 static void btif_a2dp_sink_audio_handle_start_decoding();
 static void btif_a2dp_sink_avk_handle_timer();
+static void btif_a2dp_sink_decode_ahead_req();
+static void btif_a2dp_sink_decode_ahead();
+static void btif_a2dp_sink_output_handle_timer();
 static void btif_a2dp_sink_audio_rx_flush_req();
 /* Handle incoming media packets A2DP SINK streaming */
 static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg);
@@ -199,6 +272,18 @@ bool btif_a2dp_sink_init() {
     log::fatal("Failed to increase A2DP decoder thread priority");
 #endif
   }
+
+  if (osi_property_get_bool(A2DP_SINK_PIPELINED_DECODE_PROPERTY, false)) {
+    btif_a2dp_sink_cb.output_thread.StartUp();
+    if (!btif_a2dp_sink_cb.output_thread.IsRunning()) {
+      log::error("unable to start up output thread, decoding on the output tick");
+    } else {
+      btif_a2dp_sink_cb.pipelined_decode = true;
+      if (!btif_a2dp_sink_cb.output_thread.EnableRealTimeScheduling()) {
+        log::warn("Failed to increase A2DP output thread priority");
+      }
+    }
+  }
   btif_a2dp_sink_cb.worker_thread.DoInThread(FROM_HERE,
                                              base::BindOnce(btif_a2dp_sink_init_delayed));
   return true;
@@ -223,6 +308,11 @@ static void btif_a2dp_sink_startup_delayed() {
 }
 
 static void btif_a2dp_sink_on_decode_complete(uint8_t* data, uint32_t len) {
+  if (btif_a2dp_sink_cb.pipelined_decode) {
+    // Runs without the lock, the ring counts the dropped bytes.
+    btif_a2dp_sink_cb.pcm_ring.Write(data, len);
+    return;
+  }
 #ifdef __ANDROID__
   BtifAvrcpAudioTrackWriteData(btif_a2dp_sink_cb.audio_track, reinterpret_cast<void*>(data), len);
 #endif
@@ -403,6 +493,9 @@ void btif_a2dp_sink_cleanup() {
   btif_a2dp_sink_cb.worker_thread.DoInThread(FROM_HERE,
                                              base::BindOnce(btif_a2dp_sink_cleanup_delayed));
   btif_a2dp_sink_cb.worker_thread.ShutDown();
+  if (btif_a2dp_sink_cb.output_thread.IsRunning()) {
+    btif_a2dp_sink_cb.output_thread.ShutDown();
+  }
 }
 
 static void btif_a2dp_sink_cleanup_delayed() {
@@ -532,6 +625,7 @@ static void btif_a2dp_sink_audio_handle_stop_decoding() {
 
   {
     LockGuard lock(g_mutex);
+    btif_a2dp_sink_cb.ResetPipeline();
 #ifdef __ANDROID__
     BtifAvrcpAudioTrackPause(btif_a2dp_sink_cb.audio_track);
 #endif
@@ -540,6 +634,11 @@ static void btif_a2dp_sink_audio_handle_stop_decoding() {
 
 static void btif_decode_alarm_cb(void* /* context */) {
   LockGuard lock(g_mutex);
+  if (btif_a2dp_sink_cb.pipelined_decode) {
+    btif_a2dp_sink_cb.output_thread.DoInThread(
+            FROM_HERE, base::BindOnce(btif_a2dp_sink_output_handle_timer));
+    return;
+  }
   btif_a2dp_sink_cb.worker_thread.DoInThread(FROM_HERE,
                                              base::BindOnce(btif_a2dp_sink_avk_handle_timer));
 }
@@ -555,6 +654,43 @@ static void btif_a2dp_sink_clear_track_event() {
   btif_a2dp_sink_cb.audio_track = nullptr;
 }
 
+static size_t btif_a2dp_sink_pcm_frame_size() {
+  return btif_a2dp_sink_cb.channel_count * btif_a2dp_sink_cb.bits_per_sample / 8;
+}
+
+// Returns the size of |duration_us| of decoded audio, in whole PCM frames.
+static size_t btif_a2dp_sink_pcm_bytes(uint64_t duration_us) {
+  return duration_us * btif_a2dp_sink_cb.sample_rate / 1000000 * btif_a2dp_sink_pcm_frame_size();
+}
+
+// Returns the decoded audio to keep ahead of the output: one output tick, and
+// room for the interarrival jitter and for the recent decoding time peak.
+static uint64_t btif_a2dp_sink_playout_delay_us() {
+  uint64_t delay_us = BTIF_SINK_MEDIA_TIME_TICK_MS * 1000 +
+                      4 * btif_a2dp_sink_cb.rx_timing.JitterUs() + btif_a2dp_sink_cb.decode_peak_us;
+  return std::clamp<uint64_t>(delay_us, A2DP_SINK_MIN_PLAYOUT_DELAY_MS * 1000,
+                              A2DP_SINK_MAX_PLAYOUT_DELAY_MS * 1000);
+}
+
+// Returns the RTP timestamp stored in front of the payload of a media packet,
+// see BTA_AV_SINK_MEDIA_TIMESTAMP_LEN.
+static uint32_t btif_a2dp_sink_get_timestamp(const BT_HDR* p_buf) {
+  uint32_t timestamp;
+  memcpy(&timestamp, p_buf->data + p_buf->offset - BTA_AV_SINK_MEDIA_TIMESTAMP_LEN,
+         BTA_AV_SINK_MEDIA_TIMESTAMP_LEN);
+  return timestamp;
+}
+
+// Updates the RTP timing with a received media packet. Returns false if the
+// packet is not after the previous one.
+// Must be called while locked.
+static bool btif_a2dp_sink_update_rx_timing(const BT_HDR* p_pkt) {
+  return btif_a2dp_sink_cb.rx_timing.Update(p_pkt->layer_specific,
+                                            btif_a2dp_sink_get_timestamp(p_pkt),
+                                            bluetooth::common::time_get_os_boottime_us(),
+                                            btif_a2dp_sink_cb.sample_rate);
+}
+
 // Must be called while locked.
 static void btif_a2dp_sink_audio_handle_start_decoding() {
   log::info("");
@@ -573,6 +709,12 @@ static void btif_a2dp_sink_audio_handle_start_decoding() {
   }
   alarm_set(btif_a2dp_sink_cb.decode_alarm, BTIF_SINK_MEDIA_TIME_TICK_MS, btif_decode_alarm_cb,
             nullptr);
+
+  if (btif_a2dp_sink_cb.pipelined_decode) {
+    btif_a2dp_sink_cb.pcm_ring.Reset(btif_a2dp_sink_pcm_bytes(A2DP_SINK_PCM_RING_MS * 1000));
+    btif_a2dp_sink_cb.output_primed = false;
+    btif_a2dp_sink_decode_ahead_req();
+  }
 }
 
 // Must be called while locked.
@@ -625,6 +767,118 @@ static void btif_a2dp_sink_avk_handle_timer() {
   log::verbose("process frames end");
 }
 
+static void btif_a2dp_sink_decode_ahead_req() {
+  if (btif_a2dp_sink_cb.decode_pending.exchange(true)) {
+    return;
+  }
+  btif_a2dp_sink_cb.worker_thread.DoInThread(FROM_HERE,
+                                             base::BindOnce(btif_a2dp_sink_decode_ahead));
+}
+
+// Decodes received media packets until the decoded audio covers the playout
+// delay. The decoder runs without the lock, so that a slow packet does not
+// hold up the output thread or the reception of the next packets.
+static void btif_a2dp_sink_decode_ahead() {
+  btif_a2dp_sink_cb.decode_pending = false;
+
+  while (true) {
+    BT_HDR* p_msg;
+    {
+      LockGuard lock(g_mutex);
+      if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED ||
+          btif_a2dp_sink_cb.rx_flush) {
+        return;
+      }
+      if (btif_a2dp_sink_cb.pcm_ring.Size() >=
+          btif_a2dp_sink_pcm_bytes(btif_a2dp_sink_playout_delay_us())) {
+        return;
+      }
+      p_msg = (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue);
+      if (p_msg == NULL) {
+        return;
+      }
+      if (btif_av_get_peer_sep(A2dpType::kSink) == AVDT_TSEP_SNK) {
+        log::verbose("state changed happened in this tick");
+        osi_free(p_msg);
+        continue;
+      }
+    }
+
+    // The decoder is only used on this thread.
+    log::assert_that(btif_a2dp_sink_cb.decoder_interface != nullptr,
+                     "assert failed: btif_a2dp_sink_cb.decoder_interface != nullptr");
+    uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
+    bool decoded = btif_a2dp_sink_cb.decoder_interface->decode_packet(p_msg);
+    osi_free(p_msg);
+    uint64_t decode_us = bluetooth::common::time_get_os_boottime_us() - start_us;
+
+    LockGuard lock(g_mutex);
+    BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+    if (!decoded) {
+      log::error("decoding failed");
+      stats.decode_errors++;
+    }
+    stats.decoded_packets++;
+    stats.total_decode_us += decode_us;
+    stats.max_decode_us = std::max(stats.max_decode_us, decode_us);
+    btif_a2dp_sink_cb.decode_peak_us = std::max(
+            decode_us, btif_a2dp_sink_cb.decode_peak_us - btif_a2dp_sink_cb.decode_peak_us / 64);
+  }
+}
+
+// Writes the decoded audio due since the previous output tick to the audio
+// track, and requests the worker thread to decode what replaces it.
+static void btif_a2dp_sink_output_handle_timer() {
+  LockGuard lock(g_mutex);
+
+  if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED ||
+      btif_a2dp_sink_cb.rx_flush) {
+    return;
+  }
+  btif_a2dp_sink_decode_ahead_req();
+
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  if (!btif_a2dp_sink_cb.output_primed) {
+    // Build up the playout delay before starting, or after an underrun
+    if (btif_a2dp_sink_cb.pcm_ring.Size() <
+        btif_a2dp_sink_pcm_bytes(btif_a2dp_sink_playout_delay_us())) {
+      return;
+    }
+    btif_a2dp_sink_cb.output_primed = true;
+    btif_a2dp_sink_cb.output_start_us = now_us - BTIF_SINK_MEDIA_TIME_TICK_MS * 1000;
+    btif_a2dp_sink_cb.output_frames = 0;
+  }
+
+  // Follow the elapsed time rather than the tick count, so that late ticks do
+  // not slow down the output.
+  uint64_t due_frames = (now_us - btif_a2dp_sink_cb.output_start_us) *
+                                btif_a2dp_sink_cb.sample_rate / 1000000 -
+                        btif_a2dp_sink_cb.output_frames;
+  uint64_t max_frames = static_cast<uint64_t>(btif_a2dp_sink_cb.sample_rate) *
+                        A2DP_SINK_MAX_OUTPUT_TICK_MS / 1000;
+  if (due_frames > max_frames) {
+    btif_a2dp_sink_cb.output_frames += due_frames - max_frames;
+    due_frames = max_frames;
+  }
+  btif_a2dp_sink_cb.output_frames += due_frames;
+
+  size_t len = due_frames * btif_a2dp_sink_pcm_frame_size();
+  btif_a2dp_sink_cb.output_buffer.resize(len);
+  size_t read_len = btif_a2dp_sink_cb.pcm_ring.Read(btif_a2dp_sink_cb.output_buffer.data(), len);
+  if (read_len < len) {
+    log::verbose("underrun: {} of {} bytes", read_len, len);
+    btif_a2dp_sink_cb.stats.output_underruns++;
+    btif_a2dp_sink_cb.output_primed = false;
+  }
+  if (read_len == 0) {
+    return;
+  }
+#ifdef __ANDROID__
+  BtifAvrcpAudioTrackWriteData(btif_a2dp_sink_cb.audio_track,
+                               btif_a2dp_sink_cb.output_buffer.data(), read_len);
+#endif
+}
+
 /* when true media task discards any rx frames */
 void btif_a2dp_sink_set_rx_flush(bool enable) {
   log::info("enable={}", enable);
@@ -638,6 +892,7 @@ static void btif_a2dp_sink_audio_rx_flush_event() {
   LockGuard lock(g_mutex);
   // Flush all received encoded audio buffers
   fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+  btif_a2dp_sink_cb.ResetPipeline();
 }
 
 static void btif_a2dp_sink_decoder_update_event(tBTIF_MEDIA_SINK_DECODER_UPDATE* p_buf) {
@@ -731,19 +986,32 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   }
 
   log::verbose("+");
-  /* Allocate and queue this buffer */
-  BT_HDR* p_msg = reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
+  btif_a2dp_sink_cb.stats.media_packets++;
+  if (!btif_a2dp_sink_update_rx_timing(p_pkt) && btif_a2dp_sink_cb.pipelined_decode) {
+    log::verbose("dropping late packet {}", p_pkt->layer_specific);
+    return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+  }
+
+  /* Allocate and queue this buffer, keeping the RTP timestamp in front of the payload */
+  BT_HDR* p_msg = reinterpret_cast<BT_HDR*>(
+          osi_malloc(sizeof(*p_msg) + BTA_AV_SINK_MEDIA_TIMESTAMP_LEN + p_pkt->len));
   memcpy(p_msg, p_pkt, sizeof(*p_msg));
-  p_msg->offset = 0;
-  memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
+  p_msg->offset = BTA_AV_SINK_MEDIA_TIMESTAMP_LEN;
+  memcpy(p_msg->data, p_pkt->data + p_pkt->offset - BTA_AV_SINK_MEDIA_TIMESTAMP_LEN,
+         BTA_AV_SINK_MEDIA_TIMESTAMP_LEN + p_pkt->len);
   fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
 
   if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) == MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
     osi_free(fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue));
+    btif_a2dp_sink_cb.stats.overflow_packets++;
     uint8_t ret = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
     return ret;
   }
 
+  if (btif_a2dp_sink_cb.pipelined_decode && btif_a2dp_sink_cb.decode_alarm != nullptr) {
+    btif_a2dp_sink_decode_ahead_req();
+  }
+
   // Avoid other checks if alarm has already been initialized.
   if (btif_a2dp_sink_cb.decode_alarm == nullptr &&
       fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) >= MAX_A2DP_DELAYED_START_FRAME_COUNT) {
@@ -769,8 +1037,60 @@ void btif_a2dp_sink_audio_rx_flush_req() {
                                              base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(int /* fd */) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  const BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+
+  dprintf(fd, "\nA2DP Sink State:\n");
+  dprintf(fd, "  Decoding                                                : %s\n",
+          btif_a2dp_sink_cb.pipelined_decode ? "ahead of the output" : "on the output tick");
+  const A2dpSinkRxTiming& rx_timing = btif_a2dp_sink_cb.rx_timing;
+  dprintf(fd,
+          "  Counts (received/late/lost/overflow)                    : %zu / %zu / %zu / "
+          "%zu\n",
+          stats.media_packets, rx_timing.LatePackets(), rx_timing.LostPackets(),
+          stats.overflow_packets);
+  dprintf(fd, "  RTP interarrival jitter in us                           : %llu\n",
+          (unsigned long long)rx_timing.JitterUs());
+  dprintf(fd, "  RTP timing restarts after late packets                  : %zu\n",
+          rx_timing.Resyncs());
+
+  size_t queue_len = 0;
+  uint64_t queue_us = 0;
+  if (btif_a2dp_sink_cb.rx_audio_queue != nullptr) {
+    queue_len = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+    BT_HDR* p_first = (BT_HDR*)fixed_queue_try_peek_first(btif_a2dp_sink_cb.rx_audio_queue);
+    if (p_first != nullptr && btif_a2dp_sink_cb.sample_rate > 0) {
+      queue_us = static_cast<uint64_t>(rx_timing.LastTimestamp() -
+                                       btif_a2dp_sink_get_timestamp(p_first)) *
+                 1000000 / btif_a2dp_sink_cb.sample_rate;
+    }
+  }
+  dprintf(fd, "  Receive queue (packets/media time in ms)                : %zu / %llu\n",
+          queue_len, (unsigned long long)queue_us / 1000);
+
+  if (!btif_a2dp_sink_cb.pipelined_decode) {
+    return;
+  }
+  dprintf(fd, "  Counts (decoded/decode errors)                          : %zu / %zu\n",
+          stats.decoded_packets, stats.decode_errors);
+  dprintf(fd, "  Decoding time in us (average/max/recent peak)           : %llu / %llu / %llu\n",
+          (unsigned long long)(stats.decoded_packets > 0
+                                       ? stats.total_decode_us / stats.decoded_packets
+                                       : 0),
+          (unsigned long long)stats.max_decode_us,
+          (unsigned long long)btif_a2dp_sink_cb.decode_peak_us);
+  size_t frame_size = btif_a2dp_sink_pcm_frame_size();
+  uint64_t decoded_ms = 0;
+  if (frame_size > 0 && btif_a2dp_sink_cb.sample_rate > 0) {
+    decoded_ms = static_cast<uint64_t>(btif_a2dp_sink_cb.pcm_ring.Size()) / frame_size * 1000 /
+                 btif_a2dp_sink_cb.sample_rate;
+  }
+  dprintf(fd, "  Playout delay in ms (target/decoded)                    : %llu / %llu\n",
+          (unsigned long long)btif_a2dp_sink_playout_delay_us() / 1000,
+          (unsigned long long)decoded_ms);
+  dprintf(fd, "  Counts (output underruns/dropped PCM bytes)             : %zu / %zu\n",
+          stats.output_underruns, btif_a2dp_sink_cb.pcm_ring.DroppedBytes());
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
@@ -791,6 +1111,7 @@ static void btif_a2dp_sink_set_focus_state_event(btif_a2dp_sink_focus_state_t st
   btif_a2dp_sink_cb.rx_focus_state = state;
   if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED) {
     fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+    btif_a2dp_sink_cb.ResetPipeline();
     btif_a2dp_sink_cb.rx_flush = true;
   } else if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
     btif_a2dp_sink_cb.rx_flush = false;
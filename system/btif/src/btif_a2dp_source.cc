@@ -28,10 +28,18 @@
 #endif
 
 #include <limits.h>
+#include <poll.h>
+#include <sched.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <future>
+#include <thread>
+#include <vector>
 
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bta_av_ci.h"
@@ -39,12 +47,14 @@
 #include "btif_av.h"
 #include "btif_av_co.h"
 #include "btif_metrics_logging.h"
+#include "common/histogram.h"
 #include "common/message_loop_thread.h"
 #include "common/metrics.h"
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
@@ -56,6 +66,7 @@
 using bluetooth::audio::a2dp::BluetoothAudioStatus;
 using bluetooth::common::A2dpSessionMetrics;
 using bluetooth::common::BluetoothMetricsLogger;
+using bluetooth::common::Histogram;
 using bluetooth::common::RepeatingTimer;
 using namespace bluetooth;
 
@@ -66,6 +77,150 @@ using namespace bluetooth;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * When set, the encoder runs at absolute encoding slot deadlines armed on a
+ * timerfd, instead of on media_alarm.
+ */
+#define A2DP_SOURCE_DEADLINE_SCHEDULING_PROPERTY "persist.bluetooth.a2dp_source.deadline_scheduling"
+
+/**
+ * Runs the encoder at the start of each encoding slot. The deadline of each
+ * slot is absolute and armed on a CLOCK_BOOTTIME timerfd by a dedicated
+ * thread, which then posts the encoding to the source thread. Unlike
+ * media_alarm, the delay of one tick doesn't move the following ones, and
+ * the slots missed under contention are skipped and counted instead of
+ * being encoded in a burst. If the timer fails, |on_failure| is posted to the
+ * source thread, which falls back to media_alarm.
+ */
+class EncodeSlotTimer {
+public:
+  ~EncodeSlotTimer() { Stop(); }
+
+  // Runs at the slot deadline |deadline_us|, after |missed_slots| skipped slots
+  using Task = base::RepeatingCallback<void(uint64_t deadline_us, size_t missed_slots)>;
+
+  bool Start(bluetooth::common::MessageLoopThread* thread, uint64_t period_us, Task task,
+             base::OnceClosure on_failure) {
+    Stop();
+    timer_fd_ = timerfd_create(CLOCK_BOOTTIME, TFD_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (timer_fd_ < 0 || stop_fd_ < 0) {
+      log::error("unable to create the encoding slot timer: {}", strerror(errno));
+      CloseFds();
+      return false;
+    }
+    period_us_ = period_us;
+    delay_us_ = 0;
+    running_ = true;
+    failed_ = false;
+    thread_ = std::thread(&EncodeSlotTimer::Run, this, thread, std::move(task),
+                          std::move(on_failure),
+                          bluetooth::common::time_get_os_boottime_us() + period_us);
+    return true;
+  }
+
+  // Cancels the following slots. The slot already posted to the source
+  // thread still runs.
+  void Stop() {
+    if (!thread_.joinable()) {
+      return;
+    }
+    uint64_t value = 1;
+    if (write(stop_fd_, &value, sizeof(value)) < 0) {
+      log::error("unable to stop the encoding slot timer: {}", strerror(errno));
+    }
+    thread_.join();
+    running_ = false;
+    failed_ = false;
+    CloseFds();
+  }
+
+  bool IsRunning() const { return running_; }
+
+  // True if the timer stopped on an error, until it is stopped or started
+  bool HasFailed() const { return failed_; }
+
+  // Moves the next slot deadline later by |delay_us|, up to a quarter of a
+  // period per slot, to read after the audio HAL has written.
+  void Delay(uint64_t delay_us) { delay_us_ = std::min<uint64_t>(delay_us, period_us_ / 4); }
+
+private:
+  void Run(bluetooth::common::MessageLoopThread* thread, Task task, base::OnceClosure on_failure,
+           uint64_t deadline_us) {
+    struct sched_param rt_params = {.sched_priority = 1};
+    if (sched_setscheduler(0, SCHED_FIFO, &rt_params) != 0) {
+      log::warn("unable to set SCHED_FIFO for the encoding slot timer: {}", strerror(errno));
+    }
+
+    size_t missed_slots = 0;
+    while (true) {
+      deadline_us += delay_us_.exchange(0);
+      struct itimerspec deadline = {};
+      deadline.it_value.tv_sec = deadline_us / 1000000;
+      deadline.it_value.tv_nsec = (deadline_us % 1000000) * 1000;
+      if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &deadline, nullptr) < 0) {
+        log::error("unable to arm the encoding slot timer: {}", strerror(errno));
+        Fail(thread, std::move(on_failure));
+        return;
+      }
+
+      struct pollfd fds[2] = {{timer_fd_, POLLIN, 0}, {stop_fd_, POLLIN, 0}};
+      if (poll(fds, 2, -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        log::error("unable to wait for the encoding slot timer: {}", strerror(errno));
+        Fail(thread, std::move(on_failure));
+        return;
+      }
+      if (fds[1].revents != 0) {
+        break;
+      }
+      uint64_t expirations;
+      if (read(timer_fd_, &expirations, sizeof(expirations)) < 0) {
+        continue;
+      }
+      thread->DoInThread(FROM_HERE, base::BindOnce(task, deadline_us, missed_slots));
+
+      deadline_us += period_us_;
+      missed_slots = 0;
+      uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+      if (now_us >= deadline_us) {
+        // Skip the slots that have passed: the encoder catches up on the
+        // audio from the elapsed time.
+        missed_slots = (now_us - deadline_us) / period_us_ + 1;
+        deadline_us += missed_slots * period_us_;
+      }
+    }
+  }
+
+  // Stays running, so that the source keeps streaming until |on_failure|
+  // replaces the timer
+  void Fail(bluetooth::common::MessageLoopThread* thread, base::OnceClosure on_failure) {
+    failed_ = true;
+    thread->DoInThread(FROM_HERE, std::move(on_failure));
+  }
+
+  void CloseFds() {
+    if (timer_fd_ >= 0) {
+      close(timer_fd_);
+    }
+    if (stop_fd_ >= 0) {
+      close(stop_fd_);
+    }
+    timer_fd_ = -1;
+    stop_fd_ = -1;
+  }
+
+  int timer_fd_ = -1;
+  int stop_fd_ = -1;
+  uint64_t period_us_ = 0;
+  std::thread thread_;
+  std::atomic<bool> running_ = false;
+  std::atomic<bool> failed_ = false;
+  std::atomic<uint64_t> delay_us_ = 0;
+};
+
 class SchedulingStats {
 public:
   SchedulingStats() { Reset(); }
@@ -136,6 +291,9 @@ public:
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    encode_missed_slots = 0;
+    encode_jitter_us.Reset();
+    tx_queue_occupancy.Reset();
     codec_index = -1;
   }
 
@@ -166,6 +324,13 @@ public:
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  // Encoding slots skipped in deadline scheduling mode
+  size_t encode_missed_slots;
+  // Distance between the start of encoding and the slot deadline (in us)
+  Histogram encode_jitter_us{{250, 500, 1000, 2000, 5000, 10000, 20000}};
+  // TX queue length at the start of encoding
+  Histogram tx_queue_occupancy{{0, 1, 2, 4, 8, 16}};
+
   int codec_index = -1;
 };
 
@@ -179,6 +344,7 @@ public:
         sw_audio_is_encoding(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
+        deadline_scheduling(false),
         state_(kStateOff) {}
 
   void Reset() {
@@ -186,9 +352,11 @@ public:
     tx_audio_queue = nullptr;
     tx_flush = false;
     media_alarm.CancelAndWait();
+    encode_slot_timer.Stop();
     wakelock_release();
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
+    deadline_scheduling = false;
     stats.Reset();
     accumulated_stats.Reset();
     state_ = kStateOff;
@@ -214,8 +382,10 @@ public:
   bool tx_flush; /* Discards any outgoing data when true */
   bool sw_audio_is_encoding;
   RepeatingTimer media_alarm;
+  EncodeSlotTimer encode_slot_timer; /* Replaces media_alarm in deadline scheduling mode */
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
+  bool deadline_scheduling;     /* The encoder runs on encode_slot_timer */
   BtifMediaStats stats;
   BtifMediaStats accumulated_stats;
 
@@ -253,6 +423,10 @@ static void btif_a2dp_source_audio_feeding_update_event(
         const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static void btif_a2dp_source_audio_handle_encode_slot(uint64_t deadline_us, size_t missed_slots);
+static void btif_a2dp_source_encode_slot_timer_failed(void);
+static void btif_a2dp_source_schedule_media_alarm(void);
+static void btif_a2dp_source_audio_encode(uint64_t deadline_us);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n, uint32_t bytes_read);
 static void log_tstamps_us(const char* comment, uint64_t timestamp_us);
@@ -299,6 +473,9 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src, BtifMediaStats* dst)
   dst->media_read_total_underflow_bytes += src->media_read_total_underflow_bytes;
   dst->media_read_total_underflow_count += src->media_read_total_underflow_count;
   dst->media_read_last_underflow_us = src->media_read_last_underflow_us;
+  dst->encode_missed_slots += src->encode_missed_slots;
+  dst->encode_jitter_us.Accumulate(src->encode_jitter_us);
+  dst->tx_queue_occupancy.Accumulate(src->tx_queue_occupancy);
   if (dst->codec_index < 0) {
     dst->codec_index = src->codec_index;
   }
@@ -508,7 +685,10 @@ bool btif_a2dp_source_media_task_is_shutting_down(void) {
 }
 
 // This runs on worker thread
-bool btif_a2dp_source_is_streaming(void) { return btif_a2dp_source_cb.media_alarm.IsScheduled(); }
+bool btif_a2dp_source_is_streaming(void) {
+  return btif_a2dp_source_cb.media_alarm.IsScheduled() ||
+         btif_a2dp_source_cb.encode_slot_timer.IsRunning();
+}
 
 static void btif_a2dp_source_setup_codec(const RawAddress& peer_address) {
   log::info("peer_address={} state={}", peer_address, btif_a2dp_source_cb.StateStr());
@@ -757,11 +937,16 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
   btif_a2dp_source_cb.tx_flush = false;
 
   wakelock_acquire();
-  btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
-          btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
-          base::BindRepeating(&btif_a2dp_source_audio_handle_timer),
-          std::chrono::milliseconds(
-                  btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+  btif_a2dp_source_cb.deadline_scheduling =
+          osi_property_get_bool(A2DP_SOURCE_DEADLINE_SCHEDULING_PROPERTY, false);
+  if (!btif_a2dp_source_cb.deadline_scheduling ||
+      !btif_a2dp_source_cb.encode_slot_timer.Start(
+              &btif_a2dp_source_thread,
+              btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms() * 1000,
+              base::BindRepeating(&btif_a2dp_source_audio_handle_encode_slot),
+              base::BindOnce(&btif_a2dp_source_encode_slot_timer_failed))) {
+    btif_a2dp_source_schedule_media_alarm();
+  }
   btif_a2dp_source_cb.sw_audio_is_encoding = true;
 
   btif_a2dp_source_cb.stats.Reset();
@@ -802,6 +987,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
   /* Stop the timer first */
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
+  btif_a2dp_source_cb.encode_slot_timer.Stop();
   wakelock_release();
 
   bluetooth::audio::a2dp::ack_stream_suspended(BluetoothAudioStatus::SUCCESS);
@@ -815,7 +1001,41 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
   }
 }
 
+static void btif_a2dp_source_schedule_media_alarm(void) {
+  btif_a2dp_source_cb.deadline_scheduling = false;
+  btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
+          btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
+          base::BindRepeating(&btif_a2dp_source_audio_handle_timer),
+          std::chrono::milliseconds(
+                  btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+}
+
+static void btif_a2dp_source_encode_slot_timer_failed(void) {
+  // The stream was stopped, or restarted, since the failure
+  if (!btif_a2dp_source_cb.encode_slot_timer.HasFailed()) {
+    return;
+  }
+
+  log::error("encoding slot timer failed, falling back to the periodic alarm");
+  btif_a2dp_source_cb.encode_slot_timer.Stop();
+  btif_a2dp_source_schedule_media_alarm();
+}
+
 static void btif_a2dp_source_audio_handle_timer(void) {
+  const SchedulingStats& enqueue_stats = btif_a2dp_source_cb.stats.tx_queue_enqueue_stats;
+  uint64_t deadline_us = 0;
+  if (enqueue_stats.last_update_us != 0) {
+    deadline_us = enqueue_stats.last_update_us + btif_a2dp_source_cb.encoder_interval_ms * 1000;
+  }
+  btif_a2dp_source_audio_encode(deadline_us);
+}
+
+static void btif_a2dp_source_audio_handle_encode_slot(uint64_t deadline_us, size_t missed_slots) {
+  btif_a2dp_source_cb.stats.encode_missed_slots += missed_slots;
+  btif_a2dp_source_audio_encode(deadline_us);
+}
+
+static void btif_a2dp_source_audio_encode(uint64_t deadline_us) {
   if (btif_av_is_a2dp_offload_running()) {
     return;
   }
@@ -835,6 +1055,12 @@ static void btif_a2dp_source_audio_handle_timer(void) {
 #ifdef __ANDROID__
   ATRACE_INT("btif TX queue", transmit_queue_length);
 #endif
+  if (deadline_us != 0) {
+    btif_a2dp_source_cb.stats.encode_jitter_us.Add(stats_timestamp_us > deadline_us
+                                                           ? stats_timestamp_us - deadline_us
+                                                           : deadline_us - stats_timestamp_us);
+  }
+  btif_a2dp_source_cb.stats.tx_queue_occupancy.Add(transmit_queue_length);
   if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length != nullptr) {
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(transmit_queue_length);
   }
@@ -855,6 +1081,12 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
             bluetooth::common::time_get_os_boottime_us();
     log_a2dp_audio_underrun_event(btif_av_source_active_peer(),
                                   btif_a2dp_source_cb.encoder_interval_ms, len - bytes_read);
+    if (btif_a2dp_source_cb.deadline_scheduling) {
+      // The audio HAL hasn't written all the audio of this slot yet: read
+      // the next slots later, by the time of audio missing.
+      btif_a2dp_source_cb.encode_slot_timer.Delay(btif_a2dp_source_cb.encoder_interval_ms * 1000 *
+                                                  (len - bytes_read) / len);
+    }
   }
 
   return bytes_read;
@@ -1117,6 +1349,16 @@ void btif_a2dp_source_debug_dump(int fd) {
                             1000
                   : 0);
 
+  dprintf(fd, "  Scheduling mode                                         : %s\n",
+          btif_a2dp_source_cb.deadline_scheduling ? "encoding slot deadlines" : "periodic timer");
+
+  dprintf(fd, "  Counts (missed encoding slots)                          : %zu\n",
+          accumulated_stats->encode_missed_slots);
+
+  accumulated_stats->encode_jitter_us.Dump(fd, "Encoding start jitter in us (histogram)");
+
+  accumulated_stats->tx_queue_occupancy.Dump(fd, "Queue length at encoding start (histogram)");
+
   //
   // TxQueue enqueue stats
   //
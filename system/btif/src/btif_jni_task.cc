@@ -21,11 +21,17 @@
 #include <base/threading/platform_thread.h>
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstdint>
+#include <list>
+#include <mutex>
 #include <utility>
 
+#include "btif/include/btif_jni_batch.h"
 #include "common/message_loop_thread.h"
 #include "common/postable_context.h"
+#include "common/time_util.h"
 #include "include/hardware/bluetooth.h"
 #include "osi/include/allocator.h"
 
@@ -125,3 +131,96 @@ void post_on_bt_jni(BtJniClosure closure) {
 }
 
 bluetooth::common::PostableContext* get_jni() { return jni_thread.Postable(); }
+
+namespace bluetooth::btif {
+
+/* Channels listed in the dumpsys */
+static std::mutex jni_batch_channels_mutex;
+static std::list<const JniBatchChannelBase*> jni_batch_channels;
+
+JniBatchChannelBase::JniBatchChannelBase(std::string name, JniBatchConfig config,
+                                         bluetooth::common::MessageLoopThread* thread)
+    : name_(std::move(name)),
+      config_(config),
+      stats_{},
+      thread_(thread != nullptr ? thread : &jni_thread),
+      flush_pending_(false),
+      overflowed_(false) {
+  std::lock_guard<std::mutex> lock(jni_batch_channels_mutex);
+  jni_batch_channels.push_back(this);
+}
+
+JniBatchChannelBase::~JniBatchChannelBase() {
+  std::lock_guard<std::mutex> lock(jni_batch_channels_mutex);
+  jni_batch_channels.remove(this);
+}
+
+bool JniBatchChannelBase::Admit(size_t queued) {
+  if (stats_.events++ == 0) {
+    stats_.first_event_us = bluetooth::common::time_get_os_boottime_us();
+  }
+
+  if (queued >= config_.max_queued) {
+    if (!overflowed_) {
+      log::warn("{}: {} events queued, dropping the new ones", name_, queued);
+      overflowed_ = true;
+    }
+    stats_.dropped++;
+    return false;
+  }
+  return true;
+}
+
+void JniBatchChannelBase::OnFlushed(size_t len) {
+  flush_pending_ = false;
+  overflowed_ = false;
+  if (len == 0) {
+    return;
+  }
+
+  stats_.batches++;
+  stats_.max_batch_len = std::max<uint64_t>(stats_.max_batch_len, len);
+  stats_.last_batch_us = bluetooth::common::time_get_os_boottime_us();
+}
+
+void JniBatchChannelBase::PostFlush(std::chrono::microseconds delay) {
+  if (!thread_->DoInThreadDelayed(
+              FROM_HERE, base::BindOnce(&JniBatchChannelBase::Flush, base::Unretained(this)),
+              delay)) {
+    log::error("{}: Post task to task runner failed!", name_);
+  }
+}
+
+void JniBatchChannelBase::Dump(int fd) const {
+  JniBatchStats stats = GetStats();
+
+  dprintf(fd, "  %s:\n", name_.c_str());
+  dprintf(fd, "    Window: %" PRId64 " us, max batch: %zu, max queued: %zu\n",
+          static_cast<int64_t>(config_.window.count()), config_.max_batch, config_.max_queued);
+  dprintf(fd,
+          "    Events: %" PRIu64 ", coalesced: %" PRIu64 ", dropped: %" PRIu64
+          ", batches: %" PRIu64 ", largest batch: %" PRIu64 "\n",
+          stats.events, stats.coalesced, stats.dropped, stats.batches, stats.max_batch_len);
+
+  /* Rates over the time events were delivered, events/s is the number of
+   * upcalls which would have been posted without batching. */
+  if (stats.batches != 0 && stats.last_batch_us > stats.first_event_us) {
+    double secs = (stats.last_batch_us - stats.first_event_us) / 1e6;
+    dprintf(fd, "    Events/s: %.1f, JNI thread tasks/s: %.1f\n", stats.events / secs,
+            stats.batches / secs);
+  }
+}
+
+}  // namespace bluetooth::btif
+
+void btif_jni_batch_dump(int fd) {
+  std::lock_guard<std::mutex> lock(bluetooth::btif::jni_batch_channels_mutex);
+  if (bluetooth::btif::jni_batch_channels.empty()) {
+    return;
+  }
+
+  dprintf(fd, "\nJNI upcall batching:\n");
+  for (auto channel : bluetooth::btif::jni_batch_channels) {
+    channel->Dump(fd);
+  }
+}
@@ -21,6 +21,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <mutex>
@@ -43,10 +44,12 @@
 
 using namespace bluetooth;
 
+/* Maximum number of SDUs moved between the app socket and L2CAP per syscall */
+static constexpr unsigned kMaxSdusPerBatch = 16;
+
 struct packet {
   struct packet *next, *prev;
-  uint32_t len;
-  uint8_t* data;
+  BT_HDR* msg;  // SDU received from L2CAP, delivered as one message
 };
 
 typedef struct l2cap_socket {
@@ -107,20 +110,15 @@ static void btsock_l2cap_cbk(tBTA_JV_EVT event, tBTA_JV* p_data, uint32_t l2cap_
  * wait
  *       confirming the l2cap_ind until we have more space in the buffer. */
 
-/* returns false if none - caller must free "data" memory when done with it */
-static char packet_get_head_l(l2cap_socket* sock, uint8_t** data, uint32_t* len) {
+/* returns NULL if none - caller must osi_free the returned SDU when done */
+static BT_HDR* packet_get_head_l(l2cap_socket* sock) {
   struct packet* p = sock->first_packet;
 
   if (!p) {
-    return false;
+    return NULL;
   }
 
-  if (data) {
-    *data = sock->first_packet->data;
-  }
-  if (len) {
-    *len = sock->first_packet->len;
-  }
+  BT_HDR* msg = p->msg;
   sock->first_packet = p->next;
   if (sock->first_packet) {
     sock->first_packet->prev = NULL;
@@ -128,62 +126,22 @@ static char packet_get_head_l(l2cap_socket* sock, uint8_t** data, uint32_t* len)
     sock->last_packet = NULL;
   }
 
-  if (len) {
-    sock->bytes_buffered -= *len;
-  }
+  sock->bytes_buffered -= msg->len;
 
   osi_free(p);
 
-  return true;
-}
-
-static struct packet* packet_alloc(const uint8_t* data, uint32_t len) {
-  struct packet* p = (struct packet*)osi_calloc(sizeof(*p));
-  uint8_t* buf = (uint8_t*)osi_malloc(len);
-
-  p->data = buf;
-  p->len = len;
-  memcpy(p->data, data, len);
-  return p;
-}
-
-/* makes a copy of the data, returns true on success */
-static char packet_put_head_l(l2cap_socket* sock, const void* data, uint32_t len) {
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
-
-  /*
-   * We do not check size limits here since this is used to undo "getting" a
-   * packet that the user read incompletely. That is to say the packet was
-   * already in the queue. We do check thos elimits in packet_put_tail_l() since
-   * that function is used to put new data into the queue.
-   */
-
-  if (!p) {
-    return false;
-  }
-
-  p->prev = NULL;
-  p->next = sock->first_packet;
-  sock->first_packet = p;
-  if (p->next) {
-    p->next->prev = p;
-  } else {
-    sock->last_packet = p;
-  }
-
-  sock->bytes_buffered += len;
-
-  return true;
+  return msg;
 }
 
-/* makes a copy of the data, returns true on success */
-static char packet_put_tail_l(l2cap_socket* sock, const void* data, uint32_t len) {
+/* takes ownership of "msg" without copying it, returns true on success */
+static char packet_put_tail_l(l2cap_socket* sock, BT_HDR* msg) {
   if (sock->bytes_buffered >= L2CAP_MAX_RX_BUFFER) {
     log::error("Unable to add to buffer due to buffer overflow socket_id:{}", sock->id);
     return false;
   }
 
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
+  struct packet* p = (struct packet*)osi_calloc(sizeof(*p));
+  p->msg = msg;
   p->next = NULL;
   p->prev = sock->last_packet;
   sock->last_packet = p;
@@ -193,7 +151,7 @@ static char packet_put_tail_l(l2cap_socket* sock, const void* data, uint32_t len
     sock->first_packet = p;
   }
 
-  sock->bytes_buffered += len;
+  sock->bytes_buffered += msg->len;
 
   return true;
 }
@@ -229,7 +187,7 @@ static l2cap_socket* btsock_l2cap_find_by_conn_uuid_l(Uuid& conn_uuid) {
 }
 
 static void btsock_l2cap_free_l(l2cap_socket* sock) {
-  uint8_t* buf;
+  BT_HDR* buf;
   l2cap_socket* t = socks;
 
   while (t && t != sock) {
@@ -267,7 +225,7 @@ static void btsock_l2cap_free_l(l2cap_socket* sock) {
     log::info("Application has already closed l2cap socket socket_id:{}", sock->id);
   }
 
-  while (packet_get_head_l(sock, &buf, NULL)) {
+  while ((buf = packet_get_head_l(sock)) != NULL) {
     osi_free(buf);
   }
 
@@ -710,21 +668,23 @@ static void on_l2cap_data_ind(tBTA_JV* /* evt */, uint32_t id) {
 
   app_uid = sock->app_uid;
 
-  uint32_t count;
-
-  if (BTA_JvL2capReady(sock->handle, &count) == tBTA_JV_STATUS::SUCCESS) {
-    std::vector<uint8_t> buffer(count);
-    if (BTA_JvL2capRead(sock->handle, sock->id, buffer.data(), count) == tBTA_JV_STATUS::SUCCESS) {
-      if (packet_put_tail_l(sock, buffer.data(), count)) {
-        bytes_read = count;
-        btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR, sock->id);
-      } else {  // connection must be dropped
-        log::warn("Closing socket as unable to push data to socket socket_id:{}", sock->id);
-        BTA_JvL2capClose(sock->handle);
-        btsock_l2cap_free_l(sock);
-        return;
-      }
+  // queue the received SDUs as they are, they are written to the app socket
+  // from the L2CAP buffers
+  BT_HDR* msg = NULL;
+  while (BTA_JvL2capReadBuf(sock->handle, &msg) == tBTA_JV_STATUS::SUCCESS && msg) {
+    uint16_t len = msg->len;
+    if (!packet_put_tail_l(sock, msg)) {  // connection must be dropped
+      osi_free(msg);
+      log::warn("Closing socket as unable to push data to socket socket_id:{}", sock->id);
+      BTA_JvL2capClose(sock->handle);
+      btsock_l2cap_free_l(sock);
+      return;
     }
+    bytes_read += len;
+    msg = NULL;
+  }
+  if (sock->first_packet) {
+    btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR, sock->id);
   }
 
   sock->rx_bytes += bytes_read;
@@ -910,26 +870,40 @@ bt_status_t btsock_l2cap_connect(const RawAddress* bd_addr, int channel, int* so
  * (for example: unrecoverable error or no data)
  */
 static bool flush_incoming_que_on_wr_signal_l(l2cap_socket* sock) {
-  uint8_t* buf;
-  uint32_t len;
-
-  while (packet_get_head_l(sock, &buf, &len)) {
-    ssize_t sent;
-    OSI_NO_INTR(sent = send(sock->our_fd, buf, len, MSG_DONTWAIT));
-    int saved_errno = errno;
-
-    if (sent == (signed)len) {
-      osi_free(buf);
-    } else if (sent >= 0) {
-      packet_put_head_l(sock, buf + sent, len - sent);
-      osi_free(buf);
-      if (!sent) { /* special case if other end not keeping up */
-        return true;
+  std::array<struct mmsghdr, kMaxSdusPerBatch> msgs;
+  std::array<struct iovec, kMaxSdusPerBatch> iovs;
+
+  while (sock->first_packet) {
+    // one message per SDU, written straight from the L2CAP buffers
+    unsigned count = 0;
+    for (struct packet* p = sock->first_packet; p && count < kMaxSdusPerBatch; p = p->next) {
+      iovs[count].iov_base = (uint8_t*)(p->msg + 1) + p->msg->offset;
+      iovs[count].iov_len = p->msg->len;
+      msgs[count] = {};
+      msgs[count].msg_hdr.msg_iov = &iovs[count];
+      msgs[count].msg_hdr.msg_iovlen = 1;
+      count++;
+    }
+
+    int sent;
+    OSI_NO_INTR(sent = sendmmsg(sock->our_fd, msgs.data(), count, MSG_DONTWAIT));
+    if (sent < 0) {
+      return errno == EWOULDBLOCK || errno == EAGAIN;
+    }
+
+    for (int i = 0; i < sent; i++) {
+      BT_HDR* msg = sock->first_packet->msg;
+      if (msgs[i].msg_len < msg->len) {
+        // keep the rest of the SDU at the head of the queue
+        msg->offset += msgs[i].msg_len;
+        msg->len -= msgs[i].msg_len;
+        sock->bytes_buffered -= msgs[i].msg_len;
+        if (!msgs[i].msg_len) { /* special case if other end not keeping up */
+          return true;
+        }
+        break;
       }
-    } else {
-      packet_put_head_l(sock, buf, len);
-      osi_free(buf);
-      return saved_errno == EWOULDBLOCK || saved_errno == EAGAIN;
+      osi_free(packet_get_head_l(sock));
     }
   }
 
@@ -971,29 +945,53 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
            BluetoothSocket.write(...) guarantees that any packet send to this
            socket is broken into pieces no bigger than MTU bytes (as requested
            by BT spec). */
-        size = std::min(size, (int)sock->tx_mtu);
-
-        BT_HDR* buffer = malloc_l2cap_buf(size);
-        /* The socket is created with SOCK_SEQPACKET, hence we read one message
-         * at the time. */
-        ssize_t count;
-        OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), size,
-                                 MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
-        if (count > sock->tx_mtu) {
-          /* This can't happen thanks to check in BluetoothSocket.java but leave
-           * this in case this socket is ever used anywhere else*/
-          log::error("recv more than MTU. Data will be lost: {}", count);
-          count = sock->tx_mtu;
+        std::array<BT_HDR*, kMaxSdusPerBatch> buffers;
+        std::array<struct mmsghdr, kMaxSdusPerBatch> msgs;
+        std::array<struct iovec, kMaxSdusPerBatch> iovs;
+
+        /* Every awaiting packet fits in min(size, MTU) bytes. Allocate SDU
+           buffers for the reported total size, and read the packets straight
+           into them. Packets smaller than MTU leave the rest of the data for
+           the next signal. */
+        uint16_t len = std::min(size, (int)sock->tx_mtu);
+        unsigned count = 0;
+        int allocated = 0;
+        do {
+          buffers[count] = malloc_l2cap_buf(len);
+          iovs[count].iov_base = get_l2cap_sdu_start_ptr(buffers[count]);
+          iovs[count].iov_len = len;
+          msgs[count] = {};
+          msgs[count].msg_hdr.msg_iov = &iovs[count];
+          msgs[count].msg_hdr.msg_iovlen = 1;
+          allocated += len;
+          count++;
+        } while (count < kMaxSdusPerBatch && allocated < size);
+
+        /* The socket is created with SOCK_SEQPACKET, hence each message is
+         * one packet. */
+        int received;
+        OSI_NO_INTR(received = recvmmsg(fd, msgs.data(), count,
+                                        MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC, NULL));
+        for (int i = 0; i < received; i++) {
+          unsigned int sdu_len = msgs[i].msg_len;
+          if (sdu_len > iovs[i].iov_len) {
+            /* This can't happen thanks to check in BluetoothSocket.java but
+             * leave this in case this socket is ever used anywhere else*/
+            log::error("recv more than MTU. Data will be lost: {}", sdu_len);
+            sdu_len = iovs[i].iov_len;
+          }
+
+          /* When multiple packets smaller than MTU are flushed to the socket,
+             the size of the packet read could be smaller than the buffer.
+             Hence, we adjust the buffer length. */
+          buffers[i]->len = sdu_len;
+
+          // will take care of freeing buffer
+          BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffers[i]), buffers[i], user_id);
+        }
+        for (unsigned i = std::max(received, 0); i < count; i++) {
+          osi_free(buffers[i]);
         }
-
-        /* When multiple packets smaller than MTU are flushed to the socket, the
-           size of the single packet read could be smaller than the ioctl
-           reported total size of awaiting packets. Hence, we adjust the buffer
-           length. */
-        buffer->len = count;
-
-        // will take care of freeing buffer
-        BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffer), buffer, user_id);
       }
     } else {
       drop_it = true;
@@ -20,7 +20,7 @@
  *
  *  Filename:      btif_sock_thread.cc
  *
- *  Description:   socket select thread
+ *  Description:   socket poll thread
  *
  ******************************************************************************/
 
@@ -32,20 +32,22 @@
 #include <bluetooth/log.h>
 #include <fcntl.h>
 #include <features.h>
-#include <poll.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <mutex>
 #include <optional>
+#include <unordered_map>
 
 #include "osi/include/osi.h"  // OSI_NO_INTR
 
@@ -56,11 +58,14 @@
   } while (0)
 
 #define MAX_THREAD 8
-#define MAX_POLL 64
-#define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
-#define IS_EXCEPTION(e) ((e) & POLL_EXCEPTION_EVENTS)
-#define IS_READ(e) ((e) & POLLIN)
-#define IS_WRITE(e) ((e) & POLLOUT)
+/* Maximum number of fd events handled per wakeup of a poll thread */
+#define MAX_EVENTS 64
+/* Number of monitored fds above which the closed ones are looked for */
+#define MIN_PRUNE_SLOTS 64
+#define EPOLL_EXCEPTION_EVENTS (EPOLLHUP | EPOLLRDHUP | EPOLLERR)
+#define IS_EXCEPTION(e) ((e) & EPOLL_EXCEPTION_EVENTS)
+#define IS_READ(e) ((e) & EPOLLIN)
+#define IS_WRITE(e) ((e) & EPOLLOUT)
 /*cmd executes in socket poll thread */
 #define CMD_WAKEUP 1
 #define CMD_EXIT 2
@@ -71,16 +76,20 @@
 using namespace bluetooth;
 
 struct poll_slot_t {
-  struct pollfd pfd;
+  int fd;
   uint32_t user_id;
   int type;
   int flags;
 };
 struct thread_slot_t {
   int cmd_fdr, cmd_fdw;
-  int poll_count;
-  poll_slot_t ps[MAX_POLL];
-  int psi[MAX_POLL];  // index of poll slot
+  int epoll_fd;
+  // Monitored fds, only accessed from the poll thread. Each fd is armed once
+  // (EPOLLONESHOT) for the flags in its slot, like the one-shot flags of the
+  // btsock_thread_add_fd() API. A slot is erased once all its flags signaled.
+  std::unordered_map<int, poll_slot_t> poll_slots;
+  // Size of poll_slots at which the slots of closed fds are pruned
+  size_t prune_watermark;
   std::optional<pthread_t> thread_id;
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
@@ -136,6 +145,12 @@ static int alloc_thread_slot() {
 static void free_thread_slot(int h) {
   if (0 <= h && h < MAX_THREAD) {
     close_cmd_fd(h);
+    if (ts[h].epoll_fd != -1) {
+      close(ts[h].epoll_fd);
+      ts[h].epoll_fd = -1;
+    }
+    ts[h].poll_slots.clear();
+    ts[h].prune_watermark = MIN_PRUNE_SLOTS;
     ts[h].used = 0;
   } else {
     log::error("invalid thread handle:{}", h);
@@ -148,9 +163,10 @@ void btsock_thread_init() {
     int h;
     for (h = 0; h < MAX_THREAD; h++) {
       ts[h].cmd_fdr = ts[h].cmd_fdw = -1;
+      ts[h].epoll_fd = -1;
       ts[h].used = 0;
       ts[h].thread_id = std::nullopt;
-      ts[h].poll_count = 0;
+      ts[h].prune_watermark = MIN_PRUNE_SLOTS;
       ts[h].callback = NULL;
       ts[h].cmd_callback = NULL;
     }
@@ -183,8 +199,13 @@ static inline void init_cmd_fd(int h) {
     log::error("socketpair failed: {}", strerror(errno));
     return;
   }
-  // add the cmd fd for read & write
-  add_poll(h, ts[h].cmd_fdr, 0, SOCK_THREAD_FD_RD, 0);
+  // the cmd fd stays armed, every queued command wakes up the poll thread
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = ts[h].cmd_fdr;
+  if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_ADD, ts[h].cmd_fdr, &event) < 0) {
+    log::error("epoll_ctl add cmd fd failed: {}", strerror(errno));
+  }
 }
 static inline void close_cmd_fd(int h) {
   if (ts[h].cmd_fdr != -1) {
@@ -270,78 +291,98 @@ int btsock_thread_exit(int h) {
   return false;
 }
 static void init_poll(int h) {
-  int i;
-  ts[h].poll_count = 0;
+  ts[h].poll_slots.clear();
+  ts[h].prune_watermark = MIN_PRUNE_SLOTS;
   ts[h].thread_id = std::nullopt;
   ts[h].callback = NULL;
   ts[h].cmd_callback = NULL;
-  for (i = 0; i < MAX_POLL; i++) {
-    ts[h].ps[i].pfd.fd = -1;
-    ts[h].psi[i] = -1;
+  ts[h].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (ts[h].epoll_fd < 0) {
+    log::error("epoll_create1 failed: {}", strerror(errno));
+    return;
   }
   init_cmd_fd(h);
 }
-static inline unsigned int flags2pevents(int flags) {
-  unsigned int pevents = 0;
+static inline uint32_t flags2events(int flags) {
+  uint32_t events = EPOLLET | EPOLLONESHOT;
   if (flags & SOCK_THREAD_FD_WR) {
-    pevents |= POLLOUT;
+    events |= EPOLLOUT;
   }
   if (flags & SOCK_THREAD_FD_RD) {
-    pevents |= POLLIN;
+    events |= EPOLLIN;
   }
-  pevents |= POLL_EXCEPTION_EVENTS;
-  return pevents;
+  events |= EPOLL_EXCEPTION_EVENTS;
+  return events;
+}
+
+static inline int arm_poll(int h, int op, const poll_slot_t* ps) {
+  struct epoll_event event = {};
+  event.events = flags2events(ps->flags);
+  event.data.fd = ps->fd;
+  return epoll_ctl(ts[h].epoll_fd, op, ps->fd, &event);
 }
 
 static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags, uint32_t user_id) {
-  ps->pfd.fd = fd;
+  ps->fd = fd;
   ps->user_id = user_id;
   if (ps->type != 0 && ps->type != type) {
     log::error("poll socket type should not changed! type was:{}, type now:{}", ps->type, type);
   }
   ps->type = type;
   ps->flags = flags;
-  ps->pfd.events = flags2pevents(flags);
-  ps->pfd.revents = 0;
+}
+/* The users close their fds without removing them from the poll thread, and
+ * the kernel then drops the epoll registration silently. Every slot is armed,
+ * so re-arming it fails only if its fd was closed. */
+static void prune_poll(int h) {
+  for (auto it = ts[h].poll_slots.begin(); it != ts[h].poll_slots.end();) {
+    if (arm_poll(h, EPOLL_CTL_MOD, &it->second) < 0) {
+      log::verbose("fd:{} was closed without being removed", it->first);
+      it = ts[h].poll_slots.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ts[h].prune_watermark = std::max<size_t>(MIN_PRUNE_SLOTS, 2 * ts[h].poll_slots.size());
 }
 static inline void add_poll(int h, int fd, int type, int flags, uint32_t user_id) {
   asrt(fd != -1);
-  int i;
-  int empty = -1;
-  poll_slot_t* ps = ts[h].ps;
-
-  for (i = 0; i < MAX_POLL; i++) {
-    if (ps[i].pfd.fd == fd) {
-      asrt(ts[h].poll_count < MAX_POLL);
+  auto [it, inserted] = ts[h].poll_slots.try_emplace(fd, poll_slot_t{-1, 0, 0, 0});
+  poll_slot_t* ps = &it->second;
 
-      set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
+  // a fully signaled fd keeps a disarmed registration, so adding it again
+  // takes a single epoll_ctl()
+  set_poll(ps, fd, type, inserted ? flags : flags | ps->flags, user_id);
+  if (arm_poll(h, EPOLL_CTL_MOD, ps) == 0) {
+    return;
+  }
+  if (errno == ENOENT) {
+    // a new fd, or the number of an fd closed without being removed
+    *ps = {-1, 0, 0, 0};
+    set_poll(ps, fd, type, flags, user_id);
+    if (arm_poll(h, EPOLL_CTL_ADD, ps) == 0) {
+      if (ts[h].poll_slots.size() >= ts[h].prune_watermark) {
+        prune_poll(h);
+      }
       return;
-    } else if (empty < 0 && ps[i].pfd.fd == -1) {
-      empty = i;
     }
   }
-  if (empty >= 0) {
-    asrt(ts[h].poll_count < MAX_POLL);
-    set_poll(&ps[empty], fd, type, flags, user_id);
-    ++ts[h].poll_count;
-    return;
-  }
-  log::error("exceeded max poll slot:{}!", MAX_POLL);
+  log::error("epoll_ctl failed for fd:{}: {}", fd, strerror(errno));
+  ts[h].poll_slots.erase(fd);
 }
 static inline void remove_poll(int h, poll_slot_t* ps, int flags) {
-  if (flags == ps->flags) {
-    // all monitored events signaled. To remove it, just clear the slot
-    --ts[h].poll_count;
-    memset(ps, 0, sizeof(*ps));
-    ps->pfd.fd = -1;
+  ps->flags &= ~flags;
+  if (ps->flags == 0) {
+    // all monitored events signaled, the one-shot registration is disarmed
+    ts[h].poll_slots.erase(ps->fd);
   } else {
-    // one read or one write monitor event signaled, removed the accordding bit
-    ps->flags &= ~flags;
-    // update the poll events mask
-    ps->pfd.events = flags2pevents(ps->flags);
+    // one read or one write monitor event signaled, re-arm the remaining ones
+    if (arm_poll(h, EPOLL_CTL_MOD, ps) < 0) {
+      log::error("epoll_ctl failed for fd:{}: {}", ps->fd, strerror(errno));
+    }
   }
 }
-static int process_cmd_sock(int h) {
+static int process_cmd_sock(int h, int* pending) {
   sock_cmd_t cmd = {-1, 0, 0, 0, 0};
   int fd = ts[h].cmd_fdr;
 
@@ -352,20 +393,18 @@ static int process_cmd_sock(int h) {
     log::error("recv cmd errno:{}", errno);
     return false;
   }
+  *pending -= sizeof(cmd);
   switch (cmd.id) {
     case CMD_ADD_FD:
       add_poll(h, cmd.fd, cmd.type, cmd.flags, cmd.user_id);
       break;
-    case CMD_REMOVE_FD:
-      for (int i = 1; i < MAX_POLL; ++i) {
-        poll_slot_t* poll_slot = &ts[h].ps[i];
-        if (poll_slot->pfd.fd == cmd.fd) {
-          remove_poll(h, poll_slot, poll_slot->flags);
-          break;
-        }
-      }
+    case CMD_REMOVE_FD: {
+      // a fully signaled fd has no slot but is still registered
+      ts[h].poll_slots.erase(cmd.fd);
+      epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_DEL, cmd.fd, NULL);
       close(cmd.fd);
       break;
+    }
     case CMD_WAKEUP:
       break;
     case CMD_USER_PRIVATE:
@@ -373,6 +412,8 @@ static int process_cmd_sock(int h) {
       if (ts[h].cmd_callback) {
         ts[h].cmd_callback(fd, cmd.type, cmd.flags, cmd.user_id);
       }
+      // the callback reads its own data from the cmd socket
+      *pending = 0;
       break;
     case CMD_EXIT:
       return false;
@@ -382,98 +423,84 @@ static int process_cmd_sock(int h) {
   }
   return true;
 }
-
-static void process_data_sock(int h, struct pollfd* pfds, int pfds_count, int event_count) {
-  asrt(event_count <= pfds_count);
-  int i;
-  for (i = 1; i < pfds_count; i++) {
-    if (pfds[i].revents) {
-      int ps_i = ts[h].psi[i];
-      if (ts[h].ps[ps_i].pfd.fd == -1) {
-        log::info("Socket has been removed from poll set");
-        continue;
-      }
-      asrt(pfds[i].fd == ts[h].ps[ps_i].pfd.fd);
-      uint32_t user_id = ts[h].ps[ps_i].user_id;
-      int type = ts[h].ps[ps_i].type;
-      int flags = 0;
-      if (IS_READ(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_RD;
-      }
-      if (IS_WRITE(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_WR;
-      }
-      if (IS_EXCEPTION(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_EXCEPTION;
-        // remove the whole slot not flags
-        remove_poll(h, &ts[h].ps[ps_i], ts[h].ps[ps_i].flags);
-      } else if (flags) {
-        remove_poll(h, &ts[h].ps[ps_i],
-                    flags);  // remove the monitor flags that already processed
-      }
-      if (flags) {
-        ts[h].callback(pfds[i].fd, type, flags, user_id);
-      }
-    }
+/* Handles all the commands queued when the poll thread woke up, so that a burst
+ * of re-added fds costs one wakeup instead of one per command. */
+static int process_cmd_socks(int h) {
+  int pending = 0;
+  if (ioctl(ts[h].cmd_fdr, FIONREAD, &pending) < 0) {
+    pending = 0;
   }
+  do {
+    if (!process_cmd_sock(h, &pending)) {
+      return false;
+    }
+  } while (pending >= (int)sizeof(sock_cmd_t));
+  return true;
 }
 
-static void prepare_poll_fds(int h, struct pollfd* pfds) {
-  int count = 0;
-  int ps_i = 0;
-  int pfd_i = 0;
-  asrt(ts[h].poll_count <= MAX_POLL);
-  while (count < ts[h].poll_count) {
-    if (ps_i >= MAX_POLL) {
-      log::error(
-              "exceed max poll range, ps_i:{}, MAX_POLL:{}, count:{}, "
-              "ts[h].poll_count:{}",
-              ps_i, MAX_POLL, count, ts[h].poll_count);
-      return;
+static void process_data_sock(int h, const struct epoll_event* events, int event_count) {
+  for (int i = 0; i < event_count; i++) {
+    int fd = events[i].data.fd;
+    if (fd == ts[h].cmd_fdr) {
+      continue;
+    }
+    auto it = ts[h].poll_slots.find(fd);
+    if (it == ts[h].poll_slots.end()) {
+      log::info("Socket has been removed from poll set");
+      continue;
     }
-    if (ts[h].ps[ps_i].pfd.fd >= 0) {
-      pfds[pfd_i] = ts[h].ps[ps_i].pfd;
-      ts[h].psi[pfd_i] = ps_i;
-      count++;
-      pfd_i++;
+    poll_slot_t* ps = &it->second;
+    uint32_t user_id = ps->user_id;
+    int type = ps->type;
+    int flags = 0;
+    if (IS_READ(events[i].events)) {
+      flags |= SOCK_THREAD_FD_RD;
+    }
+    if (IS_WRITE(events[i].events)) {
+      flags |= SOCK_THREAD_FD_WR;
+    }
+    if (IS_EXCEPTION(events[i].events)) {
+      flags |= SOCK_THREAD_FD_EXCEPTION;
+      // remove the whole slot not flags
+      remove_poll(h, ps, ps->flags);
+    } else if (flags) {
+      remove_poll(h, ps, flags);  // remove the monitor flags that already processed
+    } else if (arm_poll(h, EPOLL_CTL_MOD, ps) < 0) {
+      log::error("epoll_ctl failed for fd:{}: {}", fd, strerror(errno));
+    }
+    if (flags) {
+      ts[h].callback(fd, type, flags, user_id);
     }
-    ps_i++;
   }
 }
+
 static void* sock_poll_thread(void* arg) {
-  std::array<struct pollfd, MAX_POLL> pfds;
+  std::array<struct epoll_event, MAX_EVENTS> events;
 
   int h = (intptr_t)arg;
   for (;;) {
-    pfds = {};
-    prepare_poll_fds(h, pfds.data());
     int ret;
-    OSI_NO_INTR(ret = poll(pfds.data(), ts[h].poll_count, -1));
+    OSI_NO_INTR(ret = epoll_wait(ts[h].epoll_fd, events.data(), events.size(), -1));
     if (ret == -1) {
-      log::error("poll ret -1, exit the thread, errno:{}, err:{}", errno, strerror(errno));
+      log::error("epoll_wait ret -1, exit the thread, errno:{}, err:{}", errno, strerror(errno));
       break;
     }
     if (ret != 0) {
-      int need_process_data_fd = true;
-      int pfds_count = ts[h].poll_count;
-      if (pfds[0].revents)  // cmd fd always is the first one
-      {
-        asrt(pfds[0].fd == ts[h].cmd_fdr);
-        if (!process_cmd_sock(h)) {
-          log::info("h:{}, process_cmd_sock return false, exit...", h);
+      // commands first, they may remove fds signaled in the same batch
+      bool cmd_signaled = false;
+      for (int i = 0; i < ret; i++) {
+        if (events[i].data.fd == ts[h].cmd_fdr) {
+          cmd_signaled = true;
           break;
         }
-        if (ret == 1) {
-          need_process_data_fd = false;
-        } else {
-          ret--;  // exclude the cmd fd
-        }
       }
-      if (need_process_data_fd) {
-        process_data_sock(h, pfds.data(), pfds_count, ret);
+      if (cmd_signaled && !process_cmd_socks(h)) {
+        log::info("h:{}, process_cmd_sock return false, exit...", h);
+        break;
       }
+      process_data_sock(h, events.data(), ret);
     } else {
-      log::info("no data, select ret: {}", ret);
+      log::info("no data, epoll_wait ret: {}", ret);
     };
   }
   log::info("socket poll thread exiting, h:{}", h);
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif/include/btif_a2dp_sink_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using bluetooth::btif::A2dpSinkPcmRing;
+using bluetooth::btif::A2dpSinkRxTiming;
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+/* SBC packet of 4 frames of 128 samples, and its duration */
+constexpr uint32_t kPacketSamples = 512;
+constexpr uint64_t kPacketUs = uint64_t{kPacketSamples} * 1000000 / kSampleRate;
+
+std::vector<uint8_t> Bytes(size_t len, uint8_t first) {
+  std::vector<uint8_t> bytes(len);
+  std::iota(bytes.begin(), bytes.end(), first);
+  return bytes;
+}
+
+TEST(BtifA2dpSinkPcmRingTest, read_returns_written_bytes_across_the_wrap) {
+  A2dpSinkPcmRing ring;
+  ring.Reset(10);
+  std::vector<uint8_t> out(10);
+
+  auto first = Bytes(7, 0);
+  EXPECT_EQ(ring.Write(first.data(), first.size()), 0u);
+  EXPECT_EQ(ring.Read(out.data(), 5), 5u);
+
+  auto second = Bytes(6, 7);
+  EXPECT_EQ(ring.Write(second.data(), second.size()), 0u);
+  EXPECT_EQ(ring.Size(), 8u);
+  EXPECT_EQ(ring.Read(out.data(), out.size()), 8u);
+  out.resize(8);
+  EXPECT_EQ(out, Bytes(8, 5));
+  EXPECT_EQ(ring.Size(), 0u);
+}
+
+TEST(BtifA2dpSinkPcmRingTest, write_to_full_ring_counts_dropped_bytes) {
+  A2dpSinkPcmRing ring;
+  ring.Reset(8);
+
+  auto bytes = Bytes(6, 0);
+  EXPECT_EQ(ring.Write(bytes.data(), bytes.size()), 0u);
+  EXPECT_EQ(ring.Write(bytes.data(), bytes.size()), 4u);
+  EXPECT_EQ(ring.Write(bytes.data(), bytes.size()), 6u);
+  EXPECT_EQ(ring.DroppedBytes(), 10u);
+  EXPECT_EQ(ring.Size(), 8u);
+
+  ring.Clear();
+  EXPECT_EQ(ring.Size(), 0u);
+  EXPECT_EQ(ring.DroppedBytes(), 10u);
+
+  ring.Reset(8);
+  EXPECT_EQ(ring.DroppedBytes(), 0u);
+}
+
+TEST(BtifA2dpSinkPcmRingTest, read_from_empty_ring_is_short) {
+  A2dpSinkPcmRing ring;
+  ring.Reset(8);
+  std::vector<uint8_t> out(8);
+
+  EXPECT_EQ(ring.Read(out.data(), out.size()), 0u);
+  auto bytes = Bytes(3, 0);
+  ring.Write(bytes.data(), bytes.size());
+  EXPECT_EQ(ring.Read(out.data(), out.size()), 3u);
+}
+
+TEST(BtifA2dpSinkPcmRingTest, concurrent_writer_and_reader_keep_the_byte_order) {
+  A2dpSinkPcmRing ring;
+  ring.Reset(64);
+  constexpr size_t kTotal = 1 << 16;
+
+  std::thread writer([&ring]() {
+    uint8_t chunk[24];
+    for (size_t written = 0; written < kTotal;) {
+      size_t len = std::min(sizeof(chunk), kTotal - written);
+      for (size_t i = 0; i < len; i++) {
+        chunk[i] = static_cast<uint8_t>(written + i);
+      }
+      // The dropped bytes are the end of the chunk, written again next time
+      size_t dropped = ring.Write(chunk, len);
+      written += len - dropped;
+      if (dropped > 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint8_t chunk[40];
+  for (size_t read = 0; read < kTotal;) {
+    size_t len = ring.Read(chunk, sizeof(chunk));
+    for (size_t i = 0; i < len; i++) {
+      ASSERT_EQ(chunk[i], static_cast<uint8_t>(read + i));
+    }
+    read += len;
+    if (len == 0) {
+      std::this_thread::yield();
+    }
+  }
+  writer.join();
+  EXPECT_EQ(ring.Size(), 0u);
+}
+
+class BtifA2dpSinkRxTimingTest : public ::testing::Test {
+protected:
+  /* Receives the packet |index| of a stream starting at |first_timestamp|,
+   * |late_us| after its due time. */
+  bool Receive(uint16_t index, uint32_t first_timestamp = 0, uint64_t late_us = 0) {
+    return timing_.Update(index, first_timestamp + index * kPacketSamples,
+                          start_us_ + index * kPacketUs + late_us, kSampleRate);
+  }
+
+  A2dpSinkRxTiming timing_;
+  uint64_t start_us_ = 1000000;
+};
+
+TEST_F(BtifA2dpSinkRxTimingTest, regular_stream_has_no_jitter) {
+  for (uint16_t i = 0; i < 50; i++) {
+    EXPECT_TRUE(Receive(i));
+  }
+  EXPECT_LE(timing_.JitterUs(), 1u);
+  EXPECT_EQ(timing_.LatePackets(), 0u);
+  EXPECT_EQ(timing_.LostPackets(), 0u);
+  EXPECT_EQ(timing_.LastTimestamp(), 49 * kPacketSamples);
+}
+
+TEST_F(BtifA2dpSinkRxTimingTest, delayed_packets_raise_the_jitter) {
+  for (uint16_t i = 0; i < 50; i++) {
+    EXPECT_TRUE(Receive(i, 0, (i % 2) * 8000));
+  }
+  EXPECT_GT(timing_.JitterUs(), 4000u);
+}
+
+TEST_F(BtifA2dpSinkRxTimingTest, sequence_number_gaps_count_as_lost) {
+  EXPECT_TRUE(Receive(0));
+  EXPECT_TRUE(Receive(1));
+  EXPECT_TRUE(Receive(4));
+  EXPECT_EQ(timing_.LostPackets(), 2u);
+}
+
+TEST_F(BtifA2dpSinkRxTimingTest, late_packet_keeps_the_baseline) {
+  EXPECT_TRUE(Receive(0));
+  EXPECT_TRUE(Receive(1));
+  EXPECT_TRUE(Receive(2));
+  EXPECT_FALSE(Receive(1));
+  EXPECT_FALSE(Receive(2));
+  EXPECT_EQ(timing_.LatePackets(), 2u);
+  EXPECT_EQ(timing_.LastTimestamp(), 2 * kPacketSamples);
+
+  EXPECT_TRUE(Receive(3));
+  EXPECT_EQ(timing_.LastTimestamp(), 3 * kPacketSamples);
+  EXPECT_EQ(timing_.Resyncs(), 0u);
+}
+
+TEST_F(BtifA2dpSinkRxTimingTest, resyncs_after_a_run_of_late_packets) {
+  // The source restarts its timestamps far behind the last packet
+  for (uint16_t i = 0; i < 10; i++) {
+    EXPECT_TRUE(Receive(i, 1000000));
+  }
+  for (uint16_t i = 0; i < A2dpSinkRxTiming::kMaxLatePacketRun - 1; i++) {
+    EXPECT_FALSE(Receive(10 + i));
+  }
+  EXPECT_TRUE(Receive(10 + A2dpSinkRxTiming::kMaxLatePacketRun - 1));
+  EXPECT_EQ(timing_.Resyncs(), 1u);
+  EXPECT_EQ(timing_.LatePackets(), A2dpSinkRxTiming::kMaxLatePacketRun - 1);
+
+  for (uint16_t i = 10 + A2dpSinkRxTiming::kMaxLatePacketRun; i < 30; i++) {
+    EXPECT_TRUE(Receive(i));
+  }
+  EXPECT_EQ(timing_.Resyncs(), 1u);
+  EXPECT_EQ(timing_.LastTimestamp(), 29 * kPacketSamples);
+}
+
+TEST_F(BtifA2dpSinkRxTimingTest, packet_in_order_ends_the_late_packet_run) {
+  EXPECT_TRUE(Receive(0, 0));
+  EXPECT_TRUE(Receive(100, 0));
+  for (uint16_t round = 0; round < 3; round++) {
+    for (uint16_t i = 0; i < A2dpSinkRxTiming::kMaxLatePacketRun - 1; i++) {
+      EXPECT_FALSE(Receive(1 + i));
+    }
+    EXPECT_TRUE(Receive(101 + round));
+  }
+  EXPECT_EQ(timing_.Resyncs(), 0u);
+}
+
+TEST_F(BtifA2dpSinkRxTimingTest, restart_takes_the_next_packet_as_baseline) {
+  EXPECT_TRUE(Receive(10));
+  timing_.Restart();
+  EXPECT_TRUE(Receive(0));
+  EXPECT_TRUE(Receive(1));
+  EXPECT_EQ(timing_.LatePackets(), 0u);
+  EXPECT_EQ(timing_.LostPackets(), 0u);
+
+  timing_.Reset();
+  EXPECT_EQ(timing_.JitterUs(), 0u);
+  EXPECT_TRUE(Receive(0));
+}
+
+}  // namespace
@@ -16,17 +16,26 @@
 
 #include "btif/include/btif_hh.h"
 
+#include <com_android_bluetooth_flags.h>
+#include <dirent.h>
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <linux/uhid.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <array>
 #include <future>
+#include <string>
 #include <vector>
 
 #include "bta/include/bta_ag_api.h"
 #include "bta/include/bta_hh_api.h"
+#include "bta/include/bta_hh_co.h"
 #include "btcore/include/module.h"
 #include "include/hardware/bt_hh.h"
+#include "osi/include/properties.h"
 #include "test/common/core_interface.h"
 #include "test/common/mock_functions.h"
 
@@ -48,6 +57,9 @@ const tBTA_AG_RES_DATA tBTA_AG_RES_DATA::kEmpty = {};
 const bthh_interface_t* btif_hh_get_interface();
 bt_status_t btif_hh_connect(const tAclLinkSpec& link_spec);
 bt_status_t btif_hh_virtual_unplug(const tAclLinkSpec& link_spec);
+void bta_hh_co_close(btif_hh_device_t* p_dev);
+
+extern const char* dev_path;
 
 namespace bluetooth {
 namespace legacy {
@@ -299,3 +311,127 @@ TEST_F(BtifHHVirtualUnplugTest, test_btif_hh_virtual_unplug_device_not_open) {
   ASSERT_STREQ(kDeviceAddressConnecting.ToString().c_str(), res.raw_address.ToString().c_str());
   ASSERT_EQ(BTHH_CONN_STATE_DISCONNECTED, res.state);
 }
+
+// Devices stand in for uhid with a FIFO each, which reads back what the uhid
+// thread writes to it.
+class BtifHhSharedUhidThreadTest : public BtifHhWithMockTest {
+protected:
+  void SetUp() override {
+    BtifHhWithMockTest::SetUp();
+    com::android::bluetooth::flags::provider_->hid_report_queuing(true);
+    // Read once per process, with the first device opened
+    osi_property_set("persist.bluetooth.hid.shared_uhid_thread", "true");
+    saved_dev_path_ = dev_path;
+    for (btif_hh_device_t& dev : btif_hh_cb.devices) {
+      dev.dev_status = BTHH_CONN_STATE_UNKNOWN;
+      dev.internal_send_fd = -1;
+    }
+  }
+
+  void TearDown() override {
+    for (btif_hh_device_t& dev : btif_hh_cb.devices) {
+      dev.dev_status = BTHH_CONN_STATE_UNKNOWN;
+    }
+    for (int fd : fifo_fds_) {
+      close(fd);
+    }
+    for (const std::string& path : fifo_paths_) {
+      unlink(path.c_str());
+    }
+    dev_path = saved_dev_path_;
+    com::android::bluetooth::flags::provider_->reset_flags();
+    BtifHhWithMockTest::TearDown();
+  }
+
+  // Opens a device on a new FIFO, and returns the fd reading it.
+  int Open(uint8_t handle) {
+    fifo_paths_.push_back(::testing::TempDir() + "uhid_" + std::to_string(getpid()) + "_" +
+                          std::to_string(fifo_paths_.size()));
+    const std::string& path = fifo_paths_.back();
+    unlink(path.c_str());
+    EXPECT_EQ(0, mkfifo(path.c_str(), 0600));
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    EXPECT_GE(fd, 0);
+    fifo_fds_.push_back(fd);
+
+    dev_path = path.c_str();
+    tAclLinkSpec link_spec = {.addrt.type = kDeviceAddrType,
+                              .addrt.bda = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, handle}),
+                              .transport = kDeviceTransport};
+    EXPECT_TRUE(bta_hh_co_open(handle, 0, 0, 0, link_spec));
+    dev_path = saved_dev_path_;
+    return fd;
+  }
+
+  void Close(uint8_t handle) {
+    btif_hh_device_t* p_dev = btif_hh_find_dev_by_handle(handle);
+    ASSERT_NE(nullptr, p_dev);
+    bta_hh_co_close(p_dev);
+    p_dev->dev_status = BTHH_CONN_STATE_UNKNOWN;
+  }
+
+  // Returns whether the device behind |fd| was destroyed, waiting for it if needed.
+  static bool Destroyed(int fd) {
+    for (int i = 0; i < 200; i++) {
+      struct uhid_event ev = {};
+      ssize_t ret = read(fd, &ev, sizeof(ev));
+      if (ret == sizeof(ev)) {
+        return ev.type == UHID_DESTROY;
+      }
+      usleep(10000);
+    }
+    return false;
+  }
+
+  static size_t ThreadCount() {
+    size_t count = 0;
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+      return 0;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') {
+        count++;
+      }
+    }
+    closedir(dir);
+    return count;
+  }
+
+  const char* saved_dev_path_;
+  std::vector<std::string> fifo_paths_;
+  std::vector<int> fifo_fds_;
+};
+
+TEST_F(BtifHhSharedUhidThreadTest, devices_open_and_close_on_one_thread) {
+  int fd1 = Open(1);
+  // Includes the shared uhid thread, and the alarm threads started with the
+  // first device
+  size_t threads = ThreadCount();
+  int fd2 = Open(2);
+  int fd3 = Open(3);
+  ASSERT_EQ(threads, ThreadCount());
+
+  Close(2);
+  ASSERT_TRUE(Destroyed(fd2));
+  ASSERT_EQ(threads, ThreadCount());
+
+  int fd4 = Open(4);
+  Close(1);
+  Close(3);
+  ASSERT_TRUE(Destroyed(fd1));
+  ASSERT_TRUE(Destroyed(fd3));
+  ASSERT_EQ(threads, ThreadCount());
+
+  // The thread is stopped with the last device
+  Close(4);
+  ASSERT_TRUE(Destroyed(fd4));
+  ASSERT_EQ(threads - 1, ThreadCount());
+
+  // and started again with the next one
+  int fd5 = Open(5);
+  ASSERT_EQ(threads, ThreadCount());
+  Close(5);
+  ASSERT_TRUE(Destroyed(fd5));
+  ASSERT_EQ(threads - 1, ThreadCount());
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/functional/bind.h>
+#include <base/location.h>
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "btif/include/btif_jni_batch.h"
+#include "common/message_loop_thread.h"
+
+using ::benchmark::State;
+using bluetooth::btif::JniBatchChannel;
+using bluetooth::btif::JniBatchConfig;
+using bluetooth::common::MessageLoopThread;
+
+namespace {
+
+/* Scan results of a busy environment, in bursts from a number of devices */
+constexpr int kBurstLen = 1024;
+
+/* The settings of the LE scan results channel, see le_scanning_manager.cc,
+ * with a shorter window to keep the benchmark quick. */
+constexpr JniBatchConfig kConfig = {
+        .window = std::chrono::microseconds(100),
+        .max_batch = 32,
+        .max_queued = 256,
+};
+
+struct Event {
+  uint64_t device;
+  int8_t rssi;
+  std::vector<uint8_t> data;
+};
+
+/* Posts bursts of events from state.range(0) devices to a thread standing for
+ * the JNI thread, and waits for their delivery. Reports per event. */
+class BM_JniBatch : public ::benchmark::Fixture {
+public:
+  /* Stands for the callback into the Java layer */
+  void Upcall(const Event& event) {
+    benchmark::DoNotOptimize(event.data.data());
+    benchmark::DoNotOptimize(event.rssi);
+  }
+
+  void OnDelivered(int num_events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    delivered_ += num_events;
+    tasks_++;
+    cv_.notify_one();
+  }
+
+  void WaitDelivered(uint64_t num_events) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return delivered_ >= num_events; });
+  }
+
+protected:
+  void SetUp(State& state) override {
+    ::benchmark::Fixture::SetUp(state);
+    thread_.StartUp();
+    delivered_ = 0;
+    tasks_ = 0;
+  }
+
+  void TearDown(State& state) override {
+    thread_.ShutDown();
+    ::benchmark::Fixture::TearDown(state);
+  }
+
+  Event MakeEvent(int i, int num_devices) {
+    return Event{static_cast<uint64_t>(i % num_devices), static_cast<int8_t>(-(i % 100)),
+                 std::vector<uint8_t>(31, static_cast<uint8_t>(i % num_devices))};
+  }
+
+  void SetCounters(State& state, uint64_t events) {
+    state.SetItemsProcessed(events);
+    state.counters["tasks/event"] = benchmark::Counter(static_cast<double>(tasks_) / events);
+    state.counters["upcalls/s"] = benchmark::Counter(delivered_, benchmark::Counter::kIsRate);
+  }
+
+  MessageLoopThread thread_{"bt_jni_batch_benchmark"};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t delivered_;
+  uint64_t tasks_;
+};
+
+BENCHMARK_DEFINE_F(BM_JniBatch, per_event)(State& state) {
+  const int num_devices = state.range(0);
+  uint64_t events = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < kBurstLen; i++) {
+      thread_.DoInThread(FROM_HERE, base::BindOnce(
+                                            [](BM_JniBatch* self, Event event) {
+                                              self->Upcall(event);
+                                              self->OnDelivered(1);
+                                            },
+                                            base::Unretained(this), MakeEvent(i, num_devices)));
+    }
+    events += kBurstLen;
+    WaitDelivered(events);
+  }
+  SetCounters(state, events);
+}
+
+BENCHMARK_DEFINE_F(BM_JniBatch, batched)(State& state) {
+  const int num_devices = state.range(0);
+  JniBatchChannel<uint64_t, Event> channel(
+          "benchmark", kConfig,
+          [this](std::vector<Event> events) {
+            for (auto& event : events) {
+              Upcall(event);
+            }
+            OnDelivered(events.size());
+          },
+          [](const Event& queued, const Event& event) { return queued.data == event.data; },
+          &thread_);
+
+  uint64_t events = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < kBurstLen; i++) {
+      channel.Post(i % num_devices, MakeEvent(i, num_devices));
+    }
+    events += kBurstLen;
+    auto stats = channel.GetStats();
+    WaitDelivered(stats.events - stats.coalesced - stats.dropped);
+  }
+  SetCounters(state, events);
+  auto stats = channel.GetStats();
+  state.counters["coalesced/event"] =
+          benchmark::Counter(static_cast<double>(stats.coalesced) / stats.events);
+  state.counters["dropped/event"] =
+          benchmark::Counter(static_cast<double>(stats.dropped) / stats.events);
+  thread_.ShutDown();
+}
+
+BENCHMARK_REGISTER_F(BM_JniBatch, per_event)->Arg(8)->Arg(64)->Arg(256)->UseRealTime();
+BENCHMARK_REGISTER_F(BM_JniBatch, batched)->Arg(8)->Arg(64)->Arg(256)->UseRealTime();
+
+}  // namespace
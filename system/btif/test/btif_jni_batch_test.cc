@@ -0,0 +1,182 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif/include/btif_jni_batch.h"
+
+#include <base/functional/bind.h>
+#include <base/location.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "common/message_loop_thread.h"
+
+using bluetooth::btif::JniBatchChannel;
+using bluetooth::btif::JniBatchConfig;
+using bluetooth::common::MessageLoopThread;
+
+namespace {
+
+using Channel = JniBatchChannel<int, int>;
+
+/* Window long enough never to elapse during a test */
+constexpr std::chrono::seconds kLongWindow(60);
+
+class BtifJniBatchTest : public ::testing::Test {
+protected:
+  void SetUp() override { thread_.StartUp(); }
+
+  void TearDown() override {
+    thread_.ShutDown();
+    channel_.reset();
+  }
+
+  void CreateChannel(JniBatchConfig config, Channel::SupersedesCallback supersedes = nullptr) {
+    channel_ = std::make_unique<Channel>(
+            "test", config,
+            [this](std::vector<int> events) {
+              batches_.push_back(std::move(events));
+              if (delivered_ != nullptr) {
+                delivered_->set_value();
+                delivered_ = nullptr;
+              }
+            },
+            std::move(supersedes), &thread_);
+  }
+
+  /* Holds the thread until the returned promise is set, so that the events
+   * posted meanwhile are all queued before any delivery. */
+  std::promise<void> BlockThread() {
+    std::promise<void> release;
+    thread_.DoInThread(FROM_HERE,
+                       base::BindOnce([](std::shared_future<void> released) { released.wait(); },
+                                      release.get_future().share()));
+    return release;
+  }
+
+  /* Waits for the tasks posted so far to run */
+  void Sync() {
+    std::promise<void> done;
+    auto future = done.get_future();
+    thread_.DoInThread(FROM_HERE, base::BindOnce([](std::promise<void> done) { done.set_value(); },
+                                                 std::move(done)));
+    future.wait();
+  }
+
+  MessageLoopThread thread_{"bt_jni_batch_test"};
+  std::unique_ptr<Channel> channel_;
+  std::vector<std::vector<int>> batches_;
+  std::promise<void>* delivered_ = nullptr;
+};
+
+TEST_F(BtifJniBatchTest, DeliversOneBatchAfterWindow) {
+  CreateChannel({.window = std::chrono::milliseconds(20), .max_batch = 32, .max_queued = 32});
+  std::promise<void> delivered;
+  auto future = delivered.get_future();
+  delivered_ = &delivered;
+
+  for (int i = 0; i < 3; i++) {
+    channel_->Post(i, i);
+  }
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+  ASSERT_EQ(batches_, (std::vector<std::vector<int>>{{0, 1, 2}}));
+  auto stats = channel_->GetStats();
+  ASSERT_EQ(stats.events, 3u);
+  ASSERT_EQ(stats.batches, 1u);
+  ASSERT_EQ(stats.max_batch_len, 3u);
+}
+
+TEST_F(BtifJniBatchTest, DeliversFullBatchWithoutWaiting) {
+  CreateChannel({.window = kLongWindow, .max_batch = 2, .max_queued = 32});
+  auto release = BlockThread();
+
+  channel_->Post(0, 0);
+  channel_->Post(1, 1);
+  release.set_value();
+  Sync();
+
+  ASSERT_EQ(batches_, (std::vector<std::vector<int>>{{0, 1}}));
+}
+
+TEST_F(BtifJniBatchTest, CoalescesQueuedEventOfSameKey) {
+  CreateChannel({.window = kLongWindow, .max_batch = 3, .max_queued = 32});
+  auto release = BlockThread();
+
+  channel_->Post(1, 10);
+  channel_->Post(2, 20);
+  // Replaces the first event, keeping its place in the batch
+  channel_->Post(1, 11);
+  channel_->Post(3, 30);
+  release.set_value();
+  Sync();
+
+  ASSERT_EQ(batches_, (std::vector<std::vector<int>>{{11, 20, 30}}));
+  auto stats = channel_->GetStats();
+  ASSERT_EQ(stats.events, 4u);
+  ASSERT_EQ(stats.coalesced, 1u);
+}
+
+TEST_F(BtifJniBatchTest, KeepsEventsNotSuperseded) {
+  // Events only supersede the ones of the same parity
+  CreateChannel({.window = kLongWindow, .max_batch = 3, .max_queued = 32},
+                [](const int& queued, const int& event) { return queued % 2 == event % 2; });
+  auto release = BlockThread();
+
+  channel_->Post(1, 10);
+  channel_->Post(1, 11);
+  // Replaces the last event queued with the key
+  channel_->Post(1, 13);
+  channel_->Post(2, 20);
+  release.set_value();
+  Sync();
+
+  ASSERT_EQ(batches_, (std::vector<std::vector<int>>{{10, 13, 20}}));
+  ASSERT_EQ(channel_->GetStats().coalesced, 1u);
+}
+
+TEST_F(BtifJniBatchTest, DropsEventsPastMaxQueued) {
+  CreateChannel({.window = kLongWindow, .max_batch = 2, .max_queued = 2});
+  auto release = BlockThread();
+
+  channel_->Post(0, 0);
+  channel_->Post(1, 1);
+  channel_->Post(2, 2);
+  channel_->Post(3, 3);
+  // Coalescing still applies to the queued events
+  channel_->Post(1, 11);
+  release.set_value();
+  Sync();
+
+  ASSERT_EQ(batches_, (std::vector<std::vector<int>>{{0, 11}}));
+  auto stats = channel_->GetStats();
+  ASSERT_EQ(stats.events, 5u);
+  ASSERT_EQ(stats.dropped, 2u);
+  ASSERT_EQ(stats.coalesced, 1u);
+
+  // Events are queued again once the batch is delivered
+  release = BlockThread();
+  channel_->Post(2, 2);
+  channel_->Post(3, 3);
+  release.set_value();
+  Sync();
+  ASSERT_EQ(batches_.back(), (std::vector<int>{2, 3}));
+}
+
+}  // namespace
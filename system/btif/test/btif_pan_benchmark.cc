@@ -0,0 +1,166 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <linux/if_ether.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "bta/include/bta_pan_api.h"
+#include "btif/include/btif_common.h"
+#include "btif/include/btif_pan_internal.h"
+#include "btif/include/btif_sock_thread.h"
+#include "osi/include/allocator.h"
+#include "stack/include/bt_hdr.h"
+#include "test/common/main_handler.h"
+#include "test/mock/mock_stack_pan_api.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+
+int btif_is_enabled(void) { return 1; }
+bt_status_t btif_transfer_context(tBTIF_CBACK* /* p_cback */, uint16_t /* event */,
+                                  char* /* p_params */, int /* param_len */,
+                                  tBTIF_COPY_CBACK* /* p_copy_cback */) {
+  return BT_STATUS_SUCCESS;
+}
+
+namespace {
+
+constexpr int kFramesPerIteration = 64;
+
+std::mutex forwarded_mutex;
+std::condition_variable forwarded_cv;
+int forwarded_count = 0;
+
+void WriteFrame(int fd, std::vector<uint8_t>& frame) {
+  // broadcast IPv4 frames, forwarded to the first connection
+  memset(frame.data(), 0xff, 6);
+  memset(frame.data() + 6, 0x02, 6);
+  frame[12] = ETH_P_IP >> 8;
+  frame[13] = ETH_P_IP & 0xff;
+  ::benchmark::DoNotOptimize(write(fd, frame.data(), frame.size()));
+}
+
+/* A SOCK_SEQPACKET socketpair stands in for the TAP device, it also keeps one
+ * Ethernet frame per read() and write(). fds_[0] is the end owned by PAN. */
+class BM_BtifPanTap : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& state) override {
+    main_thread_start_up();
+    btsock_thread_init();
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds_.data()) < 0) {
+      fds_ = {-1, -1};
+      return;
+    }
+    int flags = fcntl(fds_[0], F_GETFL, 0);
+    fcntl(fds_[0], F_SETFL, flags | O_NONBLOCK);
+
+    forwarded_count = 0;
+    test::mock::stack_pan_api::PAN_WriteBuf.body =
+            [](uint16_t /* handle */, const RawAddress& /* dst */, const RawAddress& /* src */,
+               uint16_t /* protocol */, BT_HDR* p_buf, bool /* ext */) {
+              osi_free(p_buf);
+              std::lock_guard<std::mutex> lock(forwarded_mutex);
+              forwarded_count++;
+              forwarded_cv.notify_one();
+              return PAN_SUCCESS;
+            };
+
+    for (btpan_conn_t& conn : btpan_cb.conns) {
+      conn.handle = -1;
+    }
+    btpan_cb.conns[0].handle = 1;
+    btpan_cb.conns[0].state = PAN_STATE_OPEN;
+    btpan_cb.tap_fd = fds_[0];
+    btpan_cb.flow = 1;
+    btpan_cb.congest_packet_size = 0;
+    create_tap_read_thread(fds_[0]);
+  }
+
+  void TearDown(State& state) override {
+    destroy_tap_read_thread();
+    main_thread_shut_down();
+    btpan_cb.tap_fd = INVALID_FD;
+    btpan_cb.conns[0].handle = -1;
+    test::mock::stack_pan_api::PAN_WriteBuf = {};
+    for (int fd : fds_) {
+      if (fd != -1) {
+        close(fd);
+      }
+    }
+    ::benchmark::Fixture::TearDown(state);
+  }
+
+  std::array<int, 2> fds_ = {-1, -1};
+};
+
+}  // namespace
+
+/* Frames written by the network stack to the TAP device, forwarded to PAN by
+ * the main thread. state.range(0) is the Ethernet frame size. */
+BENCHMARK_DEFINE_F(BM_BtifPanTap, tap_to_bnep)(State& state) {
+  if (fds_[0] == -1) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  std::vector<uint8_t> frame(state.range(0));
+  for (auto _ : state) {
+    for (int i = 0; i < kFramesPerIteration; i++) {
+      WriteFrame(fds_[1], frame);
+    }
+    std::unique_lock<std::mutex> lock(forwarded_mutex);
+    forwarded_cv.wait(lock, [] { return forwarded_count >= kFramesPerIteration; });
+    forwarded_count -= kFramesPerIteration;
+  }
+  state.SetItemsProcessed(state.iterations() * kFramesPerIteration);
+  state.SetBytesProcessed(state.iterations() * kFramesPerIteration * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(BM_BtifPanTap, tap_to_bnep)->Arg(100)->Arg(1514)->UseRealTime();
+
+/* Frames received from BNEP, written to the TAP device and read back by the
+ * network stack. state.range(0) is the Ethernet frame size. */
+BENCHMARK_DEFINE_F(BM_BtifPanTap, bnep_to_tap)(State& state) {
+  if (fds_[0] == -1) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  const RawAddress src = RawAddress::kEmpty;
+  std::vector<char> payload(state.range(0) - sizeof(tETH_HDR));
+  std::vector<char> frame(state.range(0));
+  for (auto _ : state) {
+    for (int i = 0; i < kFramesPerIteration; i++) {
+      btpan_tap_send(fds_[0], src, RawAddress::kAny, ETH_P_IP, payload.data(), payload.size(),
+                     false, false);
+    }
+    for (int i = 0; i < kFramesPerIteration; i++) {
+      ::benchmark::DoNotOptimize(read(fds_[1], frame.data(), frame.size()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFramesPerIteration);
+  state.SetBytesProcessed(state.iterations() * kFramesPerIteration * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(BM_BtifPanTap, bnep_to_tap)->Arg(100)->Arg(1514)->UseRealTime();
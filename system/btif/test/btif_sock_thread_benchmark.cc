@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "btif/include/btif_sock_thread.h"
+
+using ::benchmark::State;
+
+namespace {
+
+std::mutex signaled_mutex;
+std::condition_variable signaled_cv;
+int signaled_count = 0;
+
+/* Consumes the byte written by the benchmark and watches the fd again through
+ * the command socket, the way the RFCOMM and L2CAP sockets re-arm after each
+ * read. */
+void on_signaled(int fd, int /* type */, int flags, uint32_t user_id) {
+  if (flags & SOCK_THREAD_FD_RD) {
+    char byte;
+    if (read(fd, &byte, 1) == 1) {
+      btsock_thread_add_fd(user_id, fd, 0, SOCK_THREAD_FD_RD, user_id);
+    }
+  }
+  std::lock_guard<std::mutex> lock(signaled_mutex);
+  signaled_count++;
+  signaled_cv.notify_one();
+}
+
+void WaitSignaled(int count) {
+  std::unique_lock<std::mutex> lock(signaled_mutex);
+  signaled_cv.wait(lock, [count] { return signaled_count >= count; });
+  signaled_count -= count;
+}
+
+/* A poll thread watching state.range(0) connected sockets. */
+class BM_BtsockThread : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& state) override {
+    btsock_thread_init();
+    handle_ = btsock_thread_create(on_signaled, nullptr);
+    signaled_count = 0;
+    for (int i = 0; i < state.range(0); i++) {
+      std::array<int, 2> fds;
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) < 0) {
+        break;
+      }
+      pairs_.push_back(fds);
+      // the user id of the fds is the thread handle, for the callback
+      btsock_thread_add_fd(handle_, fds[0], 0, SOCK_THREAD_FD_RD, handle_);
+    }
+  }
+
+  void TearDown(State& state) override {
+    btsock_thread_exit(handle_);
+    for (const std::array<int, 2>& fds : pairs_) {
+      close(fds[0]);
+      close(fds[1]);
+    }
+    pairs_.clear();
+    ::benchmark::Fixture::TearDown(state);
+  }
+
+  int handle_ = -1;
+  std::vector<std::array<int, 2>> pairs_;
+};
+
+}  // namespace
+
+/* One socket becomes readable per wakeup, among state.range(0) idle ones.
+ * Items are socket events. */
+BENCHMARK_DEFINE_F(BM_BtsockThread, single_ready)(State& state) {
+  if (pairs_.size() != (size_t)state.range(0)) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<size_t> dist(0, pairs_.size() - 1);
+  char byte = 0;
+  for (auto _ : state) {
+    if (write(pairs_[dist(gen)][1], &byte, 1) != 1) {
+      state.SkipWithError("write failed");
+      break;
+    }
+    WaitSignaled(1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(BM_BtsockThread, single_ready)
+        ->RangeMultiplier(4)
+        ->Range(4, 256)
+        ->UseRealTime();
+
+/* All the sockets become readable at once, and are handled in as few wakeups
+ * as the poll thread needs. Items are socket events. */
+BENCHMARK_DEFINE_F(BM_BtsockThread, all_ready)(State& state) {
+  if (pairs_.size() != (size_t)state.range(0)) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  char byte = 0;
+  for (auto _ : state) {
+    for (const std::array<int, 2>& fds : pairs_) {
+      if (write(fds[1], &byte, 1) != 1) {
+        state.SkipWithError("write failed");
+        return;
+      }
+    }
+    WaitSignaled(pairs_.size());
+  }
+  state.SetItemsProcessed(state.iterations() * pairs_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_BtsockThread, all_ready)
+        ->RangeMultiplier(4)
+        ->Range(4, 256)
+        ->UseRealTime();
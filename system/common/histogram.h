@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+/**
+ * Counts samples in buckets bounded by increasing upper limits. The last
+ * bucket counts the samples above the last limit.
+ */
+class Histogram {
+public:
+  explicit Histogram(std::vector<uint64_t> upper_limits)
+      : upper_limits_(std::move(upper_limits)), counts_(upper_limits_.size() + 1) {}
+  void Reset() { std::fill(counts_.begin(), counts_.end(), 0); }
+
+  void Add(uint64_t value) {
+    counts_[std::lower_bound(upper_limits_.begin(), upper_limits_.end(), value) -
+            upper_limits_.begin()]++;
+  }
+
+  void Accumulate(const Histogram& other) {
+    for (size_t i = 0; i < counts_.size(); i++) {
+      counts_[i] += other.counts_[i];
+    }
+  }
+
+  // Number of samples in |bucket|, the last bucket being above the last limit
+  size_t Count(size_t bucket) const { return counts_[bucket]; }
+
+  void Dump(int fd, const char* title) const {
+    dprintf(fd, "  %-56s:", title);
+    for (size_t i = 0; i < upper_limits_.size(); i++) {
+      dprintf(fd, " <=%llu: %zu", (unsigned long long)upper_limits_[i], counts_[i]);
+    }
+    dprintf(fd, " >%llu: %zu\n", (unsigned long long)upper_limits_.back(), counts_.back());
+  }
+
+private:
+  std::vector<uint64_t> upper_limits_;
+  std::vector<size_t> counts_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
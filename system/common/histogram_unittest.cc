@@ -0,0 +1,61 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/histogram.h"
+
+#include <gtest/gtest.h>
+
+using bluetooth::common::Histogram;
+
+TEST(HistogramTest, add_counts_in_bucket_of_upper_limit) {
+  Histogram histogram({0, 1, 2, 4});
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(3);
+  histogram.Add(4);
+  ASSERT_EQ(1u, histogram.Count(0));
+  ASSERT_EQ(1u, histogram.Count(1));
+  ASSERT_EQ(0u, histogram.Count(2));
+  ASSERT_EQ(2u, histogram.Count(3));
+  ASSERT_EQ(0u, histogram.Count(4));
+}
+
+TEST(HistogramTest, add_above_last_limit_counts_in_last_bucket) {
+  Histogram histogram({250, 500});
+  histogram.Add(501);
+  histogram.Add(UINT64_MAX);
+  ASSERT_EQ(0u, histogram.Count(0));
+  ASSERT_EQ(0u, histogram.Count(1));
+  ASSERT_EQ(2u, histogram.Count(2));
+}
+
+TEST(HistogramTest, accumulate_and_reset) {
+  Histogram session({250, 500});
+  Histogram total({250, 500});
+  session.Add(100);
+  session.Add(1000);
+  total.Accumulate(session);
+  total.Accumulate(session);
+  ASSERT_EQ(2u, total.Count(0));
+  ASSERT_EQ(0u, total.Count(1));
+  ASSERT_EQ(2u, total.Count(2));
+
+  session.Reset();
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_EQ(0u, session.Count(i));
+  }
+  ASSERT_EQ(2u, total.Count(0));
+}
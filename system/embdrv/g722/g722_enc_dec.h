@@ -105,6 +105,39 @@ typedef struct {
   int out_bits;
 } g722_encode_state_t;
 
+/*! Number of channels of the stereo encoder */
+#define G722_STEREO_CHANNELS 2
+
+/*! Band state of the stereo encoder, each field holds one value per channel
+    so that both channels are processed side by side. */
+typedef struct {
+  int s[G722_STEREO_CHANNELS];
+  int sp[G722_STEREO_CHANNELS];
+  int sz[G722_STEREO_CHANNELS];
+  int r[3][G722_STEREO_CHANNELS];
+  int a[3][G722_STEREO_CHANNELS];
+  int ap[3][G722_STEREO_CHANNELS];
+  int p[3][G722_STEREO_CHANNELS];
+  int d[7][G722_STEREO_CHANNELS];
+  int b[7][G722_STEREO_CHANNELS];
+  int bp[7][G722_STEREO_CHANNELS];
+  int nb[G722_STEREO_CHANNELS];
+  int det[G722_STEREO_CHANNELS];
+} g722_band_stereo_t;
+
+typedef struct {
+  /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
+  int bits_per_sample;
+
+  /*! Signal history for the QMF, split in even and odd samples. Each history
+      is stored twice, the last 12 samples start at `qmf_pos`. */
+  int16_t x_even[G722_STEREO_CHANNELS][24];
+  int16_t x_odd[G722_STEREO_CHANNELS][24];
+  int qmf_pos;
+
+  g722_band_stereo_t band[2];
+} g722_encode_stereo_state_t;
+
 typedef struct {
   /*! TRUE if the operating in the special ITU test mode, with the band split filters disabled. */
   int itu_test_mode;
@@ -136,6 +169,14 @@ g722_encode_state_t *g722_encode_init(g722_encode_state_t *s, unsigned int rate,
 int g722_encode_release(g722_encode_state_t *s);
 int g722_encode(g722_encode_state_t *s, uint8_t g722_data[], const int16_t amp[], int len);
 
+/* Encodes two channels in one pass, the output of each channel is the same as
+   g722_encode() with its own state. Returns the number of bytes per channel. */
+g722_encode_stereo_state_t *g722_encode_stereo_init(g722_encode_stereo_state_t *s,
+                                                    unsigned int rate, int options);
+int g722_encode_stereo_release(g722_encode_stereo_state_t *s);
+int g722_encode_stereo(g722_encode_stereo_state_t *s, uint8_t g722_left[], uint8_t g722_right[],
+                       const int16_t amp_left[], const int16_t amp_right[], int len);
+
 g722_decode_state_t *g722_decode_init(g722_decode_state_t *s, unsigned int rate, int options);
 int g722_decode_release(g722_decode_state_t *s);
 uint32_t g722_decode(g722_decode_state_t *s, int16_t amp[], const uint8_t g722_data[], int len,
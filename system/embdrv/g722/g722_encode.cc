@@ -64,6 +64,13 @@ static __inline int16_t saturate(int32_t val) {
 #endif
 /*- End of function --------------------------------------------------------*/
 
+/* Branchless form of saturate() for the per-channel loops of the stereo
+ * encoder, which lets the compiler process both channels in one vector. */
+static __inline int saturate_lanes(int amp) {
+  return amp < -32768 ? -32768 : (amp > 32767 ? 32767 : amp);
+}
+/*- End of function --------------------------------------------------------*/
+
 static void block4(g722_band_t *band, int d) {
   int wd1;
   int wd2;
@@ -385,4 +392,292 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[], const int16_t amp[]
   return g722_bytes;
 }
 /*- End of function --------------------------------------------------------*/
+
+/* The stereo encoder runs the same algorithm over both channels side by side:
+   the band state is laid out as struct of arrays, and each block loops over
+   the channels so that the compiler can vectorize them. */
+
+static void block4_stereo(g722_band_stereo_t *band, const int d[G722_STEREO_CHANNELS]) {
+  int wd1;
+  int wd2;
+  int wd3;
+  int i;
+  int c;
+  int sg0[G722_STEREO_CHANNELS];
+  int ap1, ap2;
+  int sz[G722_STEREO_CHANNELS];
+
+  for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+    /* Block 4, RECONS */
+    band->d[0][c] = d[c];
+    band->r[0][c] = saturate_lanes(band->s[c] + d[c]);
+
+    /* Block 4, PARREC */
+    band->p[0][c] = saturate_lanes(band->sz[c] + d[c]);
+  }
+
+  for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+    int sg1 = band->p[1][c] >> 15;
+    int sg2 = band->p[2][c] >> 15;
+
+    sg0[c] = band->p[0][c] >> 15;
+
+    /* Block 4, UPPOL2 */
+    wd1 = saturate_lanes(band->a[1][c] << 2);
+
+    wd2 = (sg0[c] == sg1) ? -wd1 : wd1;
+    if (wd2 > 32767) {
+      wd2 = 32767;
+    }
+
+    ap2 = (wd2 >> 7) + ((sg0[c] == sg2) ? 128 : -128);
+    ap2 += (band->a[2][c] * 32512) >> 15;
+    if (ap2 > 12288) {
+      ap2 = 12288;
+    } else if (ap2 < -12288) {
+      ap2 = -12288;
+    }
+    band->ap[2][c] = ap2;
+
+    /* Block 4, UPPOL1 */
+    wd1 = (sg0[c] == sg1) ? 192 : -192;
+    wd2 = (band->a[1][c] * 32640) >> 15;
+
+    ap1 = saturate_lanes(wd1 + wd2);
+    wd3 = saturate_lanes(15360 - ap2);
+    if (ap1 > wd3) {
+      ap1 = wd3;
+    } else if (ap1 < -wd3) {
+      ap1 = -wd3;
+    }
+    band->ap[1][c] = ap1;
+  }
+
+  /* Block 4, UPZERO */
+  /* Block 4, FILTEZ */
+  for (i = 1; i < 7; i++) {
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+      wd1 = (d[c] == 0) ? 0 : 128;
+      wd2 = ((band->d[i][c] >> 15) == (d[c] >> 15)) ? wd1 : -wd1;
+      wd3 = (band->b[i][c] * 32640) >> 15;
+      band->bp[i][c] = saturate_lanes(wd2 + wd3);
+    }
+  }
+
+  /* Block 4, DELAYA */
+  for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+    sz[c] = 0;
+  }
+  for (i = 6; i > 0; i--) {
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+      band->d[i][c] = band->d[i - 1][c];
+      band->b[i][c] = band->bp[i][c];
+      wd1 = saturate_lanes(band->d[i][c] + band->d[i][c]);
+      sz[c] += (band->b[i][c] * wd1) >> 15;
+    }
+  }
+
+  for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+    band->sz[c] = sz[c];
+
+    for (i = 2; i > 0; i--) {
+      band->r[i][c] = band->r[i - 1][c];
+      band->p[i][c] = band->p[i - 1][c];
+      band->a[i][c] = band->ap[i][c];
+    }
+
+    /* Block 4, FILTEP */
+    wd1 = saturate_lanes(band->r[1][c] + band->r[1][c]);
+    wd1 = (band->a[1][c] * wd1) >> 15;
+    wd2 = saturate_lanes(band->r[2][c] + band->r[2][c]);
+    wd2 = (band->a[2][c] * wd2) >> 15;
+    band->sp[c] = saturate_lanes(wd1 + wd2);
+
+    /* Block 4, PREDIC */
+    band->s[c] = saturate_lanes(band->sp[c] + band->sz[c]);
+  }
+}
+/*- End of function --------------------------------------------------------*/
+
+g722_encode_stereo_state_t *g722_encode_stereo_init(g722_encode_stereo_state_t *s,
+                                                    unsigned int rate, int options) {
+  int c;
+
+  if (s == NULL) {
+#ifdef G722_SUPPORT_MALLOC
+    if ((s = (g722_encode_stereo_state_t *)malloc(sizeof(*s))) == NULL)
+#endif
+      return NULL;
+  }
+  memset(s, 0, sizeof(*s));
+  if (rate == 48000) {
+    s->bits_per_sample = 6;
+  } else if (rate == 56000) {
+    s->bits_per_sample = 7;
+  } else {
+    s->bits_per_sample = 8;
+  }
+  for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+    s->band[0].det[c] = 32;
+    s->band[1].det[c] = 8;
+  }
+  return s;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode_stereo_release(g722_encode_stereo_state_t *s) {
+  free(s);
+  return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode_stereo(g722_encode_stereo_state_t *s, uint8_t g722_left[], uint8_t g722_right[],
+                       const int16_t amp_left[], const int16_t amp_right[], int len) {
+  const int16_t *amp[G722_STEREO_CHANNELS] = {amp_left, amp_right};
+  uint8_t *g722_data[G722_STEREO_CHANNELS] = {g722_left, g722_right};
+  g722_band_stereo_t *low = &s->band[0];
+  g722_band_stereo_t *high = &s->band[1];
+  int el;
+  int eh;
+  int wd;
+  int wd1;
+  int wd2;
+  int wd3;
+  int ril;
+  int il4;
+  int ih2;
+  int mih;
+  int nb;
+  int i;
+  int j;
+  int c;
+  int pos;
+  /* Low and high band PCM from the QMF */
+  int xlow[G722_STEREO_CHANNELS];
+  int xhigh[G722_STEREO_CHANNELS];
+  int dlow[G722_STEREO_CHANNELS];
+  int dhigh[G722_STEREO_CHANNELS];
+  int ilow[G722_STEREO_CHANNELS];
+  int ihigh[G722_STEREO_CHANNELS];
+  int g722_bytes;
+
+  g722_bytes = 0;
+  for (j = 0; j + 1 < len; j += 2) {
+    /* Apply the transmit QMF, the histories are stored twice so the last 12
+       samples are contiguous, without shuffling the buffer down */
+    pos = s->qmf_pos;
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+      s->x_even[c][pos] = s->x_even[c][pos + 12] = amp[c][j];
+      s->x_odd[c][pos] = s->x_odd[c][pos + 12] = amp[c][j + 1];
+    }
+    pos = (pos + 1) % 12;
+    s->qmf_pos = pos;
+
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+      /* Even and odd tap accumulators */
+      int sumeven = 0;
+      int sumodd = 0;
+
+      /* Discard every other QMF output */
+      for (i = 0; i < 12; i++) {
+        sumodd += s->x_even[c][pos + i] * qmf_coeffs[i];
+        sumeven += s->x_odd[c][pos + i] * qmf_coeffs[11 - i];
+      }
+      xlow[c] = (sumeven + sumodd) >> 14;
+      xhigh[c] = (sumeven - sumodd) >> 14;
+
+#ifdef RUN_LIKE_REFERENCE_G722
+      xlow[c] = limitValues(xlow[c]);
+      xhigh[c] = limitValues(xhigh[c]);
+#endif
+    }
+
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+      /* Block 1L, SUBTRA */
+      el = saturate_lanes(xlow[c] - low->s[c]);
+
+      /* Block 1L, QUANTL */
+      /* The decision levels grow with i, the level reached is one plus the
+         number of levels not above wd */
+      wd = (el >= 0) ? el : -(el + 1);
+
+      wd1 = 1;
+      for (i = 1; i < 30; i++) {
+        wd1 += (wd >= ((q6[i] * low->det[c]) >> 12));
+      }
+      ilow[c] = (el < 0) ? iln[wd1] : ilp[wd1];
+
+      /* Block 2L, INVQAL */
+      ril = ilow[c] >> 2;
+      wd2 = qm4[ril];
+      dlow[c] = (low->det[c] * wd2) >> 15;
+
+      /* Block 3L, LOGSCL */
+      il4 = rl42[ril];
+      wd = (low->nb[c] * 127) >> 7;
+      nb = wd + wl[il4];
+      if (nb < 0) {
+        nb = 0;
+      } else if (nb > 18432) {
+        nb = 18432;
+      }
+      low->nb[c] = nb;
+
+      /* Block 3L, SCALEL */
+      wd1 = (nb >> 6) & 31;
+      wd2 = 8 - (nb >> 11);
+      wd3 = (wd2 < 0) ? (ilb[wd1] << -wd2) : (ilb[wd1] >> wd2);
+      low->det[c] = wd3 << 2;
+    }
+
+    block4_stereo(low, dlow);
+
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+      /* Block 1H, SUBTRA */
+      eh = saturate_lanes(xhigh[c] - high->s[c]);
+
+      /* Block 1H, QUANTH */
+      wd = (eh >= 0) ? eh : -(eh + 1);
+      wd1 = (564 * high->det[c]) >> 12;
+      mih = (wd >= wd1) ? 2 : 1;
+      ihigh[c] = (eh < 0) ? ihn[mih] : ihp[mih];
+
+      /* Block 2H, INVQAH */
+      wd2 = qm2[ihigh[c]];
+      dhigh[c] = (high->det[c] * wd2) >> 15;
+
+      /* Block 3H, LOGSCH */
+      ih2 = rh2[ihigh[c]];
+      wd = (high->nb[c] * 127) >> 7;
+      nb = wd + wh[ih2];
+      if (nb < 0) {
+        nb = 0;
+      } else if (nb > 22528) {
+        nb = 22528;
+      }
+      high->nb[c] = nb;
+
+      /* Block 3H, SCALEH */
+      wd1 = (nb >> 6) & 31;
+      wd2 = 10 - (nb >> 11);
+      wd3 = (wd2 < 0) ? (ilb[wd1] << -wd2) : (ilb[wd1] >> wd2);
+      high->det[c] = wd3 << 2;
+    }
+
+    block4_stereo(high, dhigh);
+
+    for (c = 0; c < G722_STEREO_CHANNELS; c++) {
+#if BITS_PER_SAMPLE == 8
+      g722_data[c][g722_bytes] = (uint8_t)((ihigh[c] << 6) | ilow[c]);
+#elif BITS_PER_SAMPLE == 7
+      g722_data[c][g722_bytes] = (uint8_t)(((ihigh[c] << 6) | ilow[c]) >> 1);
+#elif BITS_PER_SAMPLE == 6
+      g722_data[c][g722_bytes] = (uint8_t)(((ihigh[c] << 6) | ilow[c]) >> 2);
+#endif
+    }
+    g722_bytes++;
+  }
+  return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
 /*- End of file ------------------------------------------------------------*/
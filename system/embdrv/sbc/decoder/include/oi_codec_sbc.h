@@ -150,6 +150,17 @@ Declarations of codec functions, data types, and macros.
 #define SBC_SNR 1
 /**@}*/
 
+/**@name Synthesis filterbank implementations */
+/**@{*/
+typedef enum {
+  OI_SBC_SYNTH_IMPL_AUTO = 0, /**< Best implementation for the running CPU */
+  OI_SBC_SYNTH_IMPL_SCALAR,   /**< Portable C implementation */
+  OI_SBC_SYNTH_IMPL_SSE41,    /**< x86 SSE4.1, selected when the CPU supports it */
+  OI_SBC_SYNTH_IMPL_AVX2,     /**< x86 AVX2, selected when the CPU supports it */
+  OI_SBC_SYNTH_IMPL_NEON,     /**< ARM NEON, available on NEON builds */
+} OI_SBC_SYNTH_IMPL;
+/**@}*/
+
 /**
 @}
 
@@ -467,6 +478,26 @@ uint32_t OI_CODEC_SBC_CalculateBitrate(OI_CODEC_SBC_FRAME_INFO* frame);
   */
 uint16_t OI_CODEC_SBC_CalculatePcmBytes(OI_CODEC_SBC_COMMON_CONTEXT* common);
 
+/**
+ * Force the implementation of the synthesis filterbank used by all decoder
+ * contexts. Every implementation produces bit-exact output.
+ *
+ * @param impl      One of the OI_SBC_SYNTH_IMPL values. OI_SBC_SYNTH_IMPL_AUTO
+ *                  selects the fastest implementation for the running CPU.
+ *
+ * @return TRUE if the implementation was selected, FALSE if it is not
+ *         supported by this build or CPU. The current implementation is then
+ *         kept.
+ */
+OI_BOOL OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL impl);
+
+/**
+ * Get the implementation of the synthesis filterbank in use.
+ *
+ * @return the selected implementation, never OI_SBC_SYNTH_IMPL_AUTO
+ */
+OI_SBC_SYNTH_IMPL OI_CODEC_SBC_GetSynthImpl(void);
+
 /**
  * Get the codec version text.
  *
@@ -126,6 +126,22 @@ typedef struct {
 
 #define DCT_SHIFT 15
 
+#define AAN_C4_FIX (759250125) /* S1.30  759250125   0.707107*/
+
+#define AAN_C6_FIX (410903207) /* S1.30  410903207   0.382683*/
+
+#define AAN_Q0_FIX (581104888) /* S1.30  581104888   0.541196*/
+
+#define AAN_Q1_FIX (1402911301) /* S1.30 1402911301   1.306563*/
+
+#define DCTII_4_K06_FIX (11585) /* S1.14      11585   0.707107*/
+
+#define DCTII_4_K08_FIX (21407) /* S1.14      21407   1.306563*/
+
+#define DCTII_4_K09_FIX (-15137) /* S1.14     -15137  -0.923880*/
+
+#define DCTII_4_K10_FIX (-8867) /* S1.14      -8867  -0.541196*/
+
 #define DCTIII_4_SHIFT_IN 2
 #define DCTIII_4_SHIFT_OUT 15
 
@@ -172,7 +188,8 @@ PRIVATE uint8_t OI_SBC_CalculateChecksum(OI_CODEC_SBC_FRAME_INFO* frame, OI_BYTE
 /* Transform functions */
 PRIVATE void shift_buffer(SBC_BUFFER_T* dest, SBC_BUFFER_T* src, OI_UINT wordCount);
 PRIVATE void cosineModulateSynth4(SBC_BUFFER_T* RESTRICT out, int32_t const* RESTRICT in);
-PRIVATE void SynthWindow40_int32_int32_symmetry_with_sum(int16_t* pcm, SBC_BUFFER_T buffer[80],
+PRIVATE void SynthWindow40_int32_int32_symmetry_with_sum(int16_t* pcm,
+                                                         SBC_BUFFER_T const buffer[80],
                                                          OI_UINT strideShift);
 
 INLINE void dct3_4(int32_t* RESTRICT out, int32_t const* RESTRICT in);
@@ -0,0 +1,199 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef _OI_CODEC_SBC_SIMD_H
+#define _OI_CODEC_SBC_SIMD_H
+
+/**
+@file
+Vectorized kernels for the synthesis filterbank (matrixing and windowing).
+
+Every kernel is bit-exact with the C implementation in synthesis-sbc.c,
+synthesis-dct8.c and synthesis-8-generated.c: the matrixing kernels
+transform several blocks at once with one block per vector lane, the
+windowing kernels compute the outputs of one block in parallel.
+
+@ingroup codec_internal
+*/
+
+/**
+@addtogroup codec_internal
+@{
+*/
+
+#include "oi_codec_sbc_private.h"
+
+/* The vector kernels only replace the default C transforms */
+#if (DCTII_8_SHIFT_IN == 0) && !defined(DCT2_8) && !defined(SYNTH80)
+#define OI_SBC_SIMD_SUPPORTED TRUE
+#else
+#define OI_SBC_SIMD_SUPPORTED FALSE
+#endif
+
+/* x86 kernels are selected at runtime, NEON is always available on ARM */
+#if (OI_SBC_SIMD_SUPPORTED == TRUE) && (defined(__x86_64__) || defined(__i386__)) && \
+        (defined(__GNUC__) || defined(__clang__))
+#define OI_SBC_SIMD_X86 TRUE
+#else
+#define OI_SBC_SIMD_X86 FALSE
+#endif
+
+#if (OI_SBC_SIMD_SUPPORTED == TRUE) && defined(__ARM_NEON)
+#define OI_SBC_SIMD_NEON TRUE
+#else
+#define OI_SBC_SIMD_NEON FALSE
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  OI_SBC_SYNTH_IMPL impl;
+  /* Matrixing of |count| consecutive blocks of one channel: block i reads its
+   * subband samples at in + i * inStride and writes out - 8 * i. */
+  void (*dct8)(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride, OI_UINT count);
+  void (*cosine4)(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride, OI_UINT count);
+  /* Windowing of one block of one channel, |buffer| points to the 80 most
+   * recent matrixing outputs. */
+  void (*window80)(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift);
+  void (*window40)(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift);
+} OI_SBC_SYNTH_KERNELS;
+
+extern const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_c;
+#if (OI_SBC_SIMD_X86 == TRUE)
+extern const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_sse41;
+extern const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_avx2;
+#endif
+#if (OI_SBC_SIMD_NEON == TRUE)
+extern const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_neon;
+#endif
+
+/** Kernels used by the synthesis filterbank, resolved on first use. */
+const OI_SBC_SYNTH_KERNELS* OI_SBC_SynthKernels(void);
+
+PRIVATE void SynthDct8_C(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride, OI_UINT count);
+PRIVATE void SynthCosine4_C(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride,
+                            OI_UINT count);
+PRIVATE void SynthWindow80_C(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift);
+PRIVATE void SynthWindow40_C(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift);
+
+#if (OI_SBC_SIMD_SUPPORTED == TRUE)
+/* Taps of SynthWindow80_generated() by output lane. For each group g of 16
+ * values, row 0 multiplies buffer[16 * g + 4 + lane] and row 1 multiplies
+ * buffer[16 * g + 12 - lane]. The left shifts of the generated code are
+ * folded in the coefficients, the right shifts are applied to each product. */
+extern const int32_t oi_sbc_synth_window80_coeffs[5][2][8];
+extern const int32_t oi_sbc_synth_window80_shifts[5][2][8];
+
+/* Taps of SynthWindow40_int32_int32_symmetry_with_sum() by output lane: row r
+ * multiplies buffer[oi_sbc_synth_window40_offsets[r] + lane]. */
+extern const uint8_t oi_sbc_synth_window40_offsets[10];
+extern const int32_t oi_sbc_synth_window40_coeffs[10][4];
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#if (OI_SBC_SIMD_SUPPORTED == TRUE)
+/* Lane parallel versions of dct2_8() and cosineModulateSynth4(): every lane
+ * of the vectors holds a different block. The including file provides OI_V_T
+ * and the OI_V_ADD/SUB/AND/SRA/SHL/SET1 operations, OI_V_MULC(k, x) returning
+ * the low 32 bits and OI_V_MULHI(k, x) the high 32 bits of the product. */
+#define OI_V_SCALE(x, y) OI_V_SRA(OI_V_ADD(x, OI_V_SET1(1 << ((y) - 1))), y)
+#define OI_V_HALF(x) OI_V_SRA(OI_V_SUB(x, OI_V_SRA(x, 31)), 1)
+#define OI_V_NEG(x) OI_V_SUB(OI_V_SET1(0), x)
+#define OI_V_BUTTERFLY(x, y)         \
+  {                                  \
+    x = OI_V_ADD(x, y);              \
+    y = OI_V_SUB(x, OI_V_SHL(y, 1)); \
+  }
+#define OI_V_FIX_MULT_DCT(k, x) OI_V_SHL(OI_V_MULHI(k, x), 2)
+#define OI_V_LONG_MULT_DCT(k, x)                                                 \
+  OI_V_SHL(OI_V_ADD(OI_V_MULC(k, OI_V_SRA(x, 16)),                               \
+                    OI_V_SRA(OI_V_MULC(k, OI_V_AND(x, OI_V_SET1(0xFFFF))), 16)), \
+           2)
+
+#define OI_SBC_DCT2_8_LANES(in, out)                         \
+  {                                                          \
+    OI_V_T L00, L01, L02, L03, L04, L05, L06, L07, L25;      \
+    L00 = OI_V_ADD((in)[0], (in)[7]);                        \
+    L01 = OI_V_ADD((in)[1], (in)[6]);                        \
+    L02 = OI_V_ADD((in)[2], (in)[5]);                        \
+    L03 = OI_V_ADD((in)[3], (in)[4]);                        \
+    L04 = OI_V_SUB((in)[3], (in)[4]);                        \
+    L05 = OI_V_SUB((in)[2], (in)[5]);                        \
+    L06 = OI_V_SUB((in)[1], (in)[6]);                        \
+    L07 = OI_V_SUB((in)[0], (in)[7]);                        \
+    OI_V_BUTTERFLY(L00, L03);                                \
+    OI_V_BUTTERFLY(L01, L02);                                \
+    L02 = OI_V_FIX_MULT_DCT(AAN_C4_FIX, OI_V_ADD(L02, L03)); \
+    OI_V_BUTTERFLY(L00, L01);                                \
+    (out)[0] = OI_V_SCALE(L00, DCTII_8_SHIFT_0);             \
+    (out)[4] = OI_V_SCALE(L01, DCTII_8_SHIFT_4);             \
+    OI_V_BUTTERFLY(L03, L02);                                \
+    (out)[6] = OI_V_SCALE(L02, DCTII_8_SHIFT_6);             \
+    (out)[2] = OI_V_SCALE(L03, DCTII_8_SHIFT_2);             \
+    L04 = OI_V_HALF(OI_V_ADD(L04, L05));                     \
+    L05 = OI_V_HALF(OI_V_ADD(L05, L06));                     \
+    L06 = OI_V_HALF(OI_V_ADD(L06, L07));                     \
+    L07 = OI_V_HALF(L07);                                    \
+    L05 = OI_V_FIX_MULT_DCT(AAN_C4_FIX, L05);                \
+    L25 = OI_V_FIX_MULT_DCT(AAN_C6_FIX, OI_V_SUB(L06, L04)); \
+    L04 = OI_V_SUB(OI_V_FIX_MULT_DCT(AAN_Q0_FIX, L04), L25); \
+    L06 = OI_V_SUB(OI_V_FIX_MULT_DCT(AAN_Q1_FIX, L06), L25); \
+    OI_V_BUTTERFLY(L07, L05);                                \
+    OI_V_BUTTERFLY(L05, L04);                                \
+    (out)[3] = OI_V_SCALE(L04, DCTII_8_SHIFT_3 - 1);         \
+    (out)[5] = OI_V_SCALE(L05, DCTII_8_SHIFT_5 - 1);         \
+    OI_V_BUTTERFLY(L07, L06);                                \
+    (out)[7] = OI_V_SCALE(L06, DCTII_8_SHIFT_7 - 1);         \
+    (out)[1] = OI_V_SCALE(L07, DCTII_8_SHIFT_1 - 1);         \
+  }
+
+#define OI_SBC_COSINE_MODULATE_4_LANES(in, out)                                     \
+  {                                                                                 \
+    OI_V_T f0, f1, f2, f3, f9, y0, y1, y2, y3;                                      \
+    f0 = OI_V_SUB((in)[0], (in)[3]);                                                \
+    f1 = OI_V_ADD((in)[0], (in)[3]);                                                \
+    f2 = OI_V_SUB((in)[1], (in)[2]);                                                \
+    f3 = OI_V_ADD((in)[1], (in)[2]);                                                \
+    y0 = OI_V_NEG(OI_V_SCALE(OI_V_ADD(f1, f3), DCT_SHIFT));                         \
+    y2 = OI_V_NEG(OI_V_SCALE(OI_V_LONG_MULT_DCT(DCTII_4_K06_FIX, OI_V_SUB(f1, f3)), \
+                             DCT_SHIFT));                                           \
+    f9 = OI_V_LONG_MULT_DCT(DCTII_4_K09_FIX, OI_V_ADD(f0, f2));                     \
+    y3 = OI_V_NEG(OI_V_SCALE(OI_V_ADD(OI_V_LONG_MULT_DCT(DCTII_4_K08_FIX, f0), f9), \
+                             DCT_SHIFT));                                           \
+    y1 = OI_V_NEG(OI_V_SCALE(OI_V_SUB(OI_V_LONG_MULT_DCT(DCTII_4_K10_FIX, f2), f9), \
+                             DCT_SHIFT));                                           \
+    (out)[0] = OI_V_NEG(y2);                                                        \
+    (out)[1] = OI_V_NEG(y3);                                                        \
+    (out)[2] = OI_V_SET1(0);                                                        \
+    (out)[3] = y3;                                                                  \
+    (out)[4] = y2;                                                                  \
+    (out)[5] = y1;                                                                  \
+    (out)[6] = y0;                                                                  \
+    (out)[7] = y1;                                                                  \
+  }
+#endif
+
+/**
+@}
+*/
+
+#endif /* _OI_CODEC_SBC_SIMD_H */
@@ -164,6 +164,7 @@ The output samples X[0..7] are defined as sums of W:
 */
 
 #include "oi_codec_sbc_private.h"
+#include "oi_codec_sbc_simd.h"
 
 const int32_t dec_window_4[21] = {
         0,      /* +0.00000000E+00 */
@@ -189,14 +190,6 @@ const int32_t dec_window_4[21] = {
         53243,  /* +2.94315332E-01 */
 };
 
-#define DCTII_4_K06_FIX (11585) /* S1.14      11585   0.707107*/
-
-#define DCTII_4_K08_FIX (21407) /* S1.14      21407   1.306563*/
-
-#define DCTII_4_K09_FIX (-15137) /* S1.14     -15137  -0.923880*/
-
-#define DCTII_4_K10_FIX (-8867) /* S1.14      -8867  -0.541196*/
-
 /** Scales x by y bits to the right, adding a rounding factor.
  */
 #ifndef SCALE
@@ -271,17 +264,51 @@ typedef void (*SYNTH_FRAME)(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* pcm,
 #define SYNTH112 SynthWindow112_generated
 #endif
 
+PRIVATE void SynthDct8_C(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride, OI_UINT count) {
+  OI_UINT i;
+
+  for (i = 0; i < count; i++) {
+    DCT2_8(out - 8 * i, in + inStride * i);
+  }
+}
+
+PRIVATE void SynthCosine4_C(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride,
+                            OI_UINT count) {
+  OI_UINT i;
+
+  for (i = 0; i < count; i++) {
+    cosineModulateSynth4(out - 8 * i, in + inStride * i);
+  }
+}
+
+PRIVATE void SynthWindow80_C(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift) {
+  SYNTH80(pcm, buffer, strideShift);
+}
+
+PRIVATE void SynthWindow40_C(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift) {
+  SynthWindow40_int32_int32_symmetry_with_sum(pcm, buffer, strideShift);
+}
+
+/* Number of blocks starting at |offset| which can be matrixed before the
+ * windowing of the first one: the matrixing of a block only writes below the
+ * windows of the blocks before it, until the filter buffer is shifted. */
+#define SYNTH_RUN_LENGTH(offset, blocks) \
+  (((offset) / 8 + 1) < (blocks) ? ((offset) / 8 + 1) : (blocks))
+
 PRIVATE void OI_SBC_SynthFrame_80(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* pcm,
                                   OI_UINT blkstart, OI_UINT blkcount) {
+  const OI_SBC_SYNTH_KERNELS* kernels = OI_SBC_SynthKernels();
   OI_UINT blk;
   OI_UINT ch;
+  OI_UINT i;
+  OI_UINT run;
   OI_UINT nrof_channels = context->common.frameInfo.nrof_channels;
   OI_UINT pcmStrideShift = context->common.pcmStride == 1 ? 0 : 1;
   OI_UINT offset = context->common.filterBufferOffset;
   int32_t* s = context->common.subdata + 8 * nrof_channels * blkstart;
   OI_UINT blkstop = blkstart + blkcount;
 
-  for (blk = blkstart; blk < blkstop; blk++) {
+  for (blk = blkstart; blk < blkstop; blk += run) {
     if (offset == 0) {
       COPY_BACKWARD_32BIT_ALIGNED_72_HALFWORDS(
               context->common.filterBuffer[0] + context->common.filterBufferLen - 72,
@@ -296,27 +323,38 @@ PRIVATE void OI_SBC_SynthFrame_80(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t
       offset -= 1 * 8;
     }
 
+    run = SYNTH_RUN_LENGTH(offset, blkstop - blk);
     for (ch = 0; ch < nrof_channels; ch++) {
-      DCT2_8(context->common.filterBuffer[ch] + offset, s);
-      SYNTH80(pcm + ch, context->common.filterBuffer[ch] + offset, pcmStrideShift);
-      s += 8;
+      kernels->dct8(context->common.filterBuffer[ch] + offset, s + 8 * ch, 8 * nrof_channels,
+                    run);
     }
-    pcm += (8 << pcmStrideShift);
+    for (i = 0; i < run; i++) {
+      for (ch = 0; ch < nrof_channels; ch++) {
+        kernels->window80(pcm + ch, context->common.filterBuffer[ch] + offset - 8 * i,
+                          pcmStrideShift);
+      }
+      pcm += (8 << pcmStrideShift);
+    }
+    offset -= 8 * (run - 1);
+    s += 8 * nrof_channels * run;
   }
   context->common.filterBufferOffset = offset;
 }
 
 PRIVATE void OI_SBC_SynthFrame_4SB(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* pcm,
                                    OI_UINT blkstart, OI_UINT blkcount) {
+  const OI_SBC_SYNTH_KERNELS* kernels = OI_SBC_SynthKernels();
   OI_UINT blk;
   OI_UINT ch;
+  OI_UINT i;
+  OI_UINT run;
   OI_UINT nrof_channels = context->common.frameInfo.nrof_channels;
   OI_UINT pcmStrideShift = context->common.pcmStride == 1 ? 0 : 1;
   OI_UINT offset = context->common.filterBufferOffset;
   int32_t* s = context->common.subdata + 8 * nrof_channels * blkstart;
   OI_UINT blkstop = blkstart + blkcount;
 
-  for (blk = blkstart; blk < blkstop; blk++) {
+  for (blk = blkstart; blk < blkstop; blk += run) {
     if (offset == 0) {
       COPY_BACKWARD_32BIT_ALIGNED_72_HALFWORDS(
               context->common.filterBuffer[0] + context->common.filterBufferLen - 72,
@@ -330,13 +368,21 @@ PRIVATE void OI_SBC_SynthFrame_4SB(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_
     } else {
       offset -= 8;
     }
+
+    run = SYNTH_RUN_LENGTH(offset, blkstop - blk);
     for (ch = 0; ch < nrof_channels; ch++) {
-      cosineModulateSynth4(context->common.filterBuffer[ch] + offset, s);
-      SynthWindow40_int32_int32_symmetry_with_sum(
-              pcm + ch, context->common.filterBuffer[ch] + offset, pcmStrideShift);
-      s += 4;
+      kernels->cosine4(context->common.filterBuffer[ch] + offset, s + 4 * ch, 4 * nrof_channels,
+                       run);
+    }
+    for (i = 0; i < run; i++) {
+      for (ch = 0; ch < nrof_channels; ch++) {
+        kernels->window40(pcm + ch, context->common.filterBuffer[ch] + offset - 8 * i,
+                          pcmStrideShift);
+      }
+      pcm += (4 << pcmStrideShift);
     }
-    pcm += (4 << pcmStrideShift);
+    offset -= 8 * (run - 1);
+    s += 4 * nrof_channels * run;
   }
   context->common.filterBufferOffset = offset;
 }
@@ -414,7 +460,7 @@ PRIVATE void OI_SBC_SynthFrame(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* p
   }
 }
 
-void SynthWindow40_int32_int32_symmetry_with_sum(int16_t* pcm, SBC_BUFFER_T buffer[80],
+void SynthWindow40_int32_int32_symmetry_with_sum(int16_t* pcm, SBC_BUFFER_T const buffer[80],
                                                  OI_UINT strideShift) {
   int32_t pa;
   int32_t pb;
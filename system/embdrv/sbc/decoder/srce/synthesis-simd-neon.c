@@ -0,0 +1,197 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/** @file
+NEON synthesis filterbank kernels.
+
+@ingroup codec_internal
+*/
+
+/**@addgroup codec_internal*/
+/**@{*/
+
+#include "oi_codec_sbc_simd.h"
+
+#if (OI_SBC_SIMD_NEON == TRUE)
+#include <arm_neon.h>
+
+#define SYNTH_TRANSPOSE_4X4_NEON(r0, r1, r2, r3)                             \
+  {                                                                          \
+    int32x4x2_t t01 = vtrnq_s32(r0, r1);                                     \
+    int32x4x2_t t23 = vtrnq_s32(r2, r3);                                     \
+    r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));   \
+    r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));   \
+    r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0])); \
+    r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1])); \
+  }
+
+/* Keeps the low 16 bits of each lane, like the (int16_t) casts of the C code */
+#define SYNTH_PACK_TRUNCATE_NEON(a, b) vcombine_s16(vmovn_s32(a), vmovn_s32(b))
+
+#define OI_V_T int32x4_t
+#define OI_V_ADD(a, b) vaddq_s32(a, b)
+#define OI_V_SUB(a, b) vsubq_s32(a, b)
+#define OI_V_AND(a, b) vandq_s32(a, b)
+#define OI_V_SRA(a, n) vshrq_n_s32(a, n)
+#define OI_V_SHL(a, n) vshlq_n_s32(a, n)
+#define OI_V_SET1(x) vdupq_n_s32(x)
+#define OI_V_MULC(k, x) vmulq_n_s32(x, k)
+#define OI_V_MULHI(k, x) SynthMulHi_NEON(x, k)
+
+static inline int32x4_t SynthMulHi_NEON(int32x4_t x, int32_t k) {
+  int32x2_t kv = vdup_n_s32(k);
+  int64x2_t lo = vmull_s32(vget_low_s32(x), kv);
+  int64x2_t hi = vmull_s32(vget_high_s32(x), kv);
+
+  return vcombine_s32(vshrn_n_s64(lo, 32), vshrn_n_s64(hi, 32));
+}
+
+static void SynthDct8_NEON(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride,
+                           OI_UINT count) {
+  /* 4 blocks at a time, one per lane */
+  for (; count >= 4; count -= 4) {
+    int32x4_t x[8], y[8];
+    OI_UINT i;
+
+    for (i = 0; i < 4; i++) {
+      x[i] = vld1q_s32(in + inStride * i);
+      x[4 + i] = vld1q_s32(in + inStride * i + 4);
+    }
+    SYNTH_TRANSPOSE_4X4_NEON(x[0], x[1], x[2], x[3]);
+    SYNTH_TRANSPOSE_4X4_NEON(x[4], x[5], x[6], x[7]);
+
+    OI_SBC_DCT2_8_LANES(x, y);
+
+    SYNTH_TRANSPOSE_4X4_NEON(y[0], y[1], y[2], y[3]);
+    SYNTH_TRANSPOSE_4X4_NEON(y[4], y[5], y[6], y[7]);
+    for (i = 0; i < 4; i++) {
+      vst1q_s16(out - 8 * i, SYNTH_PACK_TRUNCATE_NEON(y[i], y[4 + i]));
+    }
+
+    in += 4 * inStride;
+    out -= 4 * 8;
+  }
+
+  SynthDct8_C(out, in, inStride, count);
+}
+
+static void SynthCosine4_NEON(SBC_BUFFER_T* out, int32_t const* in, OI_UINT inStride,
+                              OI_UINT count) {
+  /* 4 blocks at a time, one per lane */
+  for (; count >= 4; count -= 4) {
+    int32x4_t x[4], y[8];
+    OI_UINT i;
+
+    for (i = 0; i < 4; i++) {
+      x[i] = vld1q_s32(in + inStride * i);
+    }
+    SYNTH_TRANSPOSE_4X4_NEON(x[0], x[1], x[2], x[3]);
+
+    OI_SBC_COSINE_MODULATE_4_LANES(x, y);
+
+    SYNTH_TRANSPOSE_4X4_NEON(y[0], y[1], y[2], y[3]);
+    SYNTH_TRANSPOSE_4X4_NEON(y[4], y[5], y[6], y[7]);
+    for (i = 0; i < 4; i++) {
+      vst1q_s16(out - 8 * i, SYNTH_PACK_TRUNCATE_NEON(y[i], y[4 + i]));
+    }
+
+    in += 4 * inStride;
+    out -= 4 * 8;
+  }
+
+  SynthCosine4_C(out, in, inStride, count);
+}
+
+/* Accumulates the products of one row of the window of SynthWindow80_NEON() */
+#define SYNTH_WINDOW80_ROW_NEON(acc, x, coeffs, shifts)                            \
+  {                                                                                \
+    (acc) = vaddq_s32((acc), vshlq_s32(vmulq_s32(vmovl_s16(x), vld1q_s32(coeffs)), \
+                                       vnegq_s32(vld1q_s32(shifts))));             \
+  }
+
+static void SynthWindow80_NEON(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift) {
+  int32x4_t lo = vdupq_n_s32(0);
+  int32x4_t hi = vdupq_n_s32(0);
+  int16x8_t samples;
+  OI_UINT g;
+  OI_UINT k;
+
+  for (g = 0; g < 5; g++) {
+    const int32_t* coeffs = oi_sbc_synth_window80_coeffs[g][0];
+    const int32_t* shifts = oi_sbc_synth_window80_shifts[g][0];
+    /* buffer[16 * g + 4 + lane] and buffer[16 * g + 12 - lane] */
+    int16x8_t x = vld1q_s16(buffer + 16 * g + 4);
+    int16x8_t y = vrev64q_s16(vld1q_s16(buffer + 16 * g + 5));
+
+    y = vcombine_s16(vget_high_s16(y), vget_low_s16(y));
+    SYNTH_WINDOW80_ROW_NEON(lo, vget_low_s16(x), coeffs, shifts);
+    SYNTH_WINDOW80_ROW_NEON(hi, vget_high_s16(x), coeffs + 4, shifts + 4);
+    SYNTH_WINDOW80_ROW_NEON(lo, vget_low_s16(y), coeffs + 8, shifts + 8);
+    SYNTH_WINDOW80_ROW_NEON(hi, vget_high_s16(y), coeffs + 12, shifts + 12);
+  }
+
+  /* acc / 32768 rounded toward zero, clipped to 16 bits */
+  lo = vshrq_n_s32(vaddq_s32(lo, vandq_s32(vshrq_n_s32(lo, 31), vdupq_n_s32(32767))), 15);
+  hi = vshrq_n_s32(vaddq_s32(hi, vandq_s32(vshrq_n_s32(hi, 31), vdupq_n_s32(32767))), 15);
+  samples = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+  if (strideShift == 0) {
+    vst1q_s16(pcm, samples);
+  } else {
+    int16_t out[8];
+    vst1q_s16(out, samples);
+    for (k = 0; k < 8; k++) {
+      pcm[k << strideShift] = out[k];
+    }
+  }
+}
+
+static void SynthWindow40_NEON(int16_t* pcm, SBC_BUFFER_T const* buffer, OI_UINT strideShift) {
+  int32x4_t acc = vdupq_n_s32(0);
+  int16x4_t samples;
+  OI_UINT r;
+  OI_UINT k;
+
+  for (r = 0; r < 10; r++) {
+    acc = vmlaq_s32(acc, vmovl_s16(vld1_s16(buffer + oi_sbc_synth_window40_offsets[r])),
+                    vld1q_s32(oi_sbc_synth_window40_coeffs[r]));
+  }
+
+  /* SCALE(-acc, 15) clipped to 16 bits */
+  samples = vqmovn_s32(vshrq_n_s32(vsubq_s32(vdupq_n_s32(1 << 14), acc), 15));
+  if (strideShift == 0) {
+    vst1_s16(pcm, samples);
+  } else {
+    int16_t out[4];
+    vst1_s16(out, samples);
+    for (k = 0; k < 4; k++) {
+      pcm[k << strideShift] = out[k];
+    }
+  }
+}
+
+const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_neon = {
+        .impl = OI_SBC_SYNTH_IMPL_NEON,
+        .dct8 = SynthDct8_NEON,
+        .cosine4 = SynthCosine4_NEON,
+        .window80 = SynthWindow80_NEON,
+        .window40 = SynthWindow40_NEON,
+};
+
+#endif /* OI_SBC_SIMD_NEON */
+
+/**@}*/
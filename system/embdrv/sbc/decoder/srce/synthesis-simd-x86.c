@@ -0,0 +1,236 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/** @file
+SSE4.1 and AVX2 synthesis filterbank kernels. The functions are compiled for
+their own target so that the baseline build still runs on any x86,
+synthesis-simd.c only selects them when the CPU supports the extension.
+
+The per product right shifts of the 8-subband window need the variable shifts
+of AVX2, the SSE4.1 kernels use the C window for 8 subbands.
+
+@ingroup codec_internal
+*/
+
+/**@addgroup codec_internal*/
+/**@{*/
+
+#include "oi_codec_sbc_simd.h"
+
+#if (OI_SBC_SIMD_X86 == TRUE)
+#include <immintrin.h>
+
+#define SYNTH_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SYNTH_TARGET_AVX2 __attribute__((target("avx2")))
+
+#define SYNTH_TRANSPOSE_4X4_SSE(r0, r1, r2, r3) \
+  {                                             \
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);    \
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);    \
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);    \
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);    \
+    r0 = _mm_unpacklo_epi64(t0, t1);            \
+    r1 = _mm_unpackhi_epi64(t0, t1);            \
+    r2 = _mm_unpacklo_epi64(t2, t3);            \
+    r3 = _mm_unpackhi_epi64(t2, t3);            \
+  }
+
+/* Packs the low 16 bits of each lane, like the (int16_t) casts of the C code */
+#define SYNTH_PACK_TRUNCATE_SSE(a, b)                        \
+  _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), \
+                  _mm_srai_epi32(_mm_slli_epi32(b, 16), 16))
+
+/* Stores |n| output samples held in the 16 bit lanes of |v| */
+#define SYNTH_STORE_PCM_SSE(pcm, v, n, strideShift) \
+  {                                                 \
+    int16_t samples[8];                             \
+    OI_UINT k;                                      \
+    _mm_storeu_si128((__m128i*)samples, v);         \
+    for (k = 0; k < (n); k++) {                     \
+      (pcm)[k << (strideShift)] = samples[k];       \
+    }                                               \
+  }
+
+#define OI_V_T __m128i
+#define OI_V_ADD(a, b) _mm_add_epi32(a, b)
+#define OI_V_SUB(a, b) _mm_sub_epi32(a, b)
+#define OI_V_AND(a, b) _mm_and_si128(a, b)
+#define OI_V_SRA(a, n) _mm_srai_epi32(a, n)
+#define OI_V_SHL(a, n) _mm_slli_epi32(a, n)
+#define OI_V_SET1(x) _mm_set1_epi32(x)
+#define OI_V_MULC(k, x) _mm_mullo_epi32(_mm_set1_epi32(k), x)
+#define OI_V_MULHI(k, x) SynthMulHi_SSE41(x, k)
+
+static inline SYNTH_TARGET_SSE41 __m128i SynthMulHi_SSE41(__m128i x, int32_t k) {
+  __m128i kv = _mm_set1_epi32(k);
+  __m128i even = _mm_srli_epi64(_mm_mul_epi32(x, kv), 32);
+  __m128i odd = _mm_mul_epi32(_mm_srli_epi64(x, 32), kv);
+
+  return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+static SYNTH_TARGET_SSE41 void SynthDct8_SSE41(SBC_BUFFER_T* out, int32_t const* in,
+                                               OI_UINT inStride, OI_UINT count) {
+  /* 4 blocks at a time, one per lane */
+  for (; count >= 4; count -= 4) {
+    __m128i x[8], y[8];
+    OI_UINT i;
+
+    for (i = 0; i < 4; i++) {
+      x[i] = _mm_loadu_si128((const __m128i*)(in + inStride * i));
+      x[4 + i] = _mm_loadu_si128((const __m128i*)(in + inStride * i + 4));
+    }
+    SYNTH_TRANSPOSE_4X4_SSE(x[0], x[1], x[2], x[3]);
+    SYNTH_TRANSPOSE_4X4_SSE(x[4], x[5], x[6], x[7]);
+
+    OI_SBC_DCT2_8_LANES(x, y);
+
+    SYNTH_TRANSPOSE_4X4_SSE(y[0], y[1], y[2], y[3]);
+    SYNTH_TRANSPOSE_4X4_SSE(y[4], y[5], y[6], y[7]);
+    for (i = 0; i < 4; i++) {
+      _mm_storeu_si128((__m128i*)(out - 8 * i), SYNTH_PACK_TRUNCATE_SSE(y[i], y[4 + i]));
+    }
+
+    in += 4 * inStride;
+    out -= 4 * 8;
+  }
+
+  SynthDct8_C(out, in, inStride, count);
+}
+
+static SYNTH_TARGET_SSE41 void SynthCosine4_SSE41(SBC_BUFFER_T* out, int32_t const* in,
+                                                  OI_UINT inStride, OI_UINT count) {
+  /* 4 blocks at a time, one per lane */
+  for (; count >= 4; count -= 4) {
+    __m128i x[4], y[8];
+    OI_UINT i;
+
+    for (i = 0; i < 4; i++) {
+      x[i] = _mm_loadu_si128((const __m128i*)(in + inStride * i));
+    }
+    SYNTH_TRANSPOSE_4X4_SSE(x[0], x[1], x[2], x[3]);
+
+    OI_SBC_COSINE_MODULATE_4_LANES(x, y);
+
+    SYNTH_TRANSPOSE_4X4_SSE(y[0], y[1], y[2], y[3]);
+    SYNTH_TRANSPOSE_4X4_SSE(y[4], y[5], y[6], y[7]);
+    for (i = 0; i < 4; i++) {
+      _mm_storeu_si128((__m128i*)(out - 8 * i), SYNTH_PACK_TRUNCATE_SSE(y[i], y[4 + i]));
+    }
+
+    in += 4 * inStride;
+    out -= 4 * 8;
+  }
+
+  SynthCosine4_C(out, in, inStride, count);
+}
+
+static SYNTH_TARGET_SSE41 void SynthWindow40_SSE41(int16_t* pcm, SBC_BUFFER_T const* buffer,
+                                                   OI_UINT strideShift) {
+  __m128i acc = _mm_setzero_si128();
+  OI_UINT r;
+
+  for (r = 0; r < 10; r++) {
+    __m128i x = _mm_cvtepi16_epi32(
+            _mm_loadl_epi64((const __m128i*)(buffer + oi_sbc_synth_window40_offsets[r])));
+    __m128i c = _mm_loadu_si128((const __m128i*)oi_sbc_synth_window40_coeffs[r]);
+    acc = _mm_add_epi32(acc, _mm_mullo_epi32(x, c));
+  }
+
+  /* SCALE(-acc, 15) clipped to 16 bits */
+  acc = _mm_srai_epi32(_mm_sub_epi32(_mm_set1_epi32(1 << 14), acc), 15);
+  SYNTH_STORE_PCM_SSE(pcm, _mm_packs_epi32(acc, acc), 4, strideShift);
+}
+
+const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_sse41 = {
+        .impl = OI_SBC_SYNTH_IMPL_SSE41,
+        .dct8 = SynthDct8_SSE41,
+        .cosine4 = SynthCosine4_SSE41,
+        .window80 = SynthWindow80_C,
+        .window40 = SynthWindow40_SSE41,
+};
+
+/******************************************************************************
+ * AVX2, the matrixing transforms at most 16 blocks and keeps the SSE4.1 code.
+ */
+
+static SYNTH_TARGET_AVX2 void SynthWindow80_AVX2(int16_t* pcm, SBC_BUFFER_T const* buffer,
+                                                 OI_UINT strideShift) {
+  const __m128i reverse = _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  __m256i acc = _mm256_setzero_si256();
+  OI_UINT g;
+
+  for (g = 0; g < 5; g++) {
+    /* buffer[16 * g + 4 + lane] and buffer[16 * g + 12 - lane] */
+    __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(buffer + 16 * g + 4)));
+    __m256i y = _mm256_cvtepi16_epi32(_mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i*)(buffer + 16 * g + 5)), reverse));
+
+    x = _mm256_mullo_epi32(x, _mm256_loadu_si256(
+                                      (const __m256i*)oi_sbc_synth_window80_coeffs[g][0]));
+    x = _mm256_srav_epi32(x, _mm256_loadu_si256(
+                                     (const __m256i*)oi_sbc_synth_window80_shifts[g][0]));
+    y = _mm256_mullo_epi32(y, _mm256_loadu_si256(
+                                      (const __m256i*)oi_sbc_synth_window80_coeffs[g][1]));
+    y = _mm256_srav_epi32(y, _mm256_loadu_si256(
+                                     (const __m256i*)oi_sbc_synth_window80_shifts[g][1]));
+    acc = _mm256_add_epi32(acc, _mm256_add_epi32(x, y));
+  }
+
+  /* acc / 32768 rounded toward zero, clipped to 16 bits */
+  acc = _mm256_add_epi32(acc, _mm256_and_si256(_mm256_srai_epi32(acc, 31),
+                                               _mm256_set1_epi32(32767)));
+  acc = _mm256_srai_epi32(acc, 15);
+  SYNTH_STORE_PCM_SSE(pcm,
+                      _mm_packs_epi32(_mm256_castsi256_si128(acc),
+                                      _mm256_extracti128_si256(acc, 1)),
+                      8, strideShift);
+}
+
+static SYNTH_TARGET_AVX2 void SynthWindow40_AVX2(int16_t* pcm, SBC_BUFFER_T const* buffer,
+                                                 OI_UINT strideShift) {
+  __m256i acc = _mm256_setzero_si256();
+  __m128i sum;
+  OI_UINT r;
+
+  /* Two rows per vector */
+  for (r = 0; r < 10; r += 2) {
+    __m256i x = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(
+            _mm_loadl_epi64((const __m128i*)(buffer + oi_sbc_synth_window40_offsets[r])),
+            _mm_loadl_epi64((const __m128i*)(buffer + oi_sbc_synth_window40_offsets[r + 1]))));
+    __m256i c = _mm256_loadu_si256((const __m256i*)oi_sbc_synth_window40_coeffs[r]);
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(x, c));
+  }
+  sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+
+  /* SCALE(-sum, 15) clipped to 16 bits */
+  sum = _mm_srai_epi32(_mm_sub_epi32(_mm_set1_epi32(1 << 14), sum), 15);
+  SYNTH_STORE_PCM_SSE(pcm, _mm_packs_epi32(sum, sum), 4, strideShift);
+}
+
+const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_avx2 = {
+        .impl = OI_SBC_SYNTH_IMPL_AVX2,
+        .dct8 = SynthDct8_SSE41,
+        .cosine4 = SynthCosine4_SSE41,
+        .window80 = SynthWindow80_AVX2,
+        .window40 = SynthWindow40_AVX2,
+};
+
+#endif /* OI_SBC_SIMD_X86 */
+
+/**@}*/
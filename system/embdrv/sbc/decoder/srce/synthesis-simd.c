@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/** @file
+Selection of the synthesis filterbank kernels.
+
+@ingroup codec_internal
+*/
+
+/**@addgroup codec_internal*/
+/**@{*/
+
+#include <stddef.h>
+
+#include "oi_codec_sbc_simd.h"
+
+const OI_SBC_SYNTH_KERNELS oi_sbc_synth_kernels_c = {
+        .impl = OI_SBC_SYNTH_IMPL_SCALAR,
+        .dct8 = SynthDct8_C,
+        .cosine4 = SynthCosine4_C,
+        .window80 = SynthWindow80_C,
+        .window40 = SynthWindow40_C,
+};
+
+#if (OI_SBC_SIMD_SUPPORTED == TRUE)
+const int32_t oi_sbc_synth_window80_coeffs[5][2][8] = {
+        {{0, -3263, -10385, -16457, 10445, -8443, -10337, -6087},
+         {8235, 29293, 24995, 19083, 0, 16913, 11167, 9293}},
+        {{-23167, -5229, -4944, -23641, -10594, -9632, -30605, -23144},
+         {26479, 30835, 9161, -29015, 0, 7374, 7668, 9976}},
+        {{-34794, -54042, -46126, -51556, 89196, 41020, 38212, 36110},
+         {75192, 63266, 55122, 49160, 0, 61788, 66536, 94684}},
+        {{34794, 34638, 18472, 24211, 10603, 9405, 16383, 3494},
+         {26479, 26663, 12705, 23469, 0, -18233, 22117, 11537}},
+        {{23167, 4555, 6239, 21223, 9539, 26189, 8603, 8721},
+         {8235, 12419, 9251, 26913, 0, 1499, 7543, 1370}},
+};
+
+const int32_t oi_sbc_synth_window80_shifts[5][2][8] = {
+        {{0, 5, 6, 6, 4, 7, 4, 2}, {3, 5, 5, 5, 0, 5, 4, 3}},
+        {{3, 0, 0, 2, 0, 0, 1, 0}, {2, 3, 3, 4, 0, 0, 0, 0}},
+        {{0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, 0}},
+        {{0, 0, 0, 1, 0, 1, 2, 0}, {2, 2, 1, 2, 0, 3, 4, 1}},
+        {{3, 1, 3, 8, 4, 7, 6, 7}, {3, 4, 4, 6, 0, 1, 3, 0}},
+};
+
+/* Rows are paired so that two of them fill a 256 bit vector. The values known
+ * to be zero (buffer[2 + 16 * n]) have a zero coefficient. */
+const uint8_t oi_sbc_synth_window40_offsets[10] = {0, 76, 12, 64, 16, 60, 28, 48, 32, 44};
+
+const int32_t oi_sbc_synth_window40_coeffs[10][4] = {
+        {0, 97, 0, 495},
+        {694, 495, 270, 97},
+        {694, 704, 338, -554},
+        {-1974, -554, 0, 704},
+        {1974, 3697, 0, 5824},
+        {4681, 5824, 5224, 3697},
+        {4681, 1109, -5214, -14047},
+        {-24529, -14047, 0, 1109},
+        {24529, 35274, 0, 50984},
+        {53243, 50984, 44618, 35274},
+};
+#endif
+
+static const OI_SBC_SYNTH_KERNELS* synth_kernels = NULL;
+
+static const OI_SBC_SYNTH_KERNELS* SynthKernelsForImpl(OI_SBC_SYNTH_IMPL impl) {
+  switch (impl) {
+    case OI_SBC_SYNTH_IMPL_SCALAR:
+      return &oi_sbc_synth_kernels_c;
+#if (OI_SBC_SIMD_X86 == TRUE)
+    case OI_SBC_SYNTH_IMPL_SSE41:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.1") ? &oi_sbc_synth_kernels_sse41 : NULL;
+    case OI_SBC_SYNTH_IMPL_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? &oi_sbc_synth_kernels_avx2 : NULL;
+#endif
+#if (OI_SBC_SIMD_NEON == TRUE)
+    case OI_SBC_SYNTH_IMPL_NEON:
+      return &oi_sbc_synth_kernels_neon;
+#endif
+    default:
+      return NULL;
+  }
+}
+
+static const OI_SBC_SYNTH_KERNELS* SynthBestKernels(void) {
+  static const OI_SBC_SYNTH_IMPL preferred[] = {OI_SBC_SYNTH_IMPL_AVX2, OI_SBC_SYNTH_IMPL_SSE41,
+                                                OI_SBC_SYNTH_IMPL_NEON};
+  const OI_SBC_SYNTH_KERNELS* kernels;
+  OI_UINT i;
+
+  for (i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++) {
+    kernels = SynthKernelsForImpl(preferred[i]);
+    if (kernels != NULL) {
+      return kernels;
+    }
+  }
+  return &oi_sbc_synth_kernels_c;
+}
+
+const OI_SBC_SYNTH_KERNELS* OI_SBC_SynthKernels(void) {
+  if (synth_kernels == NULL) {
+    synth_kernels = SynthBestKernels();
+  }
+  return synth_kernels;
+}
+
+OI_BOOL OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL impl) {
+  const OI_SBC_SYNTH_KERNELS* kernels;
+
+  kernels = (impl == OI_SBC_SYNTH_IMPL_AUTO) ? SynthBestKernels() : SynthKernelsForImpl(impl);
+  if (kernels == NULL) {
+    return FALSE;
+  }
+  synth_kernels = kernels;
+  return TRUE;
+}
+
+OI_SBC_SYNTH_IMPL OI_CODEC_SBC_GetSynthImpl(void) { return OI_SBC_SynthKernels()->impl; }
+
+/**@}*/
@@ -189,6 +189,16 @@ typedef struct SBC_ENC_PARAMS_TAG {
 
 } SBC_ENC_PARAMS;
 
+/* Implementations of the analysis filterbank. All of them produce the same
+ * bitstream, SBC_ENC_IMPL_AUTO picks the fastest one supported by the CPU. */
+typedef enum {
+  SBC_ENC_IMPL_AUTO = 0,
+  SBC_ENC_IMPL_SCALAR,
+  SBC_ENC_IMPL_SSE41,
+  SBC_ENC_IMPL_AVX2,
+  SBC_ENC_IMPL_NEON,
+} SBC_ENC_IMPL;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -198,6 +208,12 @@ extern "C" {
 uint32_t SBC_Encode(SBC_ENC_PARAMS* strEncParams, int16_t* input, uint8_t* output);
 void SBC_Encoder_Init(SBC_ENC_PARAMS* strEncParams);
 
+/* Force the analysis filterbank implementation. Return false if |impl| is not
+ * supported by this build or CPU, the current implementation is then kept. */
+bool SBC_Encoder_SelectImpl(SBC_ENC_IMPL impl);
+/* Return the analysis filterbank implementation in use */
+SBC_ENC_IMPL SBC_Encoder_GetImpl(void);
+
 #ifdef __cplusplus
 }
 #endif
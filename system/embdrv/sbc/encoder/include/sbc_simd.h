@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Vectorized kernels for the analysis filterbank (windowing and DCT).
+ *
+ *  Every kernel is bit-exact with the scalar SBC_IPAQ_OPT code path: the
+ *  windowing only uses 16x16->32 bit multiply-accumulates and the DCT uses
+ *  an exact split form of SBC_MULT_32_16_SIMPLIFIED.
+ *
+ ******************************************************************************/
+
+#ifndef SBC_SIMD_H
+#define SBC_SIMD_H
+
+#include "sbc_encoder.h"
+
+/* The vector kernels only implement the default configuration */
+#if (SBC_IPAQ_OPT == TRUE && SBC_ARM_ASM_OPT == FALSE && SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE && \
+     SBC_IS_64_MULT_IN_IDCT == FALSE && SBC_FAST_DCT == TRUE)
+#define SBC_SIMD_SUPPORTED TRUE
+#else
+#define SBC_SIMD_SUPPORTED FALSE
+#endif
+
+/* x86 kernels are selected at runtime, NEON is always available on ARM */
+#if (SBC_SIMD_SUPPORTED == TRUE) && (defined(__x86_64__) || defined(__i386__)) && \
+        (defined(__GNUC__) || defined(__clang__))
+#define SBC_SIMD_X86 TRUE
+#else
+#define SBC_SIMD_X86 FALSE
+#endif
+
+#if (SBC_SIMD_SUPPORTED == TRUE) && defined(__ARM_NEON)
+#define SBC_SIMD_NEON TRUE
+#else
+#define SBC_SIMD_NEON FALSE
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  SBC_ENC_IMPL impl;
+  /* Windowing of one block of one channel: |s16X| points to the oldest of the
+   * 10 * subbands input samples, |s32DCTY| receives 2 * subbands values. */
+  void (*window4)(const int16_t* s16X, int32_t* s32DCTY);
+  void (*window8)(const int16_t* s16X, int32_t* s32DCTY);
+  /* Matrixing of |n| consecutive windowed vectors into subband samples */
+  void (*dct4)(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n);
+  void (*dct8)(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n);
+} SBC_ANALYSIS_KERNELS;
+
+extern const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_c;
+#if (SBC_SIMD_X86 == TRUE)
+extern const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_sse41;
+extern const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_avx2;
+#endif
+#if (SBC_SIMD_NEON == TRUE)
+extern const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_neon;
+#endif
+
+/* Kernels used by the analysis filter, resolved on first use */
+const SBC_ANALYSIS_KERNELS* SbcAnalysisKernels(void);
+
+void SbcWindow4_C(const int16_t* s16X, int32_t* s32DCTY);
+void SbcWindow8_C(const int16_t* s16X, int32_t* s32DCTY);
+void SbcDct4_C(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n);
+void SbcDct8_C(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n);
+
+#if (SBC_SIMD_SUPPORTED == TRUE)
+/* Window coefficients interleaved by pairs of taps for 16x16+16x16 multiply
+ * accumulate instructions: [pair][output][2], the last pair is padded with 0.
+ * Output m of a block is sum(coeff[t][m] * s16X[m + t * 2 * subbands]). */
+extern const int16_t gas16WindowPairsFor4SBs[3 * 8 * 2];
+extern const int16_t gas16WindowPairsFor8SBs[3 * 16 * 2];
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#if (SBC_SIMD_SUPPORTED == TRUE)
+#include "sbc_dct.h"
+
+/* Lane parallel versions of SBC_FastIDCT8 and SBC_FastIDCT4: every lane of
+ * the vectors holds a different block. The including file provides SBC_V_T
+ * and the SBC_V_ADD/SUB/SRA/SHL/MULC operations. SBC_V_MULC(c, x) must
+ * return (int32_t)(((int64_t)c * x) >> 15) for 0 <= c < 0x8000. */
+#define SBC_FAST_IDCT8_LANES(in, out)                             \
+  {                                                               \
+    SBC_V_T x0, x1, x2, x3, x4, x5, x6, x7, temp;                 \
+    SBC_V_T res_even0, res_even1, res_even2, res_even3;           \
+    SBC_V_T res_odd0, res_odd1, res_odd2, res_odd3;               \
+    x0 = SBC_V_MULC(SBC_COS_PI_SUR_4, (in)[4]);                   \
+    x1 = SBC_V_SRA(SBC_V_ADD((in)[3], (in)[5]), 1);               \
+    x2 = SBC_V_SRA(SBC_V_ADD((in)[2], (in)[6]), 1);               \
+    x3 = SBC_V_SRA(SBC_V_ADD((in)[1], (in)[7]), 1);               \
+    x4 = SBC_V_SRA(SBC_V_ADD((in)[0], (in)[8]), 1);               \
+    x5 = SBC_V_SRA(SBC_V_SUB((in)[9], (in)[15]), 1);              \
+    x6 = SBC_V_SRA(SBC_V_SUB((in)[10], (in)[14]), 1);             \
+    x7 = SBC_V_SRA(SBC_V_SUB((in)[11], (in)[13]), 1);             \
+    temp = x0;                                                    \
+    x0 = SBC_V_MULC(SBC_COS_PI_SUR_4, SBC_V_ADD(x0, x4));         \
+    x4 = SBC_V_MULC(SBC_COS_PI_SUR_4, SBC_V_SUB(temp, x4));       \
+    x2 = SBC_V_SUB(x2, x6);                                       \
+    x6 = SBC_V_MULC(SBC_COS_PI_SUR_4, SBC_V_SHL(x6, 1));          \
+    temp = x2;                                                    \
+    x2 = SBC_V_MULC(SBC_COS_PI_SUR_8, SBC_V_ADD(x2, x6));         \
+    x6 = SBC_V_MULC(SBC_COS_3PI_SUR_8, SBC_V_SUB(temp, x6));      \
+    res_even0 = SBC_V_ADD(x0, x2);                                \
+    res_even1 = SBC_V_ADD(x4, x6);                                \
+    res_even2 = SBC_V_SUB(x4, x6);                                \
+    res_even3 = SBC_V_SUB(x0, x2);                                \
+    x7 = SBC_V_SHL(x7, 1);                                        \
+    x5 = SBC_V_SUB(SBC_V_SHL(x5, 1), x7);                         \
+    x3 = SBC_V_SUB(SBC_V_SHL(x3, 1), x5);                         \
+    x1 = SBC_V_SUB(x1, SBC_V_SRA(x3, 1));                         \
+    x5 = SBC_V_MULC(SBC_COS_PI_SUR_4, x5);                        \
+    temp = x1;                                                    \
+    x1 = SBC_V_ADD(x1, x5);                                       \
+    x5 = SBC_V_SUB(temp, x5);                                     \
+    x3 = SBC_V_SUB(x3, x7);                                       \
+    x7 = SBC_V_MULC(SBC_COS_PI_SUR_4, SBC_V_SHL(x7, 1));          \
+    temp = x3;                                                    \
+    x3 = SBC_V_MULC(SBC_COS_PI_SUR_8, SBC_V_ADD(x3, x7));         \
+    x7 = SBC_V_MULC(SBC_COS_3PI_SUR_8, SBC_V_SUB(temp, x7));      \
+    res_odd0 = SBC_V_MULC(SBC_COS_PI_SUR_16, SBC_V_ADD(x1, x3));  \
+    res_odd1 = SBC_V_MULC(SBC_COS_3PI_SUR_16, SBC_V_ADD(x5, x7)); \
+    res_odd2 = SBC_V_MULC(SBC_COS_5PI_SUR_16, SBC_V_SUB(x5, x7)); \
+    res_odd3 = SBC_V_MULC(SBC_COS_7PI_SUR_16, SBC_V_SUB(x1, x3)); \
+    (out)[0] = SBC_V_ADD(res_even0, res_odd0);                    \
+    (out)[1] = SBC_V_ADD(res_even1, res_odd1);                    \
+    (out)[2] = SBC_V_ADD(res_even2, res_odd2);                    \
+    (out)[3] = SBC_V_ADD(res_even3, res_odd3);                    \
+    (out)[7] = SBC_V_SUB(res_even0, res_odd0);                    \
+    (out)[6] = SBC_V_SUB(res_even1, res_odd1);                    \
+    (out)[5] = SBC_V_SUB(res_even2, res_odd2);                    \
+    (out)[4] = SBC_V_SUB(res_even3, res_odd3);                    \
+  }
+
+#define SBC_FAST_IDCT4_LANES(in, out)                                 \
+  {                                                                   \
+    SBC_V_T temp, x2, tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7; \
+    x2 = SBC_V_SRA((in)[2], 1);                                       \
+    temp = SBC_V_ADD((in)[0], (in)[4]);                               \
+    tmp0 = SBC_V_MULC(SBC_COS_PI_SUR_4 >> 1, temp);                   \
+    tmp1 = SBC_V_SUB(x2, tmp0);                                       \
+    tmp0 = SBC_V_ADD(tmp0, x2);                                       \
+    temp = SBC_V_ADD((in)[1], (in)[3]);                               \
+    tmp3 = SBC_V_MULC(SBC_COS_3PI_SUR_8 >> 1, temp);                  \
+    tmp2 = SBC_V_MULC(SBC_COS_PI_SUR_8 >> 1, temp);                   \
+    temp = SBC_V_SUB((in)[5], (in)[7]);                               \
+    tmp5 = SBC_V_MULC(SBC_COS_3PI_SUR_8 >> 1, temp);                  \
+    tmp4 = SBC_V_MULC(SBC_COS_PI_SUR_8 >> 1, temp);                   \
+    tmp6 = SBC_V_ADD(tmp2, tmp5);                                     \
+    tmp7 = SBC_V_SUB(tmp3, tmp4);                                     \
+    (out)[0] = SBC_V_ADD(tmp0, tmp6);                                 \
+    (out)[1] = SBC_V_ADD(tmp1, tmp7);                                 \
+    (out)[2] = SBC_V_SUB(tmp1, tmp7);                                 \
+    (out)[3] = SBC_V_SUB(tmp0, tmp6);                                 \
+  }
+#endif
+
+#endif /* SBC_SIMD_H */
@@ -26,6 +26,7 @@
 
 #include "sbc_enc_func_declare.h"
 #include "sbc_encoder.h"
+#include "sbc_simd.h"
 /*#include <math.h>*/
 
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
@@ -165,7 +166,9 @@
 #if (SBC_USE_ARM_PRAGMA == TRUE)
 #pragma arm section zidata = "sbc_s32_analysis_section"
 #endif
-static int32_t s32DCTY[16] = {0};
+/* Windowed vectors of all blocks and channels of a frame */
+static int32_t s32DCTY[SBC_MAX_NUM_OF_BLOCKS * SBC_MAX_NUM_OF_CHANNELS * 2 *
+                       SBC_MAX_NUM_OF_SUBBANDS] = {0};
 static int32_t s32X[ENC_VX_BUFFER_SIZE / 2];
 static int16_t* s16X = (int16_t*)s32X; /* s16X must be 32 bits aligned cf  SHIFTUP_X8_2*/
 #if (SBC_USE_ARM_PRAGMA == TRUE)
@@ -968,20 +971,99 @@ static int16_t* s16X = (int16_t*)s32X; /* s16X must be 32 bits aligned cf  SHIFT
 #endif
 #endif
 
+#if (SBC_SIMD_SUPPORTED == TRUE)
+const int16_t gas16WindowPairsFor4SBs[3 * 8 * 2] = {
+        /* taps 0 and 1 */
+        0, WIND_4_SUBBANDS_0_1,
+        WIND_4_SUBBANDS_1_0, WIND_4_SUBBANDS_1_1,
+        WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_2_1,
+        WIND_4_SUBBANDS_3_0, WIND_4_SUBBANDS_3_1,
+        WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_4_1,
+        WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_3_3,
+        WIND_4_SUBBANDS_2_4, WIND_4_SUBBANDS_2_3,
+        WIND_4_SUBBANDS_1_4, WIND_4_SUBBANDS_1_3,
+        /* taps 2 and 3 */
+        WIND_4_SUBBANDS_0_2, (int16_t)-WIND_4_SUBBANDS_0_2,
+        WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_1_3,
+        WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_2_3,
+        WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_3_3,
+        WIND_4_SUBBANDS_4_2, WIND_4_SUBBANDS_4_1,
+        WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_3_1,
+        WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_2_1,
+        WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_1_1,
+        /* tap 4 */
+        (int16_t)-WIND_4_SUBBANDS_0_1, 0,
+        WIND_4_SUBBANDS_1_4, 0,
+        WIND_4_SUBBANDS_2_4, 0,
+        WIND_4_SUBBANDS_3_4, 0,
+        WIND_4_SUBBANDS_4_0, 0,
+        WIND_4_SUBBANDS_3_0, 0,
+        WIND_4_SUBBANDS_2_0, 0,
+        WIND_4_SUBBANDS_1_0, 0,
+};
+
+const int16_t gas16WindowPairsFor8SBs[3 * 16 * 2] = {
+        /* taps 0 and 1 */
+        0, WIND_8_SUBBANDS_0_1,
+        WIND_8_SUBBANDS_1_0, WIND_8_SUBBANDS_1_1,
+        WIND_8_SUBBANDS_2_0, WIND_8_SUBBANDS_2_1,
+        WIND_8_SUBBANDS_3_0, WIND_8_SUBBANDS_3_1,
+        WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_4_1,
+        WIND_8_SUBBANDS_5_0, WIND_8_SUBBANDS_5_1,
+        WIND_8_SUBBANDS_6_0, WIND_8_SUBBANDS_6_1,
+        WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_7_1,
+        WIND_8_SUBBANDS_8_0, WIND_8_SUBBANDS_8_1,
+        WIND_8_SUBBANDS_7_4, WIND_8_SUBBANDS_7_3,
+        WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_6_3,
+        WIND_8_SUBBANDS_5_4, WIND_8_SUBBANDS_5_3,
+        WIND_8_SUBBANDS_4_4, WIND_8_SUBBANDS_4_3,
+        WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_3_3,
+        WIND_8_SUBBANDS_2_4, WIND_8_SUBBANDS_2_3,
+        WIND_8_SUBBANDS_1_4, WIND_8_SUBBANDS_1_3,
+        /* taps 2 and 3 */
+        WIND_8_SUBBANDS_0_2, (int16_t)-WIND_8_SUBBANDS_0_2,
+        WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_1_3,
+        WIND_8_SUBBANDS_2_2, WIND_8_SUBBANDS_2_3,
+        WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_3_3,
+        WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_4_3,
+        WIND_8_SUBBANDS_5_2, WIND_8_SUBBANDS_5_3,
+        WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_6_3,
+        WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_7_3,
+        WIND_8_SUBBANDS_8_2, WIND_8_SUBBANDS_8_1,
+        WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_7_1,
+        WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_6_1,
+        WIND_8_SUBBANDS_5_2, WIND_8_SUBBANDS_5_1,
+        WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_4_1,
+        WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_3_1,
+        WIND_8_SUBBANDS_2_2, WIND_8_SUBBANDS_2_1,
+        WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_1_1,
+        /* tap 4 */
+        (int16_t)-WIND_8_SUBBANDS_0_1, 0,
+        WIND_8_SUBBANDS_1_4, 0,
+        WIND_8_SUBBANDS_2_4, 0,
+        WIND_8_SUBBANDS_3_4, 0,
+        WIND_8_SUBBANDS_4_4, 0,
+        WIND_8_SUBBANDS_5_4, 0,
+        WIND_8_SUBBANDS_6_4, 0,
+        WIND_8_SUBBANDS_7_4, 0,
+        WIND_8_SUBBANDS_8_0, 0,
+        WIND_8_SUBBANDS_7_0, 0,
+        WIND_8_SUBBANDS_6_0, 0,
+        WIND_8_SUBBANDS_5_0, 0,
+        WIND_8_SUBBANDS_4_0, 0,
+        WIND_8_SUBBANDS_3_0, 0,
+        WIND_8_SUBBANDS_2_0, 0,
+        WIND_8_SUBBANDS_1_0, 0,
+};
+#endif
+
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
-/****************************************************************************
- * SbcAnalysisFilter - performs Analysis of the input audio stream
- *
- * RETURNS : N/A
- */
-void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
-  int16_t* ps16PcmBuf;
-  int32_t* ps32SbBuf;
-  int32_t s32Blk, s32Ch;
-  int32_t s32NumOfChannels, s32NumOfBlocks;
-  int32_t i, *ps32X, *ps32X2;
-  int32_t Offset, Offset2, ChOffset;
+
+/* Scalar windowing and matrixing kernels, |s16X| shadows the global input
+ * buffer so that the WINDOW_PARTIAL macros can be used as they are. */
+void SbcWindow4_C(const int16_t* s16X, int32_t* s32DCTY) {
+  const int32_t ChOffset = 0;
 #if (SBC_ARM_ASM_OPT == TRUE)
   register int32_t s32Hi, s32Hi2;
 #else
@@ -1000,12 +1082,70 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 #endif
 #endif
 
+  WINDOW_PARTIAL_4
+}
+
+void SbcWindow8_C(const int16_t* s16X, int32_t* s32DCTY) {
+  const int32_t ChOffset = 0;
+#if (SBC_ARM_ASM_OPT == TRUE)
+  register int32_t s32Hi, s32Hi2;
+#else
+#if (SBC_IPAQ_OPT == TRUE)
+#if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
+  register int64_t s64Temp, s64Temp2;
+#else
+  register int32_t s32Temp, s32Temp2;
+#endif
+#else
+#if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
+  int64_t s64Temp;
+#endif
+#endif
+#endif
+
+  WINDOW_PARTIAL_8
+}
+
+void SbcDct4_C(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  for (; n > 0; n--) {
+    SBC_FastIDCT4(ps32DCTY, ps32SbBuf);
+    ps32DCTY += 2 * SUB_BANDS_4;
+    ps32SbBuf += SUB_BANDS_4;
+  }
+}
+
+void SbcDct8_C(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  for (; n > 0; n--) {
+    SBC_FastIDCT8(ps32DCTY, ps32SbBuf);
+    ps32DCTY += 2 * SUB_BANDS_8;
+    ps32SbBuf += SUB_BANDS_8;
+  }
+}
+
+/****************************************************************************
+ * SbcAnalysisFilter - performs Analysis of the input audio stream
+ *
+ * The windowing runs block by block since the input buffer is shifted up
+ * while the frame is processed, the matrixing of the whole frame is then
+ * done in one pass.
+ *
+ * RETURNS : N/A
+ */
+void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
+  const SBC_ANALYSIS_KERNELS* kernels = SbcAnalysisKernels();
+  int16_t* ps16PcmBuf;
+  int32_t* ps32DCTY;
+  int32_t s32Blk, s32Ch;
+  int32_t s32NumOfChannels, s32NumOfBlocks;
+  int32_t i, *ps32X, *ps32X2;
+  int32_t Offset, Offset2, ChOffset;
+
   s32NumOfChannels = pstrEncParams->s16NumOfChannels;
   s32NumOfBlocks = pstrEncParams->s16NumOfBlocks;
 
   ps16PcmBuf = input;
 
-  ps32SbBuf = pstrEncParams->s32SbBuffer;
+  ps32DCTY = s32DCTY;
   Offset2 = (int32_t)(EncMaxShiftCounter + 40);
   for (s32Blk = 0; s32Blk < s32NumOfBlocks; s32Blk++) {
     Offset = (int32_t)(EncMaxShiftCounter - ShiftCounter);
@@ -1040,11 +1180,9 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_4
-
-      SBC_FastIDCT4(s32DCTY, ps32SbBuf);
+      kernels->window4(s16X + ChOffset, ps32DCTY);
 
-      ps32SbBuf += SUB_BANDS_4;
+      ps32DCTY += 2 * SUB_BANDS_4;
     }
     if (s32NumOfChannels == 1) {
       if (ShiftCounter >= EncMaxShiftCounter) {
@@ -1062,39 +1200,27 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
       }
     }
   }
+
+  kernels->dct4(s32DCTY, pstrEncParams->s32SbBuffer, s32NumOfBlocks * s32NumOfChannels);
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
 void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
+  const SBC_ANALYSIS_KERNELS* kernels = SbcAnalysisKernels();
   int16_t* ps16PcmBuf;
-  int32_t* ps32SbBuf;
+  int32_t* ps32DCTY;
   int32_t s32Blk, s32Ch; /* counter for block*/
   int32_t Offset, Offset2;
   int32_t s32NumOfChannels, s32NumOfBlocks;
   int32_t i, *ps32X, *ps32X2;
   int32_t ChOffset;
-#if (SBC_ARM_ASM_OPT == TRUE)
-  register int32_t s32Hi, s32Hi2;
-#else
-#if (SBC_IPAQ_OPT == TRUE)
-#if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
-  register int64_t s64Temp, s64Temp2;
-#else
-  register int32_t s32Temp, s32Temp2;
-#endif
-#else
-#if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
-  int64_t s64Temp;
-#endif
-#endif
-#endif
 
   s32NumOfChannels = pstrEncParams->s16NumOfChannels;
   s32NumOfBlocks = pstrEncParams->s16NumOfBlocks;
 
   ps16PcmBuf = input;
 
-  ps32SbBuf = pstrEncParams->s32SbBuffer;
+  ps32DCTY = s32DCTY;
   Offset2 = (int32_t)(EncMaxShiftCounter + 80);
   for (s32Blk = 0; s32Blk < s32NumOfBlocks; s32Blk++) {
     Offset = (int32_t)(EncMaxShiftCounter - ShiftCounter);
@@ -1153,11 +1279,9 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_8
+      kernels->window8(s16X + ChOffset, ps32DCTY);
 
-      SBC_FastIDCT8(s32DCTY, ps32SbBuf);
-
-      ps32SbBuf += SUB_BANDS_8;
+      ps32DCTY += 2 * SUB_BANDS_8;
     }
     if (s32NumOfChannels == 1) {
       if (ShiftCounter >= EncMaxShiftCounter) {
@@ -1175,6 +1299,8 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
       }
     }
   }
+
+  kernels->dct8(s32DCTY, pstrEncParams->s32SbBuffer, s32NumOfBlocks * s32NumOfChannels);
 }
 
 void SbcAnalysisInit(void) {
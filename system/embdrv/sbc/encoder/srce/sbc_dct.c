@@ -39,28 +39,6 @@
  *
  ******************************************************************************/
 
-#if (SBC_IS_64_MULT_IN_IDCT == FALSE)
-#define SBC_COS_PI_SUR_4                                                       \
-  (0x00005a82)                          /* ((0x8000) * 0.7071)     = cos(pi/4) \
-                                         */
-#define SBC_COS_PI_SUR_8 (0x00007641)   /* ((0x8000) * 0.9239)     = (cos(pi/8)) */
-#define SBC_COS_3PI_SUR_8 (0x000030fb)  /* ((0x8000) * 0.3827)     = (cos(3*pi/8)) */
-#define SBC_COS_PI_SUR_16 (0x00007d8a)  /* ((0x8000) * 0.9808))     = (cos(pi/16)) */
-#define SBC_COS_3PI_SUR_16 (0x00006a6d) /* ((0x8000) * 0.8315))     = (cos(3*pi/16)) */
-#define SBC_COS_5PI_SUR_16 (0x0000471c) /* ((0x8000) * 0.5556))     = (cos(5*pi/16)) */
-#define SBC_COS_7PI_SUR_16 (0x000018f8) /* ((0x8000) * 0.1951))     = (cos(7*pi/16)) */
-#define SBC_IDCT_MULT(a, b, c) SBC_MULT_32_16_SIMPLIFIED(a, b, c)
-#else
-#define SBC_COS_PI_SUR_4 (0x5A827999)   /* ((0x80000000) * 0.707106781)      = (cos(pi/4)   ) */
-#define SBC_COS_PI_SUR_8 (0x7641AF3C)   /* ((0x80000000) * 0.923879533)      = (cos(pi/8)   ) */
-#define SBC_COS_3PI_SUR_8 (0x30FBC54D)  /* ((0x80000000) * 0.382683432)      = (cos(3*pi/8) ) */
-#define SBC_COS_PI_SUR_16 (0x7D8A5F3F)  /* ((0x80000000) * 0.98078528 ))     = (cos(pi/16)  ) */
-#define SBC_COS_3PI_SUR_16 (0x6A6D98A4) /* ((0x80000000) * 0.831469612))     = (cos(3*pi/16)) */
-#define SBC_COS_5PI_SUR_16 (0x471CECE6) /* ((0x80000000) * 0.555570233))     = (cos(5*pi/16)) */
-#define SBC_COS_7PI_SUR_16 (0x18F8B83C) /* ((0x80000000) * 0.195090322))     = (cos(7*pi/16)) */
-#define SBC_IDCT_MULT(a, b, c) SBC_MULT_32_32(a, b, c)
-#endif /* SBC_IS_64_MULT_IN_IDCT */
-
 #if (SBC_FAST_DCT == FALSE)
 extern const int16_t gas16AnalDCTcoeff8[];
 extern const int16_t gas16AnalDCTcoeff4[];
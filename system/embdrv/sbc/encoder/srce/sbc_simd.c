@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Selection of the analysis filterbank kernels.
+ *
+ ******************************************************************************/
+
+#include "sbc_simd.h"
+
+#include <stddef.h>
+
+#include "sbc_encoder.h"
+
+const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_c = {
+        .impl = SBC_ENC_IMPL_SCALAR,
+        .window4 = SbcWindow4_C,
+        .window8 = SbcWindow8_C,
+        .dct4 = SbcDct4_C,
+        .dct8 = SbcDct8_C,
+};
+
+static const SBC_ANALYSIS_KERNELS* sbc_analysis_kernels = NULL;
+
+static const SBC_ANALYSIS_KERNELS* SbcKernelsForImpl(SBC_ENC_IMPL impl) {
+  switch (impl) {
+    case SBC_ENC_IMPL_SCALAR:
+      return &sbc_analysis_kernels_c;
+#if (SBC_SIMD_X86 == TRUE)
+    case SBC_ENC_IMPL_SSE41:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.1") ? &sbc_analysis_kernels_sse41 : NULL;
+    case SBC_ENC_IMPL_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? &sbc_analysis_kernels_avx2 : NULL;
+#endif
+#if (SBC_SIMD_NEON == TRUE)
+    case SBC_ENC_IMPL_NEON:
+      return &sbc_analysis_kernels_neon;
+#endif
+    default:
+      return NULL;
+  }
+}
+
+static const SBC_ANALYSIS_KERNELS* SbcBestKernels(void) {
+  static const SBC_ENC_IMPL preferred[] = {SBC_ENC_IMPL_AVX2, SBC_ENC_IMPL_SSE41,
+                                           SBC_ENC_IMPL_NEON};
+  const SBC_ANALYSIS_KERNELS* kernels;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++) {
+    kernels = SbcKernelsForImpl(preferred[i]);
+    if (kernels != NULL) {
+      return kernels;
+    }
+  }
+  return &sbc_analysis_kernels_c;
+}
+
+const SBC_ANALYSIS_KERNELS* SbcAnalysisKernels(void) {
+  if (sbc_analysis_kernels == NULL) {
+    sbc_analysis_kernels = SbcBestKernels();
+  }
+  return sbc_analysis_kernels;
+}
+
+bool SBC_Encoder_SelectImpl(SBC_ENC_IMPL impl) {
+  const SBC_ANALYSIS_KERNELS* kernels;
+
+  kernels = (impl == SBC_ENC_IMPL_AUTO) ? SbcBestKernels() : SbcKernelsForImpl(impl);
+  if (kernels == NULL) {
+    return false;
+  }
+  sbc_analysis_kernels = kernels;
+  return true;
+}
+
+SBC_ENC_IMPL SBC_Encoder_GetImpl(void) { return SbcAnalysisKernels()->impl; }
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  NEON analysis filterbank kernels.
+ *
+ ******************************************************************************/
+
+#include "sbc_simd.h"
+
+#if (SBC_SIMD_NEON == TRUE)
+#include <arm_neon.h>
+
+#define SBC_TRANSPOSE_4X4_NEON(r0, r1, r2, r3)                               \
+  {                                                                          \
+    int32x4x2_t t01 = vtrnq_s32(r0, r1);                                     \
+    int32x4x2_t t23 = vtrnq_s32(r2, r3);                                     \
+    r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));   \
+    r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));   \
+    r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0])); \
+    r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1])); \
+  }
+
+#define SBC_V_T int32x4_t
+#define SBC_V_ADD(a, b) vaddq_s32(a, b)
+#define SBC_V_SUB(a, b) vsubq_s32(a, b)
+#define SBC_V_SRA(a, n) vshrq_n_s32(a, n)
+#define SBC_V_SHL(a, n) vshlq_n_s32(a, n)
+/* c * x >> 15 computed as (c * (x >> 16) << 1) + (c * (x & 0xFFFF) >> 15) */
+#define SBC_V_MULC(c, x)                                        \
+  vaddq_s32(vshlq_n_s32(vmulq_n_s32(vshrq_n_s32(x, 16), c), 1), \
+            vshrq_n_s32(vmulq_n_s32(vandq_s32(x, vdupq_n_s32(0xFFFF)), c), 15))
+
+/* Accumulates the 5 taps of 8 consecutive outputs, |coeffs| points to the
+ * coefficient pairs of the first output and |stride| is 2 * subbands. */
+#define SBC_WINDOW_8_OUTPUTS(s16X, coeffs, stride, s32DCTY)           \
+  {                                                                   \
+    int16x8x2_t c01 = vld2q_s16(coeffs);                              \
+    int16x8x2_t c23 = vld2q_s16((coeffs) + (stride) * 2);             \
+    int16x8x2_t c4 = vld2q_s16((coeffs) + (stride) * 4);              \
+    int16x8_t x0 = vld1q_s16(s16X);                                   \
+    int16x8_t x1 = vld1q_s16((s16X) + (stride));                      \
+    int16x8_t x2 = vld1q_s16((s16X) + (stride) * 2);                  \
+    int16x8_t x3 = vld1q_s16((s16X) + (stride) * 3);                  \
+    int16x8_t x4 = vld1q_s16((s16X) + (stride) * 4);                  \
+    int32x4_t lo, hi;                                                 \
+    lo = vmull_s16(vget_low_s16(x0), vget_low_s16(c01.val[0]));       \
+    hi = vmull_s16(vget_high_s16(x0), vget_high_s16(c01.val[0]));     \
+    lo = vmlal_s16(lo, vget_low_s16(x1), vget_low_s16(c01.val[1]));   \
+    hi = vmlal_s16(hi, vget_high_s16(x1), vget_high_s16(c01.val[1])); \
+    lo = vmlal_s16(lo, vget_low_s16(x2), vget_low_s16(c23.val[0]));   \
+    hi = vmlal_s16(hi, vget_high_s16(x2), vget_high_s16(c23.val[0])); \
+    lo = vmlal_s16(lo, vget_low_s16(x3), vget_low_s16(c23.val[1]));   \
+    hi = vmlal_s16(hi, vget_high_s16(x3), vget_high_s16(c23.val[1])); \
+    lo = vmlal_s16(lo, vget_low_s16(x4), vget_low_s16(c4.val[0]));    \
+    hi = vmlal_s16(hi, vget_high_s16(x4), vget_high_s16(c4.val[0]));  \
+    vst1q_s32(s32DCTY, lo);                                           \
+    vst1q_s32((s32DCTY) + 4, hi);                                     \
+  }
+
+static void SbcWindow4_NEON(const int16_t* s16X, int32_t* s32DCTY) {
+  SBC_WINDOW_8_OUTPUTS(s16X, gas16WindowPairsFor4SBs, 2 * SUB_BANDS_4, s32DCTY);
+}
+
+static void SbcWindow8_NEON(const int16_t* s16X, int32_t* s32DCTY) {
+  SBC_WINDOW_8_OUTPUTS(s16X, gas16WindowPairsFor8SBs, 2 * SUB_BANDS_8, s32DCTY);
+  SBC_WINDOW_8_OUTPUTS(s16X + 8, gas16WindowPairsFor8SBs + 16, 2 * SUB_BANDS_8, s32DCTY + 8);
+}
+
+static void SbcDct4_NEON(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  /* 4 blocks at a time, one per lane */
+  for (; n >= 4; n -= 4) {
+    int32x4_t in[8], out[4];
+    int32_t k, v;
+
+    for (k = 0; k < 8; k += 4) {
+      for (v = 0; v < 4; v++) {
+        in[k + v] = vld1q_s32(ps32DCTY + v * 8 + k);
+      }
+      SBC_TRANSPOSE_4X4_NEON(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+
+    SBC_FAST_IDCT4_LANES(in, out);
+
+    SBC_TRANSPOSE_4X4_NEON(out[0], out[1], out[2], out[3]);
+    for (v = 0; v < 4; v++) {
+      vst1q_s32(ps32SbBuf + v * 4, out[v]);
+    }
+
+    ps32DCTY += 4 * 2 * SUB_BANDS_4;
+    ps32SbBuf += 4 * SUB_BANDS_4;
+  }
+
+  SbcDct4_C(ps32DCTY, ps32SbBuf, n);
+}
+
+static void SbcDct8_NEON(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  /* 4 blocks at a time, one per lane */
+  for (; n >= 4; n -= 4) {
+    int32x4_t in[16], out[8];
+    int32_t k, v;
+
+    for (k = 0; k < 16; k += 4) {
+      for (v = 0; v < 4; v++) {
+        in[k + v] = vld1q_s32(ps32DCTY + v * 16 + k);
+      }
+      SBC_TRANSPOSE_4X4_NEON(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+
+    SBC_FAST_IDCT8_LANES(in, out);
+
+    for (k = 0; k < 8; k += 4) {
+      SBC_TRANSPOSE_4X4_NEON(out[k], out[k + 1], out[k + 2], out[k + 3]);
+      for (v = 0; v < 4; v++) {
+        vst1q_s32(ps32SbBuf + v * 8 + k, out[k + v]);
+      }
+    }
+
+    ps32DCTY += 4 * 2 * SUB_BANDS_8;
+    ps32SbBuf += 4 * SUB_BANDS_8;
+  }
+
+  SbcDct8_C(ps32DCTY, ps32SbBuf, n);
+}
+
+const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_neon = {
+        .impl = SBC_ENC_IMPL_NEON,
+        .window4 = SbcWindow4_NEON,
+        .window8 = SbcWindow8_NEON,
+        .dct4 = SbcDct4_NEON,
+        .dct8 = SbcDct8_NEON,
+};
+
+#endif /* SBC_SIMD_NEON */
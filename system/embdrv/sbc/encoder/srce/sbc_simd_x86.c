@@ -0,0 +1,329 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  SSE4.1 and AVX2 analysis filterbank kernels. The functions are compiled
+ *  for their own target so that the baseline build still runs on any x86,
+ *  sbc_simd.c only selects them when the CPU supports the extension.
+ *
+ ******************************************************************************/
+
+#include "sbc_simd.h"
+
+#if (SBC_SIMD_X86 == TRUE)
+#include <immintrin.h>
+
+#define SBC_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SBC_TARGET_AVX2 __attribute__((target("avx2")))
+
+/* 4x4 transposition of 32 bit lanes, in each 128 bit half for AVX2 */
+#define SBC_TRANSPOSE_4X4_SSE(r0, r1, r2, r3) \
+  {                                           \
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);  \
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);  \
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);  \
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);  \
+    r0 = _mm_unpacklo_epi64(t0, t1);          \
+    r1 = _mm_unpackhi_epi64(t0, t1);          \
+    r2 = _mm_unpacklo_epi64(t2, t3);          \
+    r3 = _mm_unpackhi_epi64(t2, t3);          \
+  }
+
+#define SBC_TRANSPOSE_4X4_AVX2(r0, r1, r2, r3)  \
+  {                                             \
+    __m256i t0 = _mm256_unpacklo_epi32(r0, r1); \
+    __m256i t1 = _mm256_unpacklo_epi32(r2, r3); \
+    __m256i t2 = _mm256_unpackhi_epi32(r0, r1); \
+    __m256i t3 = _mm256_unpackhi_epi32(r2, r3); \
+    r0 = _mm256_unpacklo_epi64(t0, t1);         \
+    r1 = _mm256_unpackhi_epi64(t0, t1);         \
+    r2 = _mm256_unpacklo_epi64(t2, t3);         \
+    r3 = _mm256_unpackhi_epi64(t2, t3);         \
+  }
+
+/******************************************************************************
+ * SSE4.1
+ */
+#define SBC_V_T __m128i
+#define SBC_V_ADD(a, b) _mm_add_epi32(a, b)
+#define SBC_V_SUB(a, b) _mm_sub_epi32(a, b)
+#define SBC_V_SRA(a, n) _mm_srai_epi32(a, n)
+#define SBC_V_SHL(a, n) _mm_slli_epi32(a, n)
+/* c * x >> 15 computed as (c * (x >> 16) << 1) + (c * (x & 0xFFFF) >> 15) */
+#define SBC_V_MULC(c, x)                                                                  \
+  _mm_add_epi32(_mm_slli_epi32(_mm_mullo_epi32(_mm_set1_epi32(c), _mm_srai_epi32(x, 16)), \
+                               1),                                                        \
+                _mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(c),                         \
+                                               _mm_and_si128(x, _mm_set1_epi32(0xFFFF))), \
+                               15))
+
+static SBC_TARGET_SSE41 void SbcWindow4_SSE41(const int16_t* s16X, int32_t* s32DCTY) {
+  const int16_t* coeffs = gas16WindowPairsFor4SBs;
+  __m128i x0 = _mm_loadu_si128((const __m128i*)(s16X + 0));
+  __m128i x1 = _mm_loadu_si128((const __m128i*)(s16X + 8));
+  __m128i x2 = _mm_loadu_si128((const __m128i*)(s16X + 16));
+  __m128i x3 = _mm_loadu_si128((const __m128i*)(s16X + 24));
+  __m128i x4 = _mm_loadu_si128((const __m128i*)(s16X + 32));
+  __m128i zero = _mm_setzero_si128();
+  __m128i lo, hi;
+
+  lo = _mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), _mm_loadu_si128((const __m128i*)(coeffs + 0)));
+  hi = _mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), _mm_loadu_si128((const __m128i*)(coeffs + 8)));
+  lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x2, x3),
+                                        _mm_loadu_si128((const __m128i*)(coeffs + 16))));
+  hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x2, x3),
+                                        _mm_loadu_si128((const __m128i*)(coeffs + 24))));
+  lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x4, zero),
+                                        _mm_loadu_si128((const __m128i*)(coeffs + 32))));
+  hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x4, zero),
+                                        _mm_loadu_si128((const __m128i*)(coeffs + 40))));
+
+  _mm_storeu_si128((__m128i*)(s32DCTY + 0), lo);
+  _mm_storeu_si128((__m128i*)(s32DCTY + 4), hi);
+}
+
+static SBC_TARGET_SSE41 void SbcWindow8_SSE41(const int16_t* s16X, int32_t* s32DCTY) {
+  __m128i zero = _mm_setzero_si128();
+  int32_t m;
+
+  /* Outputs m..m+7 use the samples m..m+7 of each of the 5 taps */
+  for (m = 0; m < 16; m += 8) {
+    const int16_t* coeffs = gas16WindowPairsFor8SBs + m * 2;
+    __m128i x0 = _mm_loadu_si128((const __m128i*)(s16X + m));
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(s16X + m + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(s16X + m + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(s16X + m + 48));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(s16X + m + 64));
+    __m128i lo, hi;
+
+    lo = _mm_madd_epi16(_mm_unpacklo_epi16(x0, x1),
+                        _mm_loadu_si128((const __m128i*)(coeffs + 0)));
+    hi = _mm_madd_epi16(_mm_unpackhi_epi16(x0, x1),
+                        _mm_loadu_si128((const __m128i*)(coeffs + 8)));
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x2, x3),
+                                          _mm_loadu_si128((const __m128i*)(coeffs + 32))));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x2, x3),
+                                          _mm_loadu_si128((const __m128i*)(coeffs + 40))));
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x4, zero),
+                                          _mm_loadu_si128((const __m128i*)(coeffs + 64))));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x4, zero),
+                                          _mm_loadu_si128((const __m128i*)(coeffs + 72))));
+
+    _mm_storeu_si128((__m128i*)(s32DCTY + m), lo);
+    _mm_storeu_si128((__m128i*)(s32DCTY + m + 4), hi);
+  }
+}
+
+static SBC_TARGET_SSE41 void SbcDct4_SSE41(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  /* 4 blocks at a time, one per lane */
+  for (; n >= 4; n -= 4) {
+    __m128i in[8], out[4];
+    int32_t k, v;
+
+    for (k = 0; k < 8; k += 4) {
+      for (v = 0; v < 4; v++) {
+        in[k + v] = _mm_loadu_si128((const __m128i*)(ps32DCTY + v * 8 + k));
+      }
+      SBC_TRANSPOSE_4X4_SSE(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+
+    SBC_FAST_IDCT4_LANES(in, out);
+
+    SBC_TRANSPOSE_4X4_SSE(out[0], out[1], out[2], out[3]);
+    for (v = 0; v < 4; v++) {
+      _mm_storeu_si128((__m128i*)(ps32SbBuf + v * 4), out[v]);
+    }
+
+    ps32DCTY += 4 * 2 * SUB_BANDS_4;
+    ps32SbBuf += 4 * SUB_BANDS_4;
+  }
+
+  SbcDct4_C(ps32DCTY, ps32SbBuf, n);
+}
+
+static SBC_TARGET_SSE41 void SbcDct8_SSE41(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  /* 4 blocks at a time, one per lane */
+  for (; n >= 4; n -= 4) {
+    __m128i in[16], out[8];
+    int32_t k, v;
+
+    for (k = 0; k < 16; k += 4) {
+      for (v = 0; v < 4; v++) {
+        in[k + v] = _mm_loadu_si128((const __m128i*)(ps32DCTY + v * 16 + k));
+      }
+      SBC_TRANSPOSE_4X4_SSE(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+
+    SBC_FAST_IDCT8_LANES(in, out);
+
+    for (k = 0; k < 8; k += 4) {
+      SBC_TRANSPOSE_4X4_SSE(out[k], out[k + 1], out[k + 2], out[k + 3]);
+      for (v = 0; v < 4; v++) {
+        _mm_storeu_si128((__m128i*)(ps32SbBuf + v * 8 + k), out[k + v]);
+      }
+    }
+
+    ps32DCTY += 4 * 2 * SUB_BANDS_8;
+    ps32SbBuf += 4 * SUB_BANDS_8;
+  }
+
+  SbcDct8_C(ps32DCTY, ps32SbBuf, n);
+}
+
+const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_sse41 = {
+        .impl = SBC_ENC_IMPL_SSE41,
+        .window4 = SbcWindow4_SSE41,
+        .window8 = SbcWindow8_SSE41,
+        .dct4 = SbcDct4_SSE41,
+        .dct8 = SbcDct8_SSE41,
+};
+
+#undef SBC_V_T
+#undef SBC_V_ADD
+#undef SBC_V_SUB
+#undef SBC_V_SRA
+#undef SBC_V_SHL
+#undef SBC_V_MULC
+
+/******************************************************************************
+ * AVX2
+ */
+#define SBC_V_T __m256i
+#define SBC_V_ADD(a, b) _mm256_add_epi32(a, b)
+#define SBC_V_SUB(a, b) _mm256_sub_epi32(a, b)
+#define SBC_V_SRA(a, n) _mm256_srai_epi32(a, n)
+#define SBC_V_SHL(a, n) _mm256_slli_epi32(a, n)
+#define SBC_V_MULC(c, x)                                                               \
+  _mm256_add_epi32(                                                                    \
+          _mm256_slli_epi32(                                                           \
+                  _mm256_mullo_epi32(_mm256_set1_epi32(c), _mm256_srai_epi32(x, 16)),  \
+                  1),                                                                  \
+          _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(c),                   \
+                                               _mm256_and_si256(                       \
+                                                       x, _mm256_set1_epi32(0xFFFF))), \
+                            15))
+
+/* Loads 4 values of two blocks |stride| apart in the low and high halves */
+#define SBC_LOAD_2X4(p, stride)                                                         \
+  _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(p))), \
+                          _mm_loadu_si128((const __m128i*)((p) + (stride))), 1)
+
+#define SBC_STORE_2X4(p, stride, a)                                               \
+  {                                                                               \
+    _mm_storeu_si128((__m128i*)(p), _mm256_castsi256_si128(a));                   \
+    _mm_storeu_si128((__m128i*)((p) + (stride)), _mm256_extracti128_si256(a, 1)); \
+  }
+
+static SBC_TARGET_AVX2 void SbcWindow8_AVX2(const int16_t* s16X, int32_t* s32DCTY) {
+  const int16_t* coeffs = gas16WindowPairsFor8SBs;
+  __m256i x0 = _mm256_loadu_si256((const __m256i*)(s16X + 0));
+  __m256i x1 = _mm256_loadu_si256((const __m256i*)(s16X + 16));
+  __m256i x2 = _mm256_loadu_si256((const __m256i*)(s16X + 32));
+  __m256i x3 = _mm256_loadu_si256((const __m256i*)(s16X + 48));
+  __m256i x4 = _mm256_loadu_si256((const __m256i*)(s16X + 64));
+  __m256i zero = _mm256_setzero_si256();
+  __m256i lo, hi, c0, c1;
+  int32_t p;
+
+  /* The 16 bit unpacks work in each 128 bit half: |lo| accumulates the
+   * outputs 0..3 and 8..11, |hi| the outputs 4..7 and 12..15. */
+  lo = _mm256_setzero_si256();
+  hi = _mm256_setzero_si256();
+  for (p = 0; p < 3; p++) {
+    __m256i a = (p == 0) ? x0 : (p == 1) ? x2 : x4;
+    __m256i b = (p == 0) ? x1 : (p == 1) ? x3 : zero;
+
+    c0 = _mm256_loadu_si256((const __m256i*)(coeffs + p * 32));
+    c1 = _mm256_loadu_si256((const __m256i*)(coeffs + p * 32 + 16));
+    lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b),
+                                                _mm256_permute2x128_si256(c0, c1, 0x20)));
+    hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b),
+                                                _mm256_permute2x128_si256(c0, c1, 0x31)));
+  }
+
+  _mm256_storeu_si256((__m256i*)(s32DCTY + 0), _mm256_permute2x128_si256(lo, hi, 0x20));
+  _mm256_storeu_si256((__m256i*)(s32DCTY + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+static SBC_TARGET_AVX2 void SbcDct4_AVX2(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  /* 8 blocks at a time, blocks v and v + 4 share a row of the transposition */
+  for (; n >= 8; n -= 8) {
+    __m256i in[8], out[4];
+    int32_t k, v;
+
+    for (k = 0; k < 8; k += 4) {
+      for (v = 0; v < 4; v++) {
+        in[k + v] = SBC_LOAD_2X4(ps32DCTY + v * 8 + k, 4 * 8);
+      }
+      SBC_TRANSPOSE_4X4_AVX2(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+
+    SBC_FAST_IDCT4_LANES(in, out);
+
+    SBC_TRANSPOSE_4X4_AVX2(out[0], out[1], out[2], out[3]);
+    for (v = 0; v < 4; v++) {
+      SBC_STORE_2X4(ps32SbBuf + v * 4, 4 * 4, out[v]);
+    }
+
+    ps32DCTY += 8 * 2 * SUB_BANDS_4;
+    ps32SbBuf += 8 * SUB_BANDS_4;
+  }
+
+  SbcDct4_SSE41(ps32DCTY, ps32SbBuf, n);
+}
+
+static SBC_TARGET_AVX2 void SbcDct8_AVX2(int32_t* ps32DCTY, int32_t* ps32SbBuf, int32_t n) {
+  /* 8 blocks at a time, blocks v and v + 4 share a row of the transposition */
+  for (; n >= 8; n -= 8) {
+    __m256i in[16], out[8];
+    int32_t k, v;
+
+    for (k = 0; k < 16; k += 4) {
+      for (v = 0; v < 4; v++) {
+        in[k + v] = SBC_LOAD_2X4(ps32DCTY + v * 16 + k, 4 * 16);
+      }
+      SBC_TRANSPOSE_4X4_AVX2(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+
+    SBC_FAST_IDCT8_LANES(in, out);
+
+    for (k = 0; k < 8; k += 4) {
+      SBC_TRANSPOSE_4X4_AVX2(out[k], out[k + 1], out[k + 2], out[k + 3]);
+      for (v = 0; v < 4; v++) {
+        SBC_STORE_2X4(ps32SbBuf + v * 8 + k, 4 * 8, out[k + v]);
+      }
+    }
+
+    ps32DCTY += 8 * 2 * SUB_BANDS_8;
+    ps32SbBuf += 8 * SUB_BANDS_8;
+  }
+
+  SbcDct8_SSE41(ps32DCTY, ps32SbBuf, n);
+}
+
+/* 4 subbands windowing only has 8 outputs, the SSE4.1 version is used */
+const SBC_ANALYSIS_KERNELS sbc_analysis_kernels_avx2 = {
+        .impl = SBC_ENC_IMPL_AVX2,
+        .window4 = SbcWindow4_SSE41,
+        .window8 = SbcWindow8_AVX2,
+        .dct4 = SbcDct4_AVX2,
+        .dct8 = SbcDct8_AVX2,
+};
+
+#endif /* SBC_SIMD_X86 */
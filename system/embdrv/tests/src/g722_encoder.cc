@@ -0,0 +1,110 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include <random>
+#include <vector>
+
+#include "g722_enc_dec.h"
+
+namespace {
+
+// 20 ms of 16 kHz audio, the hearing aid interval
+constexpr int kIntervalSamples = 320;
+
+class LibG722EncTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    mono_[0] = g722_encode_init(nullptr, 64000, G722_PACKED);
+    mono_[1] = g722_encode_init(nullptr, 64000, G722_PACKED);
+    stereo_ = g722_encode_stereo_init(nullptr, 64000, G722_PACKED);
+    ASSERT_NE(mono_[0], nullptr);
+    ASSERT_NE(mono_[1], nullptr);
+    ASSERT_NE(stereo_, nullptr);
+  }
+
+  void TearDown() override {
+    g722_encode_release(mono_[0]);
+    g722_encode_release(mono_[1]);
+    g722_encode_stereo_release(stereo_);
+  }
+
+  // Encodes an interval with the stereo encoder, and checks that each channel
+  // matches the mono encoder
+  void EncodeAndCompare(const std::vector<int16_t>& left, const std::vector<int16_t>& right) {
+    int len = left.size();
+    std::vector<uint8_t> expected_left(len / 2), expected_right(len / 2);
+    std::vector<uint8_t> actual_left(len / 2), actual_right(len / 2);
+
+    ASSERT_EQ(len / 2, g722_encode(mono_[0], expected_left.data(), left.data(), len));
+    ASSERT_EQ(len / 2, g722_encode(mono_[1], expected_right.data(), right.data(), len));
+    ASSERT_EQ(len / 2, g722_encode_stereo(stereo_, actual_left.data(), actual_right.data(),
+                                          left.data(), right.data(), len));
+    ASSERT_EQ(expected_left, actual_left);
+    ASSERT_EQ(expected_right, actual_right);
+  }
+
+  g722_encode_state_t* mono_[2];
+  g722_encode_stereo_state_t* stereo_;
+};
+
+TEST_F(LibG722EncTest, stereo_matches_mono_random) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+  std::vector<int16_t> left(kIntervalSamples), right(kIntervalSamples);
+
+  for (int interval = 0; interval < 200; interval++) {
+    for (int i = 0; i < kIntervalSamples; i++) {
+      left[i] = dist(gen);
+      // Full scale square wave every few intervals, to reach the saturations
+      right[i] = (interval % 4 == 3) ? ((i / 8) % 2 ? INT16_MAX : INT16_MIN) : dist(gen) >> 4;
+    }
+    EncodeAndCompare(left, right);
+  }
+}
+
+TEST_F(LibG722EncTest, stereo_matches_mono_tones) {
+  std::vector<int16_t> left(kIntervalSamples), right(kIntervalSamples);
+
+  for (int interval = 0; interval < 200; interval++) {
+    for (int i = 0; i < kIntervalSamples; i++) {
+      double t = (interval * kIntervalSamples + i) / 16000.;
+      // Hearing aid samples are halved before encoding
+      left[i] = (int16_t)(16000 * sin(2 * M_PI * 440 * t));
+      right[i] = (int16_t)(8000 * sin(2 * M_PI * 3000 * t) + 4000 * sin(2 * M_PI * 7000 * t));
+    }
+    EncodeAndCompare(left, right);
+  }
+}
+
+TEST_F(LibG722EncTest, stereo_identical_channels) {
+  std::mt19937 gen(1);
+  std::vector<int16_t> mono(kIntervalSamples);
+  std::vector<uint8_t> left(kIntervalSamples / 2), right(kIntervalSamples / 2);
+
+  for (int interval = 0; interval < 50; interval++) {
+    for (int16_t& sample : mono) {
+      sample = (int16_t)gen() >> 1;
+    }
+    ASSERT_EQ(kIntervalSamples / 2, g722_encode_stereo(stereo_, left.data(), right.data(),
+                                                       mono.data(), mono.data(), kIntervalSamples));
+    ASSERT_EQ(left, right);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "g722_enc_dec.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// 20 ms of 16 kHz audio, the hearing aid interval
+constexpr int kIntervalSamples = 320;
+
+/* Encodes one interval for a binaural pair of hearing aids, items are
+ * intervals of both channels. */
+class BM_G722Encode : public ::benchmark::Fixture {
+protected:
+  void Configure() {
+    std::mt19937 gen(0);
+    left_.resize(kIntervalSamples);
+    right_.resize(kIntervalSamples);
+    for (int i = 0; i < kIntervalSamples; i++) {
+      left_[i] = (int16_t)gen() >> 1;
+      right_[i] = (int16_t)gen() >> 1;
+    }
+    encoded_left_.resize(kIntervalSamples / 2);
+    encoded_right_.resize(kIntervalSamples / 2);
+  }
+
+  std::vector<int16_t> left_;
+  std::vector<int16_t> right_;
+  std::vector<uint8_t> encoded_left_;
+  std::vector<uint8_t> encoded_right_;
+};
+
+}  // namespace
+
+/* One g722_encode() per hearing aid */
+BENCHMARK_DEFINE_F(BM_G722Encode, binaural_mono_encoders)(State& state) {
+  Configure();
+  g722_encode_state_t* left = g722_encode_init(nullptr, 64000, G722_PACKED);
+  g722_encode_state_t* right = g722_encode_init(nullptr, 64000, G722_PACKED);
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+            g722_encode(left, encoded_left_.data(), left_.data(), kIntervalSamples));
+    ::benchmark::DoNotOptimize(
+            g722_encode(right, encoded_right_.data(), right_.data(), kIntervalSamples));
+  }
+  state.SetItemsProcessed(state.iterations());
+  g722_encode_release(left);
+  g722_encode_release(right);
+}
+
+BENCHMARK_REGISTER_F(BM_G722Encode, binaural_mono_encoders);
+
+/* Both hearing aids with g722_encode_stereo() */
+BENCHMARK_DEFINE_F(BM_G722Encode, binaural_stereo_encoder)(State& state) {
+  Configure();
+  g722_encode_stereo_state_t* stereo = g722_encode_stereo_init(nullptr, 64000, G722_PACKED);
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(g722_encode_stereo(stereo, encoded_left_.data(),
+                                                  encoded_right_.data(), left_.data(),
+                                                  right_.data(), kIntervalSamples));
+  }
+  state.SetItemsProcessed(state.iterations());
+  g722_encode_stereo_release(stereo);
+}
+
+BENCHMARK_REGISTER_F(BM_G722Encode, binaural_stereo_encoder);
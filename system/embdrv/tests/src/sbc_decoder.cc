@@ -0,0 +1,216 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "oi_codec_sbc_simd.h"
+#include "sbc_encoder.h"
+
+namespace {
+
+constexpr OI_SBC_SYNTH_IMPL kVectorImpls[] = {OI_SBC_SYNTH_IMPL_SSE41, OI_SBC_SYNTH_IMPL_AVX2,
+                                              OI_SBC_SYNTH_IMPL_NEON};
+
+struct StreamConfig {
+  int16_t sampling_freq;
+  int16_t channel_mode;
+  int16_t num_subbands;
+  int16_t num_blocks;
+  int16_t allocation_method;
+  uint8_t format;
+};
+
+class LibSbcDecTest : public ::testing::Test {
+protected:
+  void SetUp() override { ASSERT_TRUE(OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL_SCALAR)); }
+
+  void TearDown() override { OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL_AUTO); }
+
+  // Implementations supported by this build and CPU, beside the scalar one
+  std::vector<OI_SBC_SYNTH_IMPL> SupportedVectorImpls() {
+    std::vector<OI_SBC_SYNTH_IMPL> impls;
+    for (OI_SBC_SYNTH_IMPL impl : kVectorImpls) {
+      if (OI_CODEC_SBC_SelectSynthImpl(impl)) {
+        impls.push_back(impl);
+      }
+    }
+    OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL_SCALAR);
+    return impls;
+  }
+
+  // SBC frames of random samples, with runs of full scale values
+  std::vector<std::vector<uint8_t>> Encode(const StreamConfig& config, size_t num_frames) {
+    SBC_ENC_PARAMS params;
+    memset(&params, 0, sizeof(params));
+    params.s16SamplingFreq = config.sampling_freq;
+    params.s16ChannelMode = config.channel_mode;
+    params.s16NumOfSubBands = config.num_subbands;
+    params.s16NumOfBlocks = config.num_blocks;
+    params.s16AllocationMethod = config.allocation_method;
+    params.u16BitRate = 328;
+    params.Format = config.format;
+    SBC_Encoder_Init(&params);
+    if (config.format == SBC_FORMAT_MSBC) {
+      params.s16BitPool = 26;
+    }
+
+    std::mt19937 gen(config.num_subbands * 100 + config.channel_mode * 10 + config.num_blocks);
+    std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    std::vector<int16_t> pcm(params.s16NumOfChannels * params.s16NumOfBlocks *
+                             params.s16NumOfSubBands);
+    std::vector<std::vector<uint8_t>> frames;
+    uint8_t frame[512];
+    for (size_t i = 0; i < num_frames; i++) {
+      for (int16_t& sample : pcm) {
+        sample = (i % 4 == 3) ? ((gen() & 1) ? INT16_MAX : INT16_MIN) : dist(gen);
+      }
+      uint32_t length = SBC_Encode(&params, pcm.data(), frame);
+      frames.emplace_back(frame, frame + length);
+      if (config.format == SBC_FORMAT_MSBC) {
+        // mSBC frames are followed by a padding byte
+        frames.back().push_back(0);
+      }
+    }
+    return frames;
+  }
+
+  std::vector<int16_t> Decode(OI_SBC_SYNTH_IMPL impl, const StreamConfig& config,
+                              const std::vector<std::vector<uint8_t>>& frames) {
+    EXPECT_TRUE(OI_CODEC_SBC_SelectSynthImpl(impl));
+
+    OI_CODEC_SBC_DECODER_CONTEXT context;
+    std::vector<uint32_t> context_data(CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS));
+    EXPECT_EQ(OI_OK, OI_CODEC_SBC_DecoderReset(&context, context_data.data(),
+                                               context_data.size() * sizeof(uint32_t), 2, 2,
+                                               false));
+    if (config.format == SBC_FORMAT_MSBC) {
+      EXPECT_EQ(OI_OK, OI_CODEC_SBC_DecoderConfigureMSbc(&context));
+    }
+
+    std::vector<int16_t> output;
+    int16_t pcm[SBC_MAX_SAMPLES_PER_FRAME * SBC_MAX_CHANNELS];
+    // One frame per call, like the A2DP and HFP packets
+    for (const std::vector<uint8_t>& frame : frames) {
+      const OI_BYTE* data = frame.data();
+      uint32_t data_size = frame.size();
+      uint32_t pcm_bytes = sizeof(pcm);
+      OI_STATUS status = OI_CODEC_SBC_DecodeFrame(&context, &data, &data_size, pcm, &pcm_bytes);
+      EXPECT_EQ(OI_OK, status);
+      if (status != OI_OK) {
+        break;
+      }
+      output.insert(output.end(), pcm, pcm + pcm_bytes / sizeof(int16_t));
+    }
+    return output;
+  }
+};
+
+TEST_F(LibSbcDecTest, select_impl) {
+  ASSERT_EQ(OI_CODEC_SBC_GetSynthImpl(), OI_SBC_SYNTH_IMPL_SCALAR);
+  ASSERT_FALSE(OI_CODEC_SBC_SelectSynthImpl((OI_SBC_SYNTH_IMPL)99));
+  ASSERT_EQ(OI_CODEC_SBC_GetSynthImpl(), OI_SBC_SYNTH_IMPL_SCALAR);
+
+  ASSERT_TRUE(OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL_AUTO));
+  ASSERT_NE(OI_CODEC_SBC_GetSynthImpl(), OI_SBC_SYNTH_IMPL_AUTO);
+
+  for (OI_SBC_SYNTH_IMPL impl : SupportedVectorImpls()) {
+    ASSERT_TRUE(OI_CODEC_SBC_SelectSynthImpl(impl));
+    ASSERT_EQ(OI_CODEC_SBC_GetSynthImpl(), impl);
+  }
+}
+
+TEST_F(LibSbcDecTest, kernels_match_scalar) {
+  const OI_SBC_SYNTH_KERNELS* scalar = OI_SBC_SynthKernels();
+  std::mt19937 gen(1);
+  // Ranges of the decoder, which keep the C code free of overflows
+  std::uniform_int_distribution<int32_t> subband_dist(-(1 << 26), 1 << 26);
+  std::uniform_int_distribution<int> buffer_dist(-8192, 8192);
+
+  for (OI_SBC_SYNTH_IMPL impl : SupportedVectorImpls()) {
+    ASSERT_TRUE(OI_CODEC_SBC_SelectSynthImpl(impl));
+    const OI_SBC_SYNTH_KERNELS* kernels = OI_SBC_SynthKernels();
+
+    // Matrixing of every block count, including the scalar tail
+    for (OI_UINT count = 1; count <= SBC_MAX_BLOCKS; count++) {
+      for (OI_UINT stride : {8, 16}) {
+        std::vector<int32_t> in(stride * count);
+        for (int32_t& value : in) {
+          value = subband_dist(gen);
+        }
+        std::vector<SBC_BUFFER_T> expected(8 * count), actual(8 * count);
+
+        scalar->dct8(&expected[8 * (count - 1)], in.data(), stride, count);
+        kernels->dct8(&actual[8 * (count - 1)], in.data(), stride, count);
+        ASSERT_EQ(expected, actual) << impl << " dct8 count " << count;
+
+        scalar->cosine4(&expected[8 * (count - 1)], in.data(), stride / 2, count);
+        kernels->cosine4(&actual[8 * (count - 1)], in.data(), stride / 2, count);
+        ASSERT_EQ(expected, actual) << impl << " cosine4 count " << count;
+      }
+    }
+
+    // Windowing, into interleaved and planar output
+    for (int i = 0; i < 1000; i++) {
+      SBC_BUFFER_T buffer[80];
+      for (SBC_BUFFER_T& value : buffer) {
+        value = buffer_dist(gen);
+      }
+      for (OI_UINT stride_shift : {0, 1}) {
+        int16_t expected[16] = {}, actual[16] = {};
+        scalar->window80(expected, buffer, stride_shift);
+        kernels->window80(actual, buffer, stride_shift);
+        ASSERT_EQ(0, memcmp(expected, actual, sizeof(expected))) << impl << " window80";
+
+        scalar->window40(expected, buffer, stride_shift);
+        kernels->window40(actual, buffer, stride_shift);
+        ASSERT_EQ(0, memcmp(expected, actual, sizeof(expected))) << impl << " window40";
+      }
+    }
+  }
+}
+
+TEST_F(LibSbcDecTest, decode_bit_exact) {
+  std::vector<StreamConfig> configs = {
+          {SBC_sf16000, SBC_MONO, 8, 15, SBC_LOUDNESS, SBC_FORMAT_MSBC},
+  };
+  for (int16_t subbands : {4, 8}) {
+    for (int16_t mode : {SBC_MONO, SBC_DUAL, SBC_STEREO, SBC_JOINT_STEREO}) {
+      for (int16_t blocks : {4, 8, 12, 16}) {
+        configs.push_back({SBC_sf44100, mode, subbands, blocks, SBC_LOUDNESS, SBC_FORMAT_GENERAL});
+        configs.push_back({SBC_sf48000, mode, subbands, blocks, SBC_SNR, SBC_FORMAT_GENERAL});
+      }
+    }
+  }
+
+  for (const StreamConfig& config : configs) {
+    std::vector<std::vector<uint8_t>> frames = Encode(config, 200);
+    std::vector<int16_t> expected = Decode(OI_SBC_SYNTH_IMPL_SCALAR, config, frames);
+    ASSERT_FALSE(expected.empty());
+    for (OI_SBC_SYNTH_IMPL impl : SupportedVectorImpls()) {
+      std::vector<int16_t> actual = Decode(impl, config, frames);
+      ASSERT_EQ(expected, actual) << "impl " << impl << " subbands " << config.num_subbands
+                                  << " mode " << config.channel_mode << " blocks "
+                                  << config.num_blocks;
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kNumFrames = 64;
+
+/* Decodes 48 kHz joint stereo frames (8 subbands, 16 blocks, bitpool 53) or
+ * mSBC frames with the synthesis implementation given by the first argument,
+ * the way a2dp_sbc_decoder.cc does. Items are frames, so items_per_second is
+ * the decoded frames per second on one core. */
+class BM_SbcDecode : public ::benchmark::Fixture {
+protected:
+  void Configure(State& st, bool msbc) {
+    SBC_ENC_PARAMS params;
+    memset(&params, 0, sizeof(params));
+    if (msbc) {
+      params.s16SamplingFreq = SBC_sf16000;
+      params.s16ChannelMode = SBC_MONO;
+      params.s16NumOfBlocks = 15;
+      params.Format = SBC_FORMAT_MSBC;
+      params.u16BitRate = 60;
+    } else {
+      params.s16SamplingFreq = SBC_sf48000;
+      params.s16ChannelMode = SBC_JOINT_STEREO;
+      params.s16NumOfBlocks = 16;
+      params.Format = SBC_FORMAT_GENERAL;
+      params.u16BitRate = 345;
+    }
+    params.s16NumOfSubBands = 8;
+    params.s16AllocationMethod = SBC_LOUDNESS;
+    SBC_Encoder_Init(&params);
+    if (msbc) {
+      params.s16BitPool = 26;
+    }
+
+    std::mt19937 gen(0);
+    std::vector<int16_t> pcm(params.s16NumOfChannels * params.s16NumOfBlocks *
+                             params.s16NumOfSubBands);
+    uint8_t frame[512];
+    frames_.clear();
+    for (size_t i = 0; i < kNumFrames; i++) {
+      for (int16_t& sample : pcm) {
+        sample = (int16_t)gen();
+      }
+      uint32_t length = SBC_Encode(&params, pcm.data(), frame);
+      frames_.emplace_back(frame, frame + length);
+      if (msbc) {
+        // mSBC frames are followed by a padding byte
+        frames_.back().push_back(0);
+      }
+    }
+
+    context_data_.assign(CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS), 0);
+    OI_CODEC_SBC_DecoderReset(&context_, context_data_.data(),
+                              context_data_.size() * sizeof(uint32_t), 2, 2, false);
+    if (msbc) {
+      OI_CODEC_SBC_DecoderConfigureMSbc(&context_);
+    }
+
+    supported_ = OI_CODEC_SBC_SelectSynthImpl((OI_SBC_SYNTH_IMPL)st.range(0));
+  }
+
+  void TearDown(State& st) override {
+    OI_CODEC_SBC_SelectSynthImpl(OI_SBC_SYNTH_IMPL_AUTO);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void DecodeFrames(State& state) {
+    if (!supported_) {
+      state.SkipWithError("implementation not supported");
+      return;
+    }
+    int16_t pcm[SBC_MAX_SAMPLES_PER_FRAME * SBC_MAX_CHANNELS];
+    size_t index = 0;
+    for (auto _ : state) {
+      const std::vector<uint8_t>& frame = frames_[index];
+      const OI_BYTE* data = frame.data();
+      uint32_t data_size = frame.size();
+      index = (index + 1) % frames_.size();
+      uint32_t pcm_bytes = sizeof(pcm);
+      ::benchmark::DoNotOptimize(
+              OI_CODEC_SBC_DecodeFrame(&context_, &data, &data_size, pcm, &pcm_bytes));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  OI_CODEC_SBC_DECODER_CONTEXT context_;
+  std::vector<uint32_t> context_data_;
+  std::vector<std::vector<uint8_t>> frames_;
+  bool supported_ = false;
+};
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(BM_SbcDecode, a2dp_frame)(State& state) {
+  Configure(state, false);
+  DecodeFrames(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SbcDecode, a2dp_frame)
+        ->Arg(OI_SBC_SYNTH_IMPL_SCALAR)
+        ->Arg(OI_SBC_SYNTH_IMPL_SSE41)
+        ->Arg(OI_SBC_SYNTH_IMPL_AVX2)
+        ->Arg(OI_SBC_SYNTH_IMPL_NEON);
+
+BENCHMARK_DEFINE_F(BM_SbcDecode, msbc_frame)(State& state) {
+  Configure(state, true);
+  DecodeFrames(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SbcDecode, msbc_frame)
+        ->Arg(OI_SBC_SYNTH_IMPL_SCALAR)
+        ->Arg(OI_SBC_SYNTH_IMPL_SSE41)
+        ->Arg(OI_SBC_SYNTH_IMPL_AVX2)
+        ->Arg(OI_SBC_SYNTH_IMPL_NEON);
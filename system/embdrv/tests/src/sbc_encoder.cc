@@ -0,0 +1,186 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "sbc_encoder.h"
+#include "sbc_simd.h"
+
+namespace {
+
+constexpr SBC_ENC_IMPL kVectorImpls[] = {SBC_ENC_IMPL_SSE41, SBC_ENC_IMPL_AVX2,
+                                         SBC_ENC_IMPL_NEON};
+
+struct EncoderConfig {
+  int16_t sampling_freq;
+  int16_t channel_mode;
+  int16_t num_subbands;
+  int16_t num_blocks;
+  int16_t allocation_method;
+  uint8_t format;
+};
+
+class LibSbcEncTest : public ::testing::Test {
+protected:
+  void SetUp() override { ASSERT_TRUE(SBC_Encoder_SelectImpl(SBC_ENC_IMPL_SCALAR)); }
+
+  void TearDown() override { SBC_Encoder_SelectImpl(SBC_ENC_IMPL_AUTO); }
+
+  // Implementations supported by this build and CPU, beside the scalar one
+  std::vector<SBC_ENC_IMPL> SupportedVectorImpls() {
+    std::vector<SBC_ENC_IMPL> impls;
+    for (SBC_ENC_IMPL impl : kVectorImpls) {
+      if (SBC_Encoder_SelectImpl(impl)) {
+        impls.push_back(impl);
+      }
+    }
+    SBC_Encoder_SelectImpl(SBC_ENC_IMPL_SCALAR);
+    return impls;
+  }
+
+  // Random samples, with runs of full scale values to exercise overflows
+  std::vector<int16_t> Samples(size_t count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    std::vector<int16_t> samples(count);
+    for (size_t i = 0; i < count; i++) {
+      if ((i / 256) % 4 == 3) {
+        samples[i] = (gen() & 1) ? INT16_MAX : INT16_MIN;
+      } else {
+        samples[i] = dist(gen);
+      }
+    }
+    return samples;
+  }
+
+  std::vector<uint8_t> Encode(SBC_ENC_IMPL impl, const EncoderConfig& config,
+                              const std::vector<int16_t>& pcm) {
+    EXPECT_TRUE(SBC_Encoder_SelectImpl(impl));
+
+    SBC_ENC_PARAMS params;
+    memset(&params, 0, sizeof(params));
+    params.s16SamplingFreq = config.sampling_freq;
+    params.s16ChannelMode = config.channel_mode;
+    params.s16NumOfSubBands = config.num_subbands;
+    params.s16NumOfBlocks = config.num_blocks;
+    params.s16AllocationMethod = config.allocation_method;
+    params.u16BitRate = 328;
+    params.Format = config.format;
+    SBC_Encoder_Init(&params);
+    if (config.format == SBC_FORMAT_MSBC) {
+      params.s16BitPool = 26;
+    }
+
+    size_t frame_samples = params.s16NumOfChannels * params.s16NumOfBlocks * params.s16NumOfSubBands;
+    std::vector<uint8_t> output;
+    std::vector<int16_t> input(frame_samples);
+    uint8_t frame[512];
+    for (size_t offset = 0; offset + frame_samples <= pcm.size(); offset += frame_samples) {
+      std::copy(pcm.begin() + offset, pcm.begin() + offset + frame_samples, input.begin());
+      uint32_t length = SBC_Encode(&params, input.data(), frame);
+      output.insert(output.end(), frame, frame + length);
+    }
+    return output;
+  }
+};
+
+TEST_F(LibSbcEncTest, select_impl) {
+  ASSERT_EQ(SBC_Encoder_GetImpl(), SBC_ENC_IMPL_SCALAR);
+  ASSERT_FALSE(SBC_Encoder_SelectImpl((SBC_ENC_IMPL)99));
+  ASSERT_EQ(SBC_Encoder_GetImpl(), SBC_ENC_IMPL_SCALAR);
+
+  ASSERT_TRUE(SBC_Encoder_SelectImpl(SBC_ENC_IMPL_AUTO));
+  ASSERT_NE(SBC_Encoder_GetImpl(), SBC_ENC_IMPL_AUTO);
+
+  for (SBC_ENC_IMPL impl : SupportedVectorImpls()) {
+    ASSERT_TRUE(SBC_Encoder_SelectImpl(impl));
+    ASSERT_EQ(SBC_Encoder_GetImpl(), impl);
+  }
+}
+
+TEST_F(LibSbcEncTest, kernels_match_scalar) {
+  const SBC_ANALYSIS_KERNELS* scalar = SbcAnalysisKernels();
+  std::vector<int16_t> samples = Samples(4096, 1);
+
+  for (SBC_ENC_IMPL impl : SupportedVectorImpls()) {
+    ASSERT_TRUE(SBC_Encoder_SelectImpl(impl));
+    const SBC_ANALYSIS_KERNELS* kernels = SbcAnalysisKernels();
+
+    // Windowing of every offset of the sample buffer
+    for (size_t offset = 0; offset + 80 <= samples.size(); offset++) {
+      int32_t expected[16], actual[16];
+      scalar->window8(samples.data() + offset, expected);
+      kernels->window8(samples.data() + offset, actual);
+      ASSERT_EQ(0, memcmp(expected, actual, sizeof(expected))) << impl << " offset " << offset;
+
+      scalar->window4(samples.data() + offset, expected);
+      kernels->window4(samples.data() + offset, actual);
+      ASSERT_EQ(0, memcmp(expected, actual, 8 * sizeof(int32_t))) << impl << " offset " << offset;
+    }
+
+    // Matrixing of every vector count, including the scalar tail
+    std::mt19937 gen(2);
+    for (int32_t n = 1; n <= SBC_MAX_NUM_OF_BLOCKS * SBC_MAX_NUM_OF_CHANNELS; n++) {
+      std::vector<int32_t> dcty(n * 16);
+      for (int32_t& value : dcty) {
+        value = (int32_t)gen();
+      }
+      std::vector<int32_t> input = dcty;
+      std::vector<int32_t> expected(n * 8), actual(n * 8);
+
+      scalar->dct8(input.data(), expected.data(), n);
+      kernels->dct8(dcty.data(), actual.data(), n);
+      ASSERT_EQ(expected, actual) << impl << " dct8 n=" << n;
+
+      scalar->dct4(input.data(), expected.data(), n);
+      kernels->dct4(dcty.data(), actual.data(), n);
+      ASSERT_EQ(0, memcmp(expected.data(), actual.data(), n * 4 * sizeof(int32_t)))
+              << impl << " dct4 n=" << n;
+    }
+  }
+}
+
+TEST_F(LibSbcEncTest, encode_bit_exact) {
+  std::vector<EncoderConfig> configs = {
+          {SBC_sf16000, SBC_MONO, 8, 15, SBC_LOUDNESS, SBC_FORMAT_MSBC},
+  };
+  for (int16_t subbands : {4, 8}) {
+    for (int16_t mode : {SBC_MONO, SBC_DUAL, SBC_STEREO, SBC_JOINT_STEREO}) {
+      for (int16_t blocks : {4, 8, 12, 16}) {
+        configs.push_back({SBC_sf44100, mode, subbands, blocks, SBC_LOUDNESS, SBC_FORMAT_GENERAL});
+        configs.push_back({SBC_sf48000, mode, subbands, blocks, SBC_SNR, SBC_FORMAT_GENERAL});
+      }
+    }
+  }
+
+  std::vector<int16_t> pcm = Samples(64 * 1024, 3);
+  for (SBC_ENC_IMPL impl : SupportedVectorImpls()) {
+    for (const EncoderConfig& config : configs) {
+      std::vector<uint8_t> expected = Encode(SBC_ENC_IMPL_SCALAR, config, pcm);
+      std::vector<uint8_t> actual = Encode(impl, config, pcm);
+      ASSERT_FALSE(expected.empty());
+      ASSERT_EQ(expected, actual) << "impl " << impl << " subbands " << config.num_subbands
+                                  << " mode " << config.channel_mode << " blocks "
+                                  << config.num_blocks;
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+/* Encodes 48 kHz joint stereo frames (8 subbands, 16 blocks, bitpool 53) or
+ * mSBC frames with the implementation given by the first argument. */
+class BM_SbcEncode : public ::benchmark::Fixture {
+protected:
+  void Configure(State& st, bool msbc) {
+    memset(&params_, 0, sizeof(params_));
+    if (msbc) {
+      params_.s16SamplingFreq = SBC_sf16000;
+      params_.s16ChannelMode = SBC_MONO;
+      params_.s16NumOfBlocks = 15;
+      params_.Format = SBC_FORMAT_MSBC;
+      params_.u16BitRate = 60;
+    } else {
+      params_.s16SamplingFreq = SBC_sf48000;
+      params_.s16ChannelMode = SBC_JOINT_STEREO;
+      params_.s16NumOfBlocks = 16;
+      params_.Format = SBC_FORMAT_GENERAL;
+      params_.u16BitRate = 345;
+    }
+    params_.s16NumOfSubBands = 8;
+    params_.s16AllocationMethod = SBC_LOUDNESS;
+
+    supported_ = SBC_Encoder_SelectImpl((SBC_ENC_IMPL)st.range(0));
+    SBC_Encoder_Init(&params_);
+    if (msbc) {
+      params_.s16BitPool = 26;
+    }
+
+    std::mt19937 gen(0);
+    pcm_.resize(params_.s16NumOfChannels * params_.s16NumOfBlocks * params_.s16NumOfSubBands);
+    for (int16_t& sample : pcm_) {
+      sample = (int16_t)gen();
+    }
+  }
+
+  void TearDown(State& st) override {
+    SBC_Encoder_SelectImpl(SBC_ENC_IMPL_AUTO);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void EncodeFrames(State& state) {
+    if (!supported_) {
+      state.SkipWithError("implementation not supported");
+      return;
+    }
+    uint8_t frame[512];
+    for (auto _ : state) {
+      ::benchmark::DoNotOptimize(SBC_Encode(&params_, pcm_.data(), frame));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  SBC_ENC_PARAMS params_;
+  std::vector<int16_t> pcm_;
+  bool supported_ = false;
+};
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(BM_SbcEncode, a2dp_frame)(State& state) {
+  Configure(state, false);
+  EncodeFrames(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SbcEncode, a2dp_frame)
+        ->Arg(SBC_ENC_IMPL_SCALAR)
+        ->Arg(SBC_ENC_IMPL_SSE41)
+        ->Arg(SBC_ENC_IMPL_AVX2)
+        ->Arg(SBC_ENC_IMPL_NEON);
+
+BENCHMARK_DEFINE_F(BM_SbcEncode, msbc_frame)(State& state) {
+  Configure(state, true);
+  EncodeFrames(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SbcEncode, msbc_frame)
+        ->Arg(SBC_ENC_IMPL_SCALAR)
+        ->Arg(SBC_ENC_IMPL_SSE41)
+        ->Arg(SBC_ENC_IMPL_AVX2)
+        ->Arg(SBC_ENC_IMPL_NEON);
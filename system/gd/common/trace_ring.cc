@@ -0,0 +1,357 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "BluetoothTraceRing"
+
+#include "common/trace_ring.h"
+
+#include <bluetooth/log.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'B', 'T', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// Written by the owner thread only. The record fields are atomics so that
+// snapshots can read them while they are overwritten.
+struct Ring {
+  struct Slot {
+    std::atomic<uint64_t> timestamp_ns;
+    std::atomic<uint64_t> arg;
+    std::atomic<uint64_t> tid_event;
+  };
+
+  // Number of records started, then completed. A snapshot drops the records
+  // whose slot was claimed again while reading it.
+  std::atomic<uint64_t> claimed{0};
+  std::atomic<uint64_t> published{0};
+  bool in_use = true;
+  std::array<Slot, TraceRing::kCapacity> slots{};
+};
+
+std::mutex rings_mutex;
+std::vector<Ring*> rings;
+std::map<uint32_t, std::string> thread_names;
+std::string snapshot_path;
+
+thread_local Ring* tls_ring = nullptr;
+
+// Releases the ring of the thread on thread exit, for reuse by a new thread
+class RingOwner {
+public:
+  ~RingOwner() {
+    if (ring != nullptr) {
+      std::lock_guard<std::mutex> lock(rings_mutex);
+      ring->in_use = false;
+    }
+    tls_ring = nullptr;
+  }
+  Ring* ring = nullptr;
+};
+
+uint32_t GetTid() { return static_cast<uint32_t>(syscall(SYS_gettid)); }
+
+uint64_t NowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+Ring* AttachThread() {
+  thread_local RingOwner owner;
+  uint32_t tid = GetTid();
+  char name[16] = {};
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  auto it = std::find_if(rings.begin(), rings.end(), [](Ring* ring) { return !ring->in_use; });
+  if (it != rings.end()) {
+    (*it)->in_use = true;
+    owner.ring = *it;
+  } else {
+    owner.ring = new Ring();
+    rings.push_back(owner.ring);
+  }
+  thread_names[tid] = name;
+  tls_ring = owner.ring;
+  return owner.ring;
+}
+
+std::vector<TraceEventInfo> GetEventInfos() {
+  return {
+#define BT_TRACE_EVENT_INFO(id, phase, name) \
+  {static_cast<uint16_t>(TraceEvent::id), phase, name},
+          BT_TRACE_EVENTS(BT_TRACE_EVENT_INFO)
+#undef BT_TRACE_EVENT_INFO
+  };
+}
+
+template <typename T>
+void WriteValue(std::ostream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadValue(std::istream& in, T* value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+void WriteString(std::ostream& out, const std::string& str) {
+  WriteValue<uint16_t>(out, str.size());
+  out.write(str.data(), str.size());
+}
+
+bool ReadString(std::istream& in, std::string* str) {
+  uint16_t len;
+  if (!ReadValue(in, &len)) {
+    return false;
+  }
+  str->resize(len);
+  return static_cast<bool>(in.read(str->data(), len));
+}
+
+void WriteJsonString(std::ostream& out, const std::string& str) {
+  out << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out << escaped;
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+}  // namespace
+
+void TraceRing::Enable(const std::string& path) {
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    snapshot_path = path;
+  }
+  enabled_.store(true, std::memory_order_relaxed);
+  log::info("Tracing enabled, snapshots written to \"{}\"", path);
+}
+
+void TraceRing::Disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+void TraceRing::Record(TraceEvent event, uint64_t arg) {
+  Ring* ring = tls_ring;
+  if (ring == nullptr) {
+    ring = AttachThread();
+  }
+
+  static thread_local uint64_t tid = GetTid();
+  uint64_t index = ring->published.load(std::memory_order_relaxed);
+  ring->claimed.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  auto& slot = ring->slots[index % kCapacity];
+  slot.timestamp_ns.store(NowNs(), std::memory_order_relaxed);
+  slot.arg.store(arg, std::memory_order_relaxed);
+  slot.tid_event.store(tid << 16 | static_cast<uint16_t>(event), std::memory_order_relaxed);
+  ring->published.store(index + 1, std::memory_order_release);
+}
+
+TraceSnapshot TraceRing::Snapshot() {
+  TraceSnapshot snapshot;
+  snapshot.events = GetEventInfos();
+
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  snapshot.thread_names = thread_names;
+  for (Ring* ring : rings) {
+    uint64_t published = ring->published.load(std::memory_order_acquire);
+    uint64_t first = published > kCapacity ? published - kCapacity : 0;
+    std::vector<TraceRecord> records;
+    records.reserve(published - first);
+    for (uint64_t index = first; index < published; index++) {
+      auto& slot = ring->slots[index % kCapacity];
+      uint64_t tid_event = slot.tid_event.load(std::memory_order_relaxed);
+      records.push_back(TraceRecord{slot.timestamp_ns.load(std::memory_order_relaxed),
+                                    slot.arg.load(std::memory_order_relaxed),
+                                    static_cast<uint32_t>(tid_event >> 16),
+                                    static_cast<uint16_t>(tid_event & 0xffff)});
+    }
+
+    // Drop the records overwritten while reading them
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t claimed = ring->claimed.load(std::memory_order_relaxed);
+    uint64_t valid = claimed > kCapacity ? claimed - kCapacity : 0;
+    size_t skip = std::min<uint64_t>(records.size(), valid > first ? valid - first : 0);
+    snapshot.records.insert(snapshot.records.end(), records.begin() + skip, records.end());
+  }
+
+  std::stable_sort(snapshot.records.begin(), snapshot.records.end(),
+                   [](const TraceRecord& a, const TraceRecord& b) {
+                     return a.timestamp_ns < b.timestamp_ns;
+                   });
+  return snapshot;
+}
+
+bool TraceRing::WriteSnapshot(const TraceSnapshot& snapshot, std::ostream& out) {
+  out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  WriteValue<uint32_t>(out, snapshot.events.size());
+  for (auto const& event : snapshot.events) {
+    WriteValue<uint16_t>(out, event.id);
+    WriteValue<char>(out, event.phase);
+    WriteString(out, event.name);
+  }
+  WriteValue<uint32_t>(out, snapshot.thread_names.size());
+  for (auto const& [tid, name] : snapshot.thread_names) {
+    WriteValue<uint32_t>(out, tid);
+    WriteString(out, name);
+  }
+  WriteValue<uint64_t>(out, snapshot.records.size());
+  for (auto const& record : snapshot.records) {
+    WriteValue<uint64_t>(out, record.timestamp_ns);
+    WriteValue<uint64_t>(out, record.arg);
+    WriteValue<uint32_t>(out, record.tid);
+    WriteValue<uint16_t>(out, record.event);
+  }
+  return static_cast<bool>(out);
+}
+
+std::optional<TraceSnapshot> TraceRing::ReadSnapshot(std::istream& in) {
+  char magic[sizeof(kSnapshotMagic)];
+  if (!in.read(magic, sizeof(magic)) || memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0) {
+    return std::nullopt;
+  }
+
+  TraceSnapshot snapshot;
+  uint32_t num_events;
+  if (!ReadValue(in, &num_events)) {
+    return std::nullopt;
+  }
+  snapshot.events.resize(num_events);
+  for (auto& event : snapshot.events) {
+    if (!ReadValue(in, &event.id) || !ReadValue(in, &event.phase) ||
+        !ReadString(in, &event.name)) {
+      return std::nullopt;
+    }
+  }
+
+  uint32_t num_threads;
+  if (!ReadValue(in, &num_threads)) {
+    return std::nullopt;
+  }
+  for (uint32_t i = 0; i < num_threads; i++) {
+    uint32_t tid;
+    std::string name;
+    if (!ReadValue(in, &tid) || !ReadString(in, &name)) {
+      return std::nullopt;
+    }
+    snapshot.thread_names[tid] = name;
+  }
+
+  uint64_t num_records;
+  if (!ReadValue(in, &num_records)) {
+    return std::nullopt;
+  }
+  for (uint64_t i = 0; i < num_records; i++) {
+    TraceRecord record;
+    if (!ReadValue(in, &record.timestamp_ns) || !ReadValue(in, &record.arg) ||
+        !ReadValue(in, &record.tid) || !ReadValue(in, &record.event)) {
+      return std::nullopt;
+    }
+    snapshot.records.push_back(record);
+  }
+  return snapshot;
+}
+
+void TraceRing::WriteChromeJson(const TraceSnapshot& snapshot, std::ostream& out) {
+  std::map<uint16_t, const TraceEventInfo*> events;
+  for (auto const& event : snapshot.events) {
+    events[event.id] = &event;
+  }
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (auto const& [tid, name] : snapshot.thread_names) {
+    out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+        << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+    WriteJsonString(out, name);
+    out << "}}";
+    first = false;
+  }
+
+  for (auto const& record : snapshot.records) {
+    auto it = events.find(record.event);
+    if (it == events.end()) {
+      continue;
+    }
+    char ts[32];
+    snprintf(ts, sizeof(ts), "%" PRIu64 ".%03" PRIu64, record.timestamp_ns / 1000,
+             record.timestamp_ns % 1000);
+    out << (first ? "\n" : ",\n") << "{\"ph\":\"" << it->second->phase << "\",\"pid\":0,\"tid\":"
+        << record.tid << ",\"ts\":" << ts << ",\"name\":";
+    WriteJsonString(out, it->second->name);
+    if (it->second->phase == 'i') {
+      out << ",\"s\":\"t\"";
+    }
+    out << ",\"args\":{\"arg\":" << record.arg << "}}";
+    first = false;
+  }
+  out << "\n]}\n";
+}
+
+void TraceRing::Dump(int fd) {
+  std::string path;
+  uint64_t recorded = 0;
+  size_t num_rings = 0;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    path = snapshot_path;
+    num_rings = rings.size();
+    for (Ring* ring : rings) {
+      recorded += ring->published.load(std::memory_order_relaxed);
+    }
+  }
+
+  dprintf(fd, "\nTrace rings:\n");
+  dprintf(fd, "  Enabled: %s, rings: %zu, records: %" PRIu64 "\n", IsEnabled() ? "true" : "false",
+          num_rings, recorded);
+  if (path.empty() || num_rings == 0) {
+    return;
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!WriteSnapshot(Snapshot(), out)) {
+    dprintf(fd, "  Failed to write the snapshot to %s\n", path.c_str());
+    return;
+  }
+  dprintf(fd, "  Snapshot written to %s\n", path.c_str());
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// Events recorded in the trace rings: identifier, Chrome trace phase (i for
+// instant, B and E for the begin and end of a slice) and name.
+//
+// The os::Queue events record the address of the item, which follows it from
+// one end of the queue to the other, the os::Handler events the address of
+// the handler. SnoopLogger records the packet type, direction and length in
+// bits 40+, 32+ and 0+, send_iso_data the handle and length in bits 16+ and 0+.
+#define BT_TRACE_EVENTS(X)                           \
+  X(kQueueEnqueue, 'i', "os::Queue::Enqueue")        \
+  X(kQueueDequeue, 'i', "os::Queue::TryDequeue")     \
+  X(kHandlerPost, 'i', "os::Handler::Post")          \
+  X(kHandlerTaskBegin, 'B', "os::Handler::RunTask")  \
+  X(kHandlerTaskEnd, 'E', "os::Handler::RunTask")    \
+  X(kSnoopCapture, 'i', "hal::SnoopLogger::Capture") \
+  X(kIsoSendData, 'i', "btm::IsoManager::SendIsoData")
+
+enum class TraceEvent : uint16_t {
+#define BT_TRACE_EVENT_ID(id, phase, name) id,
+  BT_TRACE_EVENTS(BT_TRACE_EVENT_ID)
+#undef BT_TRACE_EVENT_ID
+  kCount,
+};
+
+struct TraceEventInfo {
+  uint16_t id;
+  char phase;
+  std::string name;
+};
+
+struct TraceRecord {
+  uint64_t timestamp_ns;  // CLOCK_MONOTONIC
+  uint64_t arg;
+  uint32_t tid;
+  uint16_t event;
+};
+
+// Content of the trace rings of all the threads, records sorted by time
+struct TraceSnapshot {
+  std::vector<TraceEventInfo> events;
+  std::map<uint32_t, std::string> thread_names;
+  std::vector<TraceRecord> records;
+};
+
+// Per thread rings of binary trace records, for the latency of the packets
+// through the queues and threads of the stack.
+//
+// Each thread records in its own ring of kCapacity records, without locking,
+// overwriting its oldest records. Taking a snapshot reads all the rings and
+// drops the records which were overwritten while reading them. Snapshots are
+// written to a binary file, converted to Chrome trace JSON (which Perfetto
+// opens) by the bluetooth_trace_export tool.
+class TraceRing {
+public:
+  static constexpr size_t kCapacity = 2048;
+
+  // Starts tracing. Dump() writes the snapshots to |snapshot_path| if not
+  // empty.
+  static void Enable(const std::string& snapshot_path = "");
+  static void Disable();
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Records |event| in the ring of the calling thread
+  static void Record(TraceEvent event, uint64_t arg);
+
+  static TraceSnapshot Snapshot();
+
+  // Binary snapshots
+  static bool WriteSnapshot(const TraceSnapshot& snapshot, std::ostream& out);
+  static std::optional<TraceSnapshot> ReadSnapshot(std::istream& in);
+
+  // Chrome trace event format, with timestamps in microseconds
+  static void WriteChromeJson(const TraceSnapshot& snapshot, std::ostream& out);
+
+  // Prints the statistics of the rings and writes a snapshot
+  static void Dump(int fd);
+
+private:
+  static inline std::atomic<bool> enabled_{false};
+};
+
+// Records |event| when tracing is enabled, a single branch otherwise
+inline void Trace(TraceEvent event, uint64_t arg = 0) {
+  if (TraceRing::IsEnabled()) {
+    TraceRing::Record(event, arg);
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "common/trace_ring.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+static void BM_TraceDisabled(State& state) {
+  TraceRing::Disable();
+  uint64_t arg = 0;
+  for (auto _ : state) {
+    Trace(TraceEvent::kHandlerPost, arg++);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_TraceEnabled(State& state) {
+  TraceRing::Enable();
+  uint64_t arg = 0;
+  for (auto _ : state) {
+    Trace(TraceEvent::kHandlerPost, arg++);
+    benchmark::ClobberMemory();
+  }
+  TraceRing::Disable();
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TraceDisabled);
+BENCHMARK(BM_TraceEnabled);
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Converts a trace ring snapshot to Chrome trace JSON, which chrome://tracing
+// and ui.perfetto.dev open.
+//
+// Usage: bluetooth_trace_export <snapshot> [<output.json>]
+
+#include <fstream>
+#include <iostream>
+
+#include "common/trace_ring.h"
+
+using bluetooth::common::TraceRing;
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <snapshot> [<output.json>]" << std::endl;
+    return 1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    std::cerr << "Unable to open " << argv[1] << std::endl;
+    return 1;
+  }
+  auto snapshot = TraceRing::ReadSnapshot(in);
+  if (!snapshot) {
+    std::cerr << argv[1] << " is not a trace ring snapshot" << std::endl;
+    return 1;
+  }
+
+  if (argc == 2) {
+    TraceRing::WriteChromeJson(*snapshot, std::cout);
+    return 0;
+  }
+  std::ofstream out(argv[2]);
+  TraceRing::WriteChromeJson(*snapshot, out);
+  if (!out) {
+    std::cerr << "Unable to write " << argv[2] << std::endl;
+    return 1;
+  }
+  std::cerr << "Wrote " << snapshot->records.size() << " records to " << argv[2] << std::endl;
+  return 0;
+}
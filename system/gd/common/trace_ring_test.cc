@@ -0,0 +1,131 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/trace_ring.h"
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+
+#include <sstream>
+#include <thread>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+// The rings are process wide, each test records with its own args
+class TraceRingTest : public ::testing::Test {
+protected:
+  void SetUp() override { TraceRing::Enable(); }
+  void TearDown() override { TraceRing::Disable(); }
+
+  std::vector<TraceRecord> RecordsWithArgs(const TraceSnapshot& snapshot, uint64_t first,
+                                           uint64_t last) {
+    std::vector<TraceRecord> records;
+    for (auto const& record : snapshot.records) {
+      if (record.arg >= first && record.arg <= last) {
+        records.push_back(record);
+      }
+    }
+    return records;
+  }
+};
+
+TEST_F(TraceRingTest, nothing_recorded_when_disabled) {
+  TraceRing::Disable();
+  Trace(TraceEvent::kHandlerPost, 100);
+  ASSERT_TRUE(RecordsWithArgs(TraceRing::Snapshot(), 100, 100).empty());
+}
+
+TEST_F(TraceRingTest, records_of_all_threads) {
+  Trace(TraceEvent::kQueueEnqueue, 200);
+  std::thread thread([] {
+    pthread_setname_np(pthread_self(), "trace_test");
+    Trace(TraceEvent::kQueueDequeue, 201);
+  });
+  thread.join();
+  Trace(TraceEvent::kHandlerPost, 202);
+
+  auto snapshot = TraceRing::Snapshot();
+  auto records = RecordsWithArgs(snapshot, 200, 202);
+  ASSERT_EQ(records.size(), 3u);
+  // Sorted by time
+  ASSERT_EQ(records[0].event, static_cast<uint16_t>(TraceEvent::kQueueEnqueue));
+  ASSERT_EQ(records[1].event, static_cast<uint16_t>(TraceEvent::kQueueDequeue));
+  ASSERT_EQ(records[2].event, static_cast<uint16_t>(TraceEvent::kHandlerPost));
+  ASSERT_LE(records[0].timestamp_ns, records[1].timestamp_ns);
+  ASSERT_EQ(records[0].tid, records[2].tid);
+  ASSERT_NE(records[0].tid, records[1].tid);
+  ASSERT_EQ(snapshot.thread_names[records[1].tid], "trace_test");
+}
+
+TEST_F(TraceRingTest, oldest_records_overwritten) {
+  std::thread thread([] {
+    for (uint64_t arg = 0; arg < TraceRing::kCapacity + 10; arg++) {
+      Trace(TraceEvent::kSnoopCapture, 1000000 + arg);
+    }
+  });
+  thread.join();
+
+  auto records = RecordsWithArgs(TraceRing::Snapshot(), 1000000, 2000000);
+  ASSERT_EQ(records.size(), TraceRing::kCapacity);
+  ASSERT_EQ(records.front().arg, 1000010u);
+  ASSERT_EQ(records.back().arg, 1000000 + TraceRing::kCapacity + 9);
+}
+
+TEST_F(TraceRingTest, snapshot_round_trip) {
+  Trace(TraceEvent::kIsoSendData, 300);
+  auto snapshot = TraceRing::Snapshot();
+
+  std::stringstream stream;
+  ASSERT_TRUE(TraceRing::WriteSnapshot(snapshot, stream));
+  auto read = TraceRing::ReadSnapshot(stream);
+  ASSERT_TRUE(read.has_value());
+  ASSERT_EQ(read->events.size(), static_cast<size_t>(TraceEvent::kCount));
+  ASSERT_EQ(read->thread_names, snapshot.thread_names);
+  ASSERT_EQ(read->records.size(), snapshot.records.size());
+  auto records = RecordsWithArgs(*read, 300, 300);
+  ASSERT_EQ(records.size(), 1u);
+  ASSERT_EQ(records[0].event, static_cast<uint16_t>(TraceEvent::kIsoSendData));
+
+  std::stringstream garbage("not a snapshot");
+  ASSERT_FALSE(TraceRing::ReadSnapshot(garbage).has_value());
+}
+
+TEST_F(TraceRingTest, chrome_json) {
+  TraceSnapshot snapshot;
+  snapshot.events = {{0, 'B', "Task"}, {1, 'E', "Task"}, {2, 'i', "Packet"}};
+  snapshot.thread_names = {{42, "bt_\"main\""}};
+  snapshot.records = {{1000500, 7, 42, 0}, {1001000, 8, 42, 2}, {1002250, 7, 42, 1}};
+
+  std::stringstream json;
+  TraceRing::WriteChromeJson(snapshot, json);
+  ASSERT_EQ(json.str(),
+            "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+            "{\"ph\":\"M\",\"pid\":0,\"tid\":42,\"name\":\"thread_name\","
+            "\"args\":{\"name\":\"bt_\\\"main\\\"\"}},\n"
+            "{\"ph\":\"B\",\"pid\":0,\"tid\":42,\"ts\":1000.500,\"name\":\"Task\","
+            "\"args\":{\"arg\":7}},\n"
+            "{\"ph\":\"i\",\"pid\":0,\"tid\":42,\"ts\":1001.000,\"name\":\"Packet\",\"s\":\"t\","
+            "\"args\":{\"arg\":8}},\n"
+            "{\"ph\":\"E\",\"pid\":0,\"tid\":42,\"ts\":1002.250,\"name\":\"Task\","
+            "\"args\":{\"arg\":7}}\n"
+            "]}\n");
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
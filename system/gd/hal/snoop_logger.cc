@@ -27,6 +27,7 @@
 
 #include "common/circular_buffer.h"
 #include "common/strings.h"
+#include "common/trace_ring.h"
 #include "hal/snoop_logger_common.h"
 #include "module_dumper_flatbuffer.h"
 #include "os/files.h"
@@ -1119,6 +1120,10 @@ void SnoopLogger::FilterCapturedPacket(HciPacket& packet, Direction direction, P
 }
 
 void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction, PacketType type) {
+  // Packet type, direction and length
+  common::Trace(common::TraceEvent::kSnoopCapture,
+                static_cast<uint64_t>(type) << 40 | static_cast<uint64_t>(direction) << 32 |
+                        immutable_packet.size());
   //// TODO(b/335520123) update FilterCapture to stop modifying packets ////
   HciPacket mutable_packet(immutable_packet);
   HciPacket& packet = mutable_packet;
@@ -147,6 +147,7 @@ struct HciLayer::impl {
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
     hal_->sendAclData(bytes);
@@ -155,6 +156,7 @@ struct HciLayer::impl {
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
     hal_->sendScoData(bytes);
@@ -163,6 +165,7 @@ struct HciLayer::impl {
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
     hal_->sendIsoData(bytes);
@@ -308,6 +311,7 @@ struct HciLayer::impl {
       return;
     }
     std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
+    bytes->reserve(command_queue_.front().command->size());
     BitInserter bi(*bytes);
     command_queue_.front().command->Serialize(bi);
     hal_->sendHciCommand(*bytes);
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+PacketView<kLittleEndian> ToView(std::unique_ptr<PacketBuilder<kLittleEndian>> builder) {
+  return PacketView<kLittleEndian>(
+          std::make_shared<std::vector<uint8_t>>(builder->SerializeToBytes()));
+}
+
+template <size_t N>
+std::array<uint8_t, N> Bytes() {
+  std::array<uint8_t, N> bytes;
+  for (size_t i = 0; i < N; i++) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  return bytes;
+}
+
+// Remote Name Request Complete event, with a name of 248 bytes
+PacketView<kLittleEndian> RemoteNameRequestComplete() {
+  return ToView(RemoteNameRequestCompleteBuilder::Create(
+          ErrorCode::SUCCESS, Address({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}), Bytes<248>()));
+}
+
+// LE Periodic Advertising Report event, with |data_size| bytes of data
+PacketView<kLittleEndian> LePeriodicAdvertisingReport(size_t data_size) {
+  return ToView(LePeriodicAdvertisingReportBuilder::Create(
+          0x0001, 0x7f, 0xc4, CteType::NO_CONSTANT_TONE_EXTENSION, DataStatus::COMPLETE,
+          std::vector<uint8_t>(data_size, 0x5a)));
+}
+
+}  // namespace
+
+// Parses the name, copying it if state.range(0) is 0, as a span otherwise
+static void BM_ParseRemoteNameRequestComplete(State& state) {
+  auto packet = RemoteNameRequestComplete();
+  for (auto _ : state) {
+    auto event = RemoteNameRequestCompleteView::Create(EventView::Create(packet));
+    if (!event.IsValid()) {
+      state.SkipWithError("invalid event");
+      break;
+    }
+    if (state.range(0) == 0) {
+      auto name = event.GetRemoteName();
+      ::benchmark::DoNotOptimize(name.data());
+    } else {
+      auto name = event.GetRemoteNameSpan();
+      ::benchmark::DoNotOptimize(name.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+BENCHMARK(BM_ParseRemoteNameRequestComplete)->Arg(0)->Arg(1);
+
+// Parses state.range(0) bytes of data, copying them if state.range(1) is 0,
+// as a span otherwise
+static void BM_ParseLePeriodicAdvertisingReport(State& state) {
+  auto packet = LePeriodicAdvertisingReport(state.range(0));
+  for (auto _ : state) {
+    auto report = LePeriodicAdvertisingReportView::Create(
+            LeMetaEventView::Create(EventView::Create(packet)));
+    if (!report.IsValid()) {
+      state.SkipWithError("invalid report");
+      break;
+    }
+    if (state.range(1) == 0) {
+      auto data = report.GetData();
+      ::benchmark::DoNotOptimize(data.data());
+    } else {
+      auto data = report.GetDataSpan();
+      ::benchmark::DoNotOptimize(data.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+BENCHMARK(BM_ParseLePeriodicAdvertisingReport)
+        ->Args({31, 0})
+        ->Args({31, 1})
+        ->Args({247, 0})
+        ->Args({247, 1});
+
+static void BM_SerializeWriteLocalName(State& state) {
+  auto command = WriteLocalNameBuilder::Create(Bytes<248>());
+  for (auto _ : state) {
+    auto bytes = command->SerializeToBytes();
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * command->size());
+}
+
+BENCHMARK(BM_SerializeWriteLocalName);
+
+static void BM_SerializeLeSetAdvertisingData(State& state) {
+  auto command = LeSetAdvertisingDataRawBuilder::Create(std::vector<uint8_t>(31, 0x5a));
+  for (auto _ : state) {
+    auto bytes = command->SerializeToBytes();
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * command->size());
+}
+
+BENCHMARK(BM_SerializeLeSetAdvertisingData);
+
+static void BM_SerializeLeEncrypt(State& state) {
+  auto command = LeEncryptBuilder::Create(Bytes<16>(), Bytes<16>());
+  for (auto _ : state) {
+    auto bytes = command->SerializeToBytes();
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * command->size());
+}
+
+BENCHMARK(BM_SerializeLeEncrypt);
+
+// Command with scalar fields only, through the endian inserters
+static void BM_SerializeLeSetExtendedScanParameters(State& state) {
+  std::vector<PhyScanParameters> phys(2);
+  auto command = LeSetExtendedScanParametersBuilder::Create(
+          OwnAddressType::RANDOM_DEVICE_ADDRESS, LeScanningFilterPolicy::ACCEPT_ALL, 0x05, phys);
+  for (auto _ : state) {
+    auto bytes = command->SerializeToBytes();
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * command->size());
+}
+
+BENCHMARK(BM_SerializeLeSetExtendedScanParameters);
+
+}  // namespace hci
+}  // namespace bluetooth
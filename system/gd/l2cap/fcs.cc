@@ -16,34 +16,205 @@
 
 #include "l2cap/fcs.h"
 
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 namespace {
+// x^16 + x^15 + x^2 + 1, the FCS is computed least significant bit first.
+constexpr uint32_t kPolynomial = 0x18005;
+constexpr uint16_t kReflectedPolynomial = 0xa001;
+
+using CrcTable = std::array<std::array<uint16_t, 256>, 8>;
+
 // Table for optimizing the CRC calculation, which is a bitwise operation.
-static const uint16_t crctab[256] = {
-        0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601, 0x06c0, 0x0780,
-        0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440, 0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1,
-        0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81, 0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841, 0xd801,
-        0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1, 0xdf81, 0x1f40,
-        0xdd01, 0x1dc0, 0x1c80, 0xdc41, 0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0, 0x1680,
-        0xd641, 0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081, 0x1040, 0xf001, 0x30c0,
-        0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240, 0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501,
-        0x35c0, 0x3480, 0xf441, 0x3c00, 0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41,
-        0xfa01, 0x3ac0, 0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840, 0x2800, 0xe8c1, 0xe981,
-        0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41, 0xee01, 0x2ec0, 0x2f80, 0xef41, 0x2d00, 0xedc1,
-        0xec81, 0x2c40, 0xe401, 0x24c0, 0x2580, 0xe541, 0x2700, 0xe7c1, 0xe681, 0x2640, 0x2200,
-        0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0, 0x2080, 0xe041, 0xa001, 0x60c0, 0x6180, 0xa141,
-        0x6300, 0xa3c1, 0xa281, 0x6240, 0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480,
-        0xa441, 0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41, 0xaa01, 0x6ac0,
-        0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840, 0x7800, 0xb8c1, 0xb981, 0x7940, 0xbb01,
-        0x7bc0, 0x7a80, 0xba41, 0xbe01, 0x7ec0, 0x7f80, 0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40,
-        0xb401, 0x74c0, 0x7580, 0xb541, 0x7700, 0xb7c1, 0xb681, 0x7640, 0x7200, 0xb2c1, 0xb381,
-        0x7340, 0xb101, 0x71c0, 0x7080, 0xb041, 0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0,
-        0x5280, 0x9241, 0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481, 0x5440, 0x9c01,
-        0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40, 0x5a00, 0x9ac1, 0x9b81, 0x5b40,
-        0x9901, 0x59c0, 0x5880, 0x9841, 0x8801, 0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81,
-        0x4a40, 0x4e00, 0x8ec1, 0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41, 0x4400, 0x84c1,
-        0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341, 0x4100,
-        0x81c1, 0x8081, 0x4040,
-};
+// crctab[0] adds one byte, crctab[n] adds one byte followed by n zero bytes.
+constexpr CrcTable MakeCrcTable() {
+  CrcTable table{};
+  for (int i = 0; i < 256; i++) {
+    uint16_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ kReflectedPolynomial : crc >> 1;
+    }
+    table[0][i] = crc;
+  }
+  for (int n = 1; n < 8; n++) {
+    for (int i = 0; i < 256; i++) {
+      table[n][i] = (table[n - 1][i] >> 8) ^ table[0][table[n - 1][i] & 0xff];
+    }
+  }
+  return table;
+}
+
+constexpr CrcTable crctab = MakeCrcTable();
+static_assert(crctab[0][0x01] == 0xc0c1 && crctab[0][0xff] == 0x4040);
+
+uint16_t UpdateBytewise(uint16_t crc, const uint8_t* data, size_t length) {
+  for (; length > 0; length--) {
+    crc = (crc >> 8) ^ crctab[0][(crc ^ *data++) & 0xff];
+  }
+  return crc;
+}
+
+// Slice-by-8: the CRC only overlaps the first two bytes of each 8 byte step.
+uint16_t UpdateSliceBy8(uint16_t crc, const uint8_t* data, size_t length) {
+  for (; length >= 8; length -= 8, data += 8) {
+    crc = crctab[7][(crc ^ data[0]) & 0xff] ^ crctab[6][(crc >> 8) ^ data[1]] ^
+          crctab[5][data[2]] ^ crctab[4][data[3]] ^ crctab[3][data[4]] ^ crctab[2][data[5]] ^
+          crctab[1][data[6]] ^ crctab[0][data[7]];
+  }
+  return UpdateBytewise(crc, data, length);
+}
+
+// Below this many bytes the carry-less multiply does not pay for the final
+// 16 bytes it leaves to the tables.
+constexpr size_t kCarrylessMinLength = 64;
+
+// Constant folding a 64 bit lane forward by |degree| bits: x^degree mod P,
+// taken as x * (x^(degree - 1) mod P) and bit reflected so that bit 64 - n
+// holds the coefficient of x^n. The 127 bit product of a reflected lane with
+// it then lines up with the reflected 128 bit block.
+constexpr uint64_t FoldConstant(int degree) {
+  uint32_t remainder = 1;
+  for (int i = 0; i < degree - 1; i++) {
+    remainder <<= 1;
+    if (remainder & 0x10000) {
+      remainder ^= kPolynomial;
+    }
+  }
+  remainder <<= 1;
+  uint64_t constant = 0;
+  for (int n = 1; n <= 16; n++) {
+    if (remainder & (1u << n)) {
+      constant |= uint64_t{1} << (64 - n);
+    }
+  }
+  return constant;
+}
+
+// The low lane holds the higher degree half of a block, so it moves 64 bits
+// further than the high lane.
+constexpr uint64_t kFold128Low = FoldConstant(128 + 64);
+constexpr uint64_t kFold128High = FoldConstant(128);
+constexpr uint64_t kFold512Low = FoldConstant(512 + 64);
+constexpr uint64_t kFold512High = FoldConstant(512);
+
+/*
+ * Carry-less multiply path. Each 16 byte block is folded into the next ones
+ * with a multiply by x^128 (or x^512 with four blocks in flight) mod P, which
+ * leaves a 16 byte block with the same CRC as everything folded into it. That
+ * block and the tail are then added with the tables. The initial CRC is xored
+ * into the first two bytes, as the bytewise update does. |length| is at least
+ * kCarrylessMinLength.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define FCS_CARRYLESS_MULTIPLY __attribute__((target("sse2,pclmul")))
+
+FCS_CARRYLESS_MULTIPLY inline __m128i Fold(__m128i block, __m128i constants, __m128i next) {
+  __m128i low = _mm_clmulepi64_si128(block, constants, 0x00);
+  __m128i high = _mm_clmulepi64_si128(block, constants, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+FCS_CARRYLESS_MULTIPLY inline __m128i Load(const uint8_t* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+FCS_CARRYLESS_MULTIPLY uint16_t UpdateCarryless(uint16_t crc, const uint8_t* data,
+                                                size_t length) {
+  const __m128i fold_128 = _mm_set_epi64x(kFold128High, kFold128Low);
+  const __m128i fold_512 = _mm_set_epi64x(kFold512High, kFold512Low);
+
+  __m128i x0 = _mm_xor_si128(Load(data), _mm_cvtsi32_si128(crc));
+  __m128i x1 = Load(data + 16);
+  __m128i x2 = Load(data + 32);
+  __m128i x3 = Load(data + 48);
+  data += 64;
+  length -= 64;
+  for (; length >= 64; length -= 64, data += 64) {
+    x0 = Fold(x0, fold_512, Load(data));
+    x1 = Fold(x1, fold_512, Load(data + 16));
+    x2 = Fold(x2, fold_512, Load(data + 32));
+    x3 = Fold(x3, fold_512, Load(data + 48));
+  }
+  x0 = Fold(x0, fold_128, x1);
+  x0 = Fold(x0, fold_128, x2);
+  x0 = Fold(x0, fold_128, x3);
+  for (; length >= 16; length -= 16, data += 16) {
+    x0 = Fold(x0, fold_128, Load(data));
+  }
+
+  alignas(16) uint8_t remainder[16];
+  _mm_store_si128(reinterpret_cast<__m128i*>(remainder), x0);
+  return UpdateSliceBy8(UpdateSliceBy8(0, remainder, sizeof(remainder)), data, length);
+}
+
+bool HasCarrylessMultiply() { return __builtin_cpu_supports("pclmul"); }
+
+#elif defined(__aarch64__)
+#define FCS_CARRYLESS_MULTIPLY __attribute__((target("aes")))
+
+FCS_CARRYLESS_MULTIPLY inline uint64x2_t Fold(uint64x2_t block, uint64_t constant_low,
+                                              uint64_t constant_high, uint64x2_t next) {
+  uint64x2_t low = vreinterpretq_u64_p128(vmull_p64(vgetq_lane_u64(block, 0), constant_low));
+  uint64x2_t high = vreinterpretq_u64_p128(vmull_p64(vgetq_lane_u64(block, 1), constant_high));
+  return veorq_u64(veorq_u64(low, high), next);
+}
+
+FCS_CARRYLESS_MULTIPLY inline uint64x2_t Load(const uint8_t* data) {
+  return vreinterpretq_u64_u8(vld1q_u8(data));
+}
+
+FCS_CARRYLESS_MULTIPLY uint16_t UpdateCarryless(uint16_t crc, const uint8_t* data,
+                                                size_t length) {
+  uint64x2_t x0 = veorq_u64(Load(data), vsetq_lane_u64(crc, vdupq_n_u64(0), 0));
+  uint64x2_t x1 = Load(data + 16);
+  uint64x2_t x2 = Load(data + 32);
+  uint64x2_t x3 = Load(data + 48);
+  data += 64;
+  length -= 64;
+  for (; length >= 64; length -= 64, data += 64) {
+    x0 = Fold(x0, kFold512Low, kFold512High, Load(data));
+    x1 = Fold(x1, kFold512Low, kFold512High, Load(data + 16));
+    x2 = Fold(x2, kFold512Low, kFold512High, Load(data + 32));
+    x3 = Fold(x3, kFold512Low, kFold512High, Load(data + 48));
+  }
+  x0 = Fold(x0, kFold128Low, kFold128High, x1);
+  x0 = Fold(x0, kFold128Low, kFold128High, x2);
+  x0 = Fold(x0, kFold128Low, kFold128High, x3);
+  for (; length >= 16; length -= 16, data += 16) {
+    x0 = Fold(x0, kFold128Low, kFold128High, Load(data));
+  }
+
+  uint8_t remainder[16];
+  vst1q_u8(remainder, vreinterpretq_u8_u64(x0));
+  return UpdateSliceBy8(UpdateSliceBy8(0, remainder, sizeof(remainder)), data, length);
+}
+
+bool HasCarrylessMultiply() { return getauxval(AT_HWCAP) & HWCAP_PMULL; }
+
+#else
+uint16_t UpdateCarryless(uint16_t crc, const uint8_t* data, size_t length) {
+  return UpdateSliceBy8(crc, data, length);
+}
+
+bool HasCarrylessMultiply() { return false; }
+#endif
+
+using UpdateFunction = uint16_t (*)(uint16_t crc, const uint8_t* data, size_t length);
+
+// The update used from kCarrylessMinLength bytes, picked once per process.
+UpdateFunction GetLargeUpdate() {
+  static const UpdateFunction update =
+          HasCarrylessMultiply() ? UpdateCarryless : UpdateSliceBy8;
+  return update;
+}
 }  // namespace
 
 namespace bluetooth {
@@ -51,7 +222,15 @@ namespace l2cap {
 
 void Fcs::Initialize() { crc = 0; }
 
-void Fcs::AddByte(uint8_t byte) { crc = ((crc >> 8) & 0x00ff) ^ crctab[(crc & 0x00ff) ^ byte]; }
+void Fcs::AddByte(uint8_t byte) { crc = ((crc >> 8) & 0x00ff) ^ crctab[0][(crc & 0x00ff) ^ byte]; }
+
+void Fcs::AddBytes(const uint8_t* data, size_t length) {
+  if (length >= kCarrylessMinLength) {
+    crc = GetLargeUpdate()(crc, data, length);
+  } else {
+    crc = UpdateSliceBy8(crc, data, length);
+  }
+}
 
 uint16_t Fcs::GetChecksum() const { return crc; }
 
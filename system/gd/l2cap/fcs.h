@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace bluetooth {
@@ -28,6 +29,10 @@ public:
 
   void AddByte(uint8_t byte);
 
+  // Adds |length| contiguous bytes. Large inputs use a carry-less multiply
+  // when the CPU has one, and 8 bytes per step otherwise.
+  void AddBytes(const uint8_t* data, size_t length);
+
   uint16_t GetChecksum() const;
 
 private:
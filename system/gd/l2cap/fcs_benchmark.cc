@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "l2cap/fcs.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+
+// FCS over one frame of state.range(0) bytes, a byte at a time the way the
+// generated packet code adds them.
+static void BM_FcsAddByte(State& state) {
+  std::vector<uint8_t> frame(state.range(0), 0x5a);
+  for (auto _ : state) {
+    Fcs fcs;
+    fcs.Initialize();
+    for (uint8_t byte : frame) {
+      fcs.AddByte(byte);
+    }
+    ::benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+BENCHMARK(BM_FcsAddByte)->Arg(16)->Arg(64)->Arg(256)->Arg(1021)->Arg(4096);
+
+// FCS over one contiguous frame of state.range(0) bytes.
+static void BM_FcsAddBytes(State& state) {
+  std::vector<uint8_t> frame(state.range(0), 0x5a);
+  for (auto _ : state) {
+    Fcs fcs;
+    fcs.Initialize();
+    fcs.AddBytes(frame.data(), frame.size());
+    ::benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+BENCHMARK(BM_FcsAddBytes)->Arg(16)->Arg(64)->Arg(256)->Arg(1021)->Arg(4096);
+
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/fcs.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace bluetooth {
+namespace l2cap {
+namespace {
+
+uint16_t ChecksumBytewise(const uint8_t* data, size_t length) {
+  Fcs fcs;
+  fcs.Initialize();
+  for (size_t i = 0; i < length; i++) {
+    fcs.AddByte(data[i]);
+  }
+  return fcs.GetChecksum();
+}
+
+uint16_t ChecksumBulk(const uint8_t* data, size_t length) {
+  Fcs fcs;
+  fcs.Initialize();
+  fcs.AddBytes(data, length);
+  return fcs.GetChecksum();
+}
+
+std::vector<uint8_t> RandomBytes(size_t length) {
+  std::mt19937 gen(length);
+  std::uniform_int_distribution<int> dist(0, 0xff);
+  std::vector<uint8_t> bytes(length);
+  for (uint8_t& byte : bytes) {
+    byte = dist(gen);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+// The examples in the L2CAP spec, Vol 3, Part A, 3.3.5.
+TEST(L2capFcsTest, spec_examples) {
+  const std::vector<uint8_t> i_frame = {0x0e, 0x00, 0x40, 0x00, 0x02, 0x00, 0x00, 0x01,
+                                        0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+  ASSERT_EQ(0x6138, ChecksumBytewise(i_frame.data(), i_frame.size()));
+  ASSERT_EQ(0x6138, ChecksumBulk(i_frame.data(), i_frame.size()));
+
+  const std::vector<uint8_t> rr_frame = {0x04, 0x00, 0x40, 0x00, 0x01, 0x01};
+  ASSERT_EQ(0x14d4, ChecksumBytewise(rr_frame.data(), rr_frame.size()));
+  ASSERT_EQ(0x14d4, ChecksumBulk(rr_frame.data(), rr_frame.size()));
+}
+
+TEST(L2capFcsTest, add_bytes_matches_add_byte) {
+  for (size_t length = 0; length <= 1100; length++) {
+    std::vector<uint8_t> bytes = RandomBytes(length);
+    ASSERT_EQ(ChecksumBytewise(bytes.data(), bytes.size()),
+              ChecksumBulk(bytes.data(), bytes.size()))
+            << "length " << length;
+  }
+}
+
+TEST(L2capFcsTest, add_bytes_unaligned) {
+  std::vector<uint8_t> bytes = RandomBytes(1024 + 16);
+  for (size_t offset = 0; offset < 16; offset++) {
+    ASSERT_EQ(ChecksumBytewise(bytes.data() + offset, 1024),
+              ChecksumBulk(bytes.data() + offset, 1024))
+            << "offset " << offset;
+  }
+}
+
+TEST(L2capFcsTest, add_bytes_in_pieces) {
+  std::vector<uint8_t> bytes = RandomBytes(4096);
+  uint16_t expected = ChecksumBytewise(bytes.data(), bytes.size());
+  for (size_t split : {1, 7, 15, 16, 63, 64, 65, 1000, 4095}) {
+    Fcs fcs;
+    fcs.Initialize();
+    fcs.AddBytes(bytes.data(), split);
+    fcs.AddByte(bytes[split]);
+    fcs.AddBytes(bytes.data() + split + 1, bytes.size() - split - 1);
+    ASSERT_EQ(expected, fcs.GetChecksum()) << "split " << split;
+  }
+}
+
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -17,8 +17,10 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "common/bidi_queue.h"
 #include "l2cap/cid.h"
@@ -79,21 +81,25 @@ private:
     void AppendPacketView(packet::PacketView<kLittleEndian> to_append) { Append(to_append); }
   };
 
-  class CopyablePacketBuilder : public packet::BasePacketBuilder {
+  // A segment of an outgoing SDU. The SDU is serialized once, and its segments refer to that
+  // storage until they are acknowledged, so retransmissions don't copy or segment it again.
+  class SegmentBuilder : public packet::BasePacketBuilder {
   public:
-    CopyablePacketBuilder(std::shared_ptr<packet::RawBuilder> builder)
-        : builder_(std::move(builder)) {}
+    SegmentBuilder(std::shared_ptr<const std::vector<uint8_t>> sdu, size_t begin, size_t end)
+        : sdu_(std::move(sdu)), begin_(begin), end_(end) {}
 
     void Serialize(BitInserter& it) const override;
 
     size_t size() const override;
 
   private:
-    std::shared_ptr<packet::RawBuilder> builder_;
+    std::shared_ptr<const std::vector<uint8_t>> sdu_;
+    size_t begin_;
+    size_t end_;
   };
 
-  PacketViewForReassembly reassembly_stage_{
-          PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
+  // Chains the payloads of the received segments, which still refer to the received frames
+  std::optional<PacketViewForReassembly> reassembly_stage_;
   SegmentationAndReassembly sar_state_ = SegmentationAndReassembly::END;
   uint16_t remaining_sdu_continuation_packet_size_ = 0;
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "l2cap/internal/enhanced_retransmission_mode_channel_data_controller.h"
+#include "l2cap/internal/ilink.h"
+#include "l2cap/internal/scheduler.h"
+#include "l2cap/l2cap_packets.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+constexpr Cid kCid = 0x40;
+constexpr uint8_t kMaxTxWin = 64;
+// One I-frame out of kLossInterval is lost on its first transmission
+constexpr int kLossInterval = 10;
+
+class FakeLink : public ILink {
+public:
+  void SendDisconnectionRequest(Cid /* local_cid */, Cid /* remote_cid */) override {}
+  hci::AddressWithType GetDevice() const override { return hci::AddressWithType(); }
+};
+
+class CountingScheduler : public Scheduler {
+public:
+  void OnPacketsReady(Cid /* cid */, int number_packets) override { pending_ += number_packets; }
+
+  int pending_ = 0;
+};
+
+// Sends the frames ready in the controller the way the link does, and returns the number of
+// I-frames and bytes sent.
+std::pair<int, size_t> SendFrames(ErtmController& controller, CountingScheduler& scheduler,
+                                  std::vector<uint8_t>& buffer) {
+  int frames = 0;
+  size_t bytes = 0;
+  for (; scheduler.pending_ > 0; scheduler.pending_--) {
+    buffer.clear();
+    BitInserter it(buffer);
+    controller.GetNextPacket()->Serialize(it);
+    frames++;
+    bytes += buffer.size();
+  }
+  return {frames, bytes};
+}
+
+PacketView<kLittleEndian> SupervisoryFrame(SupervisoryFunction s, uint8_t req_seq) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*bytes);
+  EnhancedSupervisoryFrameBuilder::Create(kCid, s, Poll::NOT_SET, Final::NOT_SET, req_seq)
+          ->Serialize(it);
+  return PacketView<kLittleEndian>(bytes);
+}
+
+class BM_ErtmController : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = new os::Thread("ertm_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+  }
+
+  void TearDown(State& st) override {
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    handler_ = nullptr;
+    thread_ = nullptr;
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  os::Thread* thread_;
+  os::Handler* handler_;
+};
+
+// Sends SDUs of state.range(0) bytes in I-frames of up to 1000 bytes of payload. The peer
+// rejects the first lost I-frame of each SDU, which is sent again along with the frames after
+// it, then acknowledges the whole SDU. The sequence number checks of the controller assume no
+// more than local_tx_window_ (10) unacknowledged I-frames, so an SDU fits in 8 I-frames at most.
+BENCHMARK_DEFINE_F(BM_ErtmController, send_sdu_with_loss)(State& state) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  CountingScheduler scheduler;
+  FakeLink link;
+  ErtmController controller{&link, kCid, kCid, channel_queue.GetDownEnd(), handler_, &scheduler};
+  RetransmissionAndFlowControlConfigurationOption option;
+  option.tx_window_size_ = kMaxTxWin - 1;
+  option.max_transmit_ = 20;
+  option.retransmission_time_out_ = 2000;
+  option.monitor_time_out_ = 12000;
+  option.maximum_pdu_size_ = 1010;
+  controller.SetRetransmissionAndFlowControlOptions(option);
+
+  const std::vector<uint8_t> sdu(state.range(0), 0x5a);
+  std::vector<uint8_t> buffer;
+  uint8_t next_tx_seq = 0;
+  int64_t i_frames = 0;
+  size_t bytes_copied = 0;
+  for (auto _ : state) {
+    controller.OnSdu(std::make_unique<packet::RawBuilder>(sdu));
+    // OnSdu serializes the SDU once
+    bytes_copied += sdu.size();
+
+    auto [frames, bytes] = SendFrames(controller, scheduler, buffer);
+    bytes_copied += bytes;
+    std::optional<uint8_t> lost_tx_seq;
+    for (int i = 0; i < frames; i++) {
+      if (++i_frames % kLossInterval == 0 && !lost_tx_seq) {
+        lost_tx_seq = (next_tx_seq + i) % kMaxTxWin;
+      }
+    }
+    next_tx_seq = (next_tx_seq + frames) % kMaxTxWin;
+
+    if (lost_tx_seq) {
+      controller.OnPdu(SupervisoryFrame(SupervisoryFunction::REJECT, *lost_tx_seq));
+      bytes_copied += SendFrames(controller, scheduler, buffer).second;
+    }
+    controller.OnPdu(SupervisoryFrame(SupervisoryFunction::RECEIVER_READY, next_tx_seq));
+    bytes_copied += SendFrames(controller, scheduler, buffer).second;
+  }
+  state.SetBytesProcessed(state.iterations() * sdu.size());
+  state.counters["bytes_copied_per_sdu"] =
+          ::benchmark::Counter(bytes_copied, ::benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(BM_ErtmController, send_sdu_with_loss)
+        ->Arg(100)
+        ->Arg(1000)
+        ->Arg(4000)
+        ->Arg(8000);
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
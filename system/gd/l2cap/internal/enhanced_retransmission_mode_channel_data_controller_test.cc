@@ -164,6 +164,71 @@ TEST_F(ErtmDataControllerTest, reassemble_invalid_sdu_size_in_start_frame_will_d
   EXPECT_EQ(payload, nullptr);
 }
 
+TEST_F(ErtmDataControllerTest, reassemble_continuation_past_sdu_size_will_disconnect) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  ErtmController controller{&link, 1, 1, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  auto segment1 = CreateSdu({'a'});
+  auto segment2 = CreateSdu({'b', 'c', 'd'});
+  auto builder1 = EnhancedInformationStartFrameBuilder::Create(1, 0, Final::NOT_SET, 0, 3,
+                                                               std::move(segment1));
+  auto base_view = GetPacketView(std::move(builder1));
+  controller.OnPdu(base_view);
+  auto builder2 = EnhancedInformationFrameBuilder::Create(
+          1, 1, Final::NOT_SET, 0, SegmentationAndReassembly::CONTINUATION, std::move(segment2));
+  base_view = GetPacketView(std::move(builder2));
+  EXPECT_CALL(link, SendDisconnectionRequest(1, 1));
+  controller.OnPdu(base_view);
+  sync_handler(queue_handler_);
+  auto payload = channel_queue.GetUpEnd()->TryDequeue();
+  EXPECT_EQ(payload, nullptr);
+}
+
+TEST_F(ErtmDataControllerTest, transmit_segmented_sdu) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  ErtmController controller{&link, 1, 1, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  RetransmissionAndFlowControlConfigurationOption option;
+  option.tx_window_size_ = 10;
+  option.max_transmit_ = 20;
+  option.retransmission_time_out_ = 2000;
+  option.monitor_time_out_ = 12000;
+  option.maximum_pdu_size_ = 14;  // 6 bytes of payload per I-frame, without FCS
+  controller.SetRetransmissionAndFlowControlOptions(option);
+  EXPECT_CALL(scheduler, OnPacketsReady(1, 1)).Times(3);
+  controller.OnSdu(CreateSdu(
+          {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p'}));
+
+  auto view = GetPacketView(controller.GetNextPacket());
+  auto i_frame_view = EnhancedInformationFrameView::Create(
+          StandardFrameView::Create(BasicFrameView::Create(view)));
+  auto start_view = EnhancedInformationStartFrameView::Create(i_frame_view);
+  ASSERT_TRUE(start_view.IsValid());
+  EXPECT_EQ(start_view.GetL2capSduLength(), 16);
+  auto payload = start_view.GetPayload();
+  EXPECT_EQ(std::string(payload.begin(), payload.end()), "abcdef");
+
+  view = GetPacketView(controller.GetNextPacket());
+  i_frame_view = EnhancedInformationFrameView::Create(
+          StandardFrameView::Create(BasicFrameView::Create(view)));
+  ASSERT_TRUE(i_frame_view.IsValid());
+  EXPECT_EQ(i_frame_view.GetSar(), SegmentationAndReassembly::CONTINUATION);
+  EXPECT_EQ(i_frame_view.GetTxSeq(), 1);
+  payload = i_frame_view.GetPayload();
+  EXPECT_EQ(std::string(payload.begin(), payload.end()), "ghijkl");
+
+  view = GetPacketView(controller.GetNextPacket());
+  i_frame_view = EnhancedInformationFrameView::Create(
+          StandardFrameView::Create(BasicFrameView::Create(view)));
+  ASSERT_TRUE(i_frame_view.IsValid());
+  EXPECT_EQ(i_frame_view.GetSar(), SegmentationAndReassembly::END);
+  EXPECT_EQ(i_frame_view.GetTxSeq(), 2);
+  payload = i_frame_view.GetPayload();
+  EXPECT_EQ(std::string(payload.begin(), payload.end()), "mnop");
+}
+
 TEST_F(ErtmDataControllerTest, transmit_with_fcs) {
   common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
   testing::MockScheduler scheduler;
@@ -20,6 +20,7 @@
 #include <bluetooth/log.h>
 
 #include "common/bind.h"
+#include "metrics/counter_registry.h"
 #include "os/log.h"
 #include "os/metrics.h"
 
@@ -96,6 +97,7 @@ void CounterMetrics::DrainBufferedCounters() {
     Count(pair.first, pair.second);
   }
   counters_.clear();
+  CounterRegistry::Get().Drain([this](int32_t key, int64_t count) { Count(key, count); });
 }
 
 }  // namespace metrics
@@ -19,6 +19,7 @@
 #include <unordered_map>
 
 #include "gtest/gtest.h"
+#include "metrics/counter_registry.h"
 
 namespace bluetooth {
 namespace metrics {
@@ -84,6 +85,15 @@ TEST_F(CounterMetricsTest, non_positive) {
   ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 5);
 }
 
+TEST_F(CounterMetricsTest, drain_counter_registry) {
+  CounterId id = CounterRegistry::Get().Register(2001);
+  CounterRegistry::Get().Add(id, 7);
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(1, 5));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 5);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[2001], 7);
+}
+
 }  // namespace
 }  // namespace metrics
 }  // namespace bluetooth
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "BluetoothCounterRegistry"
+
+#include "metrics/counter_registry.h"
+
+#include <bluetooth/log.h>
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace metrics {
+
+CounterRegistry& CounterRegistry::Get() {
+  // Never destroyed, threads may still count during the process exit
+  static CounterRegistry* registry = new CounterRegistry();
+  return *registry;
+}
+
+CounterId CounterRegistry::Register(int32_t key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(key);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  if (keys_.size() == kMaxCounters) {
+    log::warn("No counter left for key {}", key);
+    return kInvalidCounterId;
+  }
+  CounterId id = keys_.size();
+  keys_.push_back(key);
+  ids_[key] = id;
+  return id;
+}
+
+CounterRegistry::Shard* CounterRegistry::AttachThread() {
+  thread_local ShardOwner owner;
+  owner.shard = new Shard();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.push_back(owner.shard);
+  }
+  tls_shard_ = owner.shard;
+  return owner.shard;
+}
+
+CounterRegistry::ShardOwner::~ShardOwner() {
+  if (shard != nullptr) {
+    CounterRegistry::Get().DetachThread(shard);
+  }
+}
+
+void CounterRegistry::DetachThread(Shard* shard) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t id = 0; id < kMaxCounters; id++) {
+      detached_[id] += shard->values[id].load(std::memory_order_relaxed);
+    }
+    shards_.erase(std::find(shards_.begin(), shards_.end(), shard));
+  }
+  tls_shard_ = nullptr;
+  delete shard;
+}
+
+int64_t CounterRegistry::TotalLocked(CounterId id) const {
+  int64_t total = detached_[id];
+  for (const Shard* shard : shards_) {
+    total += shard->values[id].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+int64_t CounterRegistry::Total(CounterId id) const {
+  if (id >= kMaxCounters) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return TotalLocked(id);
+}
+
+void CounterRegistry::Drain(const std::function<void(int32_t key, int64_t count)>& report) {
+  std::vector<std::pair<int32_t, int64_t>> counts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (CounterId id = 0; id < keys_.size(); id++) {
+      int64_t total = TotalLocked(id);
+      if (total != drained_[id]) {
+        counts.emplace_back(keys_[id], total - drained_[id]);
+        drained_[id] = total;
+      }
+    }
+  }
+
+  // Reported without the lock, which the threads exiting take
+  for (auto const& [key, count] : counts) {
+    report(key, count);
+  }
+}
+
+}  // namespace metrics
+}  // namespace bluetooth
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace bluetooth {
+namespace metrics {
+
+// Dense index of a counter registered with the CounterRegistry
+using CounterId = uint16_t;
+
+// Process wide counters for hot paths, cheap enough to be incremented per
+// packet from any thread.
+//
+// Counters are registered once with their metrics key, which returns a dense
+// CounterId. Each thread increments its own shard of the counters with a plain
+// relaxed store, without locking or atomic read-modify-write. The shards are
+// summed when draining, which reports what was counted since the previous
+// drain. The shards of the threads which exited are folded into the registry.
+//
+// Legacy stack code and gd modules alike use the instance returned by Get().
+// CounterMetrics drains it into the metrics along with its cached counts.
+class CounterRegistry {
+public:
+  static constexpr size_t kMaxCounters = 128;
+  static constexpr CounterId kInvalidCounterId = kMaxCounters;
+
+  static CounterRegistry& Get();
+
+  // Returns the CounterId of |key|, registering it first if needed.
+  // Returns kInvalidCounterId when all the counters are taken.
+  CounterId Register(int32_t key);
+
+  // Adds |count| to the counter |id|. Wait free.
+  void Add(CounterId id, int64_t count = 1) {
+    if (id >= kMaxCounters) {
+      return;
+    }
+    Shard* shard = tls_shard_;
+    if (shard == nullptr) {
+      shard = AttachThread();
+    }
+    // Only this thread writes to its shard
+    auto& value = shard->values[id];
+    value.store(value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+  }
+
+  // Returns the total counted by the counter |id|, including what was drained.
+  int64_t Total(CounterId id) const;
+
+  // Calls |report| with the key of each counter and what it counted since the
+  // previous drain, for the counters which counted anything.
+  void Drain(const std::function<void(int32_t key, int64_t count)>& report);
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<int64_t>, kMaxCounters> values{};
+  };
+
+  // Folds the shard of the thread back into the registry on thread exit
+  class ShardOwner {
+  public:
+    ~ShardOwner();
+    Shard* shard = nullptr;
+  };
+
+  CounterRegistry() = default;
+
+  Shard* AttachThread();
+  void DetachThread(Shard* shard);
+  int64_t TotalLocked(CounterId id) const;
+
+  // Defined inline so that Add() reads it without going through a TLS wrapper
+  static inline thread_local Shard* tls_shard_ = nullptr;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<int32_t, CounterId> ids_;
+  std::vector<int32_t> keys_;
+  std::vector<Shard*> shards_;
+  // Counted by the threads which exited
+  std::array<int64_t, kMaxCounters> detached_{};
+  // Totals of the previous drain
+  std::array<int64_t, kMaxCounters> drained_{};
+};
+
+}  // namespace metrics
+}  // namespace bluetooth
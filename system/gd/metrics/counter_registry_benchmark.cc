@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "metrics/counter_metrics.h"
+#include "metrics/counter_registry.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace metrics {
+
+// Counts per packet from each of state.threads threads, one of a few
+// counters each time. Reports per count.
+constexpr int32_t kFirstKey = 3000;
+constexpr int kNumKeys = 4;
+
+class CachingCounterMetrics : public CounterMetrics {
+private:
+  bool IsInitialized() override { return true; }
+};
+
+CachingCounterMetrics* counter_metrics = new CachingCounterMetrics();
+std::atomic<int64_t> shared_counters[kNumKeys];
+
+// CounterMetrics::CacheCount, a mutex and a hash map lookup per count
+static void BM_CounterMetricsCacheCount(State& state) {
+  int i = state.thread_index();
+  for (auto _ : state) {
+    counter_metrics->CacheCount(kFirstKey + (i++ % kNumKeys), 1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Counters shared by all the threads, an atomic increment per count
+static void BM_SharedAtomicCounter(State& state) {
+  int i = state.thread_index();
+  for (auto _ : state) {
+    shared_counters[i++ % kNumKeys].fetch_add(1, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_CounterRegistryAdd(State& state) {
+  CounterId ids[kNumKeys];
+  for (int k = 0; k < kNumKeys; k++) {
+    ids[k] = CounterRegistry::Get().Register(kFirstKey + k);
+  }
+  int i = state.thread_index();
+  for (auto _ : state) {
+    CounterRegistry::Get().Add(ids[i++ % kNumKeys]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CounterMetricsCacheCount)->Threads(1)->Threads(8);
+BENCHMARK(BM_SharedAtomicCounter)->Threads(1)->Threads(8);
+BENCHMARK(BM_CounterRegistryAdd)->Threads(1)->Threads(8);
+
+}  // namespace metrics
+}  // namespace bluetooth
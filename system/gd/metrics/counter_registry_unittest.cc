@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "metrics/counter_registry.h"
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bluetooth {
+namespace metrics {
+namespace {
+
+// The registry is process wide, each test counts with its own keys
+class CounterRegistryTest : public ::testing::Test {
+protected:
+  void SetUp() override { Drain(); }
+
+  std::unordered_map<int32_t, int64_t> Drain() {
+    std::unordered_map<int32_t, int64_t> counts;
+    CounterRegistry::Get().Drain([&](int32_t key, int64_t count) { counts[key] += count; });
+    return counts;
+  }
+
+  CounterRegistry& registry_ = CounterRegistry::Get();
+};
+
+TEST_F(CounterRegistryTest, register_returns_same_id) {
+  CounterId id = registry_.Register(1001);
+  ASSERT_NE(id, CounterRegistry::kInvalidCounterId);
+  ASSERT_EQ(registry_.Register(1001), id);
+  ASSERT_NE(registry_.Register(1002), id);
+}
+
+TEST_F(CounterRegistryTest, drain_reports_counts_since_previous_drain) {
+  CounterId id1 = registry_.Register(1101);
+  CounterId id2 = registry_.Register(1102);
+  CounterId id3 = registry_.Register(1103);
+  registry_.Add(id1);
+  registry_.Add(id1, 4);
+  registry_.Add(id2, 2);
+
+  auto counts = Drain();
+  ASSERT_EQ(counts[1101], 5);
+  ASSERT_EQ(counts[1102], 2);
+  ASSERT_EQ(counts.count(1103), 0u);
+
+  registry_.Add(id1, 3);
+  registry_.Add(id3);
+  counts = Drain();
+  ASSERT_EQ(counts[1101], 3);
+  ASSERT_EQ(counts.count(1102), 0u);
+  ASSERT_EQ(counts[1103], 1);
+  ASSERT_EQ(registry_.Total(id1), 8);
+}
+
+TEST_F(CounterRegistryTest, merges_counts_of_all_threads) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumCounts = 10000;
+  CounterId id = registry_.Register(1201);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([this, id] {
+      for (int j = 0; j < kNumCounts; j++) {
+        registry_.Add(id);
+      }
+    });
+  }
+  // Counts of the running threads are drained too
+  registry_.Add(id);
+  auto counts = Drain();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  counts[1201] += Drain()[1201];
+
+  // The threads exited, their counts are kept
+  ASSERT_EQ(counts[1201], kNumThreads * kNumCounts + 1);
+  ASSERT_EQ(registry_.Total(id), kNumThreads * kNumCounts + 1);
+}
+
+TEST_F(CounterRegistryTest, invalid_id_is_ignored) {
+  registry_.Add(CounterRegistry::kInvalidCounterId);
+  ASSERT_EQ(registry_.Total(CounterRegistry::kInvalidCounterId), 0);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace bluetooth
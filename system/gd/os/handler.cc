@@ -20,6 +20,7 @@
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/trace_ring.h"
 #include "os/log.h"
 #include "os/reactor.h"
 
@@ -43,6 +44,7 @@ Handler::~Handler() {
 }
 
 void Handler::Post(OnceClosure closure) {
+  common::Trace(common::TraceEvent::kHandlerPost, reinterpret_cast<uintptr_t>(this));
   {
     std::lock_guard<std::mutex> lock(mutex_);
     if (was_cleared()) {
@@ -89,7 +91,9 @@ void Handler::handle_next_event() {
     closure = std::move(tasks_->front());
     tasks_->pop();
   }
+  common::Trace(common::TraceEvent::kHandlerTaskBegin, reinterpret_cast<uintptr_t>(this));
   std::move(closure).Run();
+  common::Trace(common::TraceEvent::kHandlerTaskEnd, reinterpret_cast<uintptr_t>(this));
 }
 
 }  // namespace os
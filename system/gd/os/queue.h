@@ -25,6 +25,7 @@
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/trace_ring.h"
 #include "os/handler.h"
 #include "os/linux_generic/reactive_semaphore.h"
 #include "os/log.h"
@@ -251,6 +252,7 @@ std::unique_ptr<T> Queue<T>::TryDequeue() {
 
   enqueue_.reactive_semaphore_.Increase();
 
+  common::Trace(common::TraceEvent::kQueueDequeue, reinterpret_cast<uintptr_t>(data.get()));
   return data;
 }
 
@@ -258,6 +260,7 @@ template <typename T>
 void Queue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
   std::unique_ptr<T> data = callback.Run();
   log::assert_that(data != nullptr, "assert failed: data != nullptr");
+  common::Trace(common::TraceEvent::kQueueEnqueue, reinterpret_cast<uintptr_t>(data.get()));
   std::lock_guard<std::mutex> lock(mutex_);
   enqueue_.reactive_semaphore_.Decrease();
   queue_.push(std::move(data));
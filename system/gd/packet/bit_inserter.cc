@@ -42,5 +42,16 @@ void BitInserter::insert_bits(uint8_t byte, size_t num_bits) {
 
 void BitInserter::insert_byte(uint8_t byte) { insert_bits(byte, 8); }
 
+void BitInserter::insert_bytes(std::span<const uint8_t> bytes) {
+  // Unaligned bytes are shifted one at a time
+  if (num_saved_bits_ != 0) {
+    for (uint8_t byte : bytes) {
+      insert_bits(byte, 8);
+    }
+    return;
+  }
+  ByteInserter::insert_bytes(bytes);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
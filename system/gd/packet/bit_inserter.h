@@ -35,6 +35,8 @@ public:
 
   void insert_byte(uint8_t byte) override;
 
+  void insert_bytes(std::span<const uint8_t> bytes) override;
+
 protected:
   size_t num_saved_bits_{0};
   uint8_t saved_bits_{0};
@@ -48,5 +48,14 @@ void ByteInserter::insert_byte(uint8_t byte) {
   std::back_insert_iterator<std::vector<uint8_t>>::operator=(byte);
 }
 
+void ByteInserter::insert_bytes(std::span<const uint8_t> bytes) {
+  if (!registered_observers_.empty()) {
+    for (uint8_t byte : bytes) {
+      on_byte(byte);
+    }
+  }
+  container->insert(container->end(), bytes.begin(), bytes.end());
+}
+
 }  // namespace packet
 }  // namespace bluetooth
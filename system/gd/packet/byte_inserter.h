@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "packet/byte_observer.h"
@@ -33,6 +34,9 @@ public:
 
   virtual void insert_byte(uint8_t byte);
 
+  // Appends all the bytes at once, observers still see each of them
+  virtual void insert_bytes(std::span<const uint8_t> bytes);
+
   void RegisterObserver(const ByteObserver& observer);
 
   ByteObserver UnregisterObserver();
@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <forward_list>
 #include <iterator>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "packet/bit_inserter.h"
@@ -41,14 +44,12 @@ protected:
   // Write sizeof(T) bytes using the iterator
   template <typename T, typename std::enable_if<std::is_trivial<T>::value, int>::type = 0>
   void insert(T value, BitInserter& it) const {
-    uint8_t* raw_bytes = (uint8_t*)&value;
-    for (size_t i = 0; i < sizeof(T); i++) {
-      if (little_endian == true) {
-        it.insert_byte(raw_bytes[i]);
-      } else {
-        it.insert_byte(raw_bytes[sizeof(T) - i - 1]);
-      }
+    uint8_t raw_bytes[sizeof(T)];
+    std::memcpy(raw_bytes, &value, sizeof(T));
+    if (little_endian == false) {
+      std::reverse(raw_bytes, raw_bytes + sizeof(T));
     }
+    it.insert_bytes(raw_bytes);
   }
 
   // Write sizeof(FixedWidthCustomType) bytes using the iterator
@@ -57,12 +58,13 @@ protected:
                                     int>::type = 0>
   void insert(const T& value, BitInserter& it) const {
     auto* raw_bytes = value.data();
-    for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
-      if (little_endian == true) {
-        it.insert_byte(raw_bytes[i]);
-      } else {
-        it.insert_byte(raw_bytes[CustomFieldFixedSizeInterface<T>::length() - i - 1]);
-      }
+    size_t length = CustomFieldFixedSizeInterface<T>::length();
+    if (little_endian == true) {
+      it.insert_bytes(std::span<const uint8_t>(raw_bytes, length));
+      return;
+    }
+    for (size_t i = 0; i < length; i++) {
+      it.insert_byte(raw_bytes[length - i - 1]);
     }
   }
 
@@ -71,14 +73,18 @@ protected:
   void insert(T value, BitInserter& it, size_t num_bits) const {
     assert(num_bits <= (sizeof(T) * 8));
 
+    uint8_t raw_bytes[sizeof(T)];
     for (size_t i = 0; i < num_bits / 8; i++) {
       if (little_endian == true) {
-        it.insert_byte(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8)));
+        raw_bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
       } else {
-        it.insert_byte(static_cast<uint8_t>(static_cast<uint64_t>(value) >>
-                                            (((num_bits / 8) - i - 1) * 8)));
+        raw_bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >>
+                                            (((num_bits / 8) - i - 1) * 8));
       }
     }
+    if (num_bits >= 8) {
+      it.insert_bytes(std::span<const uint8_t>(raw_bytes, num_bits / 8));
+    }
     if (num_bits % 8) {
       it.insert_bits(static_cast<uint8_t>(static_cast<uint64_t>(value) >> ((num_bits / 8) * 8)),
                      num_bits % 8);
@@ -99,6 +105,11 @@ protected:
   void insert_vector(const std::vector<T>& vec, BitInserter& it) const {
     static_assert(std::is_trivial<T>::value,
                   "EndianInserter::insert requires a vector with elements of a fixed-size.");
+    if constexpr (sizeof(T) == 1) {
+      it.insert_bytes(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(vec.data()),
+                                               vec.size()));
+      return;
+    }
     for (const auto& element : vec) {
       insert(element, it);
     }
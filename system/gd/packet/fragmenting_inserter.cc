@@ -50,6 +50,12 @@ void FragmentingInserter::insert_bits(uint8_t byte, size_t num_bits) {
   saved_bits_ = static_cast<uint8_t>(new_value) & mask;
 }
 
+void FragmentingInserter::insert_bytes(std::span<const uint8_t> bytes) {
+  for (uint8_t byte : bytes) {
+    insert_bits(byte, 8);
+  }
+}
+
 void FragmentingInserter::finalize() {
   if (curr_packet_->size() != 0) {
     iterator_ = std::move(curr_packet_);
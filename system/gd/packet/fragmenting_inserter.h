@@ -34,6 +34,8 @@ public:
 
   void insert_bits(uint8_t byte, size_t num_bits) override;
 
+  void insert_bytes(std::span<const uint8_t> bytes) override;
+
   void finalize();
 
 protected:
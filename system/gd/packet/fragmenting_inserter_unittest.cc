@@ -123,6 +123,25 @@ TEST(FragmentingInserterTest, testMtuBoundaries) {
   ASSERT_EQ(kPacketSize, fragments_mtu_is_more[0]->size());
 }
 
+TEST(FragmentingInserterTest, insertBytesAcrossMtu) {
+  std::vector<std::unique_ptr<RawBuilder>> fragments;
+  FragmentingInserter it(3, std::back_insert_iterator(fragments));
+
+  it.insert_bits(static_cast<uint8_t>(0b1010), 4);
+  std::vector<uint8_t> payload = {0x12, 0x34, 0x56, 0x78};
+  it.insert_bytes(payload);
+  it.insert_bits(static_cast<uint8_t>(0b0101), 4);
+  it.finalize();
+
+  ASSERT_EQ(2ul, fragments.size());
+  std::vector<uint8_t> bytes;
+  BitInserter bit_inserter(bytes);
+  fragments[0]->Serialize(bit_inserter);
+  fragments[1]->Serialize(bit_inserter);
+  std::vector<uint8_t> result = {0x2a, 0x41, 0x63, 0x85, 0x57};
+  ASSERT_EQ(result, bytes);
+}
+
 constexpr size_t kPacketSize = 128;
 class FragmentingTest : public ::testing::TestWithParam<size_t> {
 public:
@@ -17,48 +17,27 @@
 #include "packet/iterator.h"
 
 #undef NDEBUG
+#include <algorithm>
 #include <cassert>
 
 namespace bluetooth {
 namespace packet {
 
 template <bool little_endian>
-Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t offset) {
-  data_ = data;
-  index_ = offset;
-  begin_ = 0;
-  end_ = 0;
-  for (auto& view : data) {
+Iterator<little_endian>::Iterator(std::shared_ptr<const std::vector<View>> data, size_t offset)
+    : data_(std::move(data)), index_(offset), begin_(0), end_(0) {
+  for (auto& view : *data_) {
     end_ += view.size();
   }
+  if (data_->size() == 1) {
+    cursor_ = data_->front().data();
+    cursor_size_ = end_;
+  }
 }
 
 template <bool little_endian>
-Iterator<little_endian>::Iterator(std::shared_ptr<std::vector<uint8_t>> data) {
-  data_.emplace_front(data, 0, data->size());
-  index_ = 0;
-  begin_ = 0;
-  end_ = data_.front().size();
-}
-
-template <bool little_endian>
-Iterator<little_endian> Iterator<little_endian>::operator+(int offset) const {
-  auto itr(*this);
-
-  return itr += offset;
-}
-
-template <bool little_endian>
-Iterator<little_endian>& Iterator<little_endian>::operator+=(int offset) {
-  index_ += offset;
-  return *this;
-}
-
-template <bool little_endian>
-Iterator<little_endian>& Iterator<little_endian>::operator++() {
-  index_++;
-  return *this;
-}
+Iterator<little_endian>::Iterator(std::shared_ptr<std::vector<uint8_t>> data)
+    : Iterator(std::make_shared<const std::vector<View>>(1, View(data, 0, data->size())), 0) {}
 
 template <bool little_endian>
 Iterator<little_endian> Iterator<little_endian>::operator-(int offset) const {
@@ -87,18 +66,6 @@ Iterator<little_endian>& Iterator<little_endian>::operator--() {
   return *this;
 }
 
-template <bool little_endian>
-Iterator<little_endian>& Iterator<little_endian>::operator=(const Iterator<little_endian>& itr) {
-  if (this == &itr) {
-    return *this;
-  }
-  this->data_ = itr.data_;
-  this->begin_ = itr.begin_;
-  this->end_ = itr.end_;
-  this->index_ = itr.index_;
-  return *this;
-}
-
 template <bool little_endian>
 bool Iterator<little_endian>::operator==(const Iterator<little_endian>& itr) const {
   return index_ == itr.index_;
@@ -130,28 +97,44 @@ bool Iterator<little_endian>::operator>=(const Iterator<little_endian>& itr) con
 }
 
 template <bool little_endian>
-uint8_t Iterator<little_endian>::operator*() const {
+const uint8_t* Iterator<little_endian>::Seek() const {
   assert(NumBytesRemaining() > 0);
-  size_t index = index_;
+  // Moving forward, which is what parsers do, continues from the last fragment
+  if (index_ < fragment_begin_) {
+    fragment_ = 0;
+    fragment_begin_ = 0;
+  }
 
-  for (auto view : data_) {
-    if (index < view.size()) {
-      return view[index];
+  for (; fragment_ < data_->size(); fragment_++) {
+    const View& view = (*data_)[fragment_];
+    size_t fragment_end = fragment_begin_ + view.size();
+    if (index_ < fragment_end) {
+      size_t cursor_end = std::min(fragment_end, end_);
+      cursor_begin_ = std::max(fragment_begin_, begin_);
+      cursor_size_ = cursor_end - cursor_begin_;
+      cursor_ = view.data() + (cursor_begin_ - fragment_begin_);
+      return cursor_ + (index_ - cursor_begin_);
     }
-    index -= view.size();
+    fragment_begin_ = fragment_end;
   }
 
   // Out of fragments searching for index.
   std::abort();
-  return 0;
+  return nullptr;
 }
 
 template <bool little_endian>
-size_t Iterator<little_endian>::NumBytesRemaining() const {
-  if (end_ > index_ && index_ >= begin_) {
-    return end_ - index_;
+void Iterator<little_endian>::ExtractFragmentedBytes(std::span<uint8_t> bytes) {
+  assert(NumBytesRemaining() >= bytes.size());
+  size_t copied = 0;
+
+  while (copied < bytes.size()) {
+    const uint8_t* source = Seek();
+    size_t length = std::min(bytes.size() - copied, cursor_size_ - (index_ - cursor_begin_));
+    std::memcpy(bytes.data() + copied, source, length);
+    copied += length;
+    index_ += length;
   }
-  return 0;
 }
 
 template <bool little_endian>
@@ -167,9 +150,32 @@ Iterator<little_endian> Iterator<little_endian>::Subrange(size_t index, size_t l
     to_return.end_ = 0;
   }
 
+  // Keep the part of the cached fragment within the new bounds
+  size_t cursor_begin = std::max(to_return.cursor_begin_, to_return.begin_);
+  size_t cursor_end = std::min(to_return.cursor_begin_ + to_return.cursor_size_, to_return.end_);
+  if (cursor_begin < cursor_end) {
+    to_return.cursor_ += cursor_begin - to_return.cursor_begin_;
+    to_return.cursor_begin_ = cursor_begin;
+    to_return.cursor_size_ = cursor_end - cursor_begin;
+  } else {
+    to_return.cursor_size_ = 0;
+  }
+
   return to_return;
 }
 
+template <bool little_endian>
+std::span<const uint8_t> Iterator<little_endian>::ContiguousBytes() const {
+  size_t length = NumBytesRemaining();
+  if (length == 0) {
+    return {};
+  }
+  size_t offset = index_ - cursor_begin_;
+  const uint8_t* first = offset < cursor_size_ ? cursor_ + offset : Seek();
+  assert(cursor_size_ - (index_ - cursor_begin_) >= length);
+  return std::span<const uint8_t>(first, length);
+}
+
 // Explicit instantiations for both types of Iterators.
 template class Iterator<true>;
 template class Iterator<false>;
@@ -16,10 +16,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
-#include <forward_list>
+#include <cstring>
 #include <memory>
+#include <span>
 #include <type_traits>
+#include <vector>
 
 #include "packet/custom_field_fixed_size_interface.h"
 #include "packet/view.h"
@@ -42,25 +45,41 @@ struct IteratorTraits : public std::iterator<std::random_access_iterator_tag, ui
 #endif
 
 // Templated Iterator for endianness
+//
+// The iterator caches the fragment holding the current byte, so that reads
+// within one fragment are a bounds check and a raw pointer access. Packets
+// with a single fragment never leave the cached fragment, packets with
+// several fragments look up the next one when crossing a boundary.
 template <bool little_endian>
 class Iterator : public IteratorTraits {
 public:
-  Iterator(const std::forward_list<View>& data, size_t offset);
+  Iterator(std::shared_ptr<const std::vector<View>> data, size_t offset);
   Iterator(std::shared_ptr<std::vector<uint8_t>> data);
   Iterator(const Iterator& itr) = default;
+  Iterator(Iterator&& itr) = default;
   virtual ~Iterator() = default;
 
   // All addition and subtraction operators are unbounded.
-  Iterator operator+(int offset) const;
-  Iterator& operator+=(int offset);
-  Iterator& operator++();
+  Iterator operator+(int offset) const {
+    auto itr(*this);
+    return itr += offset;
+  }
+  Iterator& operator+=(int offset) {
+    index_ += offset;
+    return *this;
+  }
+  Iterator& operator++() {
+    index_++;
+    return *this;
+  }
 
   Iterator operator-(int offset) const;
   int operator-(const Iterator& itr) const;
   Iterator& operator-=(int offset);
   Iterator& operator--();
 
-  Iterator& operator=(const Iterator& itr);
+  Iterator& operator=(const Iterator& itr) = default;
+  Iterator& operator=(Iterator&& itr) = default;
 
   bool operator!=(const Iterator& itr) const;
   bool operator==(const Iterator& itr) const;
@@ -71,12 +90,38 @@ public:
   bool operator<=(const Iterator& itr) const;
   bool operator>=(const Iterator& itr) const;
 
-  uint8_t operator*() const;
+  uint8_t operator*() const {
+    size_t offset = index_ - cursor_begin_;
+    if (offset < cursor_size_) {
+      return cursor_[offset];
+    }
+    return *Seek();
+  }
 
-  size_t NumBytesRemaining() const;
+  size_t NumBytesRemaining() const {
+    if (end_ > index_ && index_ >= begin_) {
+      return end_ - index_;
+    }
+    return 0;
+  }
 
   Iterator Subrange(size_t index, size_t length) const;
 
+  // The bytes from the iterator to its end, without copying them. They have
+  // to be in a single fragment, aborts otherwise.
+  std::span<const uint8_t> ContiguousBytes() const;
+
+  // Copies the next bytes.size() bytes, in packet order, and moves past them
+  void ExtractBytes(std::span<uint8_t> bytes) {
+    size_t offset = index_ - cursor_begin_;
+    if (offset < cursor_size_ && cursor_size_ - offset >= bytes.size()) {
+      std::memcpy(bytes.data(), cursor_ + offset, bytes.size());
+      index_ += bytes.size();
+      return;
+    }
+    ExtractFragmentedBytes(bytes);
+  }
+
   // Get the next sizeof(T) bytes and return the filled type
   template <typename T, typename std::enable_if<std::is_trivial<T>::value, int>::type = 0>
   T extract() {
@@ -84,10 +129,9 @@ public:
     T extracted_value{};
     uint8_t* value_ptr = (uint8_t*)&extracted_value;
 
-    for (size_t i = 0; i < sizeof(T); i++) {
-      size_t index = (little_endian ? i : sizeof(T) - i - 1);
-      value_ptr[index] = this->operator*();
-      this->operator++();
+    ExtractBytes(std::span<uint8_t>(value_ptr, sizeof(T)));
+    if (!little_endian) {
+      std::reverse(value_ptr, value_ptr + sizeof(T));
     }
     return extracted_value;
   }
@@ -97,19 +141,35 @@ public:
                                     int>::type = 0>
   T extract() {
     T extracted_value{};
-    for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
-      size_t index = (little_endian ? i : CustomFieldFixedSizeInterface<T>::length() - i - 1);
-      extracted_value.data()[index] = this->operator*();
-      this->operator++();
+    uint8_t* value_ptr = extracted_value.data();
+    size_t length = CustomFieldFixedSizeInterface<T>::length();
+
+    ExtractBytes(std::span<uint8_t>(value_ptr, length));
+    if (!little_endian) {
+      std::reverse(value_ptr, value_ptr + length);
     }
     return extracted_value;
   }
 
 private:
-  std::forward_list<View> data_;
+  // Caches the fragment holding the current byte and returns its address.
+  // Aborts when the iterator is out of bounds.
+  const uint8_t* Seek() const;
+  void ExtractFragmentedBytes(std::span<uint8_t> bytes);
+
+  std::shared_ptr<const std::vector<View>> data_;
   size_t index_;
   size_t begin_;
   size_t end_;
+
+  // Bytes [cursor_begin_, cursor_begin_ + cursor_size_) of the packet, the
+  // part of the cached fragment within [begin_, end_).
+  mutable const uint8_t* cursor_ = nullptr;
+  mutable size_t cursor_begin_ = 0;
+  mutable size_t cursor_size_ = 0;
+  // Index of the cached fragment in data_, and of its first byte in the packet
+  mutable size_t fragment_ = 0;
+  mutable size_t fragment_begin_ = 0;
 };
 
 }  // namespace packet
@@ -25,15 +25,21 @@ namespace packet {
 
 template <bool little_endian>
 PacketView<little_endian>::PacketView(const std::forward_list<class View> fragments)
-    : fragments_(fragments), length_(0) {
-  for (auto fragment : fragments_) {
+    : fragments_(std::make_shared<std::vector<View>>(fragments.begin(), fragments.end())),
+      length_(0) {
+  for (const auto& fragment : *fragments_) {
     length_ += fragment.size();
   }
 }
 
 template <bool little_endian>
 PacketView<little_endian>::PacketView(std::shared_ptr<const std::vector<uint8_t>> packet)
-    : fragments_({View(packet, 0, packet->size())}), length_(packet->size()) {}
+    : fragments_(std::make_shared<std::vector<View>>(1, View(packet, 0, packet->size()))),
+      length_(packet->size()) {}
+
+template <bool little_endian>
+PacketView<little_endian>::PacketView(std::shared_ptr<std::vector<View>> fragments, size_t length)
+    : fragments_(std::move(fragments)), length_(length) {}
 
 template <bool little_endian>
 Iterator<little_endian> PacketView<little_endian>::begin() const {
@@ -53,7 +59,7 @@ uint8_t PacketView<little_endian>::operator[](size_t index) const {
 template <bool little_endian>
 uint8_t PacketView<little_endian>::at(size_t index) const {
   assert(index < length_);
-  for (const auto& fragment : fragments_) {
+  for (const auto& fragment : *fragments_) {
     if (index < fragment.size()) {
       return fragment[index];
     }
@@ -70,20 +76,20 @@ size_t PacketView<little_endian>::size() const {
 }
 
 template <bool little_endian>
-std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin, size_t end) const {
+std::shared_ptr<std::vector<View>> PacketView<little_endian>::GetSubviewList(size_t begin,
+                                                                            size_t end) const {
   assert(begin <= end);
   assert(end <= length_);
 
-  std::forward_list<View> view_list;
-  std::forward_list<View>::iterator it = view_list.before_begin();
+  auto view_list = std::make_shared<std::vector<View>>();
   size_t length = end - begin;
-  for (const auto& fragment : fragments_) {
+  for (const auto& fragment : *fragments_) {
     if (begin >= fragment.size()) {
       begin -= fragment.size();
     } else {
       View view(fragment, begin, begin + std::min(length, fragment.size() - begin));
       length -= view.size();
-      it = view_list.insert_after(it, view);
+      view_list->push_back(view);
       begin = 0;
     }
   }
@@ -92,29 +98,20 @@ std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin,
 
 template <bool little_endian>
 PacketView<true> PacketView<little_endian>::GetLittleEndianSubview(size_t begin, size_t end) const {
-  return PacketView<true>(GetSubviewList(begin, end));
+  return PacketView<true>(GetSubviewList(begin, end), end - begin);
 }
 
 template <bool little_endian>
 PacketView<false> PacketView<little_endian>::GetBigEndianSubview(size_t begin, size_t end) const {
-  return PacketView<false>(GetSubviewList(begin, end));
+  return PacketView<false>(GetSubviewList(begin, end), end - begin);
 }
 
 template <bool little_endian>
 void PacketView<little_endian>::Append(PacketView to_add) {
-  auto insertion_point = fragments_.begin();
-  size_t remaining_length = length_;
-  while (remaining_length > 0) {
-    remaining_length -= insertion_point->size();
-    if (remaining_length > 0) {
-      insertion_point++;
-    }
-  }
-  assert(insertion_point != fragments_.end());
-  for (const auto& fragment : to_add.fragments_) {
-    fragments_.insert_after(insertion_point, fragment);
-    insertion_point++;
+  if (fragments_.use_count() > 1) {
+    fragments_ = std::make_shared<std::vector<View>>(*fragments_);
   }
+  fragments_->insert(fragments_->end(), to_add.fragments_->begin(), to_add.fragments_->end());
   length_ += to_add.length_;
 }
 
@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <forward_list>
+#include <memory>
 #include <vector>
 
 #include "packet/iterator.h"
@@ -55,10 +56,17 @@ protected:
   void Append(PacketView to_add);
 
 private:
-  std::forward_list<View> fragments_;
+  template <bool>
+  friend class PacketView;
+
+  PacketView(std::shared_ptr<std::vector<View>> fragments, size_t length);
+
+  // Shared with the copies of the view and its iterators, only modified by
+  // Append() when not shared.
+  std::shared_ptr<std::vector<View>> fragments_;
   size_t length_;
 
-  std::forward_list<View> GetSubviewList(size_t begin, size_t end) const;
+  std::shared_ptr<std::vector<View>> GetSubviewList(size_t begin, size_t end) const;
 };
 
 }  // namespace packet
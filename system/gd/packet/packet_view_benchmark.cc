@@ -0,0 +1,149 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <forward_list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+#include "l2cap/l2cap_packets.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace packet {
+namespace {
+
+// View of |bytes| split in fragments of |fragment_size| bytes, the way
+// reassembled ACL packets are, or in a single fragment if 0.
+PacketView<kLittleEndian> Fragmented(const std::vector<uint8_t>& bytes, size_t fragment_size) {
+  if (fragment_size == 0) {
+    return PacketView<kLittleEndian>(std::make_shared<const std::vector<uint8_t>>(bytes));
+  }
+  std::forward_list<View> fragments;
+  auto it = fragments.before_begin();
+  for (size_t begin = 0; begin < bytes.size(); begin += fragment_size) {
+    size_t end = std::min(begin + fragment_size, bytes.size());
+    it = fragments.insert_after(
+            it, View(std::make_shared<const std::vector<uint8_t>>(bytes.begin() + begin,
+                                                                  bytes.begin() + end),
+                     0, end - begin));
+  }
+  return PacketView<kLittleEndian>(fragments);
+}
+
+// LE Extended Advertising Report event with |num_reports| reports, which
+// share the 255 bytes of parameters.
+std::vector<uint8_t> ExtendedAdvertisingReport(size_t num_reports) {
+  constexpr size_t kReportHeaderSize = 24;
+  size_t data_size = (253 / num_reports) - kReportHeaderSize;
+  std::vector<uint8_t> event = {0x3e, 0x00, 0x0d, static_cast<uint8_t>(num_reports)};
+  for (size_t i = 0; i < num_reports; i++) {
+    std::vector<uint8_t> report = {
+            0x13, 0x00,                          // connectable, scannable, legacy
+            0x00,                                // public address
+            0x01, 0x02, 0x03, 0x04, 0x05, 0x06,  // address
+            0x01, 0x00,                          // LE 1M, no secondary PHY
+            0xff, 0x7f, 0xc4,                    // SID, tx power, rssi
+            0x00, 0x00,                          // no periodic advertising
+            0x00,                                // public direct address
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // direct address
+            static_cast<uint8_t>(data_size),
+    };
+    event.insert(event.end(), report.begin(), report.end());
+    event.insert(event.end(), data_size, 0x5a);
+  }
+  event[1] = event.size() - 2;
+  return event;
+}
+
+// First LE information frame carrying a whole SDU of |sdu_size| bytes
+std::vector<uint8_t> FirstLeInformationFrame(size_t sdu_size) {
+  size_t pdu_size = sdu_size + 2;
+  std::vector<uint8_t> frame = {
+          static_cast<uint8_t>(pdu_size), static_cast<uint8_t>(pdu_size >> 8),
+          0x40, 0x00,  // cid
+          static_cast<uint8_t>(sdu_size), static_cast<uint8_t>(sdu_size >> 8),
+  };
+  frame.insert(frame.end(), sdu_size, 0x5a);
+  return frame;
+}
+
+}  // namespace
+
+static void BM_ParseLeExtendedAdvertisingReport(State& state) {
+  auto event = ExtendedAdvertisingReport(state.range(0));
+  auto packet = Fragmented(event, 0);
+  for (auto _ : state) {
+    auto report = hci::LeExtendedAdvertisingReportRawView::Create(
+            hci::LeMetaEventView::Create(hci::EventView::Create(packet)));
+    if (!report.IsValid()) {
+      state.SkipWithError("invalid report");
+      break;
+    }
+    auto responses = report.GetResponses();
+    ::benchmark::DoNotOptimize(responses.data());
+  }
+  state.SetBytesProcessed(state.iterations() * event.size());
+}
+
+BENCHMARK(BM_ParseLeExtendedAdvertisingReport)->Arg(1)->Arg(2)->Arg(4);
+
+// Parses an SDU of state.range(0) bytes and copies its payload, from a
+// frame in fragments of state.range(1) bytes.
+static void BM_ParseFirstLeInformationFrame(State& state) {
+  auto frame = FirstLeInformationFrame(state.range(0));
+  auto packet = Fragmented(frame, state.range(1));
+  for (auto _ : state) {
+    auto sdu = l2cap::FirstLeInformationFrameView::Create(l2cap::BasicFrameView::Create(packet));
+    if (!sdu.IsValid()) {
+      state.SkipWithError("invalid frame");
+      break;
+    }
+    auto payload = sdu.GetPayload();
+    std::vector<uint8_t> bytes(payload.size());
+    payload.begin().ExtractBytes(bytes);
+    ::benchmark::DoNotOptimize(sdu.GetL2capSduLength());
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+BENCHMARK(BM_ParseFirstLeInformationFrame)
+        ->Args({512, 0})
+        ->Args({512, 251})
+        ->Args({4096, 0})
+        ->Args({4096, 251})
+        ->Args({4096, 27});
+
+// Copies an SDU of state.range(0) bytes, in fragments of state.range(1)
+// bytes, a byte at a time through the iterators.
+static void BM_CopyPayloadBytewise(State& state) {
+  auto packet = Fragmented(std::vector<uint8_t>(state.range(0), 0x5a), state.range(1));
+  for (auto _ : state) {
+    std::vector<uint8_t> bytes(packet.begin(), packet.end());
+    ::benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+BENCHMARK(BM_CopyPayloadBytewise)->Args({4096, 0})->Args({4096, 251})->Args({4096, 27});
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -420,6 +420,28 @@ TYPED_TEST(IteratorTest, constructor_from_shared_vector_test) {
   }
 }
 
+TYPED_TEST(IteratorTest, extractBytesTest) {
+  auto iterator = this->packet->begin() + 3;
+  vector<uint8_t> bytes(4);
+  iterator.ExtractBytes(bytes);
+  ASSERT_EQ(bytes, vector<uint8_t>(count_all.begin() + 3, count_all.begin() + 7));
+  ASSERT_EQ(*iterator, count_all[7]);
+
+  vector<uint8_t> none;
+  auto end = this->packet->end();
+  end.ExtractBytes(none);
+  ASSERT_EQ(end, this->packet->end());
+}
+
+TYPED_TEST(IteratorTest, contiguousBytesTest) {
+  auto iterator = this->packet->begin() + 3;
+  auto bytes = iterator.Subrange(0, 4).ContiguousBytes();
+  ASSERT_EQ(vector<uint8_t>(bytes.begin(), bytes.end()),
+            vector<uint8_t>(count_all.begin() + 3, count_all.begin() + 7));
+  ASSERT_EQ(iterator.ContiguousBytes().size(), count_all.size() - 3);
+  ASSERT_TRUE(this->packet->end().ContiguousBytes().empty());
+}
+
 using SubviewTestParam = std::pair<size_t, size_t>;
 class SubviewBaseTest : public ::testing::TestWithParam<SubviewTestParam> {
 public:
@@ -587,6 +609,50 @@ TEST_F(PacketViewMultiViewTest, arrayOperatorTest) {
   ASSERT_DEATH(multi_view[single_view.size()], "");
 }
 
+TEST_F(PacketViewMultiViewTest, extractAcrossFragmentsTest) {
+  size_t last_offset = single_view.size() - sizeof(uint64_t) - sizeof(uint16_t);
+  for (size_t offset = 0; offset <= last_offset; offset++) {
+    auto single_itr = single_view.begin() + offset;
+    auto multi_itr = multi_view.begin() + offset;
+    ASSERT_EQ(single_itr.extract<uint64_t>(), multi_itr.extract<uint64_t>());
+    ASSERT_EQ(single_itr.extract<uint16_t>(), multi_itr.extract<uint16_t>());
+  }
+}
+
+TEST_F(PacketViewMultiViewTest, extractBytesTest) {
+  auto multi_itr = multi_view.begin() + 1;
+  vector<uint8_t> bytes(count_all.size() - 2);
+  multi_itr.ExtractBytes(bytes);
+  ASSERT_EQ(bytes, vector<uint8_t>(count_all.begin() + 1, count_all.end() - 1));
+  ASSERT_EQ(multi_itr.NumBytesRemaining(), 1u);
+  ASSERT_EQ(*multi_itr, count_all.back());
+
+  vector<uint8_t> too_many(2);
+  ASSERT_DEATH(multi_itr.ExtractBytes(too_many), "");
+}
+
+TEST_F(PacketViewMultiViewTest, contiguousBytesTest) {
+  auto first = multi_view.begin().Subrange(1, count_1.size() - 1).ContiguousBytes();
+  ASSERT_EQ(vector<uint8_t>(first.begin(), first.end()),
+            vector<uint8_t>(count_1.begin() + 1, count_1.end()));
+  auto second = (multi_view.begin() + count_1.size()).Subrange(0, count_2.size());
+  ASSERT_EQ(second.ContiguousBytes().size(), count_2.size());
+  ASSERT_DEATH(multi_view.begin().ContiguousBytes(), "");
+}
+
+TEST_F(PacketViewMultiViewTest, subrangeAcrossFragmentsTest) {
+  auto multi_itr = multi_view.begin();
+  ASSERT_EQ(*multi_itr, count_all[0]);
+  auto subrange = multi_itr.Subrange(2, 5);
+  ASSERT_EQ(subrange.NumBytesRemaining(), 5u);
+  for (size_t i = 2; i < 7; i++) {
+    ASSERT_EQ(*subrange, count_all[i]);
+    ++subrange;
+  }
+  ASSERT_DEATH(*subrange, "");
+  ASSERT_DEATH(*(multi_itr.Subrange(0, 1) + 1), "");
+}
+
 TEST_F(PacketViewMultiViewAppendTest, sizeTestAppend) {
   ASSERT_EQ(single_view.size(), multi_view.size());
 }
@@ -620,6 +686,23 @@ TEST_F(PacketViewMultiViewAppendTest, arrayOperatorTestAppend) {
   ASSERT_DEATH(multi_view[single_view.size()], "");
 }
 
+TEST_F(PacketViewMultiViewAppendTest, appendDoesNotChangeCopiesTest) {
+  class GrowingPacketView : public PacketView<true> {
+  public:
+    using PacketView<true>::PacketView;
+    using PacketView<true>::Append;
+  };
+  GrowingPacketView view(
+          {View(std::make_shared<const vector<uint8_t>>(count_1), 0, count_1.size())});
+  PacketView<true> copy = view;
+  auto itr = view.begin();
+  view.Append(PacketView<true>(std::make_shared<const vector<uint8_t>>(count_2)));
+  ASSERT_EQ(view.size(), count_1.size() + count_2.size());
+  ASSERT_EQ(view[count_1.size()], count_2[0]);
+  ASSERT_EQ(copy.size(), count_1.size());
+  ASSERT_EQ(itr.NumBytesRemaining(), count_1.size());
+}
+
 TEST(ViewTest, arrayOperatorTest) {
   View view_all(std::make_shared<const vector<uint8_t>>(count_all), 0, count_all.size());
   size_t past_end = view_all.size();
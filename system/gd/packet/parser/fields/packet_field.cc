@@ -83,6 +83,10 @@ void PacketField::GenBuilderParameterFromView(std::ostream& s) const {
   s << "view.Get" << util::UnderscoreToCamelCase(GetName()) << "()";
 }
 
+void PacketField::GenSpanGetter(std::ostream&, Size, Size) const {}
+
+void PacketField::GenSpanInserter(std::ostream& s) const { GenInserter(s); }
+
 bool PacketField::IsContainerField() const { return false; }
 
 const PacketField* PacketField::GetElementField() const { return nullptr; }
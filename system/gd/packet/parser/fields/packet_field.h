@@ -63,6 +63,10 @@ public:
   // calculate the offset.
   virtual void GenGetter(std::ostream& s, Size start_offset, Size end_offset) const = 0;
 
+  // Get the parser getter returning a std::span over the bytes of the field, for the fields which
+  // are contiguous bytes in the packet. Generates nothing for the other fields.
+  virtual void GenSpanGetter(std::ostream& s, Size start_offset, Size end_offset) const;
+
   // Get the type of parameter used in Create(), return empty string if a parameter type was NOT
   // generated
   virtual std::string GetBuilderParameterType() const = 0;
@@ -88,6 +92,10 @@ public:
   // Generate the inserter for pushing the data in the builder.
   virtual void GenInserter(std::ostream& s) const = 0;
 
+  // Generate the inserter for pushing the data in the builder with a single call for fields of
+  // bytes, the same as GenInserter() for the other fields.
+  virtual void GenSpanInserter(std::ostream& s) const;
+
   // Generate the validator for a field for the IsValid() function.
   //
   // The way this function works is by assuming that there is an iterator |it|
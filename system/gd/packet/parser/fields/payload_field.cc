@@ -86,6 +86,16 @@ void PayloadField::GenParameterValidator(std::ostream&) const {
   // There is no validation needed for a payload
 }
 
+void PayloadField::GenSpanGetter(std::ostream& s, Size start_offset, Size end_offset) const {
+  s << "std::span<const uint8_t> " << GetGetterFunctionName() << "Span() const {";
+  s << "ASSERT(was_validated_);";
+  s << "size_t end_index = size();";
+  s << "auto to_bound = begin();";
+  GenBounds(s, start_offset, end_offset, GetSize());
+  s << "return " << GetName() << "_it.ContiguousBytes();";
+  s << "}\n\n";
+}
+
 void PayloadField::GenInserter(std::ostream&) const {
   ERROR() << __func__ << " Should never be called.";
 }
@@ -40,6 +40,8 @@ public:
 
   virtual void GenGetter(std::ostream& s, Size start_offset, Size end_offset) const override;
 
+  virtual void GenSpanGetter(std::ostream& s, Size start_offset, Size end_offset) const override;
+
   virtual std::string GetBuilderParameterType() const override;
 
   virtual bool BuilderParameterMustBeMoved() const override;
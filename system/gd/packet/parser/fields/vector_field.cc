@@ -219,6 +219,31 @@ void VectorField::GenInserter(std::ostream& s) const {
   s << "}\n";
 }
 
+void VectorField::GenSpanGetter(std::ostream& s, Size start_offset, Size end_offset) const {
+  if (!HasByteElements()) {
+    return;
+  }
+  s << "std::span<const uint8_t> " << GetGetterFunctionName() << "Span() const {";
+  s << "ASSERT(was_validated_);";
+  s << "size_t end_index = size();";
+  s << "auto to_bound = begin();";
+  GenBounds(s, start_offset, end_offset, GetSize());
+  s << "return " << GetName() << "_it.ContiguousBytes();";
+  s << "}\n";
+}
+
+void VectorField::GenSpanInserter(std::ostream& s) const {
+  if (!HasByteElements()) {
+    GenInserter(s);
+    return;
+  }
+  s << "i.insert_bytes(" << GetName() << "_);";
+}
+
+bool VectorField::HasByteElements() const {
+  return element_field_->GetFieldType() == ScalarField::kFieldType && element_size_.bits() == 8;
+}
+
 void VectorField::GenValidator(std::ostream&) const {
   // NOTE: We could check if the element size divides cleanly into the array size, but we decided to
   // forgo that in favor of just returning as many elements as possible in a best effort style.
@@ -45,6 +45,8 @@ public:
 
   virtual void GenGetter(std::ostream& s, Size start_offset, Size end_offset) const override;
 
+  virtual void GenSpanGetter(std::ostream& s, Size start_offset, Size end_offset) const override;
+
   virtual std::string GetBuilderParameterType() const override;
 
   virtual bool BuilderParameterMustBeMoved() const override;
@@ -57,6 +59,8 @@ public:
 
   virtual void GenInserter(std::ostream& s) const override;
 
+  virtual void GenSpanInserter(std::ostream& s) const override;
+
   virtual void GenValidator(std::ostream&) const override;
 
   void SetSizeField(const SizeField* size_field);
@@ -65,6 +69,9 @@ public:
 
   virtual bool IsContainerField() const override;
 
+  // Elements are uint8_t, stored as contiguous bytes in the packet
+  bool HasByteElements() const;
+
   virtual const PacketField* GetElementField() const override;
 
   virtual void GenStringRepresentation(std::ostream& s, std::string accessor) const override;
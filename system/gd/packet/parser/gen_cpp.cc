@@ -51,7 +51,8 @@ void generate_namespace_close(const std::vector<std::string>& token, std::ostrea
 }
 
 bool generate_cpp_headers_one_file(const Declarations& decls, bool generate_fuzzing,
-                                   bool generate_tests, const std::filesystem::path& input_file,
+                                   bool generate_tests, bool generate_spans,
+                                   const std::filesystem::path& input_file,
                                    const std::filesystem::path& include_dir,
                                    const std::filesystem::path& out_dir,
                                    const std::string& root_namespace) {
@@ -113,6 +114,10 @@ bool generate_cpp_headers_one_file(const Declarations& decls, bool generate_fuzz
 #endif // __has_include(<bluetooth/log.h>)
 )";
 
+  if (generate_spans) {
+    out_file << "\n#include <span>\n";
+  }
+
   if (generate_fuzzing || generate_tests) {
     out_file <<
             R"(
@@ -207,7 +212,7 @@ using ::bluetooth::packet::RawBuilder;
   for (auto& s : decls.type_defs_queue_) {
     if (s.second->GetDefinitionType() == TypeDef::Type::STRUCT) {
       const auto* struct_def = static_cast<const StructDef*>(s.second);
-      struct_def->GenDefinition(out_file);
+      struct_def->GenDefinition(out_file, generate_spans);
       out_file << "\n";
     }
   }
@@ -219,12 +224,14 @@ using ::bluetooth::packet::RawBuilder;
   }
 
   for (const auto& packet_def : decls.packet_defs_queue_) {
-    packet_def.second->GenParserDefinition(out_file, generate_fuzzing, generate_tests);
+    packet_def.second->GenParserDefinition(out_file, generate_fuzzing, generate_tests,
+                                           generate_spans);
     out_file << "\n\n";
   }
 
   for (const auto& packet_def : decls.packet_defs_queue_) {
-    packet_def.second->GenBuilderDefinition(out_file, generate_fuzzing, generate_tests);
+    packet_def.second->GenBuilderDefinition(out_file, generate_fuzzing, generate_tests,
+                                            generate_spans);
     out_file << "\n\n";
   }
 
@@ -38,7 +38,8 @@ void yyset_debug(int, void*);
 void yyset_in(FILE*, void*);
 
 bool generate_cpp_headers_one_file(const Declarations& decls, bool generate_fuzzing,
-                                   bool generate_tests, const std::filesystem::path& input_file,
+                                   bool generate_tests, bool generate_spans,
+                                   const std::filesystem::path& input_file,
                                    const std::filesystem::path& include_dir,
                                    const std::filesystem::path& out_dir,
                                    const std::string& root_namespace);
@@ -103,6 +104,9 @@ void usage(const char* prog) {
 
   ofs << std::setw(24) << "--source_root= ";
   ofs << "Root path to the source directory. Find input files relative to this." << std::endl;
+
+  ofs << std::setw(24) << "--span ";
+  ofs << "Generate std::span getters and bulk inserters for fields of bytes." << std::endl;
 }
 
 int main(int argc, const char** argv) {
@@ -113,6 +117,7 @@ int main(int argc, const char** argv) {
   std::string root_namespace = "bluetooth";
   bool generate_fuzzing = false;
   bool generate_tests = false;
+  bool generate_spans = false;
   std::queue<std::filesystem::path> input_files;
 
   const std::string arg_out = "--out=";
@@ -120,6 +125,7 @@ int main(int argc, const char** argv) {
   const std::string arg_namespace = "--root_namespace=";
   const std::string arg_fuzzing = "--fuzzing";
   const std::string arg_testing = "--testing";
+  const std::string arg_span = "--span";
   const std::string arg_source_root = "--source_root=";
 
   // Parse the source root first (if it exists) since it will be used for other
@@ -143,6 +149,8 @@ int main(int argc, const char** argv) {
       generate_fuzzing = true;
     } else if (arg.find(arg_testing) == 0) {
       generate_tests = true;
+    } else if (arg.find(arg_span) == 0) {
+      generate_spans = true;
     } else if (arg.find(arg_source_root) == 0) {
       // Do nothing (just don't treat it as input_files)
     } else {
@@ -165,7 +173,8 @@ int main(int argc, const char** argv) {
     }
     std::cout << "generating c++" << std::endl;
     if (!generate_cpp_headers_one_file(declarations, generate_fuzzing, generate_tests,
-                                       input_files.front(), include_dir, out_dir, root_namespace)) {
+                                       generate_spans, input_files.front(), include_dir, out_dir,
+                                       root_namespace)) {
       std::cerr << "Didn't generate cpp headers for " << input_files.front() << std::endl;
       return 3;
     }
@@ -32,8 +32,8 @@ PacketField* PacketDef::GetNewField(const std::string&, ParseLocation) const {
   return nullptr;  // Packets can't be fields
 }
 
-void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing,
-                                    bool generate_tests) const {
+void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests,
+                                    bool generate_spans) const {
   s << "class " << name_ << "View";
   if (parent_ != nullptr) {
     s << " : public " << parent_->name_ << "View {";
@@ -79,6 +79,9 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing,
   for (const auto& field : public_fields) {
     GenParserFieldGetter(s, field);
     s << "\n";
+    if (generate_spans) {
+      GenParserFieldSpanGetter(s, field);
+    }
   }
   GenValidator(s);
   s << "\n";
@@ -184,6 +187,13 @@ void PacketDef::GenParserFieldGetter(std::ostream& s, const PacketField* field)
   field->GenGetter(s, start_field_offset, end_field_offset);
 }
 
+void PacketDef::GenParserFieldSpanGetter(std::ostream& s, const PacketField* field) const {
+  auto start_field_offset = GetOffsetForField(field->GetName(), false);
+  auto end_field_offset = GetOffsetForField(field->GetName(), true);
+
+  field->GenSpanGetter(s, start_field_offset, end_field_offset);
+}
+
 TypeDef::Type PacketDef::GetDefinitionType() const { return TypeDef::Type::PACKET; }
 
 void PacketDef::GenValidator(std::ostream& s) const {
@@ -381,8 +391,8 @@ void PacketDef::GenParserToString(std::ostream& s) const {
   s << "}\n";
 }
 
-void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing,
-                                     bool generate_tests) const {
+void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests,
+                                     bool generate_spans) const {
   s << "class " << name_ << "Builder";
   if (parent_ != nullptr) {
     s << " : public " << parent_->name_ << "Builder";
@@ -407,7 +417,7 @@ void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing,
     }
   }
 
-  GenSerialize(s);
+  GenSerialize(s, generate_spans);
   s << "\n";
 
   GenSize(s);
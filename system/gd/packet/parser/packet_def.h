@@ -31,7 +31,8 @@ public:
 
   PacketField* GetNewField(const std::string& name, ParseLocation loc) const;
 
-  void GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const;
+  void GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests,
+                           bool generate_spans) const;
 
   void GenTestingParserFromBytes(std::ostream& s) const;
 
@@ -39,13 +40,16 @@ public:
 
   void GenParserFieldGetter(std::ostream& s, const PacketField* field) const;
 
+  void GenParserFieldSpanGetter(std::ostream& s, const PacketField* field) const;
+
   void GenValidator(std::ostream& s) const;
 
   void GenParserToString(std::ostream& s) const;
 
   TypeDef::Type GetDefinitionType() const;
 
-  void GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const;
+  void GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests,
+                            bool generate_spans) const;
 
   void GenBuilderDefinitionPybind11(std::ostream& s) const;
 
@@ -374,7 +374,7 @@ void ParentDef::GenSize(std::ostream& s) const {
   s << "}\n";
 }
 
-void ParentDef::GenSerialize(std::ostream& s) const {
+void ParentDef::GenSerialize(std::ostream& s, bool generate_spans) const {
   auto header_fields = fields_.GetFieldsBeforePayloadOrBody();
   auto footer_fields = fields_.GetFieldsAfterPayloadOrBody();
 
@@ -477,7 +477,11 @@ void ParentDef::GenSerialize(std::ostream& s) const {
       if (field == padded_field) {
         s << "size_t unpadded_size = (" << field->GetBuilderSize() << ") / 8;";
       }
-      field->GenInserter(s);
+      if (generate_spans) {
+        field->GenSpanInserter(s);
+      } else {
+        field->GenInserter(s);
+      }
     }
   }
   s << "}\n\n";
@@ -489,7 +493,11 @@ void ParentDef::GenSerialize(std::ostream& s) const {
   s << ") const {";
 
   for (const auto& field : footer_fields) {
-    field->GenInserter(s);
+    if (generate_spans) {
+      field->GenSpanInserter(s);
+    } else {
+      field->GenInserter(s);
+    }
   }
   if (parent_ != nullptr) {
     if (parent_->GetDefinitionType() == Type::PACKET) {
@@ -63,7 +63,8 @@ public:
 
   void GenSize(std::ostream& s) const;
 
-  void GenSerialize(std::ostream& s) const;
+  // Fields of bytes are inserted with a single call if |generate_spans|
+  void GenSerialize(std::ostream& s, bool generate_spans) const;
 
   void GenInstanceOf(std::ostream& s) const;
 
@@ -176,7 +176,7 @@ void StructDef::GenParseFunctionPrototype(std::ostream& s) const {
   s << "it);";
 }
 
-void StructDef::GenDefinition(std::ostream& s) const {
+void StructDef::GenDefinition(std::ostream& s, bool generate_spans) const {
   s << "class " << name_;
   if (parent_ != nullptr) {
     s << " : public " << parent_->name_;
@@ -196,7 +196,7 @@ void StructDef::GenDefinition(std::ostream& s) const {
   s << " public:\n";
   s << "  virtual ~" << name_ << "() = default;\n";
 
-  GenSerialize(s);
+  GenSerialize(s, generate_spans);
   s << "\n";
 
   GenParse(s);
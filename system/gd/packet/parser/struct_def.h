@@ -42,7 +42,7 @@ public:
 
   void GenParseFunctionPrototype(std::ostream& s) const;
 
-  void GenDefinition(std::ostream& s) const;
+  void GenDefinition(std::ostream& s, bool generate_spans) const;
 
   void GenDefinitionPybind11(std::ostream& s) const;
 
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <forward_list>
 #include <memory>
 
@@ -618,6 +619,9 @@ TEST(GeneratedPacketTest, testFixedSizeByteArray) {
   for (size_t i = 0; i < array.size(); i++) {
     ASSERT_EQ(array[i], byte_array[i]);
   }
+  auto array_span = view.GetFixed256bitInBytesSpan();
+  ASSERT_TRUE(std::equal(array_span.begin(), array_span.end(), byte_array.begin(),
+                         byte_array.end()));
 
   auto decoded_word_array = view.GetFixed256bitInWords();
   ASSERT_EQ(word_array.size(), decoded_word_array.size());
@@ -1313,6 +1317,8 @@ TEST(GeneratedPacketTest, testBitFieldAfterUnsizedArrayPacket) {
   ASSERT_EQ(parent_bf.seven_bits_, bit_field.seven_bits_);
   ASSERT_EQ(parent_bf.straddle_, bit_field.straddle_);
   ASSERT_EQ(parent_bf.five_bits_, bit_field.five_bits_);
+  auto payload_span = payload_view.GetPayloadSpan();
+  ASSERT_EQ(std::vector<uint8_t>(payload_span.begin(), payload_span.end()), count_array);
 
   auto view = BitFieldAfterUnsizedArrayPacketView::Create(payload_view);
   ASSERT_TRUE(view.IsValid());
@@ -1321,6 +1327,8 @@ TEST(GeneratedPacketTest, testBitFieldAfterUnsizedArrayPacket) {
   for (size_t i = 0; i < count_array.size(); i++) {
     ASSERT_EQ(array[i], count_array[i]);
   }
+  auto array_span = view.GetArraySpan();
+  ASSERT_EQ(std::vector<uint8_t>(array_span.begin(), array_span.end()), count_array);
   BitField bf = view.GetBitField();
   ASSERT_EQ(bf.seven_bits_, bit_field.seven_bits_);
   ASSERT_EQ(bf.straddle_, bit_field.straddle_);
@@ -78,11 +78,7 @@ bool RawBuilder::CanAddOctets(size_t num_bytes) const {
   return payload_.size() + num_bytes <= max_bytes_;
 }
 
-void RawBuilder::Serialize(BitInserter& it) const {
-  for (const auto& val : payload_) {
-    insert(val, it);
-  }
-}
+void RawBuilder::Serialize(BitInserter& it) const { it.insert_bytes(payload_); }
 
 size_t RawBuilder::size() const { return payload_.size(); }
 }  // namespace packet
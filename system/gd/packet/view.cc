@@ -39,6 +39,8 @@ uint8_t View::operator[](size_t i) const {
   return data_->operator[](i + begin_);
 }
 
+const uint8_t* View::data() const { return data_->data() + begin_; }
+
 size_t View::size() const { return end_ - begin_; }
 }  // namespace packet
 }  // namespace bluetooth
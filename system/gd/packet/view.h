@@ -33,6 +33,9 @@ public:
 
   uint8_t operator[](size_t i) const;
 
+  // Contiguous bytes of the view, valid as long as the view
+  const uint8_t* data() const;
+
   size_t size() const;
 
 private:
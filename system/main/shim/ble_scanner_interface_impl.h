@@ -19,10 +19,12 @@
  */
 #pragma once
 
+#include <memory>
 #include <queue>
 #include <set>
 #include <vector>
 
+#include "btif/include/btif_jni_batch.h"
 #include "hci/le_scanning_callback.h"
 #include "include/hardware/ble_scanner.h"
 #include "types/ble_address_with_type.h"
@@ -138,6 +140,24 @@ private:
   void handle_remote_properties(RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
                                 std::vector<uint8_t> advertising_data);
 
+  struct ScanResult {
+    uint16_t event_type;
+    uint8_t address_type;
+    tBLE_ADDR_TYPE ble_addr_type;
+    RawAddress raw_address;
+    uint8_t primary_phy;
+    uint8_t secondary_phy;
+    uint8_t advertising_sid;
+    int8_t tx_power;
+    int8_t rssi;
+    uint16_t periodic_advertising_interval;
+    std::vector<uint8_t> advertising_data;
+  };
+  void deliver_scan_results(std::vector<ScanResult> results);
+
+  // Scan results batched to the jni thread, null when posted one by one
+  std::unique_ptr<bluetooth::btif::JniBatchChannel<uint64_t, ScanResult>> scan_result_channel_;
+
   class AddressCache {
   public:
     void init(void);
@@ -23,7 +23,10 @@
 #include <bluetooth/log.h>
 #include <hardware/bluetooth.h>
 
+#include <cstring>
+
 #include "btif/include/btif_common.h"
+#include "btif/include/btif_jni_batch.h"
 #include "hci/address.h"
 #include "hci/le_scanning_manager.h"
 #if TARGET_FLOSS
@@ -35,6 +38,7 @@
 #include "main/shim/helpers.h"
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/advertise_data_parser.h"
 #include "stack/include/bt_dev_class.h"
@@ -62,6 +66,14 @@ constexpr uint8_t kLowestRssiValue = 129;
 constexpr uint16_t kAllowAllFilter = 0x00;
 constexpr uint16_t kListLogicOr = 0x01;
 
+// Scan results delivery to the jni thread in batches
+constexpr char kPropertyJniBatching[] = "persist.bluetooth.le_scan.jni_batching";
+constexpr bluetooth::btif::JniBatchConfig kScanResultBatchConfig = {
+        .window = std::chrono::milliseconds(10),
+        .max_batch = 32,
+        .max_queued = 256,
+};
+
 class DefaultScanningCallback : public ::ScanningCallbacks {
   void OnScannerRegistered(const bluetooth::Uuid /* app_uuid */, uint8_t /* scanner_id */,
                            uint8_t /* status */) override {
@@ -138,6 +150,20 @@ void BleScannerInterfaceImpl::Init() {
     bluetooth::shim::GetMsftExtensionManager()->SetScanningCallback(this);
   }
 #endif
+
+  if (scan_result_channel_ == nullptr && osi_property_get_bool(kPropertyJniBatching, false)) {
+    log::info("Batching scan results to the jni thread");
+    // A result replaces the queued one of the same advertising set when only
+    // its signal strength differs.
+    scan_result_channel_ = std::make_unique<btif::JniBatchChannel<uint64_t, ScanResult>>(
+            "LE scan results", kScanResultBatchConfig,
+            [this](std::vector<ScanResult> results) { deliver_scan_results(std::move(results)); },
+            [](const ScanResult& queued, const ScanResult& result) {
+              return queued.event_type == result.event_type &&
+                     queued.address_type == result.address_type &&
+                     queued.advertising_data == result.advertising_data;
+            });
+  }
 }
 
 /** Registers a scanner with the stack */
@@ -473,6 +499,22 @@ void BleScannerInterfaceImpl::OnScanResult(uint16_t event_type, uint8_t address_
     btm_ble_process_adv_addr(raw_address, &ble_addr_type);
   }
 
+  if (scan_result_channel_ != nullptr) {
+    // TODO: Remove when StartInquiry in GD part implemented
+    btm_ble_process_adv_pkt_cont_for_inquiry(event_type, ble_addr_type, raw_address, primary_phy,
+                                             secondary_phy, advertising_sid, tx_power, rssi,
+                                             periodic_advertising_interval, advertising_data);
+
+    // Results are queued per advertising set
+    uint64_t key = advertising_sid;
+    memcpy(reinterpret_cast<uint8_t*>(&key) + 1, raw_address.address, sizeof(raw_address.address));
+    scan_result_channel_->Post(
+            key, ScanResult{event_type, address_type, ble_addr_type, raw_address, primary_phy,
+                            secondary_phy, advertising_sid, tx_power, rssi,
+                            periodic_advertising_interval, std::move(advertising_data)});
+    return;
+  }
+
   do_in_jni_thread(base::BindOnce(&BleScannerInterfaceImpl::handle_remote_properties,
                                   base::Unretained(this), raw_address, ble_addr_type,
                                   advertising_data));
@@ -488,6 +530,17 @@ void BleScannerInterfaceImpl::OnScanResult(uint16_t event_type, uint8_t address_
                                            periodic_advertising_interval, advertising_data);
 }
 
+void BleScannerInterfaceImpl::deliver_scan_results(std::vector<ScanResult> results) {
+  for (auto& result : results) {
+    handle_remote_properties(result.raw_address, result.ble_addr_type, result.advertising_data);
+    scanning_callbacks_->OnScanResult(result.event_type, result.address_type, result.raw_address,
+                                      result.primary_phy, result.secondary_phy,
+                                      result.advertising_sid, result.tx_power, result.rssi,
+                                      result.periodic_advertising_interval,
+                                      std::move(result.advertising_data));
+  }
+}
+
 void BleScannerInterfaceImpl::OnTrackAdvFoundLost(
         bluetooth::hci::AdvertisingFilterOnFoundOnLostInfo on_found_on_lost_info) {
   AdvertisingTrackInfo track_info = {};
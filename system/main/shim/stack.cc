@@ -25,6 +25,7 @@
 #include <string>
 
 #include "common/strings.h"
+#include "common/trace_ring.h"
 #include "hal/hci_hal.h"
 #include "hci/acl_manager.h"
 #include "hci/acl_manager/acl_scheduler.h"
@@ -46,6 +47,8 @@
 #include "main/shim/le_advertising_manager.h"
 #include "main/shim/le_scanning_manager.h"
 #include "metrics/counter_metrics.h"
+#include "os/parameter_provider.h"
+#include "os/system_properties.h"
 #include "shim/dumpsys.h"
 #include "storage/storage_module.h"
 #if TARGET_FLOSS
@@ -57,6 +60,11 @@ namespace shim {
 
 using ::bluetooth::common::StringFormat;
 
+namespace {
+constexpr char kTraceRingProperty[] = "persist.bluetooth.trace_ring.enabled";
+constexpr char kTraceRingFileName[] = "bt_trace_ring.bin";
+}  // namespace
+
 struct Stack::impl {
   Acl* acl_ = nullptr;
 };
@@ -74,6 +82,12 @@ void Stack::StartEverything() {
   log::info("Starting Gd stack");
   ModuleList modules;
 
+  if (os::GetSystemPropertyBool(kTraceRingProperty, false)) {
+    // Snapshots are written next to the snoop log
+    std::string path = os::ParameterProvider::SnoopLogFilePath();
+    common::TraceRing::Enable(path.substr(0, path.find_last_of('/') + 1) + kTraceRingFileName);
+  }
+
 #if TARGET_FLOSS
   modules.add<sysprops::SyspropsModule>();
 #endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "avrcp"
+
+#include "browse_cache.h"
+
+#include <bluetooth/log.h>
+
+namespace bluetooth {
+namespace avrcp {
+
+std::shared_ptr<const BrowseCache::FolderListing> BrowseCache::GetFolder(
+        int player_id, const std::string& folder_id) {
+  for (auto it = folders_.begin(); it != folders_.end(); it++) {
+    if (it->player_id != player_id || it->folder_id != folder_id) {
+      continue;
+    }
+
+    if (it->listing->uid_counter != uid_counter_) {
+      log::verbose("Dropping stale listing of folder \"{}\"", folder_id);
+      folder_items_ -= it->listing->items.size();
+      folders_.erase(it);
+      stale_++;
+      break;
+    }
+
+    hits_++;
+    folders_.splice(folders_.begin(), folders_, it);
+    return folders_.front().listing;
+  }
+
+  misses_++;
+  return nullptr;
+}
+
+std::shared_ptr<const BrowseCache::FolderListing> BrowseCache::PutFolder(
+        int player_id, const std::string& folder_id, std::vector<ListItem> items) {
+  auto listing =
+          std::make_shared<const FolderListing>(FolderListing{uid_counter_, std::move(items)});
+  if (!IsEnabled()) {
+    return listing;
+  }
+
+  for (auto it = folders_.begin(); it != folders_.end(); it++) {
+    if (it->player_id == player_id && it->folder_id == folder_id) {
+      folder_items_ -= it->listing->items.size();
+      folders_.erase(it);
+      break;
+    }
+  }
+
+  folders_.push_front(Entry{player_id, folder_id, listing});
+  folder_items_ += listing->items.size();
+  Trim();
+  return listing;
+}
+
+std::shared_ptr<const BrowseCache::NowPlayingListing> BrowseCache::GetNowPlaying() {
+  if (now_playing_ == nullptr) {
+    misses_++;
+    return nullptr;
+  }
+
+  hits_++;
+  return now_playing_;
+}
+
+std::shared_ptr<const BrowseCache::NowPlayingListing> BrowseCache::PutNowPlaying(
+        std::string curr_song_id, std::vector<SongInfo> songs) {
+  auto listing = std::make_shared<const NowPlayingListing>(
+          NowPlayingListing{std::move(curr_song_id), std::move(songs)});
+  if (IsEnabled()) {
+    now_playing_ = listing;
+  }
+  return listing;
+}
+
+void BrowseCache::OnUidsChanged() {
+  // Listings are dropped as they are next looked up or pushed out rather than
+  // all at once, since most of them will never be browsed again.
+  uid_counter_++;
+  log::verbose("uid_counter={}", uid_counter_);
+}
+
+void BrowseCache::OnNowPlayingChanged() { now_playing_.reset(); }
+
+void BrowseCache::Clear() {
+  folders_.clear();
+  folder_items_ = 0;
+  now_playing_.reset();
+}
+
+void BrowseCache::Trim() {
+  // Stale listings go first, then the least recently used ones.
+  for (auto it = folders_.begin(); it != folders_.end();) {
+    if (it->listing->uid_counter != uid_counter_) {
+      folder_items_ -= it->listing->items.size();
+      it = folders_.erase(it);
+      stale_++;
+    } else {
+      it++;
+    }
+  }
+
+  while (folders_.size() > max_folders_ ||
+         (folders_.size() > 1 && folder_items_ > kMaxFolderItems)) {
+    folder_items_ -= folders_.back().listing->items.size();
+    folders_.pop_back();
+    evictions_++;
+  }
+}
+
+std::ostream& operator<<(std::ostream& out, const BrowseCache& c) {
+  out << "    Browse Cache: " << (c.IsEnabled() ? "enabled" : "disabled") << std::endl;
+  if (!c.IsEnabled()) {
+    return out;
+  }
+  out << "      UID Counter: " << c.uid_counter_ << std::endl;
+  out << "      Folders: " << c.folders_.size() << " (" << c.folder_items_ << " items)"
+      << std::endl;
+  out << "      Now Playing: "
+      << (c.now_playing_ != nullptr ? std::to_string(c.now_playing_->songs.size()) + " items"
+                                    : "not cached")
+      << std::endl;
+  out << "      Hits: " << c.hits_ << " Misses: " << c.misses_ << " Stale: " << c.stale_
+      << " Evictions: " << c.evictions_ << std::endl;
+  return out;
+}
+
+}  // namespace avrcp
+}  // namespace bluetooth
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware/avrcp/avrcp.h"
+
+namespace bluetooth {
+namespace avrcp {
+
+// A contiguous run of the items of a listing, as selected by the start and end
+// item of a Get Folder Items request.
+template <typename T>
+struct BrowseRange {
+  const T* begin() const { return first; }
+  const T* end() const { return last; }
+  size_t size() const { return last - first; }
+
+  const T* first;
+  const T* last;
+  // Index of the first item of the range in the listing
+  uint32_t start_item;
+};
+
+// Returns the items of |items| from |start_item| to |end_item| included,
+// clipped to the size of the listing.
+template <typename T>
+BrowseRange<T> GetBrowseRange(const std::vector<T>& items, uint32_t start_item,
+                              uint32_t end_item) {
+  size_t first = std::min<size_t>(start_item, items.size());
+  size_t last = std::max(first, std::min<size_t>(end_item + size_t{1}, items.size()));
+  return BrowseRange<T>{items.data() + first, items.data() + last, static_cast<uint32_t>(first)};
+}
+
+// A cache of the listings fetched from the Media Interface while a remote
+// device browses, so that the pages of a Get Folder Items sequence are served
+// from one fetch of the folder rather than one fetch per page.
+//
+// Folder listings are keyed by browsed player and folder, and are tagged with
+// the UID counter they were fetched under. A UIDs changed update bumps the
+// counter and older listings are dropped as they are looked up or pushed out,
+// so each folder is only fetched again once it is browsed again. The now
+// playing list is kept on its own and is replaced as the list is fetched for
+// any request or notification.
+class BrowseCache {
+public:
+  struct FolderListing {
+    uint16_t uid_counter;
+    std::vector<ListItem> items;
+  };
+
+  struct NowPlayingListing {
+    std::string curr_song_id;
+    std::vector<SongInfo> songs;
+  };
+
+  // Number of folder listings kept by default
+  static constexpr size_t kDefaultMaxFolders = 8;
+  // Number of folder items kept across all the listings. The most recently
+  // used listing is always kept.
+  static constexpr size_t kMaxFolderItems = 64 * 1024;
+
+  // A cache that keeps no folder listings never hits, but still hands back the
+  // listings it is given so that callers have a single code path.
+  explicit BrowseCache(size_t max_folders = kDefaultMaxFolders) : max_folders_(max_folders) {}
+
+  bool IsEnabled() const { return max_folders_ > 0; }
+
+  // Returns the listing of |folder_id| on |player_id| fetched under the
+  // current UID counter, or nullptr.
+  std::shared_ptr<const FolderListing> GetFolder(int player_id, const std::string& folder_id);
+
+  // Stores the listing of |folder_id| on |player_id| and returns it.
+  std::shared_ptr<const FolderListing> PutFolder(int player_id, const std::string& folder_id,
+                                                 std::vector<ListItem> items);
+
+  // Returns the now playing list, or nullptr.
+  std::shared_ptr<const NowPlayingListing> GetNowPlaying();
+
+  // Stores the now playing list and returns it.
+  std::shared_ptr<const NowPlayingListing> PutNowPlaying(std::string curr_song_id,
+                                                         std::vector<SongInfo> songs);
+
+  // The content of the browsed player has changed.
+  void OnUidsChanged();
+
+  // The now playing list or the addressed player has changed.
+  void OnNowPlayingChanged();
+
+  void Clear();
+
+  uint16_t GetUidCounter() const { return uid_counter_; }
+
+  friend std::ostream& operator<<(std::ostream& out, const BrowseCache& c);
+
+private:
+  struct Entry {
+    int player_id;
+    std::string folder_id;
+    std::shared_ptr<const FolderListing> listing;
+  };
+
+  void Trim();
+
+  size_t max_folders_;
+  uint16_t uid_counter_ = 0;
+
+  // Most recently used first
+  std::list<Entry> folders_;
+  size_t folder_items_ = 0;
+  std::shared_ptr<const NowPlayingListing> now_playing_;
+
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t stale_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+}  // namespace avrcp
+}  // namespace bluetooth
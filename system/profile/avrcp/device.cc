@@ -23,6 +23,7 @@
 #include "abstract_message_loop.h"
 #include "avrcp_common.h"
 #include "internal_include/stack_config.h"
+#include "osi/include/properties.h"
 #include "packet/avrcp/avrcp_reject_packet.h"
 #include "packet/avrcp/general_reject_packet.h"
 #include "packet/avrcp/get_current_player_application_setting_value.h"
@@ -48,6 +49,10 @@ namespace avrcp {
 #define VOL_NOT_SUPPORTED -1
 #define VOL_REGISTRATION_FAILED -2
 
+// Serves Get Folder Items pages from the listings already fetched from the
+// media interface instead of fetching the whole folder for each page.
+#define AVRCP_BROWSE_CACHE_PROPERTY "persist.bluetooth.avrcp.browse_cache"
+
 Device::Device(const RawAddress& bdaddr, bool avrcp13_compatibility,
                base::RepeatingCallback<void(uint8_t label, bool browse,
                                             std::unique_ptr<::bluetooth::PacketBuilder> message)>
@@ -59,7 +64,10 @@ Device::Device(const RawAddress& bdaddr, bool avrcp13_compatibility,
       send_message_cb_(send_msg_cb),
       ctrl_mtu_(ctrl_mtu),
       browse_mtu_(browse_mtu),
-      has_bip_client_(false) {}
+      has_bip_client_(false),
+      browse_cache_(osi_property_get_bool(AVRCP_BROWSE_CACHE_PROPERTY, false)
+                            ? BrowseCache::kDefaultMaxFolders
+                            : 0) {}
 
 void Device::RegisterInterfaces(MediaInterface* media_interface, A2dpInterface* a2dp_interface,
                                 VolumeInterface* volume_interface,
@@ -605,12 +613,11 @@ void Device::TrackChangedNotificationResponse(uint8_t label, bool interim, std::
     return;
   }
 
-  // Anytime we use the now playing list, update our map so that its always
-  // current
-  now_playing_ids_.clear();
+  // Anytime we use the now playing list, update our map and the browse cache
+  // so that they are always current
+  auto listing = CacheNowPlayingList(curr_song_id, std::move(song_list));
   uint64_t uid = 0;
-  for (const SongInfo& song : song_list) {
-    now_playing_ids_.insert(song.media_id);
+  for (const SongInfo& song : listing->songs) {
     if (curr_song_id == song.media_id) {
       log::verbose("Found media ID match for {}", song.media_id);
       uid = now_playing_ids_.get_uid(curr_song_id);
@@ -1035,15 +1042,25 @@ void Device::HandleGetFolderItems(uint8_t label, std::shared_ptr<GetFolderItemsR
       media_interface_->GetMediaPlayerList(base::Bind(&Device::GetMediaPlayerListResponse,
                                                       weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
-    case Scope::VFS:
+    case Scope::VFS: {
+      auto listing = browse_cache_.GetFolder(curr_browsed_player_id_, CurrentFolder());
+      if (listing != nullptr) {
+        SendVFSListPage(label, pkt, *listing);
+        break;
+      }
       media_interface_->GetFolderItems(
               curr_browsed_player_id_, CurrentFolder(),
               base::Bind(&Device::GetVFSListResponse, weak_ptr_factory_.GetWeakPtr(), label, pkt));
-      break;
-    case Scope::NOW_PLAYING:
+    } break;
+    case Scope::NOW_PLAYING: {
+      auto listing = browse_cache_.GetNowPlaying();
+      if (listing != nullptr) {
+        SendNowPlayingListPage(label, pkt, *listing);
+        break;
+      }
       media_interface_->GetNowPlayingList(base::Bind(&Device::GetNowPlayingListResponse,
                                                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
-      break;
+    } break;
     default:
       log::error("{}: scope={}", address_, pkt->GetScope());
       auto response = GetFolderItemsResponseBuilder::MakePlayerListBuilder(
@@ -1072,16 +1089,32 @@ void Device::HandleGetTotalNumberOfItems(uint8_t label,
                          weak_ptr_factory_.GetWeakPtr(), label));
       break;
     }
-    case Scope::VFS:
+    case Scope::VFS: {
+      auto listing = browse_cache_.GetFolder(curr_browsed_player_id_, CurrentFolder());
+      if (listing != nullptr) {
+        auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
+                Status::NO_ERROR, 0x0000, listing->items.size());
+        send_message(label, true, std::move(builder));
+        break;
+      }
       media_interface_->GetFolderItems(curr_browsed_player_id_, CurrentFolder(),
                                        base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
                                                   weak_ptr_factory_.GetWeakPtr(), label));
       break;
-    case Scope::NOW_PLAYING:
+    }
+    case Scope::NOW_PLAYING: {
+      auto listing = browse_cache_.GetNowPlaying();
+      if (listing != nullptr) {
+        auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
+                Status::NO_ERROR, 0x0000, listing->songs.size());
+        send_message(label, true, std::move(builder));
+        break;
+      }
       media_interface_->GetNowPlayingList(
               base::Bind(&Device::GetTotalNumberOfItemsNowPlayingResponse,
                          weak_ptr_factory_.GetWeakPtr(), label));
       break;
+    }
     default:
       log::error("{}: scope={}", address_, pkt->GetScope());
       break;
@@ -1102,6 +1135,9 @@ void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label, std::vector<ListIte
 
   auto builder =
           GetTotalNumberOfItemsResponseBuilder::MakeBuilder(Status::NO_ERROR, 0x0000, list.size());
+  if (browse_cache_.IsEnabled()) {
+    CacheFolderItems(std::move(list));
+  }
   send_message(label, true, std::move(builder));
 }
 
@@ -1111,6 +1147,9 @@ void Device::GetTotalNumberOfItemsNowPlayingResponse(uint8_t label, std::string
 
   auto builder =
           GetTotalNumberOfItemsResponseBuilder::MakeBuilder(Status::NO_ERROR, 0x0000, list.size());
+  if (browse_cache_.IsEnabled()) {
+    CacheNowPlayingList(std::move(curr_song_id), std::move(list));
+  }
   send_message(label, true, std::move(builder));
 }
 
@@ -1148,6 +1187,13 @@ void Device::HandleChangePath(uint8_t label, std::shared_ptr<ChangePathRequest>
     log::verbose("Popping Path from stack: new path=\"{}\"", CurrentFolder());
   }
 
+  auto listing = browse_cache_.GetFolder(curr_browsed_player_id_, CurrentFolder());
+  if (listing != nullptr) {
+    auto builder = ChangePathResponseBuilder::MakeBuilder(Status::NO_ERROR, listing->items.size());
+    send_message(label, true, std::move(builder));
+    return;
+  }
+
   media_interface_->GetFolderItems(
           curr_browsed_player_id_, CurrentFolder(),
           base::Bind(&Device::ChangePathResponse, weak_ptr_factory_.GetWeakPtr(), label, pkt));
@@ -1158,6 +1204,9 @@ void Device::ChangePathResponse(uint8_t label, std::shared_ptr<ChangePathRequest
   // TODO (apanicke): Reconstruct the VFS ID's here. Right now it gets
   // reconstructed in GetFolderItemsVFS
   auto builder = ChangePathResponseBuilder::MakeBuilder(Status::NO_ERROR, list.size());
+  if (browse_cache_.IsEnabled()) {
+    CacheFolderItems(std::move(list));
+  }
   send_message(label, true, std::move(builder));
 }
 
@@ -1359,14 +1408,8 @@ std::set<AttributeEntry> filter_attributes_requested(const SongInfo& song,
   return result;
 }
 
-void Device::GetVFSListResponse(uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
-                                std::vector<ListItem> items) {
-  log::verbose("start_item={} end_item={}", pkt->GetStartItem(), pkt->GetEndItem());
-
-  // The builder will automatically correct the status if there are zero items
-  auto builder =
-          GetFolderItemsResponseBuilder::MakeVFSBuilder(Status::NO_ERROR, 0x0000, browse_mtu_);
-
+std::shared_ptr<const BrowseCache::FolderListing> Device::CacheFolderItems(
+        std::vector<ListItem> items) {
   // TODO (apanicke): Add test that checks if vfs_ids_ is the correct size after
   // an operation.
   for (const auto& item : items) {
@@ -1377,22 +1420,49 @@ void Device::GetVFSListResponse(uint8_t label, std::shared_ptr<GetFolderItemsReq
     }
   }
 
+  return browse_cache_.PutFolder(curr_browsed_player_id_, CurrentFolder(), std::move(items));
+}
+
+std::shared_ptr<const BrowseCache::NowPlayingListing> Device::CacheNowPlayingList(
+        std::string curr_song_id, std::vector<SongInfo> song_list) {
+  now_playing_ids_.clear();
+  for (const SongInfo& song : song_list) {
+    now_playing_ids_.insert(song.media_id);
+  }
+
+  return browse_cache_.PutNowPlaying(std::move(curr_song_id), std::move(song_list));
+}
+
+void Device::GetVFSListResponse(uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
+                                std::vector<ListItem> items) {
+  auto listing = CacheFolderItems(std::move(items));
+  SendVFSListPage(label, pkt, *listing);
+}
+
+void Device::SendVFSListPage(uint8_t label, const std::shared_ptr<GetFolderItemsRequest>& pkt,
+                             const BrowseCache::FolderListing& listing) {
+  log::verbose("start_item={} end_item={}", pkt->GetStartItem(), pkt->GetEndItem());
+
+  // The builder will automatically correct the status if there are zero items
+  auto builder =
+          GetFolderItemsResponseBuilder::MakeVFSBuilder(Status::NO_ERROR, 0x0000, browse_mtu_);
+
   // Add the elements retrieved in the last get folder items request and map
   // them to UIDs The maps will be cleared every time a directory change
   // happens. These items do not need to correspond with the now playing list as
   // the UID's only need to be unique in the context of the current scope and
   // the current folder
-  for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size(); i++) {
-    if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+  for (const auto& item : GetBrowseRange(listing.items, pkt->GetStartItem(), pkt->GetEndItem())) {
+    if (item.type == ListItem::FOLDER) {
+      const auto& folder = item.folder;
       // right now we always use folders of mixed type
       FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00, folder.is_playable,
                              folder.name);
       if (!builder->AddFolder(folder_item)) {
         break;
       }
-    } else if (items[i].type == ListItem::SONG) {
-      auto song = items[i].song;
+    } else if (item.type == ListItem::SONG) {
+      auto song = item.song;
 
       // Filter out DEFAULT_COVER_ART handle if this device has no client
       if (!HasBipClient()) {
@@ -1423,19 +1493,24 @@ void Device::GetVFSListResponse(uint8_t label, std::shared_ptr<GetFolderItemsReq
 }
 
 void Device::GetNowPlayingListResponse(uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
-                                       std::string /* unused curr_song_id */,
+                                       std::string curr_song_id,
                                        std::vector<SongInfo> song_list) {
+  auto listing = CacheNowPlayingList(std::move(curr_song_id), std::move(song_list));
+  SendNowPlayingListPage(label, pkt, *listing);
+}
+
+void Device::SendNowPlayingListPage(uint8_t label,
+                                    const std::shared_ptr<GetFolderItemsRequest>& pkt,
+                                    const BrowseCache::NowPlayingListing& listing) {
   log::verbose("");
   auto builder = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(Status::NO_ERROR, 0x0000,
                                                                       browse_mtu_);
 
-  now_playing_ids_.clear();
-  for (const SongInfo& song : song_list) {
-    now_playing_ids_.insert(song.media_id);
-  }
-
-  for (size_t i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < song_list.size(); i++) {
-    auto song = song_list[i];
+  auto range = GetBrowseRange(listing.songs, pkt->GetStartItem(), pkt->GetEndItem());
+  uint64_t uid = range.start_item;
+  for (const SongInfo& song_info : range) {
+    auto song = song_info;
+    uid++;
 
     // Filter out DEFAULT_COVER_ART handle if this device has no client
     if (!HasBipClient()) {
@@ -1446,7 +1521,7 @@ void Device::GetNowPlayingListResponse(uint8_t label, std::shared_ptr<GetFolderI
                          ? song.attributes.find(Attribute::TITLE)->value()
                          : "No Song Info";
 
-    MediaElementItem item(i + 1, title, std::set<AttributeEntry>());
+    MediaElementItem item(uid, title, std::set<AttributeEntry>());
     if (pkt->GetNumAttributes() == 0x00) {
       item.attributes_ = std::move(song.attributes);
     } else {
@@ -1516,6 +1591,7 @@ void Device::SendMediaUpdate(bool metadata, bool play_status, bool queue) {
                queue, is_silence);
 
   if (queue) {
+    browse_cache_.OnNowPlayingChanged();
     HandleNowPlayingUpdate();
   }
 
@@ -1540,8 +1616,13 @@ void Device::SendFolderUpdate(bool available_players, bool addressed_player, boo
   }
 
   if (addressed_player) {
+    browse_cache_.OnNowPlayingChanged();
     HandleAddressedPlayerUpdate();
   }
+
+  if (uids) {
+    browse_cache_.OnUidsChanged();
+  }
 }
 
 void Device::HandleTrackUpdate() {
@@ -1647,10 +1728,7 @@ void Device::HandleNowPlayingNotificationResponse(uint8_t label, bool interim,
     return;
   }
 
-  now_playing_ids_.clear();
-  for (const SongInfo& song : song_list) {
-    now_playing_ids_.insert(song.media_id);
-  }
+  CacheNowPlayingList(std::move(curr_song_id), std::move(song_list));
 
   auto response = RegisterNotificationResponseBuilder::MakeNowPlayingBuilder(interim);
   send_message(now_playing_changed_.second, false, std::move(response));
@@ -1704,6 +1782,7 @@ void Device::HandleAddressedPlayerUpdate() {
 void Device::DeviceDisconnected() {
   log::info("{} : Device was disconnected", address_);
   play_pos_update_cb_.Cancel();
+  browse_cache_.Clear();
 
   // TODO (apanicke): Once the interfaces are set in the Device construction,
   // remove these conditionals.
@@ -1765,6 +1844,7 @@ std::ostream& operator<<(std::ostream& out, const Device& d) {
   out << "    Last Song Sent ID: \"" << d.last_song_info_.media_id << "\"\n";
   out << "    Current Folder: \"" << d.CurrentFolder() << "\"\n";
   out << "    MTU Sizes: CTRL=" << d.ctrl_mtu_ << " BROWSE=" << d.browse_mtu_ << std::endl;
+  out << d.browse_cache_;
   // TODO (apanicke): Add supported features as well as media keys
   return out;
 }
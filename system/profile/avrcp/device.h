@@ -43,6 +43,7 @@
 #include "packet/avrcp/set_browsed_player.h"
 #include "packet/avrcp/set_player_application_setting_value.h"
 #include "packet/avrcp/vendor_packet.h"
+#include "profile/avrcp/browse_cache.h"
 #include "profile/avrcp/media_id_map.h"
 #include "raw_address.h"
 
@@ -310,6 +311,18 @@ private:
     return current_path_.top();
   }
 
+  // Stores a listing fetched from the media interface in the browse cache and
+  // maps its items to UIDs.
+  std::shared_ptr<const BrowseCache::FolderListing> CacheFolderItems(std::vector<ListItem> items);
+  std::shared_ptr<const BrowseCache::NowPlayingListing> CacheNowPlayingList(
+          std::string curr_song_id, std::vector<SongInfo> song_list);
+
+  // Sends the page of a listing selected by a Get Folder Items request.
+  void SendVFSListPage(uint8_t label, const std::shared_ptr<GetFolderItemsRequest>& pkt,
+                       const BrowseCache::FolderListing& listing);
+  void SendNowPlayingListPage(uint8_t label, const std::shared_ptr<GetFolderItemsRequest>& pkt,
+                              const BrowseCache::NowPlayingListing& listing);
+
   void send_message(uint8_t label, bool browse,
                     std::unique_ptr<::bluetooth::PacketBuilder> message) {
     active_labels_.erase(label);
@@ -358,6 +371,8 @@ private:
   MediaIdMap vfs_ids_;
   MediaIdMap now_playing_ids_;
 
+  BrowseCache browse_cache_;
+
   uint32_t play_pos_interval_ = 0;
 
   SongInfo last_song_info_;
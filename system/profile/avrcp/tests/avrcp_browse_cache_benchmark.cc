@@ -0,0 +1,176 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "browse_cache.h"
+#include "media_id_map.h"
+#include "packet/avrcp/get_folder_items.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace avrcp {
+namespace {
+
+constexpr size_t kLibrarySize = 50000;
+constexpr uint16_t kBrowseMtu = 1017;
+constexpr int kPlayerId = 1;
+constexpr char kFolderId[] = "library";
+
+std::vector<ListItem> MakeLibrary() {
+  std::vector<ListItem> items;
+  items.reserve(kLibrarySize);
+  for (size_t i = 0; i < kLibrarySize; i++) {
+    ListItem item = {};
+    item.type = ListItem::SONG;
+    item.song.media_id = "song_" + std::to_string(i);
+    item.song.attributes.insert(AttributeEntry(Attribute::TITLE, "Title " + std::to_string(i)));
+    item.song.attributes.insert(
+            AttributeEntry(Attribute::ARTIST_NAME, "Artist " + std::to_string(i / 12)));
+    item.song.attributes.insert(
+            AttributeEntry(Attribute::ALBUM_NAME, "Album " + std::to_string(i / 12)));
+    items.push_back(item);
+  }
+  return items;
+}
+
+// Builds the Get Folder Items response for the items of |items| from
+// |start_item| to |end_item| the way Device does, and returns the number of
+// items that fit.
+size_t BuildPage(const std::vector<ListItem>& items, uint32_t start_item, uint32_t end_item,
+                 MediaIdMap& ids) {
+  auto builder =
+          GetFolderItemsResponseBuilder::MakeVFSBuilder(Status::NO_ERROR, 0x0000, kBrowseMtu);
+  size_t num_items = 0;
+  for (const auto& item : GetBrowseRange(items, start_item, end_item)) {
+    auto song = item.song;
+    auto title = song.attributes.find(Attribute::TITLE)->value();
+    MediaElementItem song_item(ids.get_uid(song.media_id), title, std::move(song.attributes));
+    if (!builder->AddSong(song_item)) {
+      break;
+    }
+    num_items++;
+  }
+  ::benchmark::DoNotOptimize(builder->size());
+  return num_items;
+}
+
+class BM_AvrcpBrowse : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    library_ = MakeLibrary();
+  }
+
+  void TearDown(State& st) override {
+    library_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  // Stands in for the listing handed over by value by the media interface
+  std::vector<ListItem> library_;
+};
+
+// Pages through the library state.range(0) items at a time, fetching the
+// whole folder and mapping all of its items to UIDs for every page.
+BENCHMARK_DEFINE_F(BM_AvrcpBrowse, get_folder_items_fetch_per_page)(State& state) {
+  MediaIdMap ids;
+  uint32_t page_size = state.range(0);
+  uint32_t start_item = 0;
+  size_t num_items = 0;
+  for (auto _ : state) {
+    std::vector<ListItem> items = library_;
+    for (const auto& item : items) {
+      ids.insert(item.song.media_id);
+    }
+    num_items += BuildPage(items, start_item, start_item + page_size - 1, ids);
+    start_item = (start_item + page_size) % kLibrarySize;
+  }
+  state.SetItemsProcessed(num_items);
+}
+
+// Pages through the library state.range(0) items at a time, serving every page
+// after the first from the browse cache.
+BENCHMARK_DEFINE_F(BM_AvrcpBrowse, get_folder_items_cached)(State& state) {
+  MediaIdMap ids;
+  BrowseCache cache;
+  uint32_t page_size = state.range(0);
+  uint32_t start_item = 0;
+  size_t num_items = 0;
+  for (auto _ : state) {
+    auto listing = cache.GetFolder(kPlayerId, kFolderId);
+    if (listing == nullptr) {
+      std::vector<ListItem> items = library_;
+      for (const auto& item : items) {
+        ids.insert(item.song.media_id);
+      }
+      listing = cache.PutFolder(kPlayerId, kFolderId, std::move(items));
+    }
+    num_items += BuildPage(listing->items, start_item, start_item + page_size - 1, ids);
+    start_item = (start_item + page_size) % kLibrarySize;
+  }
+  state.SetItemsProcessed(num_items);
+}
+
+// Same as above, with a UIDs changed update every state.range(1) pages that
+// makes the next page fetch the folder again.
+BENCHMARK_DEFINE_F(BM_AvrcpBrowse, get_folder_items_cached_uids_changed)(State& state) {
+  MediaIdMap ids;
+  BrowseCache cache;
+  uint32_t page_size = state.range(0);
+  int64_t pages_per_update = state.range(1);
+  uint32_t start_item = 0;
+  size_t num_items = 0;
+  int64_t pages = 0;
+  for (auto _ : state) {
+    if (++pages % pages_per_update == 0) {
+      cache.OnUidsChanged();
+    }
+    auto listing = cache.GetFolder(kPlayerId, kFolderId);
+    if (listing == nullptr) {
+      std::vector<ListItem> items = library_;
+      for (const auto& item : items) {
+        ids.insert(item.song.media_id);
+      }
+      listing = cache.PutFolder(kPlayerId, kFolderId, std::move(items));
+    }
+    num_items += BuildPage(listing->items, start_item, start_item + page_size - 1, ids);
+    start_item = (start_item + page_size) % kLibrarySize;
+  }
+  state.SetItemsProcessed(num_items);
+}
+
+BENCHMARK_REGISTER_F(BM_AvrcpBrowse, get_folder_items_fetch_per_page)
+        ->Arg(10)
+        ->Arg(100)
+        ->Unit(::benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(BM_AvrcpBrowse, get_folder_items_cached)
+        ->Arg(10)
+        ->Arg(100)
+        ->Unit(::benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(BM_AvrcpBrowse, get_folder_items_cached_uids_changed)
+        ->Args({10, 100})
+        ->Args({10, 1000})
+        ->Unit(::benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace avrcp
+}  // namespace bluetooth
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "browse_cache.h"
+
+namespace bluetooth {
+namespace avrcp {
+
+namespace {
+
+std::vector<ListItem> MakeFolder(const std::string& prefix, size_t num_items) {
+  std::vector<ListItem> items;
+  for (size_t i = 0; i < num_items; i++) {
+    ListItem item = {};
+    item.type = ListItem::SONG;
+    item.song.media_id = prefix + std::to_string(i);
+    items.push_back(item);
+  }
+  return items;
+}
+
+}  // namespace
+
+TEST(AvrcpBrowseCacheTest, rangeTest) {
+  std::vector<int> items = {0, 1, 2, 3, 4};
+
+  auto range = GetBrowseRange(items, 1, 3);
+  ASSERT_EQ(range.size(), 3u);
+  ASSERT_EQ(range.start_item, 1u);
+  ASSERT_EQ(*range.begin(), 1);
+
+  // The end item is clipped to the size of the listing
+  range = GetBrowseRange(items, 3, 0xFFFFFFFF);
+  ASSERT_EQ(range.size(), 2u);
+  ASSERT_EQ(*range.begin(), 3);
+
+  // Ranges starting past the end of the listing, or ending before their start
+  // are empty
+  ASSERT_EQ(GetBrowseRange(items, 5, 10).size(), 0u);
+  ASSERT_EQ(GetBrowseRange(items, 3, 1).size(), 0u);
+}
+
+TEST(AvrcpBrowseCacheTest, folderHitTest) {
+  BrowseCache cache;
+
+  ASSERT_EQ(cache.GetFolder(1, "root"), nullptr);
+  auto listing = cache.PutFolder(1, "root", MakeFolder("a", 10));
+  ASSERT_EQ(listing->items.size(), 10u);
+
+  ASSERT_EQ(cache.GetFolder(1, "root"), listing);
+  ASSERT_EQ(cache.GetFolder(1, "other"), nullptr);
+  ASSERT_EQ(cache.GetFolder(2, "root"), nullptr);
+}
+
+TEST(AvrcpBrowseCacheTest, disabledTest) {
+  BrowseCache cache(0);
+
+  auto listing = cache.PutFolder(1, "root", MakeFolder("a", 10));
+  ASSERT_NE(listing, nullptr);
+  ASSERT_EQ(listing->items.size(), 10u);
+  ASSERT_EQ(cache.GetFolder(1, "root"), nullptr);
+
+  ASSERT_NE(cache.PutNowPlaying("a0", {}), nullptr);
+  ASSERT_EQ(cache.GetNowPlaying(), nullptr);
+}
+
+TEST(AvrcpBrowseCacheTest, uidsChangedTest) {
+  BrowseCache cache;
+
+  cache.PutFolder(1, "root", MakeFolder("a", 10));
+  cache.PutNowPlaying("a0", {SongInfo{"a0", {}}});
+  cache.OnUidsChanged();
+  ASSERT_EQ(cache.GetUidCounter(), 1u);
+
+  // Folders fetched before the UIDs changed are fetched again, the now playing
+  // list is kept.
+  ASSERT_EQ(cache.GetFolder(1, "root"), nullptr);
+  ASSERT_NE(cache.GetNowPlaying(), nullptr);
+
+  auto listing = cache.PutFolder(1, "root", MakeFolder("b", 5));
+  ASSERT_EQ(listing->uid_counter, 1u);
+  ASSERT_EQ(cache.GetFolder(1, "root"), listing);
+}
+
+TEST(AvrcpBrowseCacheTest, nowPlayingChangedTest) {
+  BrowseCache cache;
+
+  cache.PutFolder(1, "root", MakeFolder("a", 10));
+  auto listing = cache.PutNowPlaying("a1", {SongInfo{"a0", {}}, SongInfo{"a1", {}}});
+  ASSERT_EQ(cache.GetNowPlaying(), listing);
+  ASSERT_EQ(listing->curr_song_id, "a1");
+
+  cache.OnNowPlayingChanged();
+  ASSERT_EQ(cache.GetNowPlaying(), nullptr);
+  ASSERT_NE(cache.GetFolder(1, "root"), nullptr);
+}
+
+TEST(AvrcpBrowseCacheTest, evictionTest) {
+  BrowseCache cache(2);
+
+  cache.PutFolder(1, "a", MakeFolder("a", 1));
+  cache.PutFolder(1, "b", MakeFolder("b", 1));
+  // Looking up "a" makes "b" the least recently used folder
+  ASSERT_NE(cache.GetFolder(1, "a"), nullptr);
+  cache.PutFolder(1, "c", MakeFolder("c", 1));
+
+  ASSERT_NE(cache.GetFolder(1, "a"), nullptr);
+  ASSERT_EQ(cache.GetFolder(1, "b"), nullptr);
+  ASSERT_NE(cache.GetFolder(1, "c"), nullptr);
+}
+
+TEST(AvrcpBrowseCacheTest, itemBudgetTest) {
+  BrowseCache cache;
+
+  cache.PutFolder(1, "a", MakeFolder("a", BrowseCache::kMaxFolderItems / 2));
+  cache.PutFolder(1, "b", MakeFolder("b", BrowseCache::kMaxFolderItems / 2 + 1));
+  ASSERT_EQ(cache.GetFolder(1, "a"), nullptr);
+  ASSERT_NE(cache.GetFolder(1, "b"), nullptr);
+
+  // A listing larger than the budget is still kept while it is browsed
+  cache.PutFolder(1, "c", MakeFolder("c", BrowseCache::kMaxFolderItems + 1));
+  ASSERT_EQ(cache.GetFolder(1, "b"), nullptr);
+  ASSERT_NE(cache.GetFolder(1, "c"), nullptr);
+}
+
+}  // namespace avrcp
+}  // namespace bluetooth
@@ -26,6 +26,7 @@
 #include "avrcp_test_helper.h"
 #include "device.h"
 #include "internal_include/stack_config.h"
+#include "osi/include/properties.h"
 #include "tests/avrcp/avrcp_test_packets.h"
 #include "tests/packet_test_helper.h"
 #include "types/raw_address.h"
@@ -1883,6 +1884,84 @@ TEST_F(AvrcpDeviceTest, invalidGetItemAttributesPacketTest) {
   SendBrowseMessage(1, short_packet);
 }
 
+TEST_F(AvrcpDeviceTest, getTotalNumberOfItemsNowPlayingKeepsUidsTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr, nullptr);
+
+  std::vector<SongInfo> list = {{"test_id1", {}}, {"test_id2", {}}, {"test_id3", {}}};
+  std::vector<SongInfo> reordered_list = {{"test_id3", {}}, {"test_id2", {}}, {"test_id1", {}}};
+
+  EXPECT_CALL(interface, GetNowPlayingList(_))
+          .WillOnce(InvokeCb<0>("test_id1", list))
+          .WillOnce(InvokeCb<0>("test_id1", reordered_list));
+  EXPECT_CALL(response_cb, Call(_, _, _)).Times(3);
+
+  // Without the browse cache, only a listing of the items maps their UIDs
+  SendBrowseMessage(1, TestBrowsePacket::Make(get_folder_items_request_now_playing));
+  SendBrowseMessage(2, TestBrowsePacket::Make(get_total_number_of_items_request_now_playing));
+
+  EXPECT_CALL(interface, PlayItem(_, true, "test_id3")).Times(1);
+  SendMessage(3, TestAvrcpPacket::Make(play_item_request));
+}
+
+class AvrcpDeviceBrowseCacheTest : public AvrcpDeviceTest {
+public:
+  void SetUp() override {
+    osi_property_set("persist.bluetooth.avrcp.browse_cache", "true");
+    AvrcpDeviceTest::SetUp();
+  }
+
+  void TearDown() override {
+    AvrcpDeviceTest::TearDown();
+    osi_property_set("persist.bluetooth.avrcp.browse_cache", "false");
+  }
+};
+
+TEST_F(AvrcpDeviceBrowseCacheTest, trackChangedRefreshesNowPlayingListTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr, nullptr);
+  SetBipClientStatus(false);
+
+  SongInfo song1 = {"test_id1", {AttributeEntry(Attribute::TITLE, "Test Song 1")}};
+  SongInfo song2 = {"test_id2", {AttributeEntry(Attribute::TITLE, "Test Song 2")}};
+  std::vector<SongInfo> list = {song1};
+  std::vector<SongInfo> new_list = {song1, song2};
+
+  EXPECT_CALL(interface, GetNowPlayingList(_))
+          .WillOnce(InvokeCb<0>("test_id1", list))
+          .WillOnce(InvokeCb<0>("test_id2", new_list));
+
+  auto interim_response = RegisterNotificationResponseBuilder::MakeTrackChangedBuilder(true, 0x01);
+  EXPECT_CALL(response_cb, Call(1, false, matchPacket(std::move(interim_response)))).Times(1);
+  auto request = RegisterNotificationRequestBuilder::MakeBuilder(Event::TRACK_CHANGED, 0);
+  auto pkt = TestAvrcpPacket::Make();
+  request->Serialize(pkt);
+  SendMessage(1, pkt);
+
+  // Served from the list fetched for the notification
+  auto page_response =
+          GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(Status::NO_ERROR, 0x0000, 0xFFFF);
+  page_response->AddSong(MediaElementItem(1, "Test Song 1", song1.attributes));
+  EXPECT_CALL(response_cb, Call(2, true, matchPacket(std::move(page_response)))).Times(1);
+  SendBrowseMessage(2, TestBrowsePacket::Make(get_folder_items_request_now_playing));
+
+  auto changed_response = RegisterNotificationResponseBuilder::MakeTrackChangedBuilder(false, 0x02);
+  EXPECT_CALL(response_cb, Call(1, false, matchPacket(std::move(changed_response)))).Times(1);
+  test_device->HandleTrackUpdate();
+
+  // Served from the list fetched for the track change, matching its UIDs
+  auto new_page_response =
+          GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(Status::NO_ERROR, 0x0000, 0xFFFF);
+  new_page_response->AddSong(MediaElementItem(1, "Test Song 1", song1.attributes));
+  new_page_response->AddSong(MediaElementItem(2, "Test Song 2", song2.attributes));
+  EXPECT_CALL(response_cb, Call(3, true, matchPacket(std::move(new_page_response)))).Times(1);
+  SendBrowseMessage(3, TestBrowsePacket::Make(get_folder_items_request_now_playing));
+}
+
 }  // namespace avrcp
 }  // namespace bluetooth
 
@@ -25,12 +25,15 @@
 #include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "common/time_util.h"
 #include "embdrv/sbc/encoder/include/sbc_encoder.h"
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 
 /* Buffer pool */
@@ -52,6 +55,13 @@
 /* Define the bitrate step when trying to match bitpool value */
 #define A2DP_SBC_BITRATE_STEP 5
 
+/* Adaptive bitpool: the bitpool is lowered by A2DP_SBC_ABR_BITPOOL_STEP at each
+ * tick the TX queue holds at least A2DP_SBC_ABR_QUEUE_HIGH packets, and raised
+ * back when the queue is empty */
+#define A2DP_SBC_ABR_PROPERTY "persist.bluetooth.a2dp_sbc.adaptive_bitpool"
+#define A2DP_SBC_ABR_QUEUE_HIGH 3
+#define A2DP_SBC_ABR_BITPOOL_STEP 4
+
 /* Readability constants */
 #define A2DP_SBC_FRAME_HEADER_SIZE_BYTES 4  // A2DP Spec v1.3, 12.4, Table 12.12
 #define A2DP_SBC_SCALE_FACTOR_BITS 4        // A2DP Spec v1.3, 12.4, Table 12.13
@@ -84,6 +94,8 @@ typedef struct {
 
   size_t media_read_total_expected_frames;
   size_t media_read_total_dropped_frames;
+
+  size_t bitpool_adjustments;
 } a2dp_sbc_encoder_stats_t;
 
 typedef struct {
@@ -94,6 +106,9 @@ typedef struct {
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
   uint32_t timestamp; /* Timestamp for the A2DP frames */
   SBC_ENC_PARAMS sbc_encoder_params;
+  bool adaptive_bitpool;  /* The bitpool follows the TX queue length */
+  int16_t target_bitpool; /* Bitpool for the target bit rate */
+  int16_t min_bitpool;    /* Lowest bitpool supported by the peer */
   tA2DP_FEEDING_PARAMS feeding_params;
   tA2DP_SBC_FEEDING_STATE feeding_state;
   int16_t pcmBuffer[SBC_MAX_PCM_BUFFER_SIZE];
@@ -296,6 +311,9 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config, bool* p_
 
   /* Finally update the bitpool in the encoder structure */
   p_encoder_params->s16BitPool = s16BitPool;
+  a2dp_sbc_encoder_cb.adaptive_bitpool = osi_property_get_bool(A2DP_SBC_ABR_PROPERTY, false);
+  a2dp_sbc_encoder_cb.target_bitpool = s16BitPool;
+  a2dp_sbc_encoder_cb.min_bitpool = std::min<int16_t>(min_bitpool, s16BitPool);
 
   log::info("final bit rate {}, final bit pool {}", p_encoder_params->u16BitRate,
             p_encoder_params->s16BitPool);
@@ -347,6 +365,32 @@ void a2dp_sbc_send_frames(uint64_t timestamp_us) {
   }
 }
 
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length) {
+  if (!a2dp_sbc_encoder_cb.adaptive_bitpool) {
+    return;
+  }
+
+  // The queue grows when the link doesn't send as fast as the encoder: lower
+  // the bit rate until it drains, then raise it back to the target.
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+  int16_t bitpool = p_encoder_params->s16BitPool;
+  if (transmit_queue_length >= A2DP_SBC_ABR_QUEUE_HIGH) {
+    bitpool = std::max<int16_t>(bitpool - A2DP_SBC_ABR_BITPOOL_STEP,
+                                a2dp_sbc_encoder_cb.min_bitpool);
+  } else if (transmit_queue_length == 0) {
+    bitpool = std::min<int16_t>(bitpool + A2DP_SBC_ABR_BITPOOL_STEP,
+                                a2dp_sbc_encoder_cb.target_bitpool);
+  }
+  if (bitpool != p_encoder_params->s16BitPool) {
+    log::verbose("queue length {}, bitpool {} -> {}", transmit_queue_length,
+                 p_encoder_params->s16BitPool, bitpool);
+    // The bitpool is carried in the header of each SBC frame, and can change
+    // between frames.
+    p_encoder_params->s16BitPool = bitpool;
+    a2dp_sbc_encoder_cb.stats.bitpool_adjustments++;
+  }
+}
+
 // Obtains the number of frames to send and number of iterations
 // to be used. |num_of_iterations| and |num_of_frames| parameters
 // are used as output param for returning the respective values.
@@ -821,6 +865,12 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
             A2DP_GetMinBitpoolSbc(codec_info), A2DP_GetMaxBitpoolSbc(codec_info));
   }
 
+  if (a2dp_sbc_encoder_cb.adaptive_bitpool) {
+    dprintf(fd, "  SBC Adaptive bitpool (current/target/adjustments)       : %d / %d / %zu\n",
+            a2dp_sbc_encoder_cb.sbc_encoder_params.s16BitPool, a2dp_sbc_encoder_cb.target_bitpool,
+            stats->bitpool_adjustments);
+  }
+
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n", a2dp_sbc_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_sbc_get_effective_frame_size());
   dprintf(fd,
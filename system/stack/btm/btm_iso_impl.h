@@ -27,6 +27,7 @@
 #include "btm_dev.h"
 #include "btm_iso_api.h"
 #include "common/time_util.h"
+#include "common/trace_ring.h"
 #include "hci/controller_interface.h"
 #include "hci/include/hci_layer.h"
 #include "internal_include/bt_trace.h"
@@ -503,6 +504,8 @@ struct iso_impl {
   }
 
   void send_iso_data(uint16_t iso_handle, const uint8_t* data, uint16_t data_len) {
+    bluetooth::common::Trace(bluetooth::common::TraceEvent::kIsoSendData,
+                             static_cast<uint64_t>(iso_handle) << 16 | data_len);
     iso_base* iso = GetIsoIfKnown(iso_handle);
     log::assert_that(iso != nullptr, "No such iso connection handle: {}", loghex(iso_handle));
 
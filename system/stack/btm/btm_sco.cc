@@ -193,8 +193,8 @@ void tSCO_CB::Free() {
 /* Buffer used for reading PCM data from audio server that will be encoded into
  * mSBC packet. The BTM_SCO_DATA_SIZE_MAX should be set to a number divisible by
  * BTM_MSBC_CODE_SIZE(240) */
-static uint8_t btm_pcm_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
-static uint8_t packet_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
+alignas(int16_t) static uint8_t btm_pcm_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
+alignas(int16_t) static uint8_t packet_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
 
 /* The read and write offset for btm_pcm_buf.
  * They are only used for WBS and the unit is byte. */
@@ -250,21 +250,22 @@ size_t btm_pcm_buf_data_len() {
 
 size_t btm_pcm_buf_avail_len() { return BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_data_len(); }
 
-size_t write_btm_pcm_buf(uint8_t* source, size_t amount) {
-  if (btm_pcm_buf_avail_len() < amount) {
-    return 0;
-  }
+/* Reads up to |amount| bytes of PCM data from the audio server straight into
+ * btm_pcm_buf, and returns the number of bytes read. */
+size_t read_btm_pcm_buf(size_t amount) {
+  amount = std::min(amount, btm_pcm_buf_avail_len());
 
-  size_t bytes_remaining = BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_write_offset;
-  if (bytes_remaining > amount) {
-    std::copy(source, source + amount, btm_pcm_buf + btm_pcm_buf_write_offset);
-  } else {
-    std::copy(source, source + bytes_remaining, btm_pcm_buf + btm_pcm_buf_write_offset);
-    std::copy(source + bytes_remaining, source + amount, btm_pcm_buf);
+  size_t read = 0;
+  while (read < amount) {
+    size_t to_read = std::min(amount - read, BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_write_offset);
+    size_t rc = bluetooth::audio::sco::read(btm_pcm_buf + btm_pcm_buf_write_offset, to_read);
+    incr_btm_pcm_buf_offset(btm_pcm_buf_write_offset, btm_pcm_buf_write_mirror, rc);
+    read += rc;
+    if (rc != to_read) {
+      break;
+    }
   }
-
-  incr_btm_pcm_buf_offset(btm_pcm_buf_write_offset, btm_pcm_buf_write_mirror, amount);
-  return amount;
+  return read;
 }
 
 /******************************************************************************/
@@ -403,9 +404,14 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
     if (status != bluetooth::hci::PacketStatusFlag::CORRECTLY_RECEIVED) {
       log::debug("{} packet corrupted with status({})", codec, PacketStatusFlagText(status));
     }
+    /* The frames are decoded in place from the packet, and the bytes left of it
+     * are copied once all the complete frames are decoded. */
     auto enqueue_packet = codec_type == BTM_SCO_CODEC_LC3
-                                  ? &bluetooth::audio::sco::swb::enqueue_packet
-                                  : &bluetooth::audio::sco::wbs::enqueue_packet;
+                                  ? &bluetooth::audio::sco::swb::enqueue_packet_in_place
+                                  : &bluetooth::audio::sco::wbs::enqueue_packet_in_place;
+    auto release_packet = codec_type == BTM_SCO_CODEC_LC3
+                                  ? &bluetooth::audio::sco::swb::release_packet
+                                  : &bluetooth::audio::sco::wbs::release_packet;
     rc = enqueue_packet(data, status != bluetooth::hci::PacketStatusFlag::CORRECTLY_RECEIVED);
     if (!rc) {
       log::debug("Failed to enqueue {} packet", codec);
@@ -421,6 +427,7 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
 
       written += bluetooth::audio::sco::write(decoded, rc);
     }
+    release_packet();
   } else {
     written = bluetooth::audio::sco::write(rx_data, data.size());
   }
@@ -428,7 +435,6 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
   /* For Chrome OS, we send the outgoing data after receiving an incoming one.
    * server, so that we can keep the data read/write rate balanced */
   size_t read = 0;
-  const uint8_t* encoded = nullptr;
 
   if (codec_type == BTM_SCO_CODEC_MSBC || codec_type == BTM_SCO_CODEC_LC3) {
     while (written) {
@@ -436,10 +442,7 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
       if (avail) {
         size_t to_read = written < avail ? written : avail;
 
-        // Read to the packet_buf first and then copy to the btm_pcm_buf.
-        read = bluetooth::audio::sco::read(packet_buf, to_read);
-
-        write_btm_pcm_buf(packet_buf, read);
+        read = read_btm_pcm_buf(to_read);
 
         if (read != to_read) {
           log::info(
@@ -463,22 +466,27 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
                                                     : &bluetooth::audio::sco::wbs::encode;
 
       size_t data_len = btm_pcm_buf_data_len();
+      size_t code_size =
+              codec_type == BTM_SCO_CODEC_LC3 ? BTM_LC3_CODE_SIZE : BTM_MSBC_CODE_SIZE;
 
       if (data_len) {
-        // Copy all data to the packet_buf first and then call encode.
+        // Encode in place, unless the PCM data wraps around the end of the
+        // btm_pcm_buf or does not start on a sample boundary, in which case it
+        // is copied to the packet_buf first.
         size_t bytes_remaining = BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_read_offset;
-
-        if (bytes_remaining > data_len) {
-          std::copy(btm_pcm_buf + btm_pcm_buf_read_offset,
-                    btm_pcm_buf + btm_pcm_buf_read_offset + data_len, packet_buf);
+        uint8_t* pcm = btm_pcm_buf + btm_pcm_buf_read_offset;
+        bool wraps = bytes_remaining < data_len && bytes_remaining < code_size;
+
+        if (wraps || btm_pcm_buf_read_offset % sizeof(int16_t) != 0) {
+          size_t first = std::min(data_len, bytes_remaining);
+          std::copy(pcm, pcm + first, packet_buf);
+          std::copy(btm_pcm_buf, btm_pcm_buf + data_len - first, packet_buf + first);
+          pcm = packet_buf;
         } else {
-          std::copy(btm_pcm_buf + btm_pcm_buf_read_offset, btm_pcm_buf + BTM_SCO_DATA_SIZE_MAX,
-                    packet_buf);
-          std::copy(btm_pcm_buf, btm_pcm_buf + data_len - bytes_remaining,
-                    packet_buf + bytes_remaining);
+          data_len = std::min(data_len, bytes_remaining);
         }
 
-        rc = encode((int16_t*)packet_buf, data_len);
+        rc = encode((int16_t*)pcm, data_len);
         incr_btm_pcm_buf_offset(btm_pcm_buf_read_offset, btm_pcm_buf_read_mirror, rc);
 
         if (!rc) {
@@ -493,21 +501,22 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
       /* Send all of the available SCO packets buffered in the queue */
       while (1) {
         auto dequeue_packet = codec_type == BTM_SCO_CODEC_LC3
-                                      ? &bluetooth::audio::sco::swb::dequeue_packet
-                                      : &bluetooth::audio::sco::wbs::dequeue_packet;
-        rc = dequeue_packet(&encoded);
+                                      ? &bluetooth::audio::sco::swb::dequeue_packet_buffer
+                                      : &bluetooth::audio::sco::wbs::dequeue_packet_buffer;
+        std::vector<uint8_t> packet;
+        rc = dequeue_packet(&packet);
         if (!rc) {
           break;
         }
 
-        auto data = std::vector<uint8_t>(encoded, encoded + rc);
-        btm_send_sco_packet(std::move(data));
+        btm_send_sco_packet(std::move(packet));
       }
     }
   } else {
     while (written) {
-      read = bluetooth::audio::sco::read(
-              btm_pcm_buf, written < BTM_SCO_DATA_SIZE_MAX ? written : BTM_SCO_DATA_SIZE_MAX);
+      auto packet = std::vector<uint8_t>(written < BTM_SCO_DATA_SIZE_MAX ? written
+                                                                        : BTM_SCO_DATA_SIZE_MAX);
+      read = bluetooth::audio::sco::read(packet.data(), packet.size());
       if (read == 0) {
         log::info(
                 "Failed to read {} bytes of PCM data from audio server",
@@ -519,9 +528,9 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
       /* In narrow-band, the CVSD encode is offloaded to controller so we can
        * send PCM data directly to SCO.
        * We don't maintain buffer read/write offset for NB as we send all data
-       * that we read from the audio server. */
-      auto data = std::vector<uint8_t>(btm_pcm_buf, btm_pcm_buf + read);
-      btm_send_sco_packet(std::move(data));
+       * that we read from the audio server, read straight into the packet. */
+      packet.resize(read);
+      btm_send_sco_packet(std::move(packet));
     }
   }
 }
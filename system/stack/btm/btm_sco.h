@@ -19,6 +19,7 @@
 #include <bluetooth/log.h>
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -82,12 +83,27 @@ bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio);
 
 /* Try to enqueue a packet to a buffer.
  * Args:
- *    data - Vector of received packet data bytes.
+ *    data - Received packet data bytes, copied to the buffer.
  *    corrupted - If the current mSBC packet read is corrupted.
  * Returns:
  *    true if enqueued, false if it failed.
  */
-bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted);
+bool enqueue_packet(std::span<const uint8_t> data, bool corrupted);
+
+/* Try to enqueue a packet without copying it, so that its mSBC frames are
+ * decoded in place. The bytes not decoded yet are copied to the buffer by
+ * release_packet(), which must be called before the data is freed.
+ * Args:
+ *    data - Received packet data bytes.
+ *    corrupted - If the current mSBC packet read is corrupted.
+ * Returns:
+ *    true if enqueued, false if it failed.
+ */
+bool enqueue_packet_in_place(std::span<const uint8_t> data, bool corrupted);
+
+/* Release the packet enqueued in place, copying the bytes not decoded yet to
+ * the buffer. */
+void release_packet();
 
 /* Try to decode mSBC frames from the packets in the buffer.
  * Args:
@@ -115,6 +131,15 @@ size_t encode(int16_t* data, size_t len);
  */
 size_t dequeue_packet(const uint8_t** output);
 
+/* Same as above, handing over the buffer the encoder wrote the packet to, to
+ * be sent without copying it.
+ * Args:
+ *    output - Vector to move the packet data bytes to.
+ * Returns:
+ *    The length of dequeued packet. 0 if failed.
+ */
+size_t dequeue_packet_buffer(std::vector<uint8_t>* output);
+
 /* Get mSBC packets' status record.
  * Returns:
  *      Pointer to the record struct, nullptr if not valid.
@@ -151,12 +176,27 @@ bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio);
 
 /* Try to enqueue a packet to a buffer.
  * Args:
- *    data - Vector of received packet data bytes.
+ *    data - Received packet data bytes, copied to the buffer.
  *    corrupted - If the current LC3 packet read is corrupted.
  * Returns:
  *    true if enqueued, false if it failed.
  */
-bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted);
+bool enqueue_packet(std::span<const uint8_t> data, bool corrupted);
+
+/* Try to enqueue a packet without copying it, so that its LC3 frames are
+ * decoded in place. The bytes not decoded yet are copied to the buffer by
+ * release_packet(), which must be called before the data is freed.
+ * Args:
+ *    data - Received packet data bytes.
+ *    corrupted - If the current LC3 packet read is corrupted.
+ * Returns:
+ *    true if enqueued, false if it failed.
+ */
+bool enqueue_packet_in_place(std::span<const uint8_t> data, bool corrupted);
+
+/* Release the packet enqueued in place, copying the bytes not decoded yet to
+ * the buffer. */
+void release_packet();
 
 /* Try to decode LC3 frames from the packets in the buffer.
  * Args:
@@ -184,6 +224,15 @@ size_t encode(int16_t* data, size_t len);
  */
 size_t dequeue_packet(const uint8_t** output);
 
+/* Same as above, handing over the buffer the encoder wrote the packet to, to
+ * be sent without copying it.
+ * Args:
+ *    output - Vector to move the packet data bytes to.
+ * Returns:
+ *    The length of dequeued packet. 0 if failed.
+ */
+size_t dequeue_packet_buffer(std::vector<uint8_t>* output);
+
 /* Get LC3 packets' status record.
  * Returns:
  *      Pointer to the record struct, nullptr if not valid.
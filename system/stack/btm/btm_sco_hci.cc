@@ -22,7 +22,6 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
-#include <cfloat>
 #include <memory>
 
 #include "btif/include/core_callbacks.h"
@@ -30,6 +29,8 @@
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_sco.h"
+#include "stack/btm/sco_packet_ring.h"
+#include "stack/btm/sco_plc.h"
 #include "udrv/include/uipc.h"
 
 #define SCO_DATA_READ_POLL_MS 10
@@ -52,7 +53,6 @@
 #define BTM_PLC_TL 64                             /* 4ms - Template Length for matching */
 #define BTM_PLC_HL (BTM_PLC_WL + BTM_MSBC_FS - 1) /* Length of History buffer required */
 #define BTM_PLC_SBCRL 36                          /* SBC Reconvergence sample Length */
-#define BTM_PLC_OLAL 16                           /* OverLap-Add Length */
 
 /* Disable the PLC when there are more than threshold of lost packets in the
  * window */
@@ -137,14 +137,6 @@ size_t write(const uint8_t* p_buf, uint32_t len) {
   return UIPC_Send(*sco_uipc, UIPC_CH_ID_AV_AUDIO, 0, p_buf, len) ? len : 0;
 }
 
-enum decode_buf_state {
-  DECODE_BUF_EMPTY,
-  DECODE_BUF_FULL,
-
-  // Neither empty nor full.
-  DECODE_BUF_HALFFULL,
-};
-
 namespace wbs {
 
 /* Second octet of H2 header is composed by 4 bits fixed 0x8 and 4 bits
@@ -171,15 +163,6 @@ static const uint8_t btm_msbc_zero_packet[] = {
         /* End of Audio Samples */
         0x00 /* A padding byte defined by mSBC */};
 
-/* Raised Cosine table for OLA */
-static const float rcos[BTM_PLC_OLAL] = {0.99148655f, 0.96623611f, 0.92510857f, 0.86950446f,
-                                         0.80131732f, 0.72286918f, 0.63683150f, 0.54613418f,
-                                         0.45386582f, 0.36316850f, 0.27713082f, 0.19868268f,
-                                         0.13049554f, 0.07489143f, 0.03376389f, 0.00851345f};
-
-static int16_t f_to_s16(float input) {
-  return input > INT16_MAX ? INT16_MAX : input < INT16_MIN ? INT16_MIN : (int16_t)input;
-}
 /* This structure tracks the packet loss for last PLC_WINDOW_SIZE of packets */
 struct tBTM_MSBC_BTM_PLC_WINDOW {
   bool loss_hist[BTM_PLC_WINDOW_SIZE]; /* The packet loss history of receiving
@@ -238,35 +221,11 @@ struct tBTM_MSBC_PLC {
 
   void overlap_add(int16_t* output, float scaler_d, const int16_t* desc, float scaler_a,
                    const int16_t* asc) {
-    for (int i = 0; i < BTM_PLC_OLAL; i++) {
-      output[i] = f_to_s16(scaler_d * desc[i] * rcos[i] +
-                           scaler_a * asc[i] * rcos[BTM_PLC_OLAL - 1 - i]);
-    }
-  }
-
-  float cross_correlation(int16_t* x, int16_t* y) {
-    float sum = 0, x2 = 0, y2 = 0;
-
-    for (int i = 0; i < BTM_PLC_TL; i++) {
-      sum += ((float)x[i]) * y[i];
-      x2 += ((float)x[i]) * x[i];
-      y2 += ((float)y[i]) * y[i];
-    }
-    return sum / sqrtf(x2 * y2);
+    plc::GetKernels().overlap_add(output, scaler_d, desc, scaler_a, asc);
   }
 
   int pattern_match(int16_t* hist) {
-    int best = 0;
-    float cn, max_cn = FLT_MIN;
-
-    for (int i = 0; i < BTM_PLC_WL; i++) {
-      cn = cross_correlation(&hist[BTM_PLC_HL - BTM_PLC_TL], &hist[i]);
-      if (cn > max_cn) {
-        best = i;
-        max_cn = cn;
-      }
-    }
-    return best;
+    return plc::PatternMatch(&hist[BTM_PLC_HL - BTM_PLC_TL], hist, BTM_PLC_WL, BTM_PLC_TL);
   }
 
   float amplitude_match(int16_t* x, int16_t* y) {
@@ -328,9 +287,8 @@ public:
 
         /* Constructs the substitution samples */
         overlap_add(frame_head, 1.0, decoded_buffer, scaler, best_match_hist);
-        for (int i = BTM_PLC_OLAL; i < BTM_MSBC_FS; i++) {
-          hist[BTM_PLC_HL + i] = f_to_s16(scaler * best_match_hist[i]);
-        }
+        plc::GetKernels().scale(&frame_head[BTM_PLC_OLAL], &best_match_hist[BTM_PLC_OLAL], scaler,
+                                BTM_MSBC_FS - BTM_PLC_OLAL);
         overlap_add(&frame_head[BTM_MSBC_FS], scaler, &best_match_hist[BTM_MSBC_FS], 1.0,
                     &best_match_hist[BTM_MSBC_FS]);
 
@@ -398,37 +356,11 @@ struct tBTM_MSBC_INFO {
   size_t packet_size; /* SCO mSBC packet size supported by lower layer */
   size_t buf_size;    /* The size of the buffer, determined by the packet_size. */
 
-  uint8_t* packet_buf;      /* Temporary buffer to store the data */
-  uint8_t* msbc_decode_buf; /* Buffer to store mSBC packets to decode */
-  size_t decode_buf_wo;     /* Write offset of the decode buffer */
-  size_t decode_buf_ro;     /* Read offset of the decode buffer */
-
-  /* Within the circular buffer, which can be visualized as having
-     two halves, mirror indicators track the pointer's location,
-     signaling whether it resides in the first or second segment:
-
-              [buf_size-1] ┼ - - -─┼ [0]
-                           │       │
-                           │       │
-     wo = x, wo_mirror = 0 ^       v ro = x, ro_mirror = 1
-                           │       │
-                           │       │
-                       [0] ┼ - - - ┼ [buf_size-1]
-              (First Half)           (Second Half)
-  */
-  bool decode_buf_wo_mirror; /* The mirror indicator specifies whether
-                                the write pointer is currently located
-                                in the first or second half of the
-                                circular buffer */
-  bool decode_buf_ro_mirror; /* The mirror indicator specifies whether
-                                the read pointer is currently located
-                                in the first or second half of the
-                                circular buffer */
-  bool read_corrupted;       /* If the current mSBC packet read is corrupted */
-
-  uint8_t* msbc_encode_buf; /* Buffer to store the encoded SCO packets */
-  size_t encode_buf_wo;     /* Write offset of the encode buffer */
-  size_t encode_buf_ro;     /* Read offset of the encode buffer */
+  ScoRxRing* decode_buf; /* Buffer of the received SCO packets */
+  bool read_corrupted;   /* If the current mSBC packet read is corrupted */
+
+  ScoTxQueue* encode_buf;                /* Queue of the SCO packets to send */
+  std::vector<uint8_t>* dequeued_packet; /* SCO packet last dequeued by dequeue_packet() */
 
   int16_t decoded_pcm_buf[BTM_MSBC_FS]; /* Buffer to store decoded PCM */
 
@@ -465,13 +397,12 @@ struct tBTM_MSBC_INFO {
 
 public:
   size_t init(size_t pkt_size) {
-    decode_buf_wo = 0;
-    decode_buf_ro = 0;
-    decode_buf_wo_mirror = false;
-    decode_buf_ro_mirror = false;
-
-    encode_buf_wo = 0;
-    encode_buf_ro = 0;
+    if (decode_buf) {
+      decode_buf->Reset();
+    }
+    if (encode_buf) {
+      encode_buf->Reset();
+    }
 
     pkt_size = get_supported_packet_size(pkt_size, &buf_size);
     if (pkt_size == packet_size) {
@@ -479,19 +410,15 @@ public:
     }
     packet_size = pkt_size;
 
-    if (!packet_buf) {
-      packet_buf = (uint8_t*)osi_calloc(BTM_MSBC_PKT_LEN);
-    }
+    delete decode_buf;
+    decode_buf = new ScoRxRing(buf_size, BTM_MSBC_PKT_LEN);
 
-    if (msbc_decode_buf) {
-      osi_free(msbc_decode_buf);
-    }
-    msbc_decode_buf = (uint8_t*)osi_calloc(buf_size);
+    delete encode_buf;
+    encode_buf = new ScoTxQueue(packet_size, buf_size, BTM_MSBC_PKT_LEN);
 
-    if (msbc_encode_buf) {
-      osi_free(msbc_encode_buf);
+    if (!dequeued_packet) {
+      dequeued_packet = new std::vector<uint8_t>();
     }
-    msbc_encode_buf = (uint8_t*)osi_calloc(buf_size);
 
     if (plc) {
       plc->deinit();
@@ -510,15 +437,15 @@ public:
   }
 
   void deinit() {
-    if (msbc_decode_buf) {
-      osi_free(msbc_decode_buf);
-    }
-    if (packet_buf) {
-      osi_free(packet_buf);
-    }
-    if (msbc_encode_buf) {
-      osi_free(msbc_encode_buf);
+    if (decode_buf) {
+      log_ring_stats();
     }
+    delete decode_buf;
+    decode_buf = nullptr;
+    delete encode_buf;
+    encode_buf = nullptr;
+    delete dequeued_packet;
+    dequeued_packet = nullptr;
     if (plc) {
       plc->deinit();
       osi_free_and_reset((void**)&plc);
@@ -528,71 +455,32 @@ public:
     }
   }
 
-  void incr_buf_offset(size_t& offset, bool& mirror, size_t bsize, size_t amount) {
-    if (bsize - offset > amount) {
-      offset += amount;
-      return;
-    }
-
-    mirror = !mirror;
-    offset = amount - (bsize - offset);
-  }
-
-  decode_buf_state decode_buf_status() {
-    if (decode_buf_ro == decode_buf_wo) {
-      if (decode_buf_ro_mirror == decode_buf_wo_mirror) {
-        return DECODE_BUF_EMPTY;
-      }
-      return DECODE_BUF_FULL;
-    }
-    return DECODE_BUF_HALFFULL;
-  }
-
-  size_t decode_buf_data_len() {
-    switch (decode_buf_status()) {
-      case DECODE_BUF_EMPTY:
-        return 0;
-      case DECODE_BUF_FULL:
-        return buf_size;
-      case DECODE_BUF_HALFFULL:
-      default:
-        if (decode_buf_wo > decode_buf_ro) {
-          return decode_buf_wo - decode_buf_ro;
-        }
-        return buf_size - (decode_buf_ro - decode_buf_wo);
-    };
+  void log_ring_stats() {
+    const auto& rx = decode_buf->GetStats();
+    const auto& tx = encode_buf->GetStats();
+    log::info(
+            "{} packets in place/stitched rx={}/{} tx={}/{}, bytes copied rx={} tx={}, "
+            "buffers allocated rx={} tx={}",
+            "mSBC", rx.in_place_pkts, rx.stitched_pkts, tx.in_place_pkts, tx.stitched_pkts,
+            rx.copied_bytes, tx.copied_bytes, rx.allocations, tx.allocations);
   }
 
-  size_t decode_buf_avail_len() { return buf_size - decode_buf_data_len(); }
-
   void mark_pkt_decoded() {
-    if (decode_buf_data_len() < BTM_MSBC_PKT_LEN) {
+    if (decode_buf->DataLen() < BTM_MSBC_PKT_LEN) {
       log::error("Trying to mark read offset beyond write offset.");
       return;
     }
 
-    incr_buf_offset(decode_buf_ro, decode_buf_ro_mirror, buf_size, BTM_MSBC_PKT_LEN);
+    decode_buf->Consume(BTM_MSBC_PKT_LEN);
   }
 
-  size_t write(const std::vector<uint8_t>& input) {
-    if (input.size() > decode_buf_avail_len()) {
-      log::warn(
-              "Cannot write input with size {} into decode_buf with {} empty "
-              "space.",
-              input.size(), decode_buf_avail_len());
-      return 0;
-    }
-
-    if (buf_size - decode_buf_wo > input.size()) {
-      std::copy(input.begin(), input.end(), msbc_decode_buf + decode_buf_wo);
-    } else {
-      std::copy(input.begin(), input.begin() + buf_size - decode_buf_wo,
-                msbc_decode_buf + decode_buf_wo);
-      std::copy(input.begin() + buf_size - decode_buf_wo, input.end(), msbc_decode_buf);
+  /* Enqueues a received SCO packet, which is either copied to the buffer, or
+   * read in place until release_packet() is called. */
+  size_t write(std::span<const uint8_t> input, bool in_place) {
+    if (in_place) {
+      return decode_buf->Borrow(input) ? input.size() : 0;
     }
-
-    incr_buf_offset(decode_buf_wo, decode_buf_wo_mirror, buf_size, input.size());
-    return input.size();
+    return decode_buf->Write(input);
   }
 
   const uint8_t* find_msbc_pkt_head() {
@@ -601,75 +489,48 @@ public:
       return nullptr;
     }
 
+    const ScoRxRing& buf = *decode_buf;
     size_t rp = 0;
-    size_t data_len = decode_buf_data_len();
+    size_t data_len = buf.DataLen();
     while (rp < BTM_MSBC_PKT_LEN && data_len - rp >= BTM_MSBC_PKT_LEN) {
-      if ((msbc_decode_buf[(decode_buf_ro + rp) % buf_size] != BTM_MSBC_H2_HEADER_0) ||
-          (!verify_h2_header_seq_num(msbc_decode_buf[(decode_buf_ro + rp + 1) % buf_size])) ||
-          (msbc_decode_buf[(decode_buf_ro + rp + 2) % buf_size] != BTM_MSBC_SYNC_WORD)) {
+      if ((buf[rp] != BTM_MSBC_H2_HEADER_0) || (!verify_h2_header_seq_num(buf[rp + 1])) ||
+          (buf[rp + 2] != BTM_MSBC_SYNC_WORD)) {
         rp++;
         continue;
       }
 
       if (rp != 0) {
-        log::warn("Skipped {} bytes of mSBC data ahead of a valid mSBC frame", (unsigned long)rp);
-        incr_buf_offset(decode_buf_ro, decode_buf_ro_mirror, buf_size, rp);
-      }
-
-      // Get the frame head.
-      if (buf_size - decode_buf_ro >= BTM_MSBC_PKT_LEN) {
-        return &msbc_decode_buf[decode_buf_ro];
+        log::warn("Skipped {} bytes of mSBC data ahead of a valid mSBC frame",
+                  (unsigned long)rp);
+        decode_buf->Consume(rp);
       }
 
-      std::copy(msbc_decode_buf + decode_buf_ro, msbc_decode_buf + buf_size, packet_buf);
-      std::copy(msbc_decode_buf, msbc_decode_buf + BTM_MSBC_PKT_LEN - (buf_size - decode_buf_ro),
-                packet_buf + (buf_size - decode_buf_ro));
-      return packet_buf;
+      // Get the frame head, in place unless it wraps around the buffer.
+      return decode_buf->Peek();
     }
 
     return nullptr;
   }
 
-  /* Fill in the mSBC header and update the buffer's write offset to guard the
-   * buffer space to be written. Return a pointer to the start of mSBC packet's
-   * body for the caller to fill the encoded mSBC data if there is enough space
-   * in the buffer to fill in a new packet, otherwise return a nullptr. */
+  /* Fill in the mSBC header and reserve the space of the packet in the
+   * outbound SCO packets. Return a pointer to the start of mSBC packet's
+   * body for the caller to fill the encoded mSBC data if there is enough
+   * space in the queue to fill in a new packet, otherwise return a nullptr. The
+   * packet is queued by commit_msbc_pkt(). */
   uint8_t* fill_msbc_pkt_template() {
-    uint8_t* wp = &msbc_encode_buf[encode_buf_wo];
-    if (buf_size - encode_buf_wo < BTM_MSBC_PKT_LEN) {
-      log::debug("Packet queue can't accommodate more packets.");
+    uint8_t* wp = encode_buf->Reserve();
+    if (wp == nullptr) {
       return nullptr;
     }
 
     wp[0] = BTM_MSBC_H2_HEADER_0;
     wp[1] = btm_h2_header_frames_count[num_encoded_msbc_pkts % 4];
-    encode_buf_wo += BTM_MSBC_PKT_LEN;
 
     num_encoded_msbc_pkts++;
     return wp + BTM_MSBC_H2_HEADER_LEN;
   }
 
-  size_t mark_pkt_dequeued() {
-    if (encode_buf_wo - encode_buf_ro < packet_size) {
-      return 0;
-    }
-
-    encode_buf_ro += packet_size;
-    if (encode_buf_ro == encode_buf_wo) {
-      encode_buf_ro = 0;
-      encode_buf_wo = 0;
-    }
-
-    return packet_size;
-  }
-
-  const uint8_t* sco_pkt_read_ptr() {
-    if (encode_buf_wo - encode_buf_ro < packet_size) {
-      return nullptr;
-    }
-
-    return &msbc_encode_buf[encode_buf_ro];
-  }
+  void commit_msbc_pkt() { encode_buf->Commit(); }
 };
 
 static tBTM_MSBC_INFO* msbc_info = nullptr;
@@ -714,7 +575,7 @@ bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio) {
   return true;
 }
 
-bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
+static bool enqueue(std::span<const uint8_t> data, bool corrupted, bool in_place) {
   if (msbc_info == nullptr) {
     log::warn("mSBC buffer uninitialized or cleaned");
     return false;
@@ -729,13 +590,29 @@ bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
   }
 
   msbc_info->read_corrupted |= corrupted;
-  if (msbc_info->write(data) != data.size()) {
+  if (msbc_info->write(data, in_place) != data.size()) {
     return false;
   }
 
   return true;
 }
 
+bool enqueue_packet(std::span<const uint8_t> data, bool corrupted) {
+  return enqueue(data, corrupted, false);
+}
+
+bool enqueue_packet_in_place(std::span<const uint8_t> data, bool corrupted) {
+  return enqueue(data, corrupted, true);
+}
+
+void release_packet() {
+  if (msbc_info == nullptr) {
+    return;
+  }
+
+  msbc_info->decode_buf->Release();
+}
+
 size_t decode(const uint8_t** out_data) {
   const uint8_t* frame_head = nullptr;
 
@@ -749,7 +626,7 @@ size_t decode(const uint8_t** out_data) {
     return 0;
   }
 
-  if (msbc_info->decode_buf_data_len() < BTM_MSBC_PKT_LEN) {
+  if (msbc_info->decode_buf->DataLen() < BTM_MSBC_PKT_LEN) {
     return 0;
   }
 
@@ -807,6 +684,7 @@ size_t encode(int16_t* data, size_t len) {
     std::copy(&btm_msbc_zero_packet[BTM_MSBC_H2_HEADER_LEN], std::end(btm_msbc_zero_packet),
               pkt_body);
   }
+  msbc_info->commit_msbc_pkt();
 
   return BTM_MSBC_CODE_SIZE;
 }
@@ -822,12 +700,23 @@ size_t dequeue_packet(const uint8_t** output) {
     return 0;
   }
 
-  *output = msbc_info->sco_pkt_read_ptr();
-  if (*output == nullptr) {
+  size_t len = msbc_info->encode_buf->Pop(msbc_info->dequeued_packet);
+  *output = len != 0 ? msbc_info->dequeued_packet->data() : nullptr;
+  return len;
+}
+
+size_t dequeue_packet_buffer(std::vector<uint8_t>* output) {
+  if (msbc_info == nullptr) {
+    log::warn("mSBC buffer uninitialized or cleaned");
+    return 0;
+  }
+
+  if (output == nullptr) {
+    log::warn("Invalid output pointer");
     return 0;
   }
 
-  return msbc_info->mark_pkt_dequeued();
+  return msbc_info->encode_buf->Pop(output);
 }
 
 tBTM_SCO_PKT_STATUS* get_pkt_status() {
@@ -861,37 +750,11 @@ struct tBTM_LC3_INFO {
   size_t packet_size; /* SCO LC3 packet size supported by lower layer */
   size_t buf_size;    /* The size of the buffer, determined by the packet_size. */
 
-  uint8_t* packet_buf;     /* Temporary buffer to store the data */
-  uint8_t* lc3_decode_buf; /* Buffer to store LC3 packets to decode */
-  size_t decode_buf_wo;    /* Write offset of the decode buffer */
-  size_t decode_buf_ro;    /* Read offset of the decode buffer */
-
-  /* Within the circular buffer, which can be visualized as having
-     two halves, mirror indicators track the pointer's location,
-     signaling whether it resides in the first or second segment:
-
-              [buf_size-1] ┼ - - -─┼ [0]
-                           │       │
-                           │       │
-     wo = x, wo_mirror = 0 ^       v ro = x, ro_mirror = 1
-                           │       │
-                           │       │
-                       [0] ┼ - - - ┼ [buf_size-1]
-              (First Half)           (Second Half)
-  */
-  bool decode_buf_wo_mirror; /* The mirror indicator specifies whether
-                                the write pointer is currently located
-                                in the first or second half of the
-                                circular buffer */
-  bool decode_buf_ro_mirror; /* The mirror indicator specifies whether
-                                the read pointer is currently located
-                                in the first or second half of the
-                                circular buffer */
-  bool read_corrupted;       /* If the current LC3 packet read is corrupted */
-
-  uint8_t* lc3_encode_buf; /* Buffer to store the encoded SCO packets */
-  size_t encode_buf_wo;    /* Write offset of the encode buffer */
-  size_t encode_buf_ro;    /* Read offset of the encode buffer */
+  ScoRxRing* decode_buf; /* Buffer of the received SCO packets */
+  bool read_corrupted;   /* If the current LC3 packet read is corrupted */
+
+  ScoTxQueue* encode_buf;                /* Queue of the SCO packets to send */
+  std::vector<uint8_t>* dequeued_packet; /* SCO packet last dequeued by dequeue_packet() */
 
   int16_t decoded_pcm_buf[BTM_LC3_FS]; /* Buffer to store decoded PCM */
 
@@ -928,13 +791,12 @@ struct tBTM_LC3_INFO {
 
 public:
   size_t init(size_t pkt_size) {
-    decode_buf_wo = 0;
-    decode_buf_ro = 0;
-    decode_buf_wo_mirror = false;
-    decode_buf_ro_mirror = false;
-
-    encode_buf_wo = 0;
-    encode_buf_ro = 0;
+    if (decode_buf) {
+      decode_buf->Reset();
+    }
+    if (encode_buf) {
+      encode_buf->Reset();
+    }
 
     pkt_size = get_supported_packet_size(pkt_size, &buf_size);
     if (pkt_size == packet_size) {
@@ -942,19 +804,15 @@ public:
     }
     packet_size = pkt_size;
 
-    if (!packet_buf) {
-      packet_buf = (uint8_t*)osi_calloc(BTM_LC3_PKT_LEN);
-    }
+    delete decode_buf;
+    decode_buf = new ScoRxRing(buf_size, BTM_LC3_PKT_LEN);
 
-    if (lc3_decode_buf) {
-      osi_free(lc3_decode_buf);
-    }
-    lc3_decode_buf = (uint8_t*)osi_calloc(buf_size);
+    delete encode_buf;
+    encode_buf = new ScoTxQueue(packet_size, buf_size, BTM_LC3_PKT_LEN);
 
-    if (lc3_encode_buf) {
-      osi_free(lc3_encode_buf);
+    if (!dequeued_packet) {
+      dequeued_packet = new std::vector<uint8_t>();
     }
-    lc3_encode_buf = (uint8_t*)osi_calloc(buf_size);
 
     if (pkt_status) {
       osi_free(pkt_status);
@@ -966,100 +824,46 @@ public:
   }
 
   void deinit() {
-    if (lc3_decode_buf) {
-      osi_free(lc3_decode_buf);
-    }
-    if (packet_buf) {
-      osi_free(packet_buf);
-    }
-    if (lc3_encode_buf) {
-      osi_free(lc3_encode_buf);
+    if (decode_buf) {
+      log_ring_stats();
     }
+    delete decode_buf;
+    decode_buf = nullptr;
+    delete encode_buf;
+    encode_buf = nullptr;
+    delete dequeued_packet;
+    dequeued_packet = nullptr;
     if (pkt_status) {
       osi_free_and_reset((void**)&pkt_status);
     }
   }
 
-  void incr_buf_offset(size_t& offset, bool& mirror, size_t bsize, size_t amount) {
-    if (bsize - offset > amount) {
-      offset += amount;
-      return;
-    }
-
-    mirror = !mirror;
-    offset = amount - (bsize - offset);
-  }
-
-  decode_buf_state decode_buf_status() {
-    if (decode_buf_ro == decode_buf_wo) {
-      if (decode_buf_ro_mirror == decode_buf_wo_mirror) {
-        return DECODE_BUF_EMPTY;
-      }
-      return DECODE_BUF_FULL;
-    }
-    return DECODE_BUF_HALFFULL;
-  }
-
-  size_t decode_buf_data_len() {
-    switch (decode_buf_status()) {
-      case DECODE_BUF_EMPTY:
-        return 0;
-      case DECODE_BUF_FULL:
-        return buf_size;
-      case DECODE_BUF_HALFFULL:
-      default:
-        if (decode_buf_wo > decode_buf_ro) {
-          return decode_buf_wo - decode_buf_ro;
-        }
-        return buf_size - (decode_buf_ro - decode_buf_wo);
-    };
-  }
-
-  size_t decode_buf_avail_len() { return buf_size - decode_buf_data_len(); }
-
-  uint8_t* fill_lc3_pkt_template() {
-    uint8_t* wp = &lc3_encode_buf[encode_buf_wo];
-    if (buf_size - encode_buf_wo < BTM_LC3_PKT_LEN) {
-      log::debug("Packet queue can't accommodate more packets.");
-      return nullptr;
-    }
-
-    wp[0] = BTM_LC3_H2_HEADER_0;
-    wp[1] = btm_h2_header_frames_count[num_encoded_lc3_pkts % 4];
-    encode_buf_wo += BTM_LC3_PKT_LEN;
-
-    num_encoded_lc3_pkts++;
-    return wp + BTM_LC3_H2_HEADER_LEN;
+  void log_ring_stats() {
+    const auto& rx = decode_buf->GetStats();
+    const auto& tx = encode_buf->GetStats();
+    log::info(
+            "{} packets in place/stitched rx={}/{} tx={}/{}, bytes copied rx={} tx={}, "
+            "buffers allocated rx={} tx={}",
+            "LC3", rx.in_place_pkts, rx.stitched_pkts, tx.in_place_pkts, tx.stitched_pkts,
+            rx.copied_bytes, tx.copied_bytes, rx.allocations, tx.allocations);
   }
 
   void mark_pkt_decoded() {
-    if (decode_buf_data_len() < BTM_LC3_PKT_LEN) {
+    if (decode_buf->DataLen() < BTM_LC3_PKT_LEN) {
       log::error("Trying to mark read offset beyond write offset.");
       return;
     }
 
-    incr_buf_offset(decode_buf_ro, decode_buf_ro_mirror, buf_size, BTM_LC3_PKT_LEN);
+    decode_buf->Consume(BTM_LC3_PKT_LEN);
   }
 
-  size_t write(const std::vector<uint8_t>& input) {
-    if (input.size() > decode_buf_avail_len()) {
-      log::warn(
-              "Cannot write input with size {} into decode_buf with {} empty "
-              "space.",
-              input.size(), decode_buf_avail_len());
-      return 0;
+  /* Enqueues a received SCO packet, which is either copied to the buffer, or
+   * read in place until release_packet() is called. */
+  size_t write(std::span<const uint8_t> input, bool in_place) {
+    if (in_place) {
+      return decode_buf->Borrow(input) ? input.size() : 0;
     }
-
-    if (buf_size - decode_buf_wo > input.size()) {
-      std::copy(input.begin(), input.end(), lc3_decode_buf + decode_buf_wo);
-    } else {
-      std::copy(input.begin(), input.begin() + buf_size - decode_buf_wo,
-                lc3_decode_buf + decode_buf_wo);
-      std::copy(input.begin() + buf_size - decode_buf_wo, input.end(), lc3_decode_buf);
-    }
-
-    incr_buf_offset(decode_buf_wo, decode_buf_wo_mirror, buf_size, input.size());
-    return input.size();
+    return decode_buf->Write(input);
   }
 
   const uint8_t* find_lc3_pkt_head() {
@@ -1068,55 +872,47 @@ public:
       return nullptr;
     }
 
+    const ScoRxRing& buf = *decode_buf;
     size_t rp = 0;
-    size_t data_len = decode_buf_data_len();
+    size_t data_len = buf.DataLen();
     while (rp < BTM_LC3_PKT_LEN && data_len - rp >= BTM_LC3_PKT_LEN) {
-      if ((lc3_decode_buf[(decode_buf_ro + rp) % buf_size] != BTM_LC3_H2_HEADER_0) ||
-          !verify_h2_header_seq_num(lc3_decode_buf[(decode_buf_ro + rp + 1) % buf_size])) {
+      if ((buf[rp] != BTM_LC3_H2_HEADER_0) || !verify_h2_header_seq_num(buf[rp + 1])) {
         rp++;
         continue;
       }
 
       if (rp != 0) {
-        log::warn("Skipped {} bytes of LC3 data ahead of a valid LC3 frame", (unsigned long)rp);
-        incr_buf_offset(decode_buf_ro, decode_buf_ro_mirror, buf_size, rp);
+        log::warn("Skipped {} bytes of LC3 data ahead of a valid LC3 frame",
+                  (unsigned long)rp);
+        decode_buf->Consume(rp);
       }
 
-      // Get the frame head.
-      if (buf_size - decode_buf_ro >= BTM_LC3_PKT_LEN) {
-        return &lc3_decode_buf[decode_buf_ro];
-      }
-
-      std::copy(lc3_decode_buf + decode_buf_ro, lc3_decode_buf + buf_size, packet_buf);
-      std::copy(lc3_decode_buf, lc3_decode_buf + BTM_LC3_PKT_LEN - (buf_size - decode_buf_ro),
-                packet_buf + (buf_size - decode_buf_ro));
-      return packet_buf;
+      // Get the frame head, in place unless it wraps around the buffer.
+      return decode_buf->Peek();
     }
 
     return nullptr;
   }
 
-  size_t mark_pkt_dequeued() {
-    if (encode_buf_wo - encode_buf_ro < packet_size) {
-      return 0;
+  /* Fill in the LC3 header and reserve the space of the packet in the
+   * outbound SCO packets. Return a pointer to the start of LC3 packet's
+   * body for the caller to fill the encoded LC3 data if there is enough
+   * space in the queue to fill in a new packet, otherwise return a nullptr. The
+   * packet is queued by commit_lc3_pkt(). */
+  uint8_t* fill_lc3_pkt_template() {
+    uint8_t* wp = encode_buf->Reserve();
+    if (wp == nullptr) {
+      return nullptr;
     }
 
-    encode_buf_ro += packet_size;
-    if (encode_buf_ro == encode_buf_wo) {
-      encode_buf_ro = 0;
-      encode_buf_wo = 0;
-    }
+    wp[0] = BTM_LC3_H2_HEADER_0;
+    wp[1] = btm_h2_header_frames_count[num_encoded_lc3_pkts % 4];
 
-    return packet_size;
+    num_encoded_lc3_pkts++;
+    return wp + BTM_LC3_H2_HEADER_LEN;
   }
 
-  const uint8_t* sco_pkt_read_ptr() {
-    if (encode_buf_wo - encode_buf_ro < packet_size) {
-      return nullptr;
-    }
-
-    return &lc3_encode_buf[encode_buf_ro];
-  }
+  void commit_lc3_pkt() { encode_buf->Commit(); }
 };
 
 static tBTM_LC3_INFO* lc3_info;
@@ -1167,7 +963,7 @@ bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio) {
   return true;
 }
 
-bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
+static bool enqueue(std::span<const uint8_t> data, bool corrupted, bool in_place) {
   if (lc3_info == nullptr) {
     log::warn("LC3 buffer uninitialized or cleaned");
     return false;
@@ -1182,13 +978,29 @@ bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
   }
 
   lc3_info->read_corrupted |= corrupted;
-  if (lc3_info->write(data) != data.size()) {
+  if (lc3_info->write(data, in_place) != data.size()) {
     return false;
   }
 
   return true;
 }
 
+bool enqueue_packet(std::span<const uint8_t> data, bool corrupted) {
+  return enqueue(data, corrupted, false);
+}
+
+bool enqueue_packet_in_place(std::span<const uint8_t> data, bool corrupted) {
+  return enqueue(data, corrupted, true);
+}
+
+void release_packet() {
+  if (lc3_info == nullptr) {
+    return;
+  }
+
+  lc3_info->decode_buf->Release();
+}
+
 size_t decode(const uint8_t** out_data) {
   const uint8_t* frame_head = nullptr;
 
@@ -1202,7 +1014,7 @@ size_t decode(const uint8_t** out_data) {
     return 0;
   }
 
-  if (lc3_info->decode_buf_data_len() < BTM_LC3_PKT_LEN) {
+  if (lc3_info->decode_buf->DataLen() < BTM_LC3_PKT_LEN) {
     return 0;
   }
 
@@ -1243,7 +1055,9 @@ size_t encode(int16_t* data, size_t len) {
     return 0;
   }
 
-  return GetInterfaceToProfiles()->lc3Codec->encodePacket(data, pkt_body);
+  size_t encoded_size = GetInterfaceToProfiles()->lc3Codec->encodePacket(data, pkt_body);
+  lc3_info->commit_lc3_pkt();
+  return encoded_size;
 }
 
 size_t dequeue_packet(const uint8_t** output) {
@@ -1257,12 +1071,23 @@ size_t dequeue_packet(const uint8_t** output) {
     return 0;
   }
 
-  *output = lc3_info->sco_pkt_read_ptr();
-  if (*output == nullptr) {
+  size_t len = lc3_info->encode_buf->Pop(lc3_info->dequeued_packet);
+  *output = len != 0 ? lc3_info->dequeued_packet->data() : nullptr;
+  return len;
+}
+
+size_t dequeue_packet_buffer(std::vector<uint8_t>* output) {
+  if (lc3_info == nullptr) {
+    log::warn("LC3 buffer uninitialized or cleaned");
+    return 0;
+  }
+
+  if (output == nullptr) {
+    log::warn("Invalid output pointer");
     return 0;
   }
 
-  return lc3_info->mark_pkt_dequeued();
+  return lc3_info->encode_buf->Pop(output);
 }
 
 tBTM_SCO_PKT_STATUS* get_pkt_status() {
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "sco_hci"
+
+#include "stack/btm/sco_packet_ring.h"
+
+#include <bluetooth/log.h>
+
+#include <algorithm>
+
+namespace bluetooth::audio::sco {
+
+ScoRxRing::ScoRxRing(size_t buf_size, size_t pkt_len)
+    : buf_(buf_size), ro_(0), len_(0), scratch_(pkt_len), stats_{} {
+  stats_.allocations = 2;
+}
+
+size_t ScoRxRing::Write(std::span<const uint8_t> data) {
+  if (data.size() > AvailLen()) {
+    log::warn("Cannot write input with size {} into decode_buf with {} empty space.", data.size(),
+              AvailLen());
+    return 0;
+  }
+
+  /* Data can't be buffered behind borrowed data */
+  Release();
+  Append(data);
+  return data.size();
+}
+
+bool ScoRxRing::Borrow(std::span<const uint8_t> data) {
+  if (data.size() > AvailLen()) {
+    log::warn("Cannot write input with size {} into decode_buf with {} empty space.", data.size(),
+              AvailLen());
+    return false;
+  }
+
+  Release();
+  borrowed_ = data;
+  return true;
+}
+
+void ScoRxRing::Release() {
+  if (borrowed_.empty()) {
+    return;
+  }
+
+  Append(borrowed_);
+  borrowed_ = {};
+}
+
+void ScoRxRing::Reset() {
+  ro_ = 0;
+  len_ = 0;
+  borrowed_ = {};
+}
+
+const uint8_t* ScoRxRing::Peek() {
+  size_t pkt_len = scratch_.size();
+  log::assert_that(DataLen() >= pkt_len, "Peeking {} bytes out of {}", pkt_len, DataLen());
+
+  if (len_ == 0) {
+    stats_.in_place_pkts++;
+    return borrowed_.data();
+  }
+  if (len_ >= pkt_len && buf_.size() - ro_ >= pkt_len) {
+    stats_.in_place_pkts++;
+    return &buf_[ro_];
+  }
+  if (len_ < pkt_len) {
+    /* The packet is split across the buffer and the borrowed data, complete it
+     * in the buffer. */
+    size_t len = pkt_len - len_;
+    Append(borrowed_.first(len));
+    borrowed_ = borrowed_.subspan(len);
+  }
+  stats_.stitched_pkts++;
+
+  size_t first = buf_.size() - ro_;
+  if (first >= pkt_len) {
+    return &buf_[ro_];
+  }
+
+  /* The packet wraps around the end of the buffer */
+  std::copy_n(&buf_[ro_], first, scratch_.begin());
+  std::copy_n(buf_.begin(), pkt_len - first, scratch_.begin() + first);
+  stats_.copied_bytes += pkt_len;
+  return scratch_.data();
+}
+
+void ScoRxRing::Append(std::span<const uint8_t> data) {
+  size_t wo = (ro_ + len_) % buf_.size();
+  size_t first = std::min(data.size(), buf_.size() - wo);
+  std::copy(data.begin(), data.begin() + first, buf_.begin() + wo);
+  std::copy(data.begin() + first, data.end(), buf_.begin());
+  len_ += data.size();
+  stats_.copied_bytes += data.size();
+}
+
+void ScoRxRing::Consume(size_t len) {
+  log::assert_that(len <= DataLen(), "Consuming {} bytes out of {}", len, DataLen());
+
+  size_t from_buf = std::min(len, len_);
+  ro_ = (ro_ + from_buf) % buf_.size();
+  len_ -= from_buf;
+  borrowed_ = borrowed_.subspan(len - from_buf);
+
+  if (len_ == 0) {
+    ro_ = 0;
+  }
+}
+
+ScoTxQueue::ScoTxQueue(size_t packet_size, size_t capacity, size_t pkt_len)
+    : packet_size_(packet_size),
+      capacity_(capacity),
+      pkt_len_(pkt_len),
+      /* A partially written packet on each side of the queued data */
+      packets_((capacity + packet_size - 1) / packet_size + 2),
+      head_(0),
+      tail_(0),
+      num_packets_(0),
+      tail_len_(0),
+      queued_len_(0),
+      reserved_in_place_(false),
+      scratch_(pkt_len),
+      stats_{} {
+  stats_.allocations = 2;
+}
+
+void ScoTxQueue::PushPacket() {
+  if (num_packets_++ != 0 && ++tail_ == packets_.size()) {
+    tail_ = 0;
+  }
+  packets_[tail_] = std::vector<uint8_t>(packet_size_);
+  tail_len_ = 0;
+  stats_.allocations++;
+}
+
+uint8_t* ScoTxQueue::Reserve() {
+  if (capacity_ - queued_len_ < pkt_len_) {
+    log::debug("Packet queue can't accommodate more packets.");
+    return nullptr;
+  }
+
+  if (num_packets_ == 0 || tail_len_ == packet_size_) {
+    PushPacket();
+  }
+
+  reserved_in_place_ = packet_size_ - tail_len_ >= pkt_len_;
+  return reserved_in_place_ ? &packets_[tail_][tail_len_] : scratch_.data();
+}
+
+void ScoTxQueue::Commit() {
+  queued_len_ += pkt_len_;
+
+  if (reserved_in_place_) {
+    tail_len_ += pkt_len_;
+    stats_.in_place_pkts++;
+    return;
+  }
+
+  size_t copied = 0;
+  while (copied < pkt_len_) {
+    if (tail_len_ == packet_size_) {
+      PushPacket();
+    }
+    size_t len = std::min(pkt_len_ - copied, packet_size_ - tail_len_);
+    std::copy_n(&scratch_[copied], len, &packets_[tail_][tail_len_]);
+    tail_len_ += len;
+    copied += len;
+  }
+  stats_.stitched_pkts++;
+  stats_.copied_bytes += pkt_len_;
+}
+
+bool ScoTxQueue::FrontIsComplete() const {
+  return num_packets_ > 1 || (num_packets_ == 1 && tail_len_ == packet_size_);
+}
+
+const uint8_t* ScoTxQueue::Front() const {
+  return FrontIsComplete() ? packets_[head_].data() : nullptr;
+}
+
+size_t ScoTxQueue::Pop(std::vector<uint8_t>* packet) {
+  if (!FrontIsComplete()) {
+    return 0;
+  }
+
+  if (packet != nullptr) {
+    /* Hand the buffer over, a new one is allocated for the next packet */
+    *packet = std::move(packets_[head_]);
+  }
+  packets_[head_].clear();
+  if (--num_packets_ == 0) {
+    tail_ = head_;
+    tail_len_ = 0;
+    queued_len_ = 0;
+  } else {
+    head_ = head_ + 1 == packets_.size() ? 0 : head_ + 1;
+    queued_len_ -= std::min(queued_len_, packet_size_);
+  }
+  return packet_size_;
+}
+
+void ScoTxQueue::Reset() {
+  for (auto& packet : packets_) {
+    packet.clear();
+  }
+  head_ = 0;
+  tail_ = 0;
+  num_packets_ = 0;
+  tail_len_ = 0;
+  queued_len_ = 0;
+}
+
+}  // namespace bluetooth::audio::sco
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bluetooth::audio::sco {
+
+/* Copies and allocations done by the SCO packet buffers, for the dumpsys */
+struct ScoPacketRingStats {
+  uint64_t in_place_pkts;  /* Codec packets read or written in place */
+  uint64_t stitched_pkts;  /* Codec packets split across buffers, and copied */
+  uint64_t copied_bytes;   /* Bytes copied from or to the HCI payloads */
+  uint64_t allocations;    /* Buffers allocated */
+};
+
+/* Buffer of the SCO data received over HCI, from which the codec packets of
+ * |pkt_len| bytes are read. The HCI payloads are either copied to the buffer,
+ * or read in place until they are released, in which case only the bytes not
+ * read yet are copied. */
+class ScoRxRing {
+public:
+  ScoRxRing(size_t buf_size, size_t pkt_len);
+
+  /* Copies |data| to the buffer. Returns the number of bytes written, 0 when
+   * they don't fit. */
+  size_t Write(std::span<const uint8_t> data);
+
+  /* Appends |data| to the buffered data without copying it. |data| must stay
+   * valid until Release() is called. Returns false when the bytes couldn't be
+   * copied to the buffer when released. */
+  bool Borrow(std::span<const uint8_t> data);
+
+  /* Copies the bytes of the borrowed data not read yet to the buffer */
+  void Release();
+
+  /* Drops all the data */
+  void Reset();
+
+  size_t DataLen() const { return len_ + borrowed_.size(); }
+  size_t AvailLen() const { return buf_.size() - DataLen(); }
+
+  /* Byte at |offset| from the read position, which is below DataLen() */
+  uint8_t operator[](size_t offset) const {
+    return offset < len_ ? buf_[(ro_ + offset) % buf_.size()] : borrowed_[offset - len_];
+  }
+
+  /* Returns the codec packet at the read position. A packet split between the
+   * buffer and the borrowed data is completed in the buffer, and one wrapping
+   * around the end of the buffer is copied. Requires DataLen() >= pkt_len. The
+   * pointer is valid until the buffer is modified. */
+  const uint8_t* Peek();
+
+  /* Advances the read position by |len| bytes */
+  void Consume(size_t len);
+
+  const ScoPacketRingStats& GetStats() const { return stats_; }
+
+private:
+  /* Copies |data| behind the buffered data */
+  void Append(std::span<const uint8_t> data);
+
+  std::vector<uint8_t> buf_;
+  size_t ro_;  /* Read offset in |buf_| */
+  size_t len_; /* Number of bytes in |buf_|, ahead of |borrowed_| */
+  std::span<const uint8_t> borrowed_;
+  std::vector<uint8_t> scratch_;
+  ScoPacketRingStats stats_;
+};
+
+/* Queue of the SCO packets of |packet_size| bytes to send over HCI, into which
+ * the codec packets of |pkt_len| bytes are written. Each SCO packet is
+ * allocated as the buffer handed to HCI, and the codec packets are written to
+ * it in place unless they are split across two SCO packets. At most
+ * |capacity| bytes are queued. */
+class ScoTxQueue {
+public:
+  ScoTxQueue(size_t packet_size, size_t capacity, size_t pkt_len);
+
+  /* Returns where to write the next codec packet, or nullptr when the queue is
+   * full. The packet is queued by Commit(). */
+  uint8_t* Reserve();
+  void Commit();
+
+  /* Returns the next complete SCO packet, or nullptr when there is none */
+  const uint8_t* Front() const;
+
+  /* Removes the next complete SCO packet, handing its buffer to |packet| when
+   * not null. Returns the size of the packet, 0 when there is none. */
+  size_t Pop(std::vector<uint8_t>* packet = nullptr);
+
+  void Reset();
+
+  size_t packet_size() const { return packet_size_; }
+
+  const ScoPacketRingStats& GetStats() const { return stats_; }
+
+private:
+  bool FrontIsComplete() const;
+  /* Allocates the buffer of a new packet at the tail */
+  void PushPacket();
+
+  const size_t packet_size_;
+  const size_t capacity_;
+  const size_t pkt_len_;
+
+  std::vector<std::vector<uint8_t>> packets_; /* Circular, from |head_| to |tail_| */
+  size_t head_;
+  size_t tail_;
+  size_t num_packets_;
+  size_t tail_len_;   /* Bytes written to the last packet */
+  size_t queued_len_; /* Bytes written to all the packets */
+  bool reserved_in_place_;
+  std::vector<uint8_t> scratch_;
+  ScoPacketRingStats stats_;
+};
+
+}  // namespace bluetooth::audio::sco
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "sco_plc"
+
+#include "stack/btm/sco_plc.h"
+
+#include <bluetooth/log.h>
+#include <math.h>
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using bluetooth::audio::sco::plc::Kernels;
+
+/* Raised Cosine table for OLA */
+const float rcos[BTM_PLC_OLAL] = {0.99148655f, 0.96623611f, 0.92510857f, 0.86950446f,
+                                  0.80131732f, 0.72286918f, 0.63683150f, 0.54613418f,
+                                  0.45386582f, 0.36316850f, 0.27713082f, 0.19868268f,
+                                  0.13049554f, 0.07489143f, 0.03376389f, 0.00851345f};
+
+/* The same table in reverse order, for the ascending half of the OLA */
+const float rcos_rev[BTM_PLC_OLAL] = {0.00851345f, 0.03376389f, 0.07489143f, 0.13049554f,
+                                      0.19868268f, 0.27713082f, 0.36316850f, 0.45386582f,
+                                      0.54613418f, 0.63683150f, 0.72286918f, 0.80131732f,
+                                      0.86950446f, 0.92510857f, 0.96623611f, 0.99148655f};
+
+int16_t f_to_s16(float input) {
+  return input > INT16_MAX ? INT16_MAX : input < INT16_MIN ? INT16_MIN : (int16_t)input;
+}
+
+/*
+ * Scalar kernels. The products of the OLA are kept in separate statements so
+ * that they are not contracted into fused multiply-adds, which the SIMD
+ * kernels do not use either.
+ */
+
+void cross_correlate_scalar(const int16_t* tmpl, const int16_t* hist, int num_lags, int len,
+                            int64_t* corr) {
+  for (int lag = 0; lag < num_lags; lag++) {
+    int64_t sum = 0;
+    for (int i = 0; i < len; i++) {
+      sum += (int32_t)tmpl[i] * hist[lag + i];
+    }
+    corr[lag] = sum;
+  }
+}
+
+void overlap_add_scalar(int16_t* output, float scaler_d, const int16_t* desc, float scaler_a,
+                        const int16_t* asc) {
+  for (int i = 0; i < BTM_PLC_OLAL; i++) {
+    float d = scaler_d * desc[i];
+    d = d * rcos[i];
+    float a = scaler_a * asc[i];
+    a = a * rcos_rev[i];
+    output[i] = f_to_s16(d + a);
+  }
+}
+
+void scale_scalar(int16_t* output, const int16_t* input, float scaler, int len) {
+  for (int i = 0; i < len; i++) {
+    output[i] = f_to_s16(scaler * input[i]);
+  }
+}
+
+const Kernels scalar_kernels = {"scalar", cross_correlate_scalar, overlap_add_scalar, scale_scalar};
+
+#if defined(__x86_64__)
+
+/*
+ * x86 SSE2 kernels, SSE2 being part of x86-64. The cross-correlation also has
+ * an AVX2 kernel, used when the CPU supports it.
+ */
+
+/* Sign extends the low and high halves of 8 samples to 32 bits. */
+inline __m128i s16_lo_to_s32(__m128i x) { return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16); }
+inline __m128i s16_hi_to_s32(__m128i x) { return _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16); }
+
+/* Saturates and truncates 4 floats the way f_to_s16() does. */
+inline __m128i f_to_s32_sat(__m128 x) {
+  x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(INT16_MIN)), _mm_set1_ps(INT16_MAX));
+  return _mm_cvttps_epi32(x);
+}
+
+void cross_correlate_sse2(const int16_t* tmpl, const int16_t* hist, int num_lags, int len,
+                          int64_t* corr) {
+  for (int lag = 0; lag < num_lags; lag++) {
+    __m128i acc = _mm_setzero_si128();
+    for (int i = 0; i < len; i += 8) {
+      __m128i x = _mm_loadu_si128((const __m128i*)(tmpl + i));
+      __m128i y = _mm_loadu_si128((const __m128i*)(hist + lag + i));
+
+      /* Each pair of products fits in 32 bits, see PatternMatch() */
+      __m128i p = _mm_madd_epi16(x, y);
+      __m128i sign = _mm_srai_epi32(p, 31);
+      acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(p, sign));
+      acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(p, sign));
+    }
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+    corr[lag] = _mm_cvtsi128_si64(acc);
+  }
+}
+
+__attribute__((target("avx2"))) void cross_correlate_avx2(const int16_t* tmpl,
+                                                          const int16_t* hist, int num_lags,
+                                                          int len, int64_t* corr) {
+  for (int lag = 0; lag < num_lags; lag++) {
+    __m256i acc = _mm256_setzero_si256();
+    for (int i = 0; i < len; i += 16) {
+      __m256i x = _mm256_loadu_si256((const __m256i*)(tmpl + i));
+      __m256i y = _mm256_loadu_si256((const __m256i*)(hist + lag + i));
+
+      __m256i p = _mm256_madd_epi16(x, y);
+      acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+      acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+    corr[lag] = _mm_cvtsi128_si64(sum);
+  }
+}
+
+void overlap_add_sse2(int16_t* output, float scaler_d, const int16_t* desc, float scaler_a,
+                      const int16_t* asc) {
+  const __m128 sd = _mm_set1_ps(scaler_d);
+  const __m128 sa = _mm_set1_ps(scaler_a);
+
+  for (int i = 0; i < BTM_PLC_OLAL; i += 8) {
+    __m128i d = _mm_loadu_si128((const __m128i*)(desc + i));
+    __m128i a = _mm_loadu_si128((const __m128i*)(asc + i));
+
+    __m128 d0 = _mm_mul_ps(_mm_mul_ps(sd, _mm_cvtepi32_ps(s16_lo_to_s32(d))),
+                           _mm_loadu_ps(rcos + i));
+    __m128 d4 = _mm_mul_ps(_mm_mul_ps(sd, _mm_cvtepi32_ps(s16_hi_to_s32(d))),
+                           _mm_loadu_ps(rcos + i + 4));
+    __m128 a0 = _mm_mul_ps(_mm_mul_ps(sa, _mm_cvtepi32_ps(s16_lo_to_s32(a))),
+                           _mm_loadu_ps(rcos_rev + i));
+    __m128 a4 = _mm_mul_ps(_mm_mul_ps(sa, _mm_cvtepi32_ps(s16_hi_to_s32(a))),
+                           _mm_loadu_ps(rcos_rev + i + 4));
+
+    __m128i o = _mm_packs_epi32(f_to_s32_sat(_mm_add_ps(d0, a0)),
+                                f_to_s32_sat(_mm_add_ps(d4, a4)));
+    _mm_storeu_si128((__m128i*)(output + i), o);
+  }
+}
+
+void scale_sse2(int16_t* output, const int16_t* input, float scaler, int len) {
+  const __m128 s = _mm_set1_ps(scaler);
+
+  int i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m128i x = _mm_loadu_si128((const __m128i*)(input + i));
+    __m128 x0 = _mm_mul_ps(s, _mm_cvtepi32_ps(s16_lo_to_s32(x)));
+    __m128 x4 = _mm_mul_ps(s, _mm_cvtepi32_ps(s16_hi_to_s32(x)));
+    _mm_storeu_si128((__m128i*)(output + i),
+                     _mm_packs_epi32(f_to_s32_sat(x0), f_to_s32_sat(x4)));
+  }
+  scale_scalar(output + i, input + i, scaler, len - i);
+}
+
+const Kernels sse2_kernels = {"sse2", cross_correlate_sse2, overlap_add_sse2, scale_sse2};
+
+const Kernels avx2_kernels = {"avx2", cross_correlate_avx2, overlap_add_sse2, scale_sse2};
+
+const Kernels& SelectKernels() {
+  return __builtin_cpu_supports("avx2") ? avx2_kernels : sse2_kernels;
+}
+
+#elif defined(__aarch64__)
+
+/*
+ * ARM AArch64 Neon kernels
+ */
+
+/* Saturates and truncates 4 floats the way f_to_s16() does. */
+inline int32x4_t f_to_s32_sat(float32x4_t x) {
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(INT16_MIN)), vdupq_n_f32(INT16_MAX));
+  return vcvtq_s32_f32(x);
+}
+
+inline float32x4_t s16_lo_to_f32(int16x8_t x) {
+  return vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+}
+
+inline float32x4_t s16_hi_to_f32(int16x8_t x) { return vcvtq_f32_s32(vmovl_high_s16(x)); }
+
+void cross_correlate_neon(const int16_t* tmpl, const int16_t* hist, int num_lags, int len,
+                          int64_t* corr) {
+  for (int lag = 0; lag < num_lags; lag++) {
+    int64x2_t acc = vdupq_n_s64(0);
+    for (int i = 0; i < len; i += 8) {
+      int16x8_t x = vld1q_s16(tmpl + i);
+      int16x8_t y = vld1q_s16(hist + lag + i);
+
+      acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(x), vget_low_s16(y)));
+      acc = vpadalq_s32(acc, vmull_high_s16(x, y));
+    }
+    corr[lag] = vaddvq_s64(acc);
+  }
+}
+
+void overlap_add_neon(int16_t* output, float scaler_d, const int16_t* desc, float scaler_a,
+                      const int16_t* asc) {
+  for (int i = 0; i < BTM_PLC_OLAL; i += 8) {
+    int16x8_t d = vld1q_s16(desc + i);
+    int16x8_t a = vld1q_s16(asc + i);
+
+    float32x4_t d0 = vmulq_f32(vmulq_n_f32(s16_lo_to_f32(d), scaler_d), vld1q_f32(rcos + i));
+    float32x4_t d4 = vmulq_f32(vmulq_n_f32(s16_hi_to_f32(d), scaler_d), vld1q_f32(rcos + i + 4));
+    float32x4_t a0 = vmulq_f32(vmulq_n_f32(s16_lo_to_f32(a), scaler_a), vld1q_f32(rcos_rev + i));
+    float32x4_t a4 =
+            vmulq_f32(vmulq_n_f32(s16_hi_to_f32(a), scaler_a), vld1q_f32(rcos_rev + i + 4));
+
+    int16x8_t o = vcombine_s16(vmovn_s32(f_to_s32_sat(vaddq_f32(d0, a0))),
+                               vmovn_s32(f_to_s32_sat(vaddq_f32(d4, a4))));
+    vst1q_s16(output + i, o);
+  }
+}
+
+void scale_neon(int16_t* output, const int16_t* input, float scaler, int len) {
+  int i = 0;
+  for (; i + 8 <= len; i += 8) {
+    int16x8_t x = vld1q_s16(input + i);
+    int32x4_t x0 = f_to_s32_sat(vmulq_n_f32(s16_lo_to_f32(x), scaler));
+    int32x4_t x4 = f_to_s32_sat(vmulq_n_f32(s16_hi_to_f32(x), scaler));
+    vst1q_s16(output + i, vcombine_s16(vmovn_s32(x0), vmovn_s32(x4)));
+  }
+  scale_scalar(output + i, input + i, scaler, len - i);
+}
+
+const Kernels neon_kernels = {"neon", cross_correlate_neon, overlap_add_neon, scale_neon};
+
+const Kernels& SelectKernels() { return neon_kernels; }
+
+#else
+
+const Kernels& SelectKernels() { return scalar_kernels; }
+
+#endif
+
+}  // namespace
+
+namespace bluetooth::audio::sco::plc {
+
+const Kernels& GetKernels() {
+  static const Kernels& kernels = SelectKernels();
+  return kernels;
+}
+
+const Kernels& GetScalarKernels() { return scalar_kernels; }
+
+int PatternMatch(const int16_t* tmpl, const int16_t* hist, int num_lags, int len,
+                 const Kernels& kernels) {
+  log::assert_that(len > 0 && len % 16 == 0 && len <= BTM_PLC_MAX_TL, "Invalid template length {}",
+                   len);
+  log::assert_that(num_lags > 0 && num_lags <= BTM_PLC_MAX_WL, "Invalid window length {}",
+                   num_lags);
+
+  /* The template is saturated to -INT16_MAX so that the sum of two products
+   * with the history fits in 32 bits, and the correlations are exact on every
+   * path. */
+  int16_t x[BTM_PLC_MAX_TL];
+  int64_t x2 = 0;
+  for (int i = 0; i < len; i++) {
+    x[i] = std::max<int16_t>(tmpl[i], -INT16_MAX);
+    x2 += (int32_t)x[i] * x[i];
+  }
+
+  int64_t corr[BTM_PLC_MAX_WL];
+  kernels.cross_correlate(x, hist, num_lags, len, corr);
+
+  /* The energy of the history window slides along with the lag */
+  int64_t y2 = 0;
+  for (int i = 0; i < len; i++) {
+    y2 += (int32_t)hist[i] * hist[i];
+  }
+
+  int best = 0;
+  double max_cn = FLT_MIN;
+  for (int lag = 0; lag < num_lags; lag++) {
+    if (lag > 0) {
+      y2 += (int32_t)hist[lag + len - 1] * hist[lag + len - 1];
+      y2 -= (int32_t)hist[lag - 1] * hist[lag - 1];
+    }
+    if (x2 == 0 || y2 == 0) {
+      continue;
+    }
+
+    double cn = corr[lag] / sqrt((double)x2 * y2);
+    if (cn > max_cn) {
+      best = lag;
+      max_cn = cn;
+    }
+  }
+  return best;
+}
+
+}  // namespace bluetooth::audio::sco::plc
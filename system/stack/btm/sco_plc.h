@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Signal processing kernels of the packet loss concealment of the wideband
+ * speech path. The kernels are picked once per process among the SIMD
+ * implementations the CPU supports, and produce the same output as the scalar
+ * ones on every path. */
+
+#define BTM_PLC_OLAL 16 /* OverLap-Add Length */
+
+/* Bounds of the pattern matching, in samples. The template length is a
+ * multiple of 16 samples. */
+#define BTM_PLC_MAX_TL 128
+#define BTM_PLC_MAX_WL 512
+
+namespace bluetooth::audio::sco::plc {
+
+struct Kernels {
+  const char* name;
+
+  /* Sets corr[lag] to the sum of tmpl[i] * hist[lag + i] for i < len, for each
+   * lag < num_lags. */
+  void (*cross_correlate)(const int16_t* tmpl, const int16_t* hist, int num_lags, int len,
+                          int64_t* corr);
+
+  /* Fades |desc| out and |asc| in over BTM_PLC_OLAL samples, scaled by
+   * |scaler_d| and |scaler_a|, into |output|. */
+  void (*overlap_add)(int16_t* output, float scaler_d, const int16_t* desc, float scaler_a,
+                      const int16_t* asc);
+
+  /* Sets output[i] to input[i] * scaler for i < len, saturated. The input may
+   * overlap the output when it starts at least 8 samples before it: samples
+   * are written in order, as they would be one at a time. */
+  void (*scale)(int16_t* output, const int16_t* input, float scaler, int len);
+};
+
+/* The kernels used by the PLC */
+const Kernels& GetKernels();
+
+/* The portable kernels, which the SIMD ones are checked against */
+const Kernels& GetScalarKernels();
+
+/* Returns the lag in [0, num_lags) of the |len| samples of |hist| with the
+ * highest normalized cross-correlation with the |len| samples of |tmpl|, or
+ * 0 when none correlates positively. */
+int PatternMatch(const int16_t* tmpl, const int16_t* hist, int num_lags, int len,
+                 const Kernels& kernels = GetKernels());
+
+}  // namespace bluetooth::audio::sco::plc
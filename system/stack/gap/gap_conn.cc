@@ -399,6 +399,41 @@ uint16_t GAP_ConnReadData(uint16_t gap_handle, uint8_t* p_data, uint16_t max_len
   return BT_PASS;
 }
 
+/*******************************************************************************
+ *
+ * Function         GAP_ConnReadBuf
+ *
+ * Description      Dequeues the next received SDU without copying it.
+ *
+ * Parameters:      handle      - Handle of the connection returned in the Open
+ *                  pp_buf      - Set to the dequeued buffer, owned by the
+ *                                caller
+ *
+ * Returns          BT_PASS             - data read
+ *                  GAP_ERR_BAD_HANDLE  - invalid handle
+ *                  GAP_NO_DATA_AVAIL   - no data available
+ *
+ ******************************************************************************/
+uint16_t GAP_ConnReadBuf(uint16_t gap_handle, BT_HDR** pp_buf) {
+  tGAP_CCB* p_ccb = gap_find_ccb_by_handle(gap_handle);
+
+  if (!p_ccb) {
+    return GAP_ERR_BAD_HANDLE;
+  }
+
+  mutex_global_lock();
+
+  BT_HDR* p_buf = static_cast<BT_HDR*>(fixed_queue_try_dequeue(p_ccb->rx_queue));
+  if (p_buf != NULL) {
+    p_ccb->rx_queue_size -= p_buf->len;
+  }
+
+  mutex_global_unlock();
+
+  *pp_buf = p_buf;
+  return p_buf != NULL ? BT_PASS : GAP_NO_DATA_AVAIL;
+}
+
 /*******************************************************************************
  *
  * Function         GAP_GetRxQueueCnt
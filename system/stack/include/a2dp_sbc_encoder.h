@@ -58,6 +58,10 @@ int a2dp_sbc_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_sbc_send_frames(uint64_t timestamp_us);
 
+// Set the transmit queue length for the adaptive bitpool of the A2DP SBC
+// encoder.
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length);
+
 // Get SBC bitrate
 // Returns |uint32_t| bitrate in bits per second
 uint32_t a2dp_sbc_get_bitrate();
@@ -158,6 +158,21 @@ uint16_t GAP_ConnClose(uint16_t gap_handle);
  ******************************************************************************/
 uint16_t GAP_ConnReadData(uint16_t gap_handle, uint8_t* p_data, uint16_t max_len, uint16_t* p_len);
 
+/*******************************************************************************
+ *
+ * Function         GAP_ConnReadBuf
+ *
+ * Description      Dequeues the next received SDU without copying it. The
+ *                  caller takes ownership of the returned buffer and must
+ *                  osi_free it.
+ *
+ * Returns          BT_PASS             - data read
+ *                  GAP_ERR_BAD_HANDLE  - invalid handle
+ *                  GAP_NO_DATA_AVAIL   - no data available
+ *
+ ******************************************************************************/
+uint16_t GAP_ConnReadBuf(uint16_t gap_handle, BT_HDR** pp_buf);
+
 /*******************************************************************************
  *
  * Function         GAP_GetRxQueueCnt
@@ -136,6 +136,21 @@ struct tSdpApi {
     [[nodiscard]] bool (*SDP_ServiceSearchAttributeRequest2)(
             const RawAddress&, tSDP_DISCOVERY_DB*,
             base::RepeatingCallback<tSDP_DISC_CMPL_CB> complete_callback);
+
+    /*******************************************************************************
+
+      Function         SDP_InvalidateCache
+
+      Description      This function drops the records of a remote device
+                       kept from previous searches, so that the next searches
+                       query the device again.
+
+      Parameters:      bd_addr     - (input) device address
+
+      Returns          void
+
+     ******************************************************************************/
+    void (*SDP_InvalidateCache)(const RawAddress&);
   } service;
 
   struct {
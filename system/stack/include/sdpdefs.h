@@ -50,6 +50,10 @@
 #define ATTR_ID_SERVICE_DESCRIPTION (LANGUAGE_BASE_ID + 0x0001)
 #define ATTR_ID_PROVIDER_NAME (LANGUAGE_BASE_ID + 0x0002)
 
+/* Service Discovery Server
+ */
+#define ATTR_ID_SERVICE_DATABASE_STATE 0x0201
+
 /* Device Identification (DI)
  */
 #define ATTR_ID_SPECIFICATION_ID 0x0200
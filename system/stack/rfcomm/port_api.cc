@@ -30,11 +30,11 @@
 #include <bluetooth/log.h>
 
 #include <cstdint>
+#include <mutex>
 
 #include "internal_include/bt_trace.h"
 #include "os/logging/log_adapter.h"
 #include "osi/include/allocator.h"
-#include "osi/include/mutex.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/bt_uuid16.h"
@@ -763,11 +763,10 @@ int PORT_ReadData(uint16_t handle, char* p_data, uint16_t max_len, uint16_t* p_l
 
       *p_len += max_len;
 
-      mutex_global_lock();
-
-      p_port->rx.queue_size -= max_len;
-
-      mutex_global_unlock();
+      {
+        std::lock_guard<std::mutex> lock(port_lock(p_port));
+        p_port->rx.queue_size -= max_len;
+      }
 
       break;
     } else {
@@ -776,17 +775,17 @@ int PORT_ReadData(uint16_t handle, char* p_data, uint16_t max_len, uint16_t* p_l
       *p_len += p_buf->len;
       max_len -= p_buf->len;
 
-      mutex_global_lock();
-
-      p_port->rx.queue_size -= p_buf->len;
+      {
+        std::lock_guard<std::mutex> lock(port_lock(p_port));
 
-      if (max_len) {
-        p_data += p_buf->len;
-      }
+        p_port->rx.queue_size -= p_buf->len;
 
-      osi_free(fixed_queue_try_dequeue(p_port->rx.queue));
+        if (max_len) {
+          p_data += p_buf->len;
+        }
 
-      mutex_global_unlock();
+        osi_free(fixed_queue_try_dequeue(p_port->rx.queue));
+      }
 
       count++;
     }
@@ -832,9 +831,11 @@ static int port_write(tPORT* p_port, BT_HDR* p_buf) {
       (p_port->rfc.state != RFC_STATE_OPENED) ||
       ((p_port->port_ctrl & (PORT_CTRL_REQ_SENT | PORT_CTRL_IND_RECEIVED)) !=
        (PORT_CTRL_REQ_SENT | PORT_CTRL_IND_RECEIVED))) {
+    std::unique_lock<std::mutex> lock(port_lock(p_port));
     if ((p_port->tx.queue_size > PORT_TX_CRITICAL_WM) ||
         (fixed_queue_length(p_port->tx.queue) > PORT_TX_BUF_CRITICAL_WM)) {
       log::warn("PORT_Write: Queue size: {}", p_port->tx.queue_size);
+      lock.unlock();
 
       osi_free(p_buf);
 
@@ -917,7 +918,7 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
 
   /* If there are buffers scheduled for transmission check if requested */
   /* data fits into the end of the queue */
-  mutex_global_lock();
+  std::unique_lock<std::mutex> lock(port_lock(p_port));
 
   p_buf = (BT_HDR*)fixed_queue_try_peek_last(p_port->tx.queue);
   if ((p_buf != NULL) && (((int)p_buf->len + available) <= (int)p_port->peer_mtu) &&
@@ -928,7 +929,6 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
                                     available, DATA_CO_CALLBACK_TYPE_OUTGOING)) {
       log::error("p_data_co_callback DATA_CO_CALLBACK_TYPE_OUTGOING failed, available:{}",
                  available);
-      mutex_global_unlock();
       return PORT_UNKNOWN_ERROR;
     }
     // memcpy ((uint8_t *)(p_buf + 1) + p_buf->offset + p_buf->len, p_data,
@@ -938,12 +938,10 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
     *p_len = available;
     p_buf->len += (uint16_t)available;
 
-    mutex_global_unlock();
-
     return PORT_SUCCESS;
   }
 
-  mutex_global_unlock();
+  lock.unlock();
 
   // int max_read = length < p_port->peer_mtu ? length : p_port->peer_mtu;
 
@@ -1066,7 +1064,7 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len, uint16
 
   /* If there are buffers scheduled for transmission check if requested */
   /* data fits into the end of the queue */
-  mutex_global_lock();
+  std::unique_lock<std::mutex> lock(port_lock(p_port));
 
   p_buf = (BT_HDR*)fixed_queue_try_peek_last(p_port->tx.queue);
   if ((p_buf != NULL) && ((p_buf->len + max_len) <= p_port->peer_mtu) &&
@@ -1077,12 +1075,10 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len, uint16
     *p_len = max_len;
     p_buf->len += max_len;
 
-    mutex_global_unlock();
-
     return PORT_SUCCESS;
   }
 
-  mutex_global_unlock();
+  lock.unlock();
 
   while (max_len) {
     /* if we're over buffer high water mark, we're done */
@@ -26,6 +26,7 @@
 #define PORT_INT_H
 
 #include <cstdint>
+#include <mutex>
 
 #include "include/macros.h"
 #include "internal_include/bt_target.h"
@@ -228,6 +229,7 @@ tPORT* port_find_port(uint8_t dlci, const RawAddress& bd_addr);
 uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals, uint8_t signal);
 uint32_t port_flow_control_user(tPORT* p_port);
 void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count);
+std::mutex& port_lock(const tPORT* p_port);
 
 /*
  * Functions provided by the port_rfc.cc
@@ -30,6 +30,7 @@
 #include <frameworks/proto_logging/stats/enums/bluetooth/enums.pb.h>
 
 #include <cstdint>
+#include <mutex>
 
 #include "hal/snoop_logger.h"
 #include "internal_include/bt_target.h"
@@ -37,7 +38,6 @@
 #include "main/shim/entry.h"
 #include "os/logging/log_adapter.h"
 #include "osi/include/allocator.h"
-#include "osi/include/mutex.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_uuid16.h"
 #include "stack/include/stack_metrics_logging.h"
@@ -831,12 +831,11 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
     }
   }
 
-  mutex_global_lock();
-
-  fixed_queue_enqueue(p_port->rx.queue, p_buf);
-  p_port->rx.queue_size += p_buf->len;
-
-  mutex_global_unlock();
+  {
+    std::lock_guard<std::mutex> lock(port_lock(p_port));
+    fixed_queue_enqueue(p_port->rx.queue, p_buf);
+    p_port->rx.queue_size += p_buf->len;
+  }
 
   /* perform flow control procedures if necessary */
   port_flow_control_peer(p_port, false, 0);
@@ -933,14 +932,15 @@ uint32_t port_rfc_send_tx_data(tPORT* p_port) {
     /* while the rfcomm peer is not flow controlling us, and peer is ready */
     while (!p_port->tx.peer_fc && p_port->rfc.p_mcb && p_port->rfc.p_mcb->peer_ready) {
       /* get data from tx queue and send it */
-      mutex_global_lock();
+      {
+        std::lock_guard<std::mutex> lock(port_lock(p_port));
+        p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue);
+        if (p_buf != NULL) {
+          p_port->tx.queue_size -= p_buf->len;
+        }
+      }
 
-      p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue);
       if (p_buf != NULL) {
-        p_port->tx.queue_size -= p_buf->len;
-
-        mutex_global_unlock();
-
         log::verbose("Sending RFCOMM_DataReq tx.queue_size={}", p_port->tx.queue_size);
 
         RFCOMM_DataReq(p_port->rfc.p_mcb, p_port->dlci, p_buf);
@@ -954,8 +954,6 @@ uint32_t port_rfc_send_tx_data(tPORT* p_port) {
       }
       /* queue is empty-- all data sent */
       else {
-        mutex_global_unlock();
-
         events |= PORT_EV_TXEMPTY;
         break;
       }
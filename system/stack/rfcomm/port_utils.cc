@@ -28,10 +28,10 @@
 
 #include <cstdint>
 #include <cstring>
+#include <mutex>
 
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
-#include "osi/include/mutex.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack/include/l2cdefs.h"
@@ -202,18 +202,19 @@ void port_release_port(tPORT* p_port) {
   log::verbose("p_port: {} state: {} keep_handle: {}", fmt::ptr(p_port), p_port->rfc.state,
                p_port->keep_port_handle);
 
-  mutex_global_lock();
-  BT_HDR* p_buf;
-  while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->rx.queue)) != nullptr) {
-    osi_free(p_buf);
-  }
-  p_port->rx.queue_size = 0;
+  {
+    std::lock_guard<std::mutex> lock(port_lock(p_port));
+    BT_HDR* p_buf;
+    while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->rx.queue)) != nullptr) {
+      osi_free(p_buf);
+    }
+    p_port->rx.queue_size = 0;
 
-  while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue)) != nullptr) {
-    osi_free(p_buf);
+    while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue)) != nullptr) {
+      osi_free(p_buf);
+    }
+    p_port->tx.queue_size = 0;
   }
-  p_port->tx.queue_size = 0;
-  mutex_global_unlock();
 
   alarm_cancel(p_port->rfc.port_timer);
 
@@ -229,12 +230,13 @@ void port_release_port(tPORT* p_port) {
 
     rfc_port_timer_stop(p_port);
 
-    mutex_global_lock();
-    fixed_queue_free(p_port->tx.queue, nullptr);
-    p_port->tx.queue = nullptr;
-    fixed_queue_free(p_port->rx.queue, nullptr);
-    p_port->rx.queue = nullptr;
-    mutex_global_unlock();
+    {
+      std::lock_guard<std::mutex> lock(port_lock(p_port));
+      fixed_queue_free(p_port->tx.queue, nullptr);
+      p_port->tx.queue = nullptr;
+      fixed_queue_free(p_port->rx.queue, nullptr);
+      p_port->rx.queue = nullptr;
+    }
 
     if (p_port->keep_port_handle) {
       log::verbose("Re-initialize handle: {}", p_port->handle);
@@ -529,3 +531,19 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
     }
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         port_lock
+ *
+ * Description      Returns the lock of the tx and rx queues of a port, which
+ *                  keeps the queues and their byte counts consistent between
+ *                  the stack and the threads moving the data. The locks live
+ *                  outside of the port control blocks, which are cleared with
+ *                  memset().
+ *
+ ******************************************************************************/
+std::mutex& port_lock(const tPORT* p_port) {
+  static std::mutex port_locks[MAX_RFC_PORTS];
+  return port_locks[p_port - rfc_cb.port.port];
+}
@@ -27,6 +27,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <mutex>
 #include <unordered_map>
 
 #include "stack/include/bt_hdr.h"
@@ -236,6 +237,7 @@ void rfc_sec_check_complete(RawAddress bd_addr, tBT_TRANSPORT transport, void* p
 void rfc_inc_credit(tPORT* p_port, uint8_t credit);
 void rfc_dec_credit(tPORT* p_port);
 void rfc_check_send_cmd(tRFC_MCB* p_mcb, BT_HDR* p_buf);
+std::recursive_mutex& rfc_mcb_lock(const tRFC_MCB* p_mcb);
 
 /*
  * Functions provided by the rfc_ts_frames.cc
@@ -28,6 +28,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <mutex>
 #include <set>
 
 #include "hal/snoop_logger.h"
@@ -934,10 +935,13 @@ void rfc_process_fcoff(tRFC_MCB* p_mcb, bool is_command) {
  *
  ******************************************************************************/
 void rfc_process_l2cap_congestion(tRFC_MCB* p_mcb, bool is_congested) {
-  p_mcb->l2cap_congested = is_congested;
+  {
+    std::lock_guard<std::recursive_mutex> lock(rfc_mcb_lock(p_mcb));
+    p_mcb->l2cap_congested = is_congested;
 
-  if (!is_congested) {
-    rfc_check_send_cmd(p_mcb, nullptr);
+    if (!is_congested) {
+      rfc_check_send_cmd(p_mcb, nullptr);
+    }
   }
 
   if (!rfc_cb.rfc.peer_rx_disabled) {
@@ -27,6 +27,7 @@
 #include <bluetooth/log.h>
 
 #include <cstdint>
+#include <mutex>
 
 #include "internal_include/bt_target.h"
 #include "os/logging/log_adapter.h"
@@ -413,6 +414,8 @@ void rfc_dec_credit(tPORT* p_port) {
  *
  ******************************************************************************/
 void rfc_check_send_cmd(tRFC_MCB* p_mcb, BT_HDR* p_buf) {
+  std::lock_guard<std::recursive_mutex> lock(rfc_mcb_lock(p_mcb));
+
   /* if passed a buffer queue it */
   if (p_buf != NULL) {
     if (p_mcb->cmd_q == NULL) {
@@ -434,3 +437,18 @@ void rfc_check_send_cmd(tRFC_MCB* p_mcb, BT_HDR* p_buf) {
     }
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         rfc_mcb_lock
+ *
+ * Description      Returns the lock of the command queue of a multiplexer
+ *                  channel, which keeps the frames of its ports in order on
+ *                  the L2CAP channel. It is recursive because L2CAP reports
+ *                  congestion changes from within L2CA_DataWrite().
+ *
+ ******************************************************************************/
+std::recursive_mutex& rfc_mcb_lock(const tRFC_MCB* p_mcb) {
+  static std::recursive_mutex mcb_locks[MAX_BD_CONNECTIONS];
+  return mcb_locks[p_mcb - rfc_cb.port.rfc_mcb];
+}
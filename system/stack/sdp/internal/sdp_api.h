@@ -99,6 +99,18 @@ bool SDP_ServiceSearchAttributeRequest2(
         const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db,
         base::RepeatingCallback<tSDP_DISC_CMPL_CB> complete_callback);
 
+/*******************************************************************************
+ *
+ * Function         SDP_InvalidateCache
+ *
+ * Description      This function drops the records of a remote device kept
+ *                  from previous searches.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_InvalidateCache(const RawAddress& bd_addr);
+
 /* API of utilities to find data in the local discovery database */
 
 /*******************************************************************************
@@ -182,6 +182,8 @@ bool SDP_ServiceSearchAttributeRequest(const RawAddress& bd_addr, tSDP_DISCOVERY
   p_ccb->p_cb = p_cb;
 
   p_ccb->is_attr_search = true;
+  /* Records of a previous search are checked against the server first */
+  p_ccb->check_cache = sdp_cache_has_search(bd_addr, p_db);
 
   return true;
 }
@@ -213,10 +215,25 @@ bool SDP_ServiceSearchAttributeRequest2(
   p_ccb->complete_callback = std::move(complete_callback);
 
   p_ccb->is_attr_search = true;
+  /* Records of a previous search are checked against the server first */
+  p_ccb->check_cache = sdp_cache_has_search(bd_addr, p_db);
 
   return true;
 }
 
+/*******************************************************************************
+ *
+ * Function         SDP_InvalidateCache
+ *
+ * Description      This function drops the records of a remote device kept
+ *                  from previous searches, so that the next searches query the
+ *                  device again. It is called when the bond changes.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_InvalidateCache(const RawAddress& bd_addr) { sdp_cache_invalidate(bd_addr); }
+
 /*******************************************************************************
  *
  * Function         SDP_FindAttributeInRec
@@ -1070,6 +1087,7 @@ bluetooth::legacy::stack::sdp::tSdpApi api_ = {
                         .SDP_ServiceSearchRequest = ::SDP_ServiceSearchRequest,
                         .SDP_ServiceSearchAttributeRequest = ::SDP_ServiceSearchAttributeRequest,
                         .SDP_ServiceSearchAttributeRequest2 = ::SDP_ServiceSearchAttributeRequest2,
+                        .SDP_InvalidateCache = ::SDP_InvalidateCache,
                 },
         .db =
                 {
@@ -1152,5 +1170,6 @@ void SDP_Dumpsys(int fd) {
   for (unsigned i = 0; i < kMaxSdpConnections; i++) {
     SDP_DumpConnectionControlBlock(fd, sdp_cb.ccb[i]);
   }
+  sdp_cache_dumpsys(fd);
 }
 #undef DUMPSYS_TAG
@@ -0,0 +1,425 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/******************************************************************************
+ *
+ *  this file contains the cache of the records found on remote SDP servers
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "stack::sdp"
+
+#include <bluetooth/log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include "main/shim/dumpsys.h"
+#include "stack/include/bt_types.h"
+#include "stack/include/bt_uuid16.h"
+#include "stack/include/sdp_status.h"
+#include "stack/include/sdpdefs.h"
+#include "stack/sdp/internal/sdp_api.h"
+#include "stack/sdp/sdpint.h"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+using bluetooth::Uuid;
+using namespace bluetooth;
+
+namespace {
+
+/* Remote devices, and searches per remote device, which are kept. The least
+ * recently used ones are dropped first. */
+constexpr size_t kMaxCachedPeers = 32;
+constexpr size_t kMaxCachedSearchesPerPeer = 16;
+
+constexpr std::chrono::milliseconds kCacheLifetime{SDP_CACHE_LIFETIME_MS};
+
+/* The records found by one search, along with the filters of the search */
+struct tSDP_CACHED_SEARCH {
+  std::vector<Uuid> uuid_filters;
+  std::vector<uint16_t> attr_filters;
+  std::vector<uint8_t> records; /* Attribute lists as sent by the server, back to back */
+  std::chrono::steady_clock::time_point stored_time;
+  /* ServiceDatabaseState of the server when the records were read, if read on
+   * the same connection */
+  bool db_state_known{false};
+  uint32_t db_state{0};
+};
+
+struct tSDP_CACHED_PEER {
+  RawAddress bd_addr;
+  bool no_db_state{false};                /* The server has no ServiceDatabaseState */
+  std::list<tSDP_CACHED_SEARCH> searches; /* Most recently used first */
+};
+
+struct tSDP_CACHE_STATS {
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t stale{0}; /* Searches found in the cache, but not up to date */
+  uint64_t invalidations{0};
+  /* Time from the request to the completion of the successful searches */
+  uint64_t num_cached_searches{0};
+  uint64_t num_remote_searches{0};
+  std::chrono::microseconds cached_search_time{0};
+  std::chrono::microseconds remote_search_time{0};
+  std::chrono::microseconds max_remote_search_time{0};
+};
+
+/* Not cleared by sdp_free(), the reconnections which follow a restart of the
+ * stack are the ones which benefit the most from the cache. */
+std::list<tSDP_CACHED_PEER> sdp_cache; /* Most recently used first */
+tSDP_CACHE_STATS sdp_cache_stats;
+
+tSDP_CACHED_PEER* sdp_cache_find_peer(const RawAddress& bd_addr) {
+  auto it = std::find_if(sdp_cache.begin(), sdp_cache.end(),
+                         [&bd_addr](const tSDP_CACHED_PEER& peer) {
+                           return peer.bd_addr == bd_addr;
+                         });
+  if (it == sdp_cache.end()) {
+    return nullptr;
+  }
+  sdp_cache.splice(sdp_cache.begin(), sdp_cache, it);
+  return &sdp_cache.front();
+}
+
+bool sdp_cache_filters_match(const tSDP_CACHED_SEARCH& search, const tSDP_DISCOVERY_DB& db) {
+  return std::equal(search.uuid_filters.begin(), search.uuid_filters.end(), db.uuid_filters,
+                    db.uuid_filters + db.num_uuid_filters) &&
+         std::equal(search.attr_filters.begin(), search.attr_filters.end(), db.attr_filters,
+                    db.attr_filters + db.num_attr_filters);
+}
+
+/* Returns the records of a previous search with the same filters as the
+ * database, unless they are too old. */
+tSDP_CACHED_SEARCH* sdp_cache_find_search(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB& db) {
+  tSDP_CACHED_PEER* p_peer = sdp_cache_find_peer(bd_addr);
+  if (p_peer == nullptr) {
+    return nullptr;
+  }
+
+  auto it = std::find_if(
+          p_peer->searches.begin(), p_peer->searches.end(),
+          [&db](const tSDP_CACHED_SEARCH& search) { return sdp_cache_filters_match(search, db); });
+  if (it == p_peer->searches.end()) {
+    return nullptr;
+  }
+  if (std::chrono::steady_clock::now() - it->stored_time > kCacheLifetime) {
+    p_peer->searches.erase(it);
+    return nullptr;
+  }
+  p_peer->searches.splice(p_peer->searches.begin(), p_peer->searches, it);
+  return &p_peer->searches.front();
+}
+
+/* Reads the ServiceDatabaseState from the attribute lists of the SDP server
+ * record. It changes whenever records are added to or removed from the
+ * server. */
+bool sdp_cache_find_db_state(uint8_t* p, uint8_t* p_end, uint32_t* p_db_state) {
+  while (p < p_end) {
+    /* Attribute list of a record */
+    uint8_t type = *p++;
+    uint32_t list_len;
+    p = sdpu_get_len_from_type(p, p_end, type, &list_len);
+    if (p == nullptr || (type >> 3) != DATA_ELE_SEQ_DESC_TYPE || p + list_len > p_end) {
+      return false;
+    }
+
+    uint8_t* p_list_end = p + list_len;
+    while (p < p_list_end) {
+      /* Attribute ID, then attribute value */
+      uint32_t len;
+      type = *p++;
+      p = sdpu_get_len_from_type(p, p_list_end, type, &len);
+      if (p == nullptr || (type >> 3) != UINT_DESC_TYPE || len != 2 || p + len > p_list_end) {
+        return false;
+      }
+      uint16_t attr_id;
+      BE_STREAM_TO_UINT16(attr_id, p);
+
+      type = *p++;
+      p = sdpu_get_len_from_type(p, p_list_end, type, &len);
+      if (p == nullptr || p + len > p_list_end) {
+        return false;
+      }
+      if (attr_id == ATTR_ID_SERVICE_DATABASE_STATE && (type >> 3) == UINT_DESC_TYPE &&
+          len == 4) {
+        BE_STREAM_TO_UINT32(*p_db_state, p);
+        return true;
+      }
+      p += len;
+    }
+  }
+  return false;
+}
+
+/* Takes the ServiceDatabaseState from the search results if they hold the SDP
+ * server record, from the check done before the search otherwise. */
+void sdp_cache_search_db_state(const tCONN_CB& ccb, tSDP_CACHED_SEARCH& search) {
+  tSDP_DISC_REC* p_rec =
+          SDP_FindServiceInDb(ccb.p_db, UUID_SERVCLASS_SERVICE_DISCOVERY_SERVER, nullptr);
+  tSDP_DISC_ATTR* p_attr =
+          p_rec ? SDP_FindAttributeInRec(p_rec, ATTR_ID_SERVICE_DATABASE_STATE) : nullptr;
+  if (p_attr != nullptr && SDP_DISC_ATTR_TYPE(p_attr->attr_len_type) == UINT_DESC_TYPE &&
+      SDP_DISC_ATTR_LEN(p_attr->attr_len_type) == 4) {
+    search.db_state_known = true;
+    search.db_state = p_attr->attr_value.v.u32;
+  } else {
+    search.db_state_known = ccb.db_state_known;
+    search.db_state = ccb.db_state;
+  }
+}
+
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_has_search
+ *
+ * Description      This function checks if the records of a previous search to
+ *                  the same device with the same filters are kept. They are
+ *                  only used once the ServiceDatabaseState of the device is
+ *                  read again, see sdp_cache_answer().
+ *
+ * Returns          true if the records of a previous search are kept
+ *
+ ******************************************************************************/
+bool sdp_cache_has_search(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB* p_db) {
+  /* The raw data is expected as received, continuation included */
+  if (p_db == nullptr || p_db->raw_data != nullptr) {
+    return false;
+  }
+
+  if (sdp_cache_find_search(bd_addr, *p_db) == nullptr) {
+    sdp_cache_stats.misses++;
+    return false;
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_answer
+ *
+ * Description      This function answers a service search attribute request
+ *                  from the records of a previous search with the same filters,
+ *                  if the ServiceDatabaseState just read from the server is the
+ *                  one the records were read with. The records read with
+ *                  another state are dropped.
+ *
+ * Returns          true if the search is answered, with its status in
+ *                  p_status. false if the device must be searched, the state
+ *                  is then kept in the CCB for the records found.
+ *
+ ******************************************************************************/
+bool sdp_cache_answer(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_end, tSDP_STATUS* p_status) {
+  tSDP_CACHED_PEER* p_peer = sdp_cache_find_peer(p_ccb->device_address);
+  if (p_peer == nullptr) {
+    sdp_cache_stats.stale++;
+    return false;
+  }
+
+  uint32_t db_state;
+  if (!sdp_cache_find_db_state(p, p_end, &db_state)) {
+    /* Nothing to check the records against, stop caching them */
+    log::info("No ServiceDatabaseState for peer:{}, records not cached", p_peer->bd_addr);
+    p_peer->no_db_state = true;
+    p_peer->searches.clear();
+    sdp_cache_stats.stale++;
+    return false;
+  }
+
+  size_t num_searches = p_peer->searches.size();
+  p_peer->searches.remove_if([db_state](const tSDP_CACHED_SEARCH& search) {
+    return search.db_state_known && search.db_state != db_state;
+  });
+  if (p_peer->searches.size() != num_searches) {
+    log::info("Records of peer:{} changed, state now 0x{:08x}", p_peer->bd_addr, db_state);
+    sdp_cache_stats.invalidations++;
+  }
+
+  p_ccb->db_state_known = true;
+  p_ccb->db_state = db_state;
+
+  tSDP_CACHED_SEARCH* p_search = sdp_cache_find_search(p_ccb->device_address, *p_ccb->p_db);
+  if (p_search == nullptr || !p_search->db_state_known) {
+    sdp_cache_stats.stale++;
+    return false;
+  }
+
+  sdp_cache_stats.hits++;
+  log::verbose("SDP - Search answered from cache for peer {}", p_ccb->device_address);
+  p_ccb->is_cached = true;
+  p = p_search->records.data();
+  *p_status = sdp_disc_add_records(p_ccb, p, p + p_search->records.size())
+                      ? tSDP_STATUS::SDP_SUCCESS
+                      : tSDP_STATUS::SDP_DB_FULL;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_store
+ *
+ * Description      This function keeps the records found by a successful
+ *                  service search attribute request for the next searches with
+ *                  the same filters.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_store(const tCONN_CB& ccb, const uint8_t* p_records, const uint8_t* p_end) {
+  const tSDP_DISCOVERY_DB* p_db = ccb.p_db;
+  if (p_db->raw_data != nullptr) {
+    return;
+  }
+
+  tSDP_CACHED_PEER* p_peer = sdp_cache_find_peer(ccb.device_address);
+  if (p_peer == nullptr) {
+    if (sdp_cache.size() >= kMaxCachedPeers) {
+      sdp_cache.pop_back();
+    }
+    sdp_cache.emplace_front();
+    p_peer = &sdp_cache.front();
+    p_peer->bd_addr = ccb.device_address;
+  }
+  if (p_peer->no_db_state) {
+    return;
+  }
+
+  std::list<tSDP_CACHED_SEARCH>& searches = p_peer->searches;
+  searches.remove_if([p_db](const tSDP_CACHED_SEARCH& search) {
+    return sdp_cache_filters_match(search, *p_db);
+  });
+  if (searches.size() >= kMaxCachedSearchesPerPeer) {
+    searches.pop_back();
+  }
+  searches.push_front({
+          .uuid_filters = std::vector<Uuid>(p_db->uuid_filters,
+                                            p_db->uuid_filters + p_db->num_uuid_filters),
+          .attr_filters = std::vector<uint16_t>(p_db->attr_filters,
+                                                p_db->attr_filters + p_db->num_attr_filters),
+          .records = std::vector<uint8_t>(p_records, p_end),
+          .stored_time = std::chrono::steady_clock::now(),
+  });
+  sdp_cache_search_db_state(ccb, searches.front());
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_invalidate
+ *
+ * Description      This function drops the records kept for a remote device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_invalidate(const RawAddress& bd_addr) {
+  tSDP_CACHED_PEER* p_peer = sdp_cache_find_peer(bd_addr);
+  if (p_peer == nullptr) {
+    return;
+  }
+  log::verbose("SDP - Dropped cached records of peer {}", bd_addr);
+  sdp_cache.pop_front();
+  sdp_cache_stats.invalidations++;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_clear
+ *
+ * Description      This function drops all the cached records and statistics.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_clear(void) {
+  sdp_cache.clear();
+  sdp_cache_stats = {};
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_log_search_time
+ *
+ * Description      This function records the time taken by a successful
+ *                  search, from the request to the completion callback.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_log_search_time(const tCONN_CB& ccb) {
+  if (!(ccb.con_flags & SDP_FLAGS_IS_ORIG)) {
+    return;
+  }
+
+  auto search_time = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - ccb.start_time);
+  if (ccb.is_cached) {
+    sdp_cache_stats.num_cached_searches++;
+    sdp_cache_stats.cached_search_time += search_time;
+  } else {
+    sdp_cache_stats.num_remote_searches++;
+    sdp_cache_stats.remote_search_time += search_time;
+    sdp_cache_stats.max_remote_search_time =
+            std::max(sdp_cache_stats.max_remote_search_time, search_time);
+  }
+}
+
+#define DUMPSYS_TAG "shim::legacy::sdp"
+
+void sdp_cache_dumpsys(int fd) {
+  const tSDP_CACHE_STATS& stats = sdp_cache_stats;
+  LOG_DUMPSYS(fd, "cache hits:%llu misses:%llu stale:%llu invalidations:%llu peers:%zu",
+              static_cast<unsigned long long>(stats.hits),
+              static_cast<unsigned long long>(stats.misses),
+              static_cast<unsigned long long>(stats.stale),
+              static_cast<unsigned long long>(stats.invalidations), sdp_cache.size());
+  if (stats.num_cached_searches) {
+    LOG_DUMPSYS(fd, "  cached searches:%llu avg_us:%lld",
+                static_cast<unsigned long long>(stats.num_cached_searches),
+                static_cast<long long>(stats.cached_search_time.count() /
+                                       stats.num_cached_searches));
+  }
+  if (stats.num_remote_searches) {
+    LOG_DUMPSYS(fd, "  remote searches:%llu avg_us:%lld max_us:%lld",
+                static_cast<unsigned long long>(stats.num_remote_searches),
+                static_cast<long long>(stats.remote_search_time.count() /
+                                       stats.num_remote_searches),
+                static_cast<long long>(stats.max_remote_search_time.count()));
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  for (const tSDP_CACHED_PEER& peer : sdp_cache) {
+    LOG_DUMPSYS(fd, "  peer:%s searches:%zu no_db_state:%s",
+                fmt::format("{}", peer.bd_addr).c_str(), peer.searches.size(),
+                peer.no_db_state ? "true" : "false");
+    for (const tSDP_CACHED_SEARCH& search : peer.searches) {
+      LOG_DUMPSYS(fd, "    uuids:%zu attrs:%zu bytes:%zu db_state:0x%08x age_s:%lld",
+                  search.uuid_filters.size(), search.attr_filters.size(), search.records.size(),
+                  search.db_state,
+                  static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(
+                                                 now - search.stored_time)
+                                                 .count()));
+    }
+  }
+}
+
+#undef DUMPSYS_TAG
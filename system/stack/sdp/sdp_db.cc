@@ -28,6 +28,7 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "internal_include/bt_target.h"
@@ -39,25 +40,64 @@
 #include "stack/sdp/sdpint.h"
 
 using namespace bluetooth;
+using bluetooth::Uuid;
+
+/* The UUIDs of the last service search, and the records containing all of
+ * them. The server searches once per record found with the same UUIDs. Cleared
+ * whenever the UUID index changes. */
+static struct {
+  bool valid;
+  tSDP_UUID_SEQ seq;
+  tSDP_RECORD_SET matches;
+} sdp_db_last_search;
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_uuid_from_array
+ *
+ * Description      This function converts a 2, 4 or 16 byte big endian UUID,
+ *                  as found in records and requests, to a Uuid.
+ *
+ * Returns          true if the length is valid, else false
+ *
+ ******************************************************************************/
+static bool sdp_db_uuid_from_array(const uint8_t* p, uint32_t len, Uuid* p_uuid) {
+  switch (len) {
+    case Uuid::kNumBytes16:
+      *p_uuid = Uuid::From16Bit((p[0] << 8) | p[1]);
+      return true;
+    case Uuid::kNumBytes32:
+      *p_uuid = Uuid::From32Bit(((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+      return true;
+    case Uuid::kNumBytes128:
+      *p_uuid = Uuid::From128BitBE(p);
+      return true;
+    default:
+      return false;
+  }
+}
 
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         sdp_db_index_uuids_in_seq
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Description      This function adds the record to the UUID index entry of
+ *                  every UUID in a data element sequence, and its nested
+ *                  sequences.
  *
- * Returns          true if found, else false
+ * Returns          void
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len, const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static void sdp_db_index_uuids_in_seq(uint8_t* p, uint32_t seq_len, size_t rec_index,
+                                      int nest_level) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
+  Uuid uuid;
 
   /* A little safety check to avoid excessive recursion */
   if (nest_level > 3) {
-    return false;
+    return;
   }
 
   while (p < p_end) {
@@ -69,19 +109,95 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len, const uint8_t* p_uuid
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) {
-        return true;
+      if (sdp_db_uuid_from_array(p, len, &uuid)) {
+        sdp_cb.server_db.uuid_index[uuid].set(rec_index);
       }
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1)) {
-        return true;
-      }
+      sdp_db_index_uuids_in_seq(p, len, rec_index, nest_level + 1);
     }
     p = p + len;
   }
+}
 
-  /* If here, failed to match */
-  return false;
+/*******************************************************************************
+ *
+ * Function         sdp_db_index_record
+ *
+ * Description      This function updates the UUID index after the attributes
+ *                  of a record changed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_index_record(const tSDP_RECORD* p_rec) {
+  std::map<Uuid, tSDP_RECORD_SET>& index = sdp_cb.server_db.uuid_index;
+  size_t rec_index = p_rec - &sdp_cb.server_db.record[0];
+  Uuid uuid;
+
+  sdp_db_last_search.valid = false;
+  for (auto it = index.begin(); it != index.end();) {
+    it->second.reset(rec_index);
+    it = it->second.none() ? index.erase(it) : std::next(it);
+  }
+
+  for (uint16_t xx = 0; xx < p_rec->num_attributes; xx++) {
+    const tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[xx];
+    if (p_attr->type == UUID_DESC_TYPE) {
+      if (sdp_db_uuid_from_array(p_attr->value_ptr, p_attr->len, &uuid)) {
+        index[uuid].set(rec_index);
+      }
+    } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
+      sdp_db_index_uuids_in_seq(p_attr->value_ptr, p_attr->len, rec_index, 0);
+    }
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_unindex_record
+ *
+ * Description      This function updates the UUID index when a record is
+ *                  removed, and the records after it move down one slot.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_unindex_record(size_t rec_index) {
+  std::map<Uuid, tSDP_RECORD_SET>& index = sdp_cb.server_db.uuid_index;
+  const tSDP_RECORD_SET below = ~(~tSDP_RECORD_SET() << rec_index);
+
+  sdp_db_last_search.valid = false;
+  for (auto it = index.begin(); it != index.end();) {
+    tSDP_RECORD_SET& records = it->second;
+    records = (records & below) | ((records >> 1) & ~below);
+    it = records.none() ? index.erase(it) : std::next(it);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_same_uuid_seq
+ *
+ * Description      This function checks if a UUID sequence is the one of the
+ *                  last service search, for which the matches are known.
+ *
+ * Returns          true if it is the same, else false
+ *
+ ******************************************************************************/
+static bool sdp_db_same_uuid_seq(const tSDP_UUID_SEQ* p_seq) {
+  const tSDP_UUID_SEQ& last = sdp_db_last_search.seq;
+
+  if (!sdp_db_last_search.valid || last.num_uids != p_seq->num_uids) {
+    return false;
+  }
+  for (uint16_t yy = 0; yy < p_seq->num_uids; yy++) {
+    if (last.uuid_entry[yy].len != p_seq->uuid_entry[yy].len ||
+        memcmp(last.uuid_entry[yy].value, p_seq->uuid_entry[yy].value,
+               p_seq->uuid_entry[yy].len) != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 /*******************************************************************************
@@ -96,46 +212,40 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len, const uint8_t* p_uuid
  *
  ******************************************************************************/
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec, const tSDP_UUID_SEQ* p_seq) {
-  uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
-
-  /* If NULL, start at the beginning, else start at the first specified record
-   */
-  if (!p_rec) {
-    p_rec = &sdp_cb.server_db.record[0];
-  } else {
-    p_rec++;
-  }
-
-  /* Look through the records. The spec says that a match occurs if */
-  /* the record contains all the passed UUIDs in it.                */
-  for (; p_rec < p_end; p_rec++) {
-    for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len)) {
-            break;
-          }
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len, &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0)) {
-            break;
-          }
-        }
-      }
-      /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) {
+  const tSDP_DB& db = sdp_cb.server_db;
+
+  if (!sdp_db_same_uuid_seq(p_seq)) {
+    /* The spec says that a match occurs if the record contains all the passed
+     * UUIDs in it. Intersect the records containing each of them. */
+    tSDP_RECORD_SET matches;
+    Uuid uuid;
+
+    matches.set();
+    for (uint16_t yy = 0; yy < p_seq->num_uids && matches.any(); yy++) {
+      if (!sdp_db_uuid_from_array(&p_seq->uuid_entry[yy].value[0], p_seq->uuid_entry[yy].len,
+                                  &uuid)) {
+        log::error("invalid length");
+        matches.reset();
         break;
       }
+      auto it = db.uuid_index.find(uuid);
+      if (it == db.uuid_index.end()) {
+        matches.reset();
+      } else {
+        matches &= it->second;
+      }
     }
 
-    /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) {
-      return p_rec;
+    sdp_db_last_search.valid = true;
+    sdp_db_last_search.seq = *p_seq;
+    sdp_db_last_search.matches = matches;
+  }
+
+  /* If NULL, start at the beginning, else start after the specified record */
+  size_t xx = p_rec ? (p_rec - &db.record[0]) + 1 : 0;
+  for (; xx < db.num_records; xx++) {
+    if (sdp_db_last_search.matches.test(xx)) {
+      return &db.record[xx];
     }
   }
 
@@ -154,14 +264,15 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec, const tSDP_UU
  *
  ******************************************************************************/
 tSDP_RECORD* sdp_db_find_record(uint32_t handle) {
-  tSDP_RECORD* p_rec;
+  tSDP_RECORD* p_begin = &sdp_cb.server_db.record[0];
   tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
 
-  /* Look through the records for the caller's handle */
-  for (p_rec = &sdp_cb.server_db.record[0]; p_rec < p_end; p_rec++) {
-    if (p_rec->record_handle == handle) {
-      return p_rec;
-    }
+  /* Records are created with increasing handles, and kept in order */
+  tSDP_RECORD* p_rec = std::lower_bound(
+          p_begin, p_end, handle,
+          [](const tSDP_RECORD& rec, uint32_t handle) { return rec.record_handle < handle; });
+  if (p_rec != p_end && p_rec->record_handle == handle) {
+    return p_rec;
   }
 
   /* Record with that handle not found. */
@@ -182,14 +293,14 @@ tSDP_RECORD* sdp_db_find_record(uint32_t handle) {
  ******************************************************************************/
 const tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(const tSDP_RECORD* p_rec, uint16_t start_attr,
                                               uint16_t end_attr) {
-  const tSDP_ATTRIBUTE* p_at;
-  uint16_t xx;
-
-  /* Note that the attributes in a record are assumed to be in sorted order */
-  for (xx = 0, p_at = &p_rec->attribute[0]; xx < p_rec->num_attributes; xx++, p_at++) {
-    if ((p_at->id >= start_attr) && (p_at->id <= end_attr)) {
-      return p_at;
-    }
+  const tSDP_ATTRIBUTE* p_end = &p_rec->attribute[p_rec->num_attributes];
+
+  /* Note that the attributes in a record are kept in sorted order */
+  const tSDP_ATTRIBUTE* p_at = std::lower_bound(
+          &p_rec->attribute[0], p_end, start_attr,
+          [](const tSDP_ATTRIBUTE& attr, uint16_t id) { return attr.id < id; });
+  if (p_at != p_end && p_at->id <= end_attr) {
+    return p_at;
   }
 
   /* No matching attribute found */
@@ -386,6 +497,8 @@ bool SDP_DeleteRecord(uint32_t handle) {
   if (handle == 0 || sdp_cb.server_db.num_records == 0) {
     /* Delete all records in the database */
     sdp_cb.server_db.num_records = 0;
+    sdp_cb.server_db.uuid_index.clear();
+    sdp_db_last_search.valid = false;
 
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
@@ -406,6 +519,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
         }
 
         sdp_cb.server_db.num_records--;
+        sdp_db_unindex_record(xx);
 
         log::verbose("SDP_DeleteRecord ok, num_records:{}", sdp_cb.server_db.num_records);
         /* if we're deleting the primary DI record, clear the */
@@ -456,20 +570,8 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id, uint8_t attr
     return false;
   }
 
-  /* If not found, see if we can allocate a new entry */
-  if (xx == p_rec->num_attributes) {
-    p_attr = &p_rec->attribute[p_rec->num_attributes];
-  } else {
-    /* Since the attributes are kept in sorted order, insert ours here */
-    for (yy = p_rec->num_attributes; yy > xx; yy--) {
-      p_rec->attribute[yy] = p_rec->attribute[yy - 1];
-    }
-  }
-
-  p_attr->id = attr_id;
-  p_attr->type = attr_type;
-  p_attr->len = attr_len;
-
+  /* Check the value fits before moving any attribute, so that a failure
+   * leaves the attributes sorted */
   if (p_rec->free_pad_ptr + attr_len >= SDP_MAX_PAD_LEN) {
     if (p_rec->free_pad_ptr >= SDP_MAX_PAD_LEN) {
       log::error(
@@ -480,30 +582,40 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id, uint8_t attr
     }
 
     /* do truncate only for text string type descriptor */
-    if (attr_type == TEXT_STR_DESC_TYPE) {
-      log::warn("SDP_AddAttributeToRecord: attr_len:{} too long. truncate to ({})", attr_len,
-                SDP_MAX_PAD_LEN - p_rec->free_pad_ptr);
+    if (attr_type != TEXT_STR_DESC_TYPE) {
+      log::error("SDP_AddAttributeToRecord fail, length exceed maximum: ID {}: attr_len:{}",
+                 attr_id, attr_len);
+      return false;
+    }
 
-      attr_len = SDP_MAX_PAD_LEN - p_rec->free_pad_ptr;
-      p_val[SDP_MAX_PAD_LEN - p_rec->free_pad_ptr - 1] = '\0';
-    } else {
-      attr_len = 0;
+    log::warn("SDP_AddAttributeToRecord: attr_len:{} too long. truncate to ({})", attr_len,
+              SDP_MAX_PAD_LEN - p_rec->free_pad_ptr);
+
+    attr_len = SDP_MAX_PAD_LEN - p_rec->free_pad_ptr;
+    p_val[SDP_MAX_PAD_LEN - p_rec->free_pad_ptr - 1] = '\0';
+  }
+
+  /* If not found, see if we can allocate a new entry */
+  if (xx == p_rec->num_attributes) {
+    p_attr = &p_rec->attribute[p_rec->num_attributes];
+  } else {
+    /* Since the attributes are kept in sorted order, insert ours here */
+    for (yy = p_rec->num_attributes; yy > xx; yy--) {
+      p_rec->attribute[yy] = p_rec->attribute[yy - 1];
     }
   }
 
+  p_attr->id = attr_id;
+  p_attr->type = attr_type;
+  p_attr->len = attr_len;
+  p_attr->value_ptr = &p_rec->attr_pad[p_rec->free_pad_ptr];
+
   if (attr_len > 0) {
-    p_attr->len = attr_len;
     memcpy(&p_rec->attr_pad[p_rec->free_pad_ptr], p_val, (size_t)attr_len);
-    p_attr->value_ptr = &p_rec->attr_pad[p_rec->free_pad_ptr];
     p_rec->free_pad_ptr += attr_len;
-  } else if (attr_len == 0 && p_attr->len != 0) {
-    /* if truncate to 0 length, simply don't add */
-    log::error("SDP_AddAttributeToRecord fail, length exceed maximum: ID {}: attr_len:{}", attr_id,
-               attr_len);
-    p_attr->id = p_attr->type = p_attr->len = 0;
-    return false;
   }
   p_rec->num_attributes++;
+  sdp_db_index_record(p_rec);
   return true;
 }
 
@@ -872,6 +984,7 @@ bool SDP_DeleteAttributeFromRecord(tSDP_RECORD* p_rec, uint16_t attr_id) {
         }
         p_rec->free_pad_ptr -= len;
       }
+      sdp_db_index_record(p_rec);
       return true;
     }
   }
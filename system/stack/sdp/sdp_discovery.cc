@@ -32,6 +32,7 @@
 #include "osi/include/allocator.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
+#include "stack/include/bt_uuid16.h"
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdp_discovery_db.h"
 #include "stack/sdp/sdpint.h"
@@ -571,6 +572,27 @@ static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end) {
   return p;
 }
 
+/*******************************************************************************
+ *
+ * Function         sdp_disc_add_records
+ *
+ * Description      This function saves attribute lists stored back to back,
+ *                  one per record, in the database of the connection.
+ *
+ * Returns          true if all the records were saved, false on error or if
+ *                  the database is full
+ *
+ ******************************************************************************/
+bool sdp_disc_add_records(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_end) {
+  while (p < p_end) {
+    p = save_attr_seq(p_ccb, p, p_end);
+    if (!p) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         process_service_search_attr_rsp
@@ -662,18 +684,28 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 
     bytes_left -= base_bytes;
 
-    /* Build the UID sequence. */
-    p = sdpu_build_uuid_seq(p, p_ccb->p_db->num_uuid_filters, p_ccb->p_db->uuid_filters,
-                            bytes_left);
-
-    /* Max attribute byte count */
-    UINT16_TO_BE_STREAM(p, sdp_cb.max_attr_list_size);
+    if (p_ccb->disc_state == SDP_DISC_WAIT_DB_STATE) {
+      /* Only the ServiceDatabaseState of the SDP server record */
+      Uuid server_uuid = Uuid::From16Bit(UUID_SERVCLASS_SERVICE_DISCOVERY_SERVER);
+      uint16_t db_state_attr = ATTR_ID_SERVICE_DATABASE_STATE;
 
-    /* If no attribute filters, build a wildcard attribute sequence */
-    if (p_ccb->p_db->num_attr_filters) {
-      p = sdpu_build_attrib_seq(p, p_ccb->p_db->attr_filters, p_ccb->p_db->num_attr_filters);
+      p = sdpu_build_uuid_seq(p, 1, &server_uuid, bytes_left);
+      UINT16_TO_BE_STREAM(p, sdp_cb.max_attr_list_size);
+      p = sdpu_build_attrib_seq(p, &db_state_attr, 1);
     } else {
-      p = sdpu_build_attrib_seq(p, NULL, 0);
+      /* Build the UID sequence. */
+      p = sdpu_build_uuid_seq(p, p_ccb->p_db->num_uuid_filters, p_ccb->p_db->uuid_filters,
+                              bytes_left);
+
+      /* Max attribute byte count */
+      UINT16_TO_BE_STREAM(p, sdp_cb.max_attr_list_size);
+
+      /* If no attribute filters, build a wildcard attribute sequence */
+      if (p_ccb->p_db->num_attr_filters) {
+        p = sdpu_build_attrib_seq(p, p_ccb->p_db->attr_filters, p_ccb->p_db->num_attr_filters);
+      } else {
+        p = sdpu_build_attrib_seq(p, NULL, 0);
+      }
     }
 
     /* No continuation for first request */
@@ -734,14 +766,28 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
     return;
   }
 
-  while (p < p_end) {
-    p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
-    if (!p) {
-      sdp_disconnect(p_ccb, tSDP_STATUS::SDP_DB_FULL);
+  if (p_ccb->disc_state == SDP_DISC_WAIT_DB_STATE) {
+    /* Answer from the records of the previous search if the records of the
+     * server did not change since, or go on with the search */
+    tSDP_STATUS status;
+    if (sdp_cache_answer(p_ccb, p, p_end, &status)) {
+      sdp_disconnect(p_ccb, status);
       return;
     }
+    p_ccb->list_len = 0;
+    p_ccb->disc_state = SDP_DISC_WAIT_SEARCH_ATTR;
+    process_service_search_attr_rsp(p_ccb, NULL, NULL);
+    return;
   }
 
+  if (!sdp_disc_add_records(p_ccb, p, p_end)) {
+    sdp_disconnect(p_ccb, tSDP_STATUS::SDP_DB_FULL);
+    return;
+  }
+
+  /* Keep the records for the next search with the same filters */
+  sdp_cache_store(*p_ccb, p, p_end);
+
   /* Since we got everything we need, disconnect the call */
   sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
   sdp_disconnect(p_ccb, tSDP_STATUS::SDP_SUCCESS);
@@ -957,7 +1003,7 @@ static void process_service_search_rsp(tCONN_CB* p_ccb, uint8_t* p_reply, uint8_
  ******************************************************************************/
 void sdp_disc_connected(tCONN_CB* p_ccb) {
   if (p_ccb->is_attr_search) {
-    p_ccb->disc_state = SDP_DISC_WAIT_SEARCH_ATTR;
+    p_ccb->disc_state = p_ccb->check_cache ? SDP_DISC_WAIT_DB_STATE : SDP_DISC_WAIT_SEARCH_ATTR;
 
     process_service_search_attr_rsp(p_ccb, NULL, NULL);
   } else {
@@ -1016,7 +1062,8 @@ void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg) {
       break;
 
     case SDP_PDU_SERVICE_SEARCH_ATTR_RSP:
-      if (p_ccb->disc_state == SDP_DISC_WAIT_SEARCH_ATTR) {
+      if (p_ccb->disc_state == SDP_DISC_WAIT_SEARCH_ATTR ||
+          p_ccb->disc_state == SDP_DISC_WAIT_DB_STATE) {
         process_service_search_attr_rsp(p_ccb, p, p_end);
         invalid_pdu = false;
       }
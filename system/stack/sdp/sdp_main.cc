@@ -26,6 +26,8 @@
 
 #include <bluetooth/log.h>
 
+#include <chrono>
+
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
 #include "stack/include/bt_hdr.h"
@@ -282,6 +284,7 @@ tCONN_CB* sdp_conn_originate(const RawAddress& bd_addr) {
 
   /* Save the BD Address */
   p_ccb->device_address = bd_addr;
+  p_ccb->start_time = std::chrono::steady_clock::now();
 
   /* Transition to the next appropriate state, waiting for connection confirm */
   if (cid == 0) {
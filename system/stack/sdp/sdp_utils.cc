@@ -387,6 +387,9 @@ tCONN_CB* sdpu_allocate_ccb(void) {
  *
  ******************************************************************************/
 void sdpu_callback(const tCONN_CB& ccb, tSDP_REASON reason) {
+  if (reason == tSDP_STATUS::SDP_SUCCESS) {
+    sdp_cache_log_search_time(ccb);
+  }
   if (ccb.p_cb) {
     (ccb.p_cb)(ccb.device_address, reason);
   } else if (ccb.complete_callback) {
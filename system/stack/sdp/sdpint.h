@@ -27,7 +27,10 @@
 #include <base/functional/callback.h>
 #include <base/strings/stringprintf.h>
 
+#include <bitset>
+#include <chrono>
 #include <cstdint>
+#include <map>
 #include <string>
 
 #include "include/macros.h"
@@ -46,6 +49,7 @@
 
 /* Timeout definitions. */
 #define SDP_INACT_TIMEOUT_MS (30 * 1000) /* Inactivity timeout (in ms) */
+#define SDP_CACHE_LIFETIME_MS (10 * 60 * 1000) /* Remote record cache lifetime (in ms) */
 
 /* Define the Protocol Data Unit (PDU) types.
  */
@@ -107,11 +111,17 @@ struct tSDP_RECORD {
   uint8_t attr_pad[SDP_MAX_PAD_LEN];
 };
 
+/* Set of records in the SDP database, by index in the record array */
+typedef std::bitset<SDP_MAX_RECORDS> tSDP_RECORD_SET;
+
 /* Define the SDP database */
 struct tSDP_DB {
   uint32_t di_primary_handle; /* Device ID Primary record or NULL if nonexistent */
   uint16_t num_records;
-  tSDP_RECORD record[SDP_MAX_RECORDS];
+  tSDP_RECORD record[SDP_MAX_RECORDS]; /* Sorted by record handle */
+  /* Records containing each UUID, at the top level of an attribute or in its
+   * data element sequences. Updated whenever a record or attribute changes. */
+  std::map<bluetooth::Uuid, tSDP_RECORD_SET> uuid_index;
 };
 
 /* Continuation information for the SDP server response */
@@ -171,6 +181,7 @@ enum : uint8_t {
   SDP_DISC_WAIT_SEARCH_ATTR = 3,
   SDP_DISC_WAIT_UNUSED4 = 4,
   SDP_DISC_WAIT_CANCEL = 5,
+  SDP_DISC_WAIT_DB_STATE = 6,
 };
 typedef uint8_t tSDP_DISC_WAIT;
 
@@ -202,6 +213,11 @@ struct tCONN_CB {
 
   tSDP_DISC_WAIT disc_state{SDP_DISC_WAIT_CONN};
   bool is_attr_search{false};
+  bool is_cached{false};      /* Search answered from the remote record cache */
+  bool check_cache{false};    /* Records of a previous search to check first */
+  bool db_state_known{false}; /* ServiceDatabaseState read on this connection */
+  uint32_t db_state{0};
+  std::chrono::steady_clock::time_point start_time; /* When the search was requested */
 
   uint16_t cont_offset;     /* Continuation state data in the server response */
   tSDP_CONT_INFO cont_info;  // structure to hold continuation information for
@@ -219,6 +235,7 @@ inline std::string sdp_disc_wait_text(const tSDP_DISC_WAIT& state) {
     CASE_RETURN_TEXT(SDP_DISC_WAIT_ATTR);
     CASE_RETURN_TEXT(SDP_DISC_WAIT_SEARCH_ATTR);
     CASE_RETURN_TEXT(SDP_DISC_WAIT_CANCEL);
+    CASE_RETURN_TEXT(SDP_DISC_WAIT_DB_STATE);
     default:
       return base::StringPrintf("UNKNOWN[%d]", state);
   }
@@ -299,6 +316,16 @@ tSDP_RECORD* sdp_db_find_record(uint32_t handle);
 const tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(const tSDP_RECORD* p_rec, uint16_t start_attr,
                                               uint16_t end_attr);
 
+/* Functions provided by sdp_cache.cc
+ */
+bool sdp_cache_has_search(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB* p_db);
+bool sdp_cache_answer(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_end, tSDP_STATUS* p_status);
+void sdp_cache_store(const tCONN_CB& ccb, const uint8_t* p_records, const uint8_t* p_end);
+void sdp_cache_invalidate(const RawAddress& bd_addr);
+void sdp_cache_clear(void);
+void sdp_cache_log_search_time(const tCONN_CB& ccb);
+void sdp_cache_dumpsys(int fd);
+
 /* Functions provided by sdp_server.cc
  */
 void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
@@ -307,6 +334,7 @@ void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
  */
 void sdp_disc_connected(tCONN_CB* p_ccb);
 void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
+bool sdp_disc_add_records(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_end);
 
 void update_pce_entry_to_interop_database(RawAddress remote_addr);
 bool is_sdp_pbap_pce_disabled(RawAddress remote_addr);
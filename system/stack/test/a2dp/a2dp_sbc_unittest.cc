@@ -26,6 +26,7 @@
 #include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/include/a2dp_sbc_decoder.h"
 #include "stack/include/a2dp_sbc_encoder.h"
 #include "stack/include/avdt_api.h"
@@ -38,6 +39,8 @@ constexpr uint32_t kSbcReadSize = 512;
 constexpr uint32_t kA2dpTickUs = 23 * 1000;
 constexpr char kWavFile[] = "test/a2dp/raw_data/pcm1644s.wav";
 constexpr uint16_t kPeerMtu = 1000;
+constexpr char kAdaptiveBitpoolProperty[] = "persist.bluetooth.a2dp_sbc.adaptive_bitpool";
+constexpr uint8_t kMinBitpool = 2;
 const uint8_t kCodecInfoSbcCapability[AVDT_CODEC_SIZE] = {
         6,                   // Length (A2DP_SBC_INFO_LEN)
         0,                   // Media Type: AVDT_MEDIA_TYPE_AUDIO
@@ -279,5 +282,102 @@ TEST_F(A2dpSbcTest, get_track_bits_per_sample) {
   ASSERT_EQ(A2DP_GetTrackBitsPerSampleSbc(kCodecInfoSbcCapability), 16);
 }
 
+// Bitpool of the last SBC frame enqueued, from its header
+static uint8_t last_bitpool = 0;
+
+class A2dpSbcAdaptiveBitpoolTest : public A2dpSbcTest {
+protected:
+  void SetUp() override {
+    A2dpSbcTest::SetUp();
+    osi_property_set(kAdaptiveBitpoolProperty, "true");
+    auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t {
+      memset(p_buf, 0, len);
+      return len;
+    };
+    auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+      last_bitpool = Data(p_buf)[2];
+      osi_free(p_buf);
+      return true;
+    };
+    InitializeEncoder(true, read_cb, enqueue_cb);
+    timestamp_us_ = bluetooth::common::time_gettimeofday_us();
+    encoder_iface_->send_frames(timestamp_us_);
+    target_bitpool_ = EncodeTick(0);
+  }
+
+  void TearDown() override {
+    osi_property_set(kAdaptiveBitpoolProperty, "false");
+    A2dpSbcTest::TearDown();
+  }
+
+  // Encodes one tick with |queue_length| packets in the TX queue, and returns
+  // the bitpool of the frames encoded
+  uint8_t EncodeTick(size_t queue_length) {
+    last_bitpool = 0;
+    encoder_iface_->set_transmit_queue_length(queue_length);
+    timestamp_us_ += kA2dpTickUs;
+    encoder_iface_->send_frames(timestamp_us_);
+    return last_bitpool;
+  }
+
+  uint64_t timestamp_us_;
+  uint8_t target_bitpool_;
+};
+
+TEST_F(A2dpSbcAdaptiveBitpoolTest, steps_down_while_queue_is_high) {
+  ASSERT_GT(target_bitpool_, kMinBitpool + 8);
+  ASSERT_EQ(target_bitpool_ - 4, EncodeTick(3));
+  ASSERT_EQ(target_bitpool_ - 8, EncodeTick(5));
+  // The bitpool holds while the queue drains
+  ASSERT_EQ(target_bitpool_ - 8, EncodeTick(2));
+  ASSERT_EQ(target_bitpool_ - 8, EncodeTick(1));
+}
+
+TEST_F(A2dpSbcAdaptiveBitpoolTest, steps_up_once_queue_is_empty) {
+  EncodeTick(3);
+  EncodeTick(3);
+  ASSERT_EQ(target_bitpool_ - 4, EncodeTick(0));
+  ASSERT_EQ(target_bitpool_, EncodeTick(0));
+}
+
+TEST_F(A2dpSbcAdaptiveBitpoolTest, stays_within_peer_and_target_bounds) {
+  // Never above the bitpool of the target bit rate
+  ASSERT_EQ(target_bitpool_, EncodeTick(0));
+
+  // Never below the minimum bitpool of the peer
+  for (int i = 0; i < target_bitpool_ / 4 + 1; i++) {
+    ASSERT_GE(EncodeTick(8), kMinBitpool);
+  }
+  ASSERT_EQ(kMinBitpool, EncodeTick(8));
+
+  for (int i = 0; i < target_bitpool_ / 4 + 1; i++) {
+    ASSERT_LE(EncodeTick(0), target_bitpool_);
+  }
+  ASSERT_EQ(target_bitpool_, EncodeTick(0));
+}
+
+TEST_F(A2dpSbcTest, bitpool_is_fixed_without_adaptive_bitpool) {
+  auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t {
+    memset(p_buf, 0, len);
+    return len;
+  };
+  auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+    last_bitpool = Data(p_buf)[2];
+    osi_free(p_buf);
+    return true;
+  };
+  InitializeEncoder(true, read_cb, enqueue_cb);
+  uint64_t timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+  timestamp_us += kA2dpTickUs;
+  encoder_iface_->send_frames(timestamp_us);
+  uint8_t bitpool = last_bitpool;
+
+  encoder_iface_->set_transmit_queue_length(8);
+  timestamp_us += kA2dpTickUs;
+  encoder_iface_->send_frames(timestamp_us);
+  ASSERT_EQ(bitpool, last_bitpool);
+}
+
 }  // namespace testing
 }  // namespace bluetooth
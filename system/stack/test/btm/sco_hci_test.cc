@@ -469,6 +469,43 @@ TEST_F(ScoHciSwbTest, SwbDecodeWithIrregularOffset) {
   }
 }
 
+TEST_F(ScoHciWbsTest, WbsDecodeInPlace) {
+  for (auto [pkt_size, buf_size] : irregular_packet_to_buffer_size) {
+    bluetooth::audio::sco::wbs::init(pkt_size);
+
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < 2 * buf_size / ENCODED_PACKET_SIZE; i++) {
+      stream.insert(stream.end(), msbc_zero_packet.begin(), msbc_zero_packet.end());
+    }
+
+    size_t num_decoded = 0;
+    for (size_t offset = 0; offset < stream.size(); offset += pkt_size) {
+      std::vector<uint8_t> payload(stream.begin() + offset, stream.begin() + offset + pkt_size);
+      ASSERT_EQ(bluetooth::audio::sco::wbs::enqueue_packet_in_place(payload, false), true);
+
+      const uint8_t* decoded = nullptr;
+      while (bluetooth::audio::sco::wbs::decode(&decoded) != 0) {
+        ASSERT_NE(decoded, nullptr);
+        num_decoded++;
+      }
+      bluetooth::audio::sco::wbs::release_packet();
+
+      // The bytes left of the payload are buffered, it is not read anymore
+      std::fill(payload.begin(), payload.end(), 0xff);
+    }
+
+    int num_decoded_frames;
+    double packet_loss_ratio;
+    ASSERT_EQ(num_decoded, stream.size() / ENCODED_PACKET_SIZE);
+    ASSERT_TRUE(bluetooth::audio::sco::wbs::fill_plc_stats(&num_decoded_frames,
+                                                           &packet_loss_ratio));
+    ASSERT_EQ(num_decoded_frames, (int)num_decoded);
+    ASSERT_EQ(packet_loss_ratio, 0.0);
+
+    bluetooth::audio::sco::wbs::cleanup();
+  }
+}
+
 TEST_F(ScoHciWbsTest, WbsEncodeWithoutInit) {
   int16_t data[120] = {0};
   // Return 0 if buffer is uninitialized
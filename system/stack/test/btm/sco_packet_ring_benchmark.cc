@@ -0,0 +1,184 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "stack/btm/sco_packet_ring.h"
+
+using ::benchmark::State;
+using bluetooth::audio::sco::ScoPacketRingStats;
+using bluetooth::audio::sco::ScoRxRing;
+using bluetooth::audio::sco::ScoTxQueue;
+
+namespace {
+
+/* Codec packet length of mSBC and LC3, see btm_sco_hci.cc */
+constexpr size_t kPktLen = 60;
+constexpr size_t kNumPkts = 60;
+
+/* Buffer sizes of the supported SCO packet sizes, see btm_sco_hci.cc */
+size_t BufferSize(size_t packet_size) {
+  switch (packet_size) {
+    case 72:
+      return 360;
+    case 24:
+      return 120;
+    default:
+      return kPktLen;
+  }
+}
+
+/* Stands for the codec reading or writing the whole packet */
+uint8_t Checksum(const uint8_t* pkt) {
+  uint8_t sum = 0;
+  for (size_t i = 0; i < kPktLen; i++) {
+    sum += pkt[i];
+  }
+  return sum;
+}
+
+void SetCounters(State& state, const ScoPacketRingStats& stats) {
+  state.counters["copied_bytes/pkt"] =
+          benchmark::Counter(stats.copied_bytes, benchmark::Counter::kAvgIterations);
+  state.counters["allocations/pkt"] =
+          benchmark::Counter(stats.allocations, benchmark::Counter::kAvgIterations);
+  state.counters["stitched/pkt"] =
+          benchmark::Counter(stats.stitched_pkts, benchmark::Counter::kAvgIterations);
+}
+
+class BM_ScoPacketRing : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    stream_.resize(kNumPkts * kPktLen);
+    for (size_t i = 0; i < stream_.size(); i++) {
+      stream_[i] = (uint8_t)(i * 7);
+    }
+  }
+
+  /* Feeds the SCO packets of state.range(0) bytes through the decode buffer,
+   * either copying them or reading them in place. Reports per SCO packet. */
+  void RunRx(State& state, bool in_place) {
+    const size_t packet_size = state.range(0);
+    ScoRxRing ring(BufferSize(packet_size), kPktLen);
+    size_t offset = 0;
+    for (auto _ : state) {
+      std::span<const uint8_t> packet(&stream_[offset], packet_size);
+      if (in_place) {
+        ring.Borrow(packet);
+      } else {
+        ring.Write(packet);
+      }
+      while (ring.DataLen() >= kPktLen) {
+        benchmark::DoNotOptimize(Checksum(ring.Peek()));
+        ring.Consume(kPktLen);
+      }
+      if (in_place) {
+        ring.Release();
+      }
+      offset = (offset + packet_size) % (stream_.size() - packet_size + 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    SetCounters(state, ring.GetStats());
+  }
+
+  std::vector<uint8_t> stream_;
+};
+
+/* Encodes codec packets in place into a flat ring, then copies each SCO
+ * packet to the buffer handed to HCI, as before the packet queue. The buffer
+ * size is a multiple of both lengths, so that nothing wraps around. */
+class CopyingTxQueue {
+public:
+  explicit CopyingTxQueue(size_t packet_size)
+      : packet_size_(packet_size), buf_(BufferSize(packet_size)), stats_{} {
+    stats_.allocations = 1;
+  }
+
+  uint8_t* Reserve() {
+    return buf_.size() - len_ >= kPktLen ? &buf_[(ro_ + len_) % buf_.size()] : nullptr;
+  }
+
+  void Commit() {
+    len_ += kPktLen;
+    stats_.in_place_pkts++;
+  }
+
+  size_t Pop(std::vector<uint8_t>* packet) {
+    if (len_ < packet_size_) {
+      return 0;
+    }
+    *packet = std::vector<uint8_t>(&buf_[ro_], &buf_[ro_] + packet_size_);
+    ro_ = (ro_ + packet_size_) % buf_.size();
+    len_ -= packet_size_;
+    stats_.copied_bytes += packet_size_;
+    stats_.allocations++;
+    return packet_size_;
+  }
+
+  const ScoPacketRingStats& GetStats() const { return stats_; }
+
+private:
+  const size_t packet_size_;
+  std::vector<uint8_t> buf_;
+  size_t ro_ = 0;
+  size_t len_ = 0;
+  ScoPacketRingStats stats_;
+};
+
+/* Encodes codec packets and sends the SCO packets of state.range(0) bytes.
+ * Reports per codec packet. */
+template <typename Queue>
+void RunTx(State& state, Queue& queue) {
+  std::vector<uint8_t> packet;
+  uint8_t seq = 0;
+  for (auto _ : state) {
+    uint8_t* pkt = queue.Reserve();
+    memset(pkt, seq++, kPktLen);
+    queue.Commit();
+    while (queue.Pop(&packet) != 0) {
+      benchmark::DoNotOptimize(packet.data());
+      benchmark::ClobberMemory();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  SetCounters(state, queue.GetStats());
+}
+
+BENCHMARK_DEFINE_F(BM_ScoPacketRing, rx_copy)(State& state) { RunRx(state, false); }
+
+BENCHMARK_DEFINE_F(BM_ScoPacketRing, rx_in_place)(State& state) { RunRx(state, true); }
+
+BENCHMARK_DEFINE_F(BM_ScoPacketRing, tx_copy)(State& state) {
+  CopyingTxQueue queue(state.range(0));
+  RunTx(state, queue);
+}
+
+BENCHMARK_DEFINE_F(BM_ScoPacketRing, tx_in_place)(State& state) {
+  ScoTxQueue queue(state.range(0), BufferSize(state.range(0)), kPktLen);
+  RunTx(state, queue);
+}
+
+BENCHMARK_REGISTER_F(BM_ScoPacketRing, rx_copy)->Arg(60)->Arg(72)->Arg(24);
+BENCHMARK_REGISTER_F(BM_ScoPacketRing, rx_in_place)->Arg(60)->Arg(72)->Arg(24);
+BENCHMARK_REGISTER_F(BM_ScoPacketRing, tx_copy)->Arg(60)->Arg(72)->Arg(24);
+BENCHMARK_REGISTER_F(BM_ScoPacketRing, tx_in_place)->Arg(60)->Arg(72)->Arg(24);
+
+}  // namespace
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/btm/sco_packet_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using bluetooth::audio::sco::ScoRxRing;
+using bluetooth::audio::sco::ScoTxQueue;
+
+constexpr size_t kPktLen = 60;
+
+/* Codec packets whose bytes all hold their sequence number */
+std::vector<uint8_t> MakeStream(size_t num_pkts) {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < num_pkts; i++) {
+    stream.insert(stream.end(), kPktLen, (uint8_t)i);
+  }
+  return stream;
+}
+
+bool IsPacket(const uint8_t* pkt, uint8_t seq) {
+  for (size_t i = 0; i < kPktLen; i++) {
+    if (pkt[i] != seq) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(ScoRxRingTest, WriteAndPeek) {
+  ScoRxRing ring(kPktLen, kPktLen);
+  auto stream = MakeStream(2);
+
+  ASSERT_EQ(ring.Write({stream.data(), kPktLen}), kPktLen);
+  // Return 0 if buffer is full
+  ASSERT_EQ(ring.Write({stream.data() + kPktLen, kPktLen}), 0u);
+
+  ASSERT_TRUE(IsPacket(ring.Peek(), 0));
+  ring.Consume(kPktLen);
+  ASSERT_EQ(ring.DataLen(), 0u);
+  ASSERT_EQ(ring.GetStats().in_place_pkts, 1u);
+  ASSERT_EQ(ring.GetStats().copied_bytes, kPktLen);
+}
+
+TEST(ScoRxRingTest, BorrowReadsInPlace) {
+  ScoRxRing ring(kPktLen, kPktLen);
+  auto stream = MakeStream(1);
+
+  ASSERT_TRUE(ring.Borrow(stream));
+  ASSERT_EQ(ring.DataLen(), kPktLen);
+  ASSERT_EQ(ring.Peek(), stream.data());
+  ring.Consume(kPktLen);
+  ring.Release();
+
+  ASSERT_EQ(ring.DataLen(), 0u);
+  ASSERT_EQ(ring.GetStats().copied_bytes, 0u);
+}
+
+TEST(ScoRxRingTest, ReleaseCopiesTheRest) {
+  // 72 bytes SCO packets carrying 60 bytes codec packets
+  const size_t packet_size = 72;
+  ScoRxRing ring(360, kPktLen);
+  auto stream = MakeStream(6);
+
+  uint8_t seq = 0;
+  for (size_t offset = 0; offset < stream.size(); offset += packet_size) {
+    std::vector<uint8_t> packet(stream.begin() + offset, stream.begin() + offset + packet_size);
+    ASSERT_TRUE(ring.Borrow(packet));
+    while (ring.DataLen() >= kPktLen) {
+      ASSERT_TRUE(IsPacket(ring.Peek(), seq++));
+      ring.Consume(kPktLen);
+    }
+    ring.Release();
+    // The released packet must not be read anymore
+    std::fill(packet.begin(), packet.end(), 0xff);
+  }
+
+  ASSERT_EQ(seq, 6);
+  ASSERT_EQ(ring.DataLen(), 0u);
+  // Only the codec packets split across two SCO packets are copied
+  ASSERT_EQ(ring.GetStats().copied_bytes, 4 * kPktLen);
+  ASSERT_EQ(ring.GetStats().stitched_pkts, 4u);
+  ASSERT_EQ(ring.GetStats().in_place_pkts, 2u);
+}
+
+TEST(ScoRxRingTest, WrapAround) {
+  ScoRxRing ring(150, kPktLen);
+  auto stream = MakeStream(4);
+
+  ASSERT_EQ(ring.Write({stream.data(), 90}), 90u);
+  ASSERT_TRUE(IsPacket(ring.Peek(), 0));
+  ring.Consume(kPktLen);
+  // The write wraps around the end of the buffer
+  ASSERT_EQ(ring.Write({stream.data() + 90, 90}), 90u);
+  ASSERT_EQ(ring.AvailLen(), 30u);
+  ASSERT_EQ(ring[kPktLen], 2);
+
+  ASSERT_TRUE(IsPacket(ring.Peek(), 1));
+  ring.Consume(kPktLen);
+  ASSERT_TRUE(IsPacket(ring.Peek(), 2));
+  ring.Consume(kPktLen);
+  ASSERT_EQ(ring.DataLen(), 0u);
+
+  ASSERT_EQ(ring.GetStats().in_place_pkts, 2u);
+  ASSERT_EQ(ring.GetStats().stitched_pkts, 1u);
+}
+
+TEST(ScoRxRingTest, BorrowFailsWhenFull) {
+  ScoRxRing ring(kPktLen, kPktLen);
+  auto stream = MakeStream(2);
+
+  ASSERT_TRUE(ring.Borrow({stream.data(), kPktLen}));
+  // The borrowed packet takes its room in the buffer
+  ASSERT_FALSE(ring.Borrow({stream.data() + kPktLen, kPktLen}));
+  ASSERT_EQ(ring.Write({stream.data() + kPktLen, kPktLen}), 0u);
+  ASSERT_TRUE(IsPacket(ring.Peek(), 0));
+}
+
+TEST(ScoTxQueueTest, WritesInPlace) {
+  ScoTxQueue queue(kPktLen, 2 * kPktLen, kPktLen);
+
+  ASSERT_EQ(queue.Front(), nullptr);
+  for (uint8_t seq = 0; seq < 2; seq++) {
+    uint8_t* pkt = queue.Reserve();
+    ASSERT_NE(pkt, nullptr);
+    std::fill(pkt, pkt + kPktLen, seq);
+    queue.Commit();
+  }
+  // Return nullptr if the queue is full
+  ASSERT_EQ(queue.Reserve(), nullptr);
+
+  const uint8_t* front = queue.Front();
+  std::vector<uint8_t> packet;
+  ASSERT_EQ(queue.Pop(&packet), kPktLen);
+  // The packet handed over is the buffer the codec packet was written to
+  ASSERT_EQ(packet.data(), front);
+  ASSERT_TRUE(IsPacket(packet.data(), 0));
+  ASSERT_EQ(queue.Pop(&packet), kPktLen);
+  ASSERT_TRUE(IsPacket(packet.data(), 1));
+  ASSERT_EQ(queue.Pop(&packet), 0u);
+
+  ASSERT_EQ(queue.GetStats().in_place_pkts, 2u);
+  ASSERT_EQ(queue.GetStats().copied_bytes, 0u);
+}
+
+TEST(ScoTxQueueTest, SplitsAcrossPackets) {
+  const size_t packet_size = 72;
+  ScoTxQueue queue(packet_size, 360, kPktLen);
+
+  for (uint8_t seq = 0; seq < 6; seq++) {
+    uint8_t* pkt = queue.Reserve();
+    ASSERT_NE(pkt, nullptr);
+    std::fill(pkt, pkt + kPktLen, seq);
+    queue.Commit();
+  }
+  ASSERT_EQ(queue.Reserve(), nullptr);
+
+  std::vector<uint8_t> stream;
+  std::vector<uint8_t> packet;
+  while (queue.Pop(&packet) != 0) {
+    ASSERT_EQ(packet.size(), packet_size);
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  ASSERT_EQ(stream, MakeStream(6));
+  ASSERT_EQ(queue.GetStats().in_place_pkts, 2u);
+  ASSERT_EQ(queue.GetStats().stitched_pkts, 4u);
+}
+
+TEST(ScoTxQueueTest, IncompletePacketIsKept) {
+  const size_t packet_size = 72;
+  ScoTxQueue queue(packet_size, 360, kPktLen);
+
+  ASSERT_NE(queue.Reserve(), nullptr);
+  queue.Commit();
+  ASSERT_EQ(queue.Front(), nullptr);
+  ASSERT_EQ(queue.Pop(), 0u);
+
+  ASSERT_NE(queue.Reserve(), nullptr);
+  queue.Commit();
+  ASSERT_NE(queue.Front(), nullptr);
+  ASSERT_EQ(queue.Pop(), packet_size);
+  ASSERT_EQ(queue.Front(), nullptr);
+
+  queue.Reset();
+  ASSERT_EQ(queue.Pop(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <math.h>
+#include <string.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "stack/btm/sco_plc.h"
+
+using ::benchmark::State;
+using bluetooth::audio::sco::plc::GetKernels;
+using bluetooth::audio::sco::plc::GetScalarKernels;
+using bluetooth::audio::sco::plc::Kernels;
+using bluetooth::audio::sco::plc::PatternMatch;
+
+namespace {
+
+/* Parameters of the mSBC concealment, see btm_sco_hci.cc */
+constexpr int kFrameSize = 120;
+constexpr int kWindowLength = 256;
+constexpr int kTemplateLength = 64;
+constexpr int kHistoryLength = kWindowLength + kFrameSize - 1;
+constexpr int kReconvergenceLength = 36;
+constexpr int kNumFrames = 1000;
+constexpr float kScaler = 1.1f;
+
+/* Voiced speech like signal: a few harmonics of a slowly gliding pitch */
+std::vector<int16_t> MakeSpeech(size_t len) {
+  std::vector<int16_t> samples(len);
+  double phase = 0;
+  for (size_t i = 0; i < len; i++) {
+    double pitch = 150 + 50 * sin(2 * M_PI * i / 16000.0);
+    phase += 2 * M_PI * pitch / 16000.0;
+    samples[i] = (int16_t)(6000 * sin(phase) + 3000 * sin(2 * phase) + 1500 * sin(3 * phase));
+  }
+  return samples;
+}
+
+/* Deterministic frame loss pattern, so that every kernel set conceals the same
+ * frames. */
+std::vector<bool> MakeLosses(int num_frames, int loss_percent) {
+  std::vector<bool> losses(num_frames);
+  uint32_t seed = 1;
+  for (auto&& lost : losses) {
+    seed = seed * 1664525u + 1013904223u;
+    lost = (seed >> 16) % 100 < (uint32_t)loss_percent;
+  }
+  return losses;
+}
+
+/* Runs the history bookkeeping and the signal processing of the mSBC PLC on
+ * one frame, the codec excepted. */
+class Concealer {
+public:
+  explicit Concealer(const Kernels& kernels) : kernels_(kernels) {}
+
+  void OnFrame(const int16_t* decoded, bool lost) {
+    int16_t* frame_head = &hist_[kHistoryLength];
+
+    if (!lost) {
+      int16_t input[kFrameSize];
+      memcpy(input, decoded, sizeof(input));
+      if (handled_bad_frames_ != 0) {
+        memcpy(input, frame_head, kReconvergenceLength * sizeof(int16_t));
+        kernels_.overlap_add(&input[kReconvergenceLength], 1.0f, &frame_head[kReconvergenceLength],
+                             1.0f, &input[kReconvergenceLength]);
+        handled_bad_frames_ = 0;
+      }
+      memmove(hist_, &hist_[kFrameSize], (kHistoryLength - kFrameSize) * sizeof(int16_t));
+      memcpy(&hist_[kHistoryLength - kFrameSize], input, sizeof(input));
+      return;
+    }
+
+    if (handled_bad_frames_ == 0) {
+      best_lag_ = PatternMatch(&hist_[kHistoryLength - kTemplateLength], hist_, kWindowLength,
+                               kTemplateLength, kernels_) +
+                  kTemplateLength;
+      const int16_t* best_match_hist = &hist_[best_lag_];
+      kernels_.overlap_add(frame_head, 1.0f, decoded, kScaler, best_match_hist);
+      kernels_.scale(&frame_head[BTM_PLC_OLAL], &best_match_hist[BTM_PLC_OLAL], kScaler,
+                     kFrameSize - BTM_PLC_OLAL);
+      kernels_.overlap_add(&frame_head[kFrameSize], kScaler, &best_match_hist[kFrameSize], 1.0f,
+                           &best_match_hist[kFrameSize]);
+      memmove(&frame_head[kFrameSize + BTM_PLC_OLAL], &best_match_hist[kFrameSize + BTM_PLC_OLAL],
+              kReconvergenceLength * sizeof(int16_t));
+    } else {
+      memmove(frame_head, &hist_[best_lag_],
+              (kFrameSize + kReconvergenceLength + BTM_PLC_OLAL) * sizeof(int16_t));
+    }
+    handled_bad_frames_++;
+    memmove(hist_, &hist_[kFrameSize],
+            (kHistoryLength + kReconvergenceLength + BTM_PLC_OLAL) * sizeof(int16_t));
+  }
+
+private:
+  const Kernels& kernels_;
+  int16_t hist_[kHistoryLength + kFrameSize + kReconvergenceLength + BTM_PLC_OLAL] = {};
+  int best_lag_ = 0;
+  int handled_bad_frames_ = 0;
+};
+
+class BM_ScoPlc : public ::benchmark::Fixture {
+protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    speech_ = MakeSpeech(kNumFrames * kFrameSize);
+  }
+
+  void Run(State& state, const Kernels& kernels) {
+    auto losses = MakeLosses(kNumFrames, state.range(0));
+    Concealer concealer(kernels);
+    int frame = 0;
+    for (auto _ : state) {
+      concealer.OnFrame(&speech_[frame * kFrameSize], losses[frame]);
+      frame = (frame + 1) % kNumFrames;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(kernels.name);
+  }
+
+  std::vector<int16_t> speech_;
+};
+
+/* Per frame cost of the concealment, at state.range(0) percent frame loss */
+BENCHMARK_DEFINE_F(BM_ScoPlc, conceal_scalar)(State& state) { Run(state, GetScalarKernels()); }
+
+BENCHMARK_DEFINE_F(BM_ScoPlc, conceal_dispatched)(State& state) { Run(state, GetKernels()); }
+
+BENCHMARK_REGISTER_F(BM_ScoPlc, conceal_scalar)->Arg(5)->Arg(10)->Arg(20);
+BENCHMARK_REGISTER_F(BM_ScoPlc, conceal_dispatched)->Arg(5)->Arg(10)->Arg(20);
+
+}  // namespace
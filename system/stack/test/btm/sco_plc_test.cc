@@ -0,0 +1,161 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/btm/sco_plc.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using bluetooth::audio::sco::plc::GetKernels;
+using bluetooth::audio::sco::plc::GetScalarKernels;
+using bluetooth::audio::sco::plc::Kernels;
+using bluetooth::audio::sco::plc::PatternMatch;
+
+constexpr int kTemplateLength = 64;
+constexpr int kWindowLength = 256;
+constexpr int kHistoryLength = kWindowLength + kTemplateLength + 120;
+
+/* Deterministic full scale noise */
+std::vector<int16_t> MakeNoise(size_t len, uint32_t seed) {
+  std::vector<int16_t> samples(len);
+  for (auto& sample : samples) {
+    seed = seed * 1664525u + 1013904223u;
+    sample = (int16_t)(seed >> 16);
+  }
+  return samples;
+}
+
+std::vector<int16_t> MakeSine(size_t len, double period, double amplitude) {
+  std::vector<int16_t> samples(len);
+  for (size_t i = 0; i < len; i++) {
+    samples[i] = (int16_t)(amplitude * sin(2 * M_PI * i / period));
+  }
+  return samples;
+}
+
+class ScoPlcTest : public ::testing::Test {
+protected:
+  const Kernels& kernels_ = GetKernels();
+  const Kernels& scalar_ = GetScalarKernels();
+};
+
+TEST_F(ScoPlcTest, CrossCorrelateMatchesScalar) {
+  for (uint32_t seed : {1u, 2u, 3u}) {
+    auto hist = MakeNoise(kHistoryLength, seed);
+    auto tmpl = MakeNoise(kTemplateLength, ~seed);
+    /* The kernels expect the template to be saturated to -INT16_MAX */
+    for (auto& sample : tmpl) {
+      sample = std::max<int16_t>(sample, -INT16_MAX);
+    }
+
+    std::vector<int64_t> expected(kWindowLength), actual(kWindowLength);
+    scalar_.cross_correlate(tmpl.data(), hist.data(), kWindowLength, kTemplateLength,
+                            expected.data());
+    kernels_.cross_correlate(tmpl.data(), hist.data(), kWindowLength, kTemplateLength,
+                             actual.data());
+    ASSERT_EQ(expected, actual) << kernels_.name;
+  }
+}
+
+TEST_F(ScoPlcTest, CrossCorrelateFullScale) {
+  std::vector<int16_t> tmpl(BTM_PLC_MAX_TL, -INT16_MAX);
+  std::vector<int16_t> hist(BTM_PLC_MAX_TL + 1, INT16_MIN);
+
+  std::vector<int64_t> expected(2), actual(2);
+  scalar_.cross_correlate(tmpl.data(), hist.data(), 2, BTM_PLC_MAX_TL, expected.data());
+  kernels_.cross_correlate(tmpl.data(), hist.data(), 2, BTM_PLC_MAX_TL, actual.data());
+  ASSERT_EQ(expected[0], (int64_t)BTM_PLC_MAX_TL * INT16_MAX * -INT16_MIN);
+  ASSERT_EQ(expected, actual) << kernels_.name;
+}
+
+TEST_F(ScoPlcTest, OverlapAddMatchesScalar) {
+  auto desc = MakeNoise(BTM_PLC_OLAL, 4);
+  auto asc = MakeNoise(BTM_PLC_OLAL, 5);
+
+  /* Scalers of the concealment, and large ones to check the saturation */
+  for (float scaler : {0.75f, 1.0f, 1.2f, 3.0f}) {
+    int16_t expected[BTM_PLC_OLAL], actual[BTM_PLC_OLAL];
+    scalar_.overlap_add(expected, 1.0f, desc.data(), scaler, asc.data());
+    kernels_.overlap_add(actual, 1.0f, desc.data(), scaler, asc.data());
+    ASSERT_TRUE(std::equal(expected, expected + BTM_PLC_OLAL, actual))
+            << kernels_.name << " scaler=" << scaler;
+
+    scalar_.overlap_add(expected, scaler, desc.data(), 1.0f, asc.data());
+    kernels_.overlap_add(actual, scaler, desc.data(), 1.0f, asc.data());
+    ASSERT_TRUE(std::equal(expected, expected + BTM_PLC_OLAL, actual))
+            << kernels_.name << " scaler=" << scaler;
+  }
+}
+
+TEST_F(ScoPlcTest, ScaleMatchesScalar) {
+  auto input = MakeNoise(120, 6);
+
+  for (int len : {1, 7, 8, 104, 120}) {
+    std::vector<int16_t> expected(len), actual(len);
+    scalar_.scale(expected.data(), input.data(), 1.2f, len);
+    kernels_.scale(actual.data(), input.data(), 1.2f, len);
+    ASSERT_EQ(expected, actual) << kernels_.name << " len=" << len;
+  }
+}
+
+TEST_F(ScoPlcTest, ScaleOverlappingInput) {
+  /* Like the concealment of a first lost frame, where the substitution samples
+   * are read from the history they are written after. */
+  auto expected = MakeNoise(kHistoryLength, 7);
+  auto actual = expected;
+  const int lag = 64;
+  const int len = kHistoryLength - lag;
+
+  for (int i = 0; i < len; i++) {
+    expected[lag + i] = (int16_t)std::min(std::max(0.9f * expected[i], -32768.0f), 32767.0f);
+  }
+  kernels_.scale(&actual[lag], &actual[0], 0.9f, len);
+  ASSERT_EQ(expected, actual) << kernels_.name;
+}
+
+TEST_F(ScoPlcTest, PatternMatchMatchesScalar) {
+  for (uint32_t seed : {8u, 9u, 10u}) {
+    auto hist = MakeNoise(kHistoryLength, seed);
+    const int16_t* tmpl = &hist[kHistoryLength - kTemplateLength];
+    ASSERT_EQ(PatternMatch(tmpl, hist.data(), kWindowLength, kTemplateLength, scalar_),
+              PatternMatch(tmpl, hist.data(), kWindowLength, kTemplateLength, kernels_))
+            << kernels_.name;
+  }
+}
+
+TEST_F(ScoPlcTest, PatternMatchFindsPeriod) {
+  /* The best match of the end of a periodic signal lies a whole number of
+   * periods before it. */
+  const int period = 50;
+  auto hist = MakeSine(kWindowLength + kTemplateLength, period, 20000);
+  const int16_t* tmpl = &hist[kWindowLength];
+
+  int lag = PatternMatch(tmpl, hist.data(), kWindowLength, kTemplateLength);
+  ASSERT_EQ((kWindowLength - lag) % period, 0);
+}
+
+TEST_F(ScoPlcTest, PatternMatchSilence) {
+  std::vector<int16_t> hist(kWindowLength + kTemplateLength, 0);
+  ASSERT_EQ(PatternMatch(&hist[kWindowLength], hist.data(), kWindowLength, kTemplateLength), 0);
+}
+
+}  // namespace
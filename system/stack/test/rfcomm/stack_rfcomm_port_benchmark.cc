@@ -0,0 +1,131 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "mock_l2cap_layer.h"
+#include "osi/include/allocator.h"
+#include "osi/include/fixed_queue.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/l2cdefs.h"
+#include "stack/include/port_api.h"
+#include "stack/rfcomm/port_int.h"
+#include "stack/rfcomm/rfc_int.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr uint16_t kPayloadSize = 512;
+constexpr uint16_t kMtu = 990;
+
+/* L2CAP channel which accepts everything, without the gmock bookkeeping which
+ * would serialize the threads. */
+class FakeL2capInterface : public bluetooth::l2cap::MockL2capInterface {
+public:
+  tL2CAP_DW_RESULT DataWrite(uint16_t /* cid */, BT_HDR* p_data) override {
+    osi_free(p_data);
+    return tL2CAP_DW_RESULT::SUCCESS;
+  }
+};
+
+FakeL2capInterface fake_l2cap;
+
+/* Opens one port per thread, either each on its own multiplexer like SPP links
+ * to different devices, or all on the first multiplexer. */
+void OpenPorts(int num_ports, bool shared_mcb) {
+  rfc_cb = {};
+  bluetooth::l2cap::SetMockInterface(&fake_l2cap);
+
+  for (int i = 0; i < num_ports; i++) {
+    tRFC_MCB* p_mcb = &rfc_cb.port.rfc_mcb[shared_mcb ? 0 : i];
+    if (p_mcb->cmd_q == nullptr) {
+      p_mcb->cmd_q = fixed_queue_new(SIZE_MAX);
+      p_mcb->state = RFC_MX_STATE_CONNECTED;
+      p_mcb->peer_ready = true;
+      p_mcb->flow = PORT_FC_TS710;
+      p_mcb->is_initiator = true;
+      p_mcb->lcid = L2CAP_BASE_APPL_CID + i;
+    }
+
+    tPORT* p_port = &rfc_cb.port.port[i];
+    p_port->in_use = true;
+    p_port->handle = i + 1;
+    p_port->dlci = 2 * (i + 1);
+    p_port->state = PORT_CONNECTION_STATE_OPENED;
+    p_port->rfc.state = RFC_STATE_OPENED;
+    p_port->rfc.p_mcb = p_mcb;
+    p_port->port_ctrl = PORT_CTRL_REQ_SENT | PORT_CTRL_IND_RECEIVED;
+    p_port->mtu = kMtu;
+    p_port->peer_mtu = kMtu;
+    p_port->rx_buf_critical = PORT_RX_BUF_CRITICAL_WM;
+    p_port->tx.queue = fixed_queue_new(SIZE_MAX);
+    p_port->rx.queue = fixed_queue_new(SIZE_MAX);
+    p_mcb->port_handles[p_port->dlci] = p_port->handle;
+  }
+}
+
+void ClosePorts(int num_ports) {
+  for (int i = 0; i < num_ports; i++) {
+    tPORT* p_port = &rfc_cb.port.port[i];
+    fixed_queue_free(p_port->tx.queue, osi_free);
+    fixed_queue_free(p_port->rx.queue, osi_free);
+  }
+  for (tRFC_MCB& mcb : rfc_cb.port.rfc_mcb) {
+    fixed_queue_free(mcb.cmd_q, osi_free);
+  }
+  rfc_cb = {};
+}
+
+/* Each thread sends and receives one payload per iteration on its own port,
+ * the way a socket thread and the stack move data for one SPP connection.
+ * bytes_per_second is the total over all the ports. */
+void TransferOnPorts(State& state, bool shared_mcb) {
+  if (state.thread_index() == 0) {
+    OpenPorts(state.threads(), shared_mcb);
+  }
+
+  tPORT* p_port = &rfc_cb.port.port[state.thread_index()];
+  uint16_t handle = state.thread_index() + 1;
+  char tx_data[kPayloadSize] = {};
+  char rx_data[kPayloadSize];
+
+  for (auto _ : state) {
+    uint16_t length = 0;
+    ::benchmark::DoNotOptimize(PORT_WriteData(handle, tx_data, kPayloadSize, &length));
+
+    BT_HDR* p_buf = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + kPayloadSize);
+    p_buf->len = kPayloadSize;
+    PORT_DataInd(p_port->rfc.p_mcb, p_port->dlci, p_buf);
+
+    ::benchmark::DoNotOptimize(PORT_ReadData(handle, rx_data, kPayloadSize, &length));
+  }
+  state.SetBytesProcessed(state.iterations() * kPayloadSize * 2);
+
+  if (state.thread_index() == 0) {
+    ClosePorts(state.threads());
+  }
+}
+
+void BM_RfcommPortTransfer(State& state) { TransferOnPorts(state, false); }
+void BM_RfcommPortTransferSharedMultiplexer(State& state) { TransferOnPorts(state, true); }
+
+}  // namespace
+
+BENCHMARK(BM_RfcommPortTransfer)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_RfcommPortTransferSharedMultiplexer)->ThreadRange(1, 8)->UseRealTime();
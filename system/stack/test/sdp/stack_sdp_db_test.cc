@@ -16,16 +16,63 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <vector>
+
+#include "stack/include/bt_uuid16.h"
 #include "stack/include/sdp_api.h"
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdpint.h"
 
+using bluetooth::legacy::stack::sdp::get_legacy_stack_sdp_api;
+
 namespace {
 constexpr char service_name[] = "TestServiceName";
 constexpr uint32_t kFirstRecordHandle = 0x10000;
-}  // namespace
 
-using bluetooth::legacy::stack::sdp::get_legacy_stack_sdp_api;
+// The UUID sequence of a service search request, with one 16 or 128 bit UUID.
+tSDP_UUID_SEQ UuidSeq(uint16_t uuid16, bool as_128_bit = false) {
+  tSDP_UUID_SEQ seq = {};
+  seq.num_uids = 1;
+  if (as_128_bit) {
+    bluetooth::Uuid::UUID128Bit uuid = bluetooth::Uuid::From16Bit(uuid16).To128BitBE();
+    seq.uuid_entry[0].len = uuid.size();
+    memcpy(seq.uuid_entry[0].value, uuid.data(), uuid.size());
+  } else {
+    seq.uuid_entry[0].len = 2;
+    seq.uuid_entry[0].value[0] = uuid16 >> 8;
+    seq.uuid_entry[0].value[1] = uuid16 & 0xff;
+  }
+  return seq;
+}
+
+uint32_t CreateServiceRecord(uint16_t service_uuid, uint8_t rfcomm_channel) {
+  uint32_t record_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  if (!get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(record_handle, 1,
+                                                                    &service_uuid)) {
+    return 0;
+  }
+  tSDP_PROTOCOL_ELEM protocols[2] = {};
+  protocols[0].protocol_uuid = UUID_PROTOCOL_L2CAP;
+  protocols[1].protocol_uuid = UUID_PROTOCOL_RFCOMM;
+  protocols[1].num_params = 1;
+  protocols[1].params[0] = rfcomm_channel;
+  if (!get_legacy_stack_sdp_api()->handle.SDP_AddProtocolList(record_handle, 2, protocols)) {
+    return 0;
+  }
+  return record_handle;
+}
+
+// The handles of the records matching a service search, in order.
+std::vector<uint32_t> ServiceSearch(const tSDP_UUID_SEQ& seq) {
+  std::vector<uint32_t> handles;
+  for (const tSDP_RECORD* p_rec = sdp_db_service_search(nullptr, &seq); p_rec != nullptr;
+       p_rec = sdp_db_service_search(p_rec, &seq)) {
+    handles.push_back(p_rec->record_handle);
+  }
+  return handles;
+}
+}  // namespace
 
 class StackSdpDbTest : public ::testing::Test {
 protected:
@@ -178,3 +225,78 @@ TEST_F(StackSdpDbTest, SDP_AddAttribute__three_attributes_replace_middle) {
 
   ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(record_handle));
 }
+
+TEST_F(StackSdpDbTest, SDP_AddAttribute__too_long_keeps_attribute_order) {
+  uint32_t record_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  ASSERT_NE((uint32_t)0, record_handle);
+
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddAttribute(
+          record_handle, ATTR_ID_SERVICE_NAME, TEXT_STR_DESC_TYPE,
+          (uint32_t)(strlen(service_name) + 1), (uint8_t*)service_name));
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddAttribute(
+          record_handle, ATTR_ID_PROVIDER_NAME, TEXT_STR_DESC_TYPE,
+          (uint32_t)(strlen(service_name) + 1), (uint8_t*)service_name));
+
+  // Only text strings are truncated, other values which do not fit are rejected
+  std::vector<uint8_t> too_long(SDP_MAX_PAD_LEN);
+  ASSERT_FALSE(get_legacy_stack_sdp_api()->handle.SDP_AddAttribute(
+          record_handle, ATTR_ID_SERVICE_DESCRIPTION, UINT_DESC_TYPE, too_long.size(),
+          too_long.data()));
+
+  tSDP_RECORD* record = sdp_db_find_record(record_handle);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ((uint16_t)(1 /* record_handle */ + 2 /* attribute count */), record->num_attributes);
+  ASSERT_EQ(ATTR_ID_SERVICE_RECORD_HDL, record->attribute[0].id);
+  ASSERT_EQ(ATTR_ID_SERVICE_NAME, record->attribute[1].id);
+  ASSERT_EQ(ATTR_ID_PROVIDER_NAME, record->attribute[2].id);
+  ASSERT_TRUE(sdp_db_find_attr_in_rec(record, ATTR_ID_SERVICE_DESCRIPTION,
+                                      ATTR_ID_SERVICE_DESCRIPTION) == nullptr);
+  ASSERT_EQ(&record->attribute[1],
+            sdp_db_find_attr_in_rec(record, ATTR_ID_SERVICE_NAME, ATTR_ID_PROVIDER_NAME));
+
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(record_handle));
+}
+
+TEST_F(StackSdpDbTest, sdp_db_service_search__uuid_index) {
+  uint32_t spp_handle = CreateServiceRecord(UUID_SERVCLASS_SERIAL_PORT, 1);
+  uint32_t opp_handle = CreateServiceRecord(UUID_SERVCLASS_OBEX_OBJECT_PUSH, 2);
+  uint32_t pbap_handle = CreateServiceRecord(UUID_SERVCLASS_PBAP_PSE, 3);
+  ASSERT_NE((uint32_t)0, spp_handle);
+  ASSERT_NE((uint32_t)0, opp_handle);
+  ASSERT_NE((uint32_t)0, pbap_handle);
+
+  // Service class and protocol UUIDs are found, in any UUID size
+  ASSERT_EQ(std::vector<uint32_t>({opp_handle}),
+            ServiceSearch(UuidSeq(UUID_SERVCLASS_OBEX_OBJECT_PUSH)));
+  ASSERT_EQ(std::vector<uint32_t>({opp_handle}),
+            ServiceSearch(UuidSeq(UUID_SERVCLASS_OBEX_OBJECT_PUSH, true)));
+  ASSERT_EQ(std::vector<uint32_t>({spp_handle, opp_handle, pbap_handle}),
+            ServiceSearch(UuidSeq(UUID_PROTOCOL_RFCOMM)));
+  ASSERT_TRUE(ServiceSearch(UuidSeq(UUID_SERVCLASS_AUDIO_SOURCE)).empty());
+
+  // Every UUID of the request has to be in the record
+  tSDP_UUID_SEQ seq = UuidSeq(UUID_PROTOCOL_L2CAP);
+  seq.uuid_entry[seq.num_uids++] = UuidSeq(UUID_SERVCLASS_PBAP_PSE).uuid_entry[0];
+  ASSERT_EQ(std::vector<uint32_t>({pbap_handle}), ServiceSearch(seq));
+  seq.uuid_entry[seq.num_uids++] = UuidSeq(UUID_SERVCLASS_SERIAL_PORT).uuid_entry[0];
+  ASSERT_TRUE(ServiceSearch(seq).empty());
+
+  // Records after a deleted one move down, the index follows them
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(spp_handle));
+  ASSERT_TRUE(ServiceSearch(UuidSeq(UUID_SERVCLASS_SERIAL_PORT)).empty());
+  ASSERT_EQ(std::vector<uint32_t>({pbap_handle}),
+            ServiceSearch(UuidSeq(UUID_SERVCLASS_PBAP_PSE)));
+  ASSERT_EQ(std::vector<uint32_t>({opp_handle, pbap_handle}),
+            ServiceSearch(UuidSeq(UUID_PROTOCOL_RFCOMM)));
+
+  // Replacing an attribute drops the UUIDs of its old value
+  uint16_t service_uuid = UUID_SERVCLASS_MESSAGE_ACCESS;
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(opp_handle, 1,
+                                                                           &service_uuid));
+  ASSERT_TRUE(ServiceSearch(UuidSeq(UUID_SERVCLASS_OBEX_OBJECT_PUSH)).empty());
+  ASSERT_EQ(std::vector<uint32_t>({opp_handle}),
+            ServiceSearch(UuidSeq(UUID_SERVCLASS_MESSAGE_ACCESS)));
+
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(0));
+  ASSERT_TRUE(sdp_cb.server_db.uuid_index.empty());
+}
@@ -18,8 +18,10 @@
 #include <gtest/gtest.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "include/macros.h"
 #include "osi/include/allocator.h"
@@ -29,6 +31,7 @@
 #include "stack/sdp/internal/sdp_api.h"
 #include "stack/sdp/sdpint.h"
 #include "test/fake/fake_osi.h"
+#include "test/mock/mock_osi_alarm.h"
 #include "test/mock/mock_osi_allocator.h"
 #include "test/mock/mock_stack_l2cap_api.h"
 
@@ -190,6 +193,232 @@ TEST_F(StackSdpInitTest, sdp_service_search_request_queuing_race_condition) {
   sdp_disconnect(p_ccb2, tSDP_STATUS::SDP_SUCCESS);
 }
 
+namespace {
+
+constexpr uint16_t kCachedServiceUuid = UUID_SERVCLASS_AUDIO_SINK;
+
+// Service search attribute response holding one record with the service class
+// id list and a protocol descriptor list with the L2CAP PSM |psm|
+std::vector<uint8_t> SearchAttrRsp(uint16_t psm) {
+  return {
+          SDP_PDU_SERVICE_SEARCH_ATTR_RSP,
+          0x00, 0x01,  // transaction id
+          0x00, 0x1C,  // parameter length
+          0x00, 0x19,  // attribute lists byte count
+          0x35, 0x17, 0x35, 0x15,
+          0x09, 0x00, 0x01, 0x35, 0x03, 0x19, 0x11, 0x0B,  // service class id list
+          0x09, 0x00, 0x04, 0x35, 0x08, 0x35, 0x06, 0x19, 0x01, 0x00,
+          0x09, static_cast<uint8_t>(psm >> 8), static_cast<uint8_t>(psm),  // L2CAP PSM
+          0x00,  // no continuation
+  };
+}
+
+// Service search attribute response holding the ServiceDatabaseState of the
+// SDP server record
+std::vector<uint8_t> DbStateRsp(uint32_t db_state) {
+  return {
+          SDP_PDU_SERVICE_SEARCH_ATTR_RSP,
+          0x00, 0x01,  // transaction id
+          0x00, 0x0F,  // parameter length
+          0x00, 0x0C,  // attribute lists byte count
+          0x35, 0x0A, 0x35, 0x08, 0x09, 0x02, 0x01, 0x0A,
+          static_cast<uint8_t>(db_state >> 24), static_cast<uint8_t>(db_state >> 16),
+          static_cast<uint8_t>(db_state >> 8), static_cast<uint8_t>(db_state),
+          0x00,  // no continuation
+  };
+}
+
+// Service search attribute response of a server without ServiceDatabaseState
+const std::vector<uint8_t> kNoDbStateRsp = {
+        SDP_PDU_SERVICE_SEARCH_ATTR_RSP,
+        0x00, 0x01,  // transaction id
+        0x00, 0x05,  // parameter length
+        0x00, 0x02,  // attribute lists byte count
+        0x35, 0x00,
+        0x00,  // no continuation
+};
+
+constexpr uint16_t kPsm = 0x1001;
+constexpr uint16_t kNewPsm = 0x1003;
+
+int sdp_cache_callback_count = 0;
+tSDP_RESULT sdp_cache_callback_result = tSDP_STATUS::SDP_GENERIC_ERROR;
+std::vector<uint8_t> sdp_cache_last_request;
+
+void sdp_cache_callback(const RawAddress& /* bd_addr */, tSDP_RESULT result) {
+  sdp_cache_callback_count++;
+  sdp_cache_callback_result = result;
+}
+
+class StackSdpCacheTest : public StackSdpInitTest {
+protected:
+  void SetUp() override {
+    StackSdpInitTest::SetUp();
+    sdp_cache_clear();
+    sdp_cache_callback_count = 0;
+    sdp_cache_callback_result = tSDP_STATUS::SDP_GENERIC_ERROR;
+    test::mock::stack_l2cap_api::L2CA_DataWrite.body = [](uint16_t /* cid */,
+                                                          BT_HDR* p_data) -> tL2CAP_DW_RESULT {
+      const uint8_t* p = (const uint8_t*)(p_data + 1) + p_data->offset;
+      sdp_cache_last_request.assign(p, p + p_data->len);
+      osi_free_and_reset((void**)&p_data);
+      return tL2CAP_DW_RESULT::SUCCESS;
+    };
+  }
+
+  void TearDown() override {
+    sdp_cache_clear();
+    StackSdpInitTest::TearDown();
+  }
+
+  // Starts a search and connects to the peer, returns the CCB of the search
+  tCONN_CB* StartSearch(uint16_t uuid = kCachedServiceUuid) {
+    const bluetooth::Uuid service_uuid = bluetooth::Uuid::From16Bit(uuid);
+    EXPECT_TRUE(SDP_InitDiscoveryDb(sdp_db, BT_DEFAULT_BUFFER_SIZE, 1, &service_uuid, 0, nullptr));
+    const int cid = L2CA_ConnectReqWithSecurity_cid;
+    EXPECT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, sdp_cache_callback));
+    EXPECT_EQ(cid + 1, L2CA_ConnectReqWithSecurity_cid);
+    tCONN_CB* p_ccb = sdpu_find_ccb_by_cid(L2CA_ConnectReqWithSecurity_cid);
+    EXPECT_NE(p_ccb, nullptr);
+
+    tL2CAP_CFG_INFO cfg;
+    sdp_cb.reg_info.pL2CA_ConfigCfm_Cb(p_ccb->connection_id, 0, &cfg);
+    return p_ccb;
+  }
+
+  void Reply(tCONN_CB* p_ccb, const std::vector<uint8_t>& rsp) {
+    BT_HDR* p_msg = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + rsp.size());
+    p_msg->offset = 0;
+    p_msg->len = rsp.size();
+    memcpy(p_msg + 1, rsp.data(), rsp.size());
+    sdp_cb.reg_info.pL2CA_DataInd_Cb(p_ccb->connection_id, p_msg);
+  }
+
+  void Disconnected(tCONN_CB* p_ccb) {
+    sdp_cb.reg_info.pL2CA_DisconnectCfm_Cb(p_ccb->connection_id, 0);
+    ASSERT_EQ(p_ccb->con_state, tSDP_STATE::IDLE);
+  }
+
+  // Runs a search on the air, the peer has the service on |psm|
+  void SearchRemote(uint16_t psm = kPsm) {
+    tCONN_CB* p_ccb = StartSearch();
+    ASSERT_EQ(p_ccb->disc_state, SDP_DISC_WAIT_SEARCH_ATTR);
+    Reply(p_ccb, SearchAttrRsp(psm));
+    Disconnected(p_ccb);
+  }
+
+  // Runs a search for which the cache is checked first, the peer has the
+  // service on |psm| and the state |db_state|. Returns the CCB once the search
+  // on the air is started, or nullptr if answered from the cache.
+  tCONN_CB* SearchChecked(uint32_t db_state) {
+    tCONN_CB* p_ccb = StartSearch();
+    EXPECT_EQ(p_ccb->disc_state, SDP_DISC_WAIT_DB_STATE);
+    Reply(p_ccb, DbStateRsp(db_state));
+    if (p_ccb->disc_state != SDP_DISC_WAIT_SEARCH_ATTR) {
+      Disconnected(p_ccb);
+      return nullptr;
+    }
+    return p_ccb;
+  }
+
+  // L2CAP PSM of the service found by the last search
+  uint16_t FoundPsm() {
+    tSDP_DISC_REC* p_rec = SDP_FindServiceInDb(sdp_db, kCachedServiceUuid, nullptr);
+    tSDP_PROTOCOL_ELEM elem;
+    if (p_rec == nullptr || !SDP_FindProtocolListElemInRec(p_rec, UUID_PROTOCOL_L2CAP, &elem)) {
+      return 0;
+    }
+    return elem.params[0];
+  }
+};
+
+}  // namespace
+
+TEST_F(StackSdpCacheTest, remote_search_then_cached_search) {
+  SearchRemote();
+  ASSERT_EQ(sdp_cache_callback_count, 1);
+  ASSERT_EQ(sdp_cache_callback_result, tSDP_STATUS::SDP_SUCCESS);
+  ASSERT_EQ(FoundPsm(), kPsm);
+
+  // The records were not read along with the state of the server, they are
+  // searched again
+  tCONN_CB* p_ccb = SearchChecked(0x1234);
+  ASSERT_NE(p_ccb, nullptr);
+  ASSERT_EQ(sdp_cache_callback_count, 1);
+  Reply(p_ccb, SearchAttrRsp(kPsm));
+  Disconnected(p_ccb);
+  ASSERT_EQ(sdp_cache_callback_count, 2);
+
+  // Only the state of the server is read
+  ASSERT_EQ(SearchChecked(0x1234), nullptr);
+  const std::vector<uint8_t> db_state_uuid = {0x35, 0x03, 0x19, 0x10, 0x00};
+  const std::vector<uint8_t> db_state_attr = {0x35, 0x03, 0x09, 0x02, 0x01};
+  ASSERT_NE(std::search(sdp_cache_last_request.begin(), sdp_cache_last_request.end(),
+                        db_state_uuid.begin(), db_state_uuid.end()),
+            sdp_cache_last_request.end());
+  ASSERT_NE(std::search(sdp_cache_last_request.begin(), sdp_cache_last_request.end(),
+                        db_state_attr.begin(), db_state_attr.end()),
+            sdp_cache_last_request.end());
+  ASSERT_EQ(sdp_cache_callback_count, 3);
+  ASSERT_EQ(sdp_cache_callback_result, tSDP_STATUS::SDP_SUCCESS);
+  ASSERT_EQ(FoundPsm(), kPsm);
+}
+
+TEST_F(StackSdpCacheTest, records_changed_between_searches) {
+  SearchRemote();
+  tCONN_CB* p_ccb = SearchChecked(0x1234);
+  ASSERT_NE(p_ccb, nullptr);
+  Reply(p_ccb, SearchAttrRsp(kPsm));
+  Disconnected(p_ccb);
+
+  // The peer registered its service again on another PSM
+  p_ccb = SearchChecked(0x1235);
+  ASSERT_NE(p_ccb, nullptr);
+  Reply(p_ccb, SearchAttrRsp(kNewPsm));
+  Disconnected(p_ccb);
+  ASSERT_EQ(sdp_cache_callback_count, 3);
+  ASSERT_EQ(sdp_cache_callback_result, tSDP_STATUS::SDP_SUCCESS);
+  ASSERT_EQ(FoundPsm(), kNewPsm);
+
+  // The records found with the new state are the ones cached
+  ASSERT_EQ(SearchChecked(0x1235), nullptr);
+  ASSERT_EQ(sdp_cache_callback_count, 4);
+  ASSERT_EQ(FoundPsm(), kNewPsm);
+}
+
+TEST_F(StackSdpCacheTest, no_db_state_not_cached) {
+  SearchRemote();
+
+  tCONN_CB* p_ccb = StartSearch();
+  ASSERT_EQ(p_ccb->disc_state, SDP_DISC_WAIT_DB_STATE);
+  Reply(p_ccb, kNoDbStateRsp);
+  ASSERT_EQ(p_ccb->disc_state, SDP_DISC_WAIT_SEARCH_ATTR);
+  Reply(p_ccb, SearchAttrRsp(kPsm));
+  Disconnected(p_ccb);
+  ASSERT_EQ(sdp_cache_callback_count, 2);
+
+  // Nothing to check the records against, the state is not read anymore
+  SearchRemote();
+  ASSERT_EQ(sdp_cache_callback_count, 3);
+}
+
+TEST_F(StackSdpCacheTest, other_filters_not_cached) {
+  SearchRemote();
+
+  tCONN_CB* p_ccb = StartSearch(UUID_SERVCLASS_AUDIO_SOURCE);
+  ASSERT_EQ(p_ccb->disc_state, SDP_DISC_WAIT_SEARCH_ATTR);
+  sdp_disconnect(p_ccb, tSDP_STATUS::SDP_SUCCESS);
+}
+
+TEST_F(StackSdpCacheTest, invalidate) {
+  SearchRemote();
+
+  SDP_InvalidateCache(addr);
+  SearchRemote();
+  ASSERT_EQ(sdp_cache_callback_count, 2);
+  ASSERT_EQ(FoundPsm(), kPsm);
+}
+
 TEST_F(StackSdpInitTest, sdp_disc_wait_text) {
   std::vector<std::pair<tSDP_DISC_WAIT, std::string>> states = {
           std::make_pair(SDP_DISC_WAIT_CONN, "SDP_DISC_WAIT_CONN"),
@@ -197,6 +426,7 @@ TEST_F(StackSdpInitTest, sdp_disc_wait_text) {
           std::make_pair(SDP_DISC_WAIT_ATTR, "SDP_DISC_WAIT_ATTR"),
           std::make_pair(SDP_DISC_WAIT_SEARCH_ATTR, "SDP_DISC_WAIT_SEARCH_ATTR"),
           std::make_pair(SDP_DISC_WAIT_CANCEL, "SDP_DISC_WAIT_CANCEL"),
+          std::make_pair(SDP_DISC_WAIT_DB_STATE, "SDP_DISC_WAIT_DB_STATE"),
   };
   for (const auto& state : states) {
     ASSERT_STREQ(state.second.c_str(), sdp_disc_wait_text(state.first).c_str());
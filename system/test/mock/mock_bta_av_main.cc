@@ -63,9 +63,19 @@ void bta_av_conn_cback(uint8_t /* handle */, const RawAddress& /* bd_addr */, ui
                        tAVDT_CTRL* /* p_data */, uint8_t /* scb_index */) {
   inc_func_call_count(__func__);
 }
-void bta_av_dup_audio_buf(tBTA_AV_SCB* /* p_scb */, BT_HDR* /* p_buf */) {
+void bta_av_dup_audio_buf(tBTA_AV_SCB* /* p_scb */, tBTA_AV_MEDIA_PKT* /* p_pkt */) {
   inc_func_call_count(__func__);
 }
+tBTA_AV_MEDIA_PKT* bta_av_media_pkt_new(BT_HDR* /* p_buf */, uint32_t /* timestamp */) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+BT_HDR* bta_av_media_pkt_take(tBTA_AV_SCB* /* p_scb */, tBTA_AV_MEDIA_PKT* /* p_pkt */) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+void bta_av_media_pkt_release(tBTA_AV_MEDIA_PKT* /* p_pkt */) { inc_func_call_count(__func__); }
+void bta_av_flush_audio_list(tBTA_AV_SCB* /* p_scb */) { inc_func_call_count(__func__); }
 void bta_av_free_scb(tBTA_AV_SCB* /* p_scb */) { inc_func_call_count(__func__); }
 void bta_av_restore_switch(void) { inc_func_call_count(__func__); }
 void bta_av_sm_execute(tBTA_AV_CB* /* p_cb */, uint16_t /* event */, tBTA_AV_DATA* /* p_data */) {
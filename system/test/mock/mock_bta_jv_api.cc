@@ -56,6 +56,11 @@ tBTA_JV_STATUS BTA_JvL2capRead(uint32_t /* handle */, uint32_t /* req_id */, uin
   inc_func_call_count(__func__);
   return tBTA_JV_STATUS::SUCCESS;
 }
+tBTA_JV_STATUS BTA_JvL2capReadBuf(uint32_t /* handle */, BT_HDR** pp_buf) {
+  inc_func_call_count(__func__);
+  *pp_buf = nullptr;
+  return tBTA_JV_STATUS::FAILURE;
+}
 tBTA_JV_STATUS BTA_JvL2capReady(uint32_t /* handle */, uint32_t* /* p_data_size */) {
   inc_func_call_count(__func__);
   return tBTA_JV_STATUS::SUCCESS;
@@ -40,6 +40,7 @@ void bta_hh_co_close(btif_hh_device_t* /* p_dev */) { inc_func_call_count(__func
 void bta_hh_co_data(uint8_t /* dev_handle */, uint8_t* /* p_rpt */, uint16_t /* len */) {
   inc_func_call_count(__func__);
 }
+void bta_hh_co_dump(int /* fd */) { inc_func_call_count(__func__); }
 void bta_hh_co_get_rpt_rsp(uint8_t /* dev_handle */, uint8_t /* status */,
                            const uint8_t* /* p_rpt */, uint16_t /* len */) {
   inc_func_call_count(__func__);
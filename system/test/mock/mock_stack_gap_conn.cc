@@ -58,6 +58,11 @@ uint16_t GAP_ConnReadData(uint16_t /* gap_handle */, uint8_t* /* p_data */, uint
   inc_func_call_count(__func__);
   return 0;
 }
+uint16_t GAP_ConnReadBuf(uint16_t /* gap_handle */, BT_HDR** pp_buf) {
+  inc_func_call_count(__func__);
+  *pp_buf = nullptr;
+  return GAP_NO_DATA_AVAIL;
+}
 uint16_t GAP_ConnWriteData(uint16_t /* gap_handle */, BT_HDR* /* msg */) {
   inc_func_call_count(__func__);
   return 0;
@@ -55,6 +55,7 @@ struct SDP_GetDiRecord SDP_GetDiRecord;
 struct SDP_SetLocalDiRecord SDP_SetLocalDiRecord;
 struct SDP_GetNumDiRecords SDP_GetNumDiRecords;
 struct SDP_Dumpsys SDP_Dumpsys;
+struct SDP_InvalidateCache SDP_InvalidateCache;
 
 }  // namespace stack_sdp_api
 }  // namespace mock
@@ -148,4 +149,8 @@ void SDP_Dumpsys(int fd) {
   inc_func_call_count(__func__);
   return test::mock::stack_sdp_api::SDP_Dumpsys(fd);
 }
+void SDP_InvalidateCache(const RawAddress& bd_addr) {
+  inc_func_call_count(__func__);
+  test::mock::stack_sdp_api::SDP_InvalidateCache(bd_addr);
+}
 // END mockcify generation
@@ -265,6 +265,15 @@ struct SDP_Dumpsys {
 };
 extern struct SDP_Dumpsys SDP_Dumpsys;
 
+// Name: SDP_InvalidateCache
+// Params: const RawAddress& bd_addr
+// Returns: void
+struct SDP_InvalidateCache {
+  std::function<void(const RawAddress& bd_addr)> body{[](const RawAddress& /* bd_addr */) {}};
+  void operator()(const RawAddress& bd_addr) { body(bd_addr); }
+};
+extern struct SDP_InvalidateCache SDP_InvalidateCache;
+
 }  // namespace stack_sdp_api
 }  // namespace mock
 }  // namespace test